@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include "event-impl.h"
+
+#include <stdint.h>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall-clock profile of the events of a simulation.
+ *
+ * Where DesMetrics traces when the events are scheduled and run in
+ * simulated time, the EventProfiler measures the wall-clock time they
+ * take to run, to find the models which cost the most.
+ *
+ * The time of an event, the number of events it schedules or
+ * reschedules, and the number of allocations it makes, are attributed
+ * to the function it calls, as given by EventImpl::GetFunction(), and
+ * to its context, normally the node id. The profile is printed as a
+ * flat summary by function, then by node.
+ *
+ * The allocations counted are those of the events, whether or not
+ * their memory comes from the pool of EventImpl, of the packets, and
+ * of the packet buffers not taken from the free list of Buffer. Other
+ * allocations, such as those of the headers and of the containers of
+ * the models, are not counted.
+ *
+ * Only a sample of the events is measured: one in a period, on average,
+ * at pseudo-random intervals so that periodic patterns of events do not
+ * bias the sample. The times and counts are scaled by the period, so
+ * that they estimate those of the whole run. The other events cost a
+ * counter decrement. A few expensive events make the estimates noisy:
+ * a smaller period gives better ones, and a period of 1 measures every
+ * event.
+ *
+ * DefaultSimulatorImpl profiles its events when its \c ProfileSampling
+ * attribute is not zero, and prints the profile at Simulator::Destroy():
+ * \verbatim
+   $ ./waf --run "tcp-bulk-send --ns3::DefaultSimulatorImpl::ProfileSampling=100" \endverbatim
+ *
+ * The functions are named from the symbols of the shared libraries
+ * where the platform allows it. Otherwise, as for the virtual class
+ * methods, they are named by their signature, with the dynamic type of
+ * their object and the representation of their pointer.
+ */
+class EventProfiler
+{
+public:
+  /** The wall clock. */
+  typedef std::chrono::steady_clock Clock;
+
+  /** Constructor, the profiler is disabled. */
+  EventProfiler ();
+
+  /**
+   * Set the sampling period and clear the profile.
+   *
+   * \param [in] period The mean number of events per sample, 0 to disable
+   *             the profiler.
+   */
+  void SetPeriod (uint32_t period);
+  /** \returns The sampling period, 0 if the profiler is disabled. */
+  uint32_t GetPeriod (void) const;
+
+  /**
+   * Decide whether to measure the next event.
+   *
+   * \returns \c true if the event is sampled.
+   */
+  bool Sample (void)
+  {
+    return m_countdown != 0 && --m_countdown == 0 && Rearm ();
+  }
+
+  /** Count an allocation made by the running event. */
+  static void CountAllocation (void)
+  {
+    m_allocations++;
+  }
+  /** \returns The number of allocations counted by this thread. */
+  static uint64_t GetAllocations (void)
+  {
+    return m_allocations;
+  }
+
+  /** What the time of a sampled event is attributed to. */
+  struct Key
+  {
+    const std::type_info *event;  //!< The dynamic type of the event.
+    EventImpl::Function function; //!< The function called by the event.
+    uint32_t context;             //!< The context of the event.
+
+    /**
+     * \param [in] o The other key.
+     * \returns \c true if this key is ordered before \p o.
+     */
+    bool operator < (const Key &o) const;
+  };
+
+  /**
+   * Identify a sampled event. This must be done before the event runs,
+   * since it may be deleted once invoked.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   * \returns The key of the event.
+   */
+  static Key GetKey (const EventImpl *event, uint32_t context);
+
+  /**
+   * Record the measure of a sampled event.
+   *
+   * \param [in] key The key of the event, from GetKey().
+   * \param [in] start The wall-clock time at which the event started.
+   * \param [in] scheduled The number of events scheduled by the event.
+   * \param [in] allocations The number of allocations made by the event.
+   */
+  void Record (const Key &key, Clock::time_point start, uint32_t scheduled,
+               uint64_t allocations);
+
+  /**
+   * Print the profile.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] eventCount The number of events run.
+   */
+  void Print (std::ostream &os, uint64_t eventCount) const;
+
+private:
+  /** The measures of the sampled events. */
+  struct Measure
+  {
+    uint64_t samples;      //!< Number of sampled events.
+    uint64_t ns;           //!< Wall-clock time of the sampled events, in nanoseconds.
+    uint64_t scheduled;    //!< Events scheduled by the sampled events.
+    uint64_t allocations;  //!< Allocations made by the sampled events.
+  };
+
+  /**
+   * Draw the number of events until the next sample.
+   *
+   * \returns \c true
+   */
+  bool Rearm (void);
+
+  /**
+   * Name the function called by the events of a key.
+   *
+   * \param [in] key The key.
+   * \returns The name.
+   */
+  static std::string GetName (const Key &key);
+
+  /** The mean number of events per sample, 0 if disabled. */
+  uint32_t m_period;
+  /** Number of events until the next sample, 0 if disabled. */
+  uint32_t m_countdown;
+  /** State of the generator of the sampling intervals. */
+  uint64_t m_state;
+  /** The measures. */
+  std::map<Key, Measure> m_measures;
+  /** Number of allocations counted by this thread. */
+  static thread_local uint64_t m_allocations;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
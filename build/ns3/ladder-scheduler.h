@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+#include <unordered_set>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This class implements the Ladder Queue of W.T. Tang, R.S.M. Goh and
+ * I.L.-J. Thng, "Ladder Queue: An O(1) Priority Queue Structure for
+ * Large-Scale Discrete Event Simulation", ACM TOMACS 15(3), 2005.
+ *
+ * Events are kept in three tiers:
+ *  - Top: an unsorted vector receiving the events scheduled far in the
+ *    future, at or after m_topStart.
+ *  - Ladder: up to MAX_RUNGS rungs of buckets. When the ladder is empty,
+ *    the content of Top is spread over a first rung whose bucket width is
+ *    the mean spacing of those events. The width thus follows the
+ *    distribution of the event times instead of being sampled as in the
+ *    CalendarScheduler. A bucket that holds more than THRESHOLD events
+ *    when it is reached is spread over a child rung with narrower buckets.
+ *  - Bottom: the few events about to be executed, sorted in decreasing
+ *    order so that the earliest one is removed from the back.
+ *
+ * Insertion in Top and in a rung is O(1) and each event is moved at most
+ * once per rung, hence the amortized O(1) cost of insertion and removal.
+ * Buckets are vectors, and the vectors of the rungs are reused from one
+ * epoch to the next.
+ *
+ * Remove() has to search the tier the event belongs to, which is linear
+ * in the size of Top for events scheduled far ahead. Reschedule() does
+ * not search Top: the entry of the event is left there, marked as moved
+ * by its uid, and dropped when Top is spread over the ladder. Pushing
+ * back a timer, such as a retransmission timeout, is thus O(1).
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+  virtual void Reschedule (const Scheduler::Event &ev, const Scheduler::EventKey &newKey);
+  virtual void RemoveCancelled (std::vector<Scheduler::Event> &cancelled);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: an array of buckets of equal width. */
+  struct Rung
+  {
+    std::vector<Bucket> buckets;  /**< The buckets, only nBuckets are in use. */
+    uint32_t nBuckets;            /**< Number of buckets in use. */
+    uint64_t start;               /**< Time stamp of the start of the first bucket. */
+    uint64_t width;               /**< Duration of a bucket, in dimensionless time units. */
+    uint32_t current;             /**< First bucket not yet moved down. */
+  };
+
+  /** Maximum number of rungs of the ladder. */
+  static const uint32_t MAX_RUNGS = 8;
+  /** Bucket size above which a bucket is spread over a new rung. */
+  static const uint32_t THRESHOLD = 50;
+  /** Maximum number of buckets of a rung. */
+  static const uint32_t MAX_BUCKETS = 32768;
+
+  /**
+   * \param [in] rung The rung index.
+   * \returns The time stamp of the start of the first bucket not yet moved down.
+   */
+  inline uint64_t CurrentStart (uint32_t rung) const;
+  /**
+   * Find the rung an event time belongs to.
+   *
+   * \param [in] ts The time stamp of the event.
+   * \returns The rung index, or m_nRungs if the event belongs to Bottom.
+   */
+  inline uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Set up a new rung below the existing ones and spread events over it.
+   *
+   * \param [in] start The time stamp of the start of the rung.
+   * \param [in] span The duration covered by the rung.
+   * \param [in] events The events to spread, all in [start, start + span).
+   */
+  void SpawnRung (uint64_t start, uint64_t span, const Bucket &events);
+  /** Spread the content of Top over the first rung, or Bottom if small. */
+  void TransferTop (void);
+  /** Move the next events down the ladder until Bottom is not empty. */
+  void FillBottom (void);
+  /**
+   * Insert an event in the sorted Bottom.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /**
+   * Remove an event from an unsorted bucket.
+   *
+   * \param [in,out] bucket The bucket.
+   * \param [in] ev The event.
+   * \returns \c true if the event was found.
+   */
+  static bool RemoveFromBucket (Bucket &bucket, const Scheduler::Event &ev);
+  /**
+   * Remove the cancelled events from a bucket, keeping the order of the others.
+   *
+   * \param [in,out] bucket The bucket.
+   * \param [out] cancelled The removed events are appended to this vector.
+   */
+  static void RemoveCancelledFromBucket (Bucket &bucket, std::vector<Scheduler::Event> &cancelled);
+  /** Drop the entries of Top whose event was moved by Reschedule(). */
+  void DropMovedFromTop (void);
+
+  /** Events at or after m_topStart, unsorted. */
+  Bucket m_top;
+  /** Uids of the entries of Top whose event was moved by Reschedule(). */
+  std::unordered_set<uint32_t> m_movedFromTop;
+  /** Time stamp above which events are inserted in Top. */
+  uint64_t m_topStart;
+  /** The rungs, only m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted by decreasing key. */
+  Bucket m_bottom;
+  /** Number of events in the scheduler. */
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_CONGESTION_BALIA_H
+#define MPTCP_CONGESTION_BALIA_H
+
+#include "ns3/mptcp-congestion-ops.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Balanced Linked Adaptation
+ *
+ * From "Multipath TCP: Analysis, Design and Implementation" (Peng et al.,
+ * IEEE/ACM ToN 2016). With x_r = w_r / rtt_r and alpha_r = max_k (x_k) / x_r,
+ * for each ACK on path r, w_r (in packets) is increased by
+ *
+ *   x_r / (rtt_r * (sum_k x_k)^2) * (1 + alpha_r) / 2 * (4 + alpha_r) / 5
+ *
+ * and upon loss decreased by
+ *
+ *   w_r / 2 * min (alpha_r, 1.5)
+ */
+class MpTcpCongestionBalia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpCongestionBalia ();
+
+  /**
+   * \brief Copy constructor.
+   * \param sock object to copy.
+   */
+  MpTcpCongestionBalia (const MpTcpCongestionBalia& sock);
+
+  virtual ~MpTcpCongestionBalia ();
+
+  virtual std::string GetName () const;
+
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual double ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const;
+
+  /**
+   * \return alpha_r of the subflow, 1 if unknown
+   */
+  double ComputeAlpha () const;
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_BALIA_H */
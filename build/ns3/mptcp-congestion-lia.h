@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_CONGESTION_LIA_H
+#define MPTCP_CONGESTION_LIA_H
+
+#include "ns3/mptcp-congestion-ops.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Linked Increases Algorithm (\rfc{6356})
+ *
+ * For each ACK received on subflow i, cwnd_i is increased by
+ *
+ *   min (alpha * bytes_acked * MSS_i / cwnd_total, bytes_acked * MSS_i / cwnd_i)
+ *
+ * with
+ *
+ *   alpha = cwnd_total * max_i (cwnd_i / rtt_i^2) / (sum_i (cwnd_i / rtt_i))^2
+ *
+ * which simplifies the first term to
+ *   max_i (cwnd_i / rtt_i^2) * bytes_acked * MSS_i / (sum_i (cwnd_i / rtt_i))^2
+ */
+class MpTcpCongestionLia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpCongestionLia ();
+
+  /**
+   * \brief Copy constructor.
+   * \param sock object to copy.
+   */
+  MpTcpCongestionLia (const MpTcpCongestionLia& sock);
+
+  virtual ~MpTcpCongestionLia ();
+
+  virtual std::string GetName () const;
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual double ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const;
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_LIA_H */
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_CONGESTION_OLIA_H
+#define MPTCP_CONGESTION_OLIA_H
+
+#include "ns3/mptcp-congestion-ops.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Opportunistic Linked Increases Algorithm
+ *
+ * From "MPTCP is not Pareto-optimal: performance issues and a possible
+ * solution" (Khalili et al., CoNEXT 2012). For each ACK on path r, w_r
+ * (in packets) is increased by
+ *
+ *   (w_r / rtt_r^2) / (sum_p (w_p / rtt_p))^2 + alpha_r / w_r
+ *
+ * alpha_r shifts window from the paths with the largest window (M) towards
+ * the presumably best paths (B), i.e. the ones maximizing l_r^2 / rtt_r where
+ * l_r is the number of bytes acked between the last two losses:
+ * - 1 / (|P| * |B\M|) if r is in B\M,
+ * - -1 / (|P| * |M|) if r is in M and B\M is not empty,
+ * - 0 otherwise.
+ *
+ * \note The meta only tracks the argmax of both sets, i.e. B and M are
+ * assumed to be singletons, which is always the case but for exact ties.
+ */
+class MpTcpCongestionOlia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpCongestionOlia ();
+
+  /**
+   * \brief Copy constructor.
+   * \param sock object to copy.
+   */
+  MpTcpCongestionOlia (const MpTcpCongestionOlia& sock);
+
+  virtual ~MpTcpCongestionOlia ();
+
+  virtual std::string GetName () const;
+
+  /**
+   * \brief Accounts the acked bytes in the current inter-loss interval
+   */
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time& rtt);
+
+  /**
+   * \brief Starts a new inter-loss interval and halves the window
+   */
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual double ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const;
+
+  /**
+   * \return alpha_r of the subflow
+   */
+  double ComputeAlpha () const;
+
+private:
+  uint64_t m_lastInterval;    //!< Bytes acked between the two last losses (l1r)
+  uint64_t m_currentInterval; //!< Bytes acked since the last loss (l2r)
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_OLIA_H */
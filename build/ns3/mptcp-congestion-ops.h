@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_CONGESTION_OPS_H
+#define MPTCP_CONGESTION_OPS_H
+
+#include "ns3/tcp-congestion-ops.h"
+
+namespace ns3 {
+
+class MpTcpSocketBase;
+class MpTcpSubflow;
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Base class for the MPTCP coupled congestion controls
+ *
+ * Every subflow owns its own instance, attached by the meta socket in
+ * MpTcpSocketBase::AddSubflow. Slow start and the reaction to losses
+ * default to NewReno; subclasses only provide the coupled increase
+ * computed in CongestionAvoidance.
+ *
+ * The aggregates (sum of cwnd, sum of cwnd/rtt, max of cwnd/rtt^2 ...) are
+ * cached by the meta socket and refreshed each time a subflow window
+ * changes, so that an increase costs O(1) regardless of the number of subflows.
+ *
+ * Coupled increases are often smaller than one byte per ACK, hence the
+ * fractional part is accumulated in m_cwndCnt.
+ */
+class MpTcpCongestionOps : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpCongestionOps ();
+
+  /**
+   * \brief Copy constructor.
+   * \param sock object to copy.
+   */
+  MpTcpCongestionOps (const MpTcpCongestionOps& sock);
+
+  virtual ~MpTcpCongestionOps ();
+
+  virtual std::string GetName () const;
+
+  /**
+   * \brief Links the algorithm to the connection it is coupled with
+   * \param meta The meta socket holding the aggregates
+   * \param subflow The subflow this instance controls
+   */
+  virtual void SetMeta (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> subflow);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  /**
+   * \brief Coupled congestion avoidance
+   *
+   * Falls back to NewReno as long as the instance is not attached to a meta.
+   *
+   * \param tcb internal congestion state
+   * \param segmentsAcked count of segments acked
+   */
+  virtual void CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  /**
+   * \brief Amount of bytes the window should grow of for this ACK
+   *
+   * \param tcb internal congestion state
+   * \param segmentsAcked count of segments acked
+   * \return the (possibly fractional and negative) increase in bytes
+   */
+  virtual double ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const;
+
+  /**
+   * \return Smoothed RTT of the subflow in seconds
+   */
+  double GetSubflowRtt () const;
+
+  /**
+   * The meta and the subflow are not referenced: the subflow owns this
+   * instance and holds the meta, so that strong pointers would make cycles.
+   */
+  MpTcpSocketBase *m_metaSock;      //!< Meta holding the cached aggregates
+  MpTcpSubflow *m_subflow;          //!< Subflow controlled by this instance
+  double m_cwndCnt;                 //!< Fractional part of the window increase
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_OPS_H */
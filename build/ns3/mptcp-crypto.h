@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2007 Georgia Tech Research Corporation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Kashif Nadeem <kshfnadeem@gmail.com>
+ *          Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *
+ */
+
+#ifndef MPTCP_CRYPTO_H
+#define MPTCP_CRYPTO_H
+
+#include <stdint.h>
+
+  /**
+   * Token:  A locally unique identifier given to a multipath connection
+   * by a host.  May also be referred to as a "Connection ID".
+   *
+   * In this specification, with only the SHA-1 algorithm
+   * (bit "H") specified and selected, the token MUST be a truncated (most
+   * significant 32 bits) SHA-1 hash ([4], [15]) of the key.  A different,
+   * 64-bit truncation (the least significant 64 bits) of the SHA-1 hash
+   * of the key MUST be used as the initial data sequence number.  Note
+   * that the key MUST be hashed in network byte order.  Also note that
+   * the "least significant" bits MUST be the rightmost bits of the SHA-1
+   * digest, as per [4].  Future specifications of the use of the crypto
+   * bits may choose to specify different algorithms for token and IDSN
+   * generation.
+   */
+namespace ns3
+{
+  /**
+   * \brief Hash algorithms negotiated in MP_CAPABLE
+   *
+   * SHA-1 is the only one defined by \rfc{6824}, \rfc{8684} replaces it by SHA-256.
+   */
+  enum mptcp_crypto_alg_t
+  {
+    HMAC_SHA1 = 1,  /**< Default choice */
+    HMAC_SHA256 = 2 /**< MPTCP version 1 */
+  };
+
+  /**
+   * \brief Size in bytes of the HMAC carried by the third ACK of MP_JOIN
+   *
+   * HMAC-SHA256 is truncated to the leftmost 160 bits by \rfc{8684}.
+   */
+  static const uint32_t MPTCP_HMAC_SIZE = 20;
+
+  /**
+   * \brief This function generates the token and idsn based on the passed key
+   *
+   * The token is the most significant 32 bits of the hash of the key,
+   * the least significant 64 bits of that same hash are the initial data
+   * sequence number, as specified by \rfc{6824} (SHA-1) and \rfc{8684} (SHA-256).
+   * The key is hashed in network byte order.
+   *
+   * \param alg The hmac algorith m to use to generate the hash
+   * \param key Given key for a connection
+   * \param token Resulting token generated from the key
+   * \param idsn Resulting initial data sequence number generated from the key
+   */
+  void
+  GenerateTokenForKey( mptcp_crypto_alg_t alg, uint64_t key, uint32_t& token, uint64_t& idsn);
+
+  /**
+   * \brief Computes the HMAC authenticating a MP_JOIN handshake
+   *
+   * HMAC-A = HMAC(Key=(Key-A+Key-B), Msg=(R-A+R-B)) where A is the host sending
+   * the HMAC, hence the SYN/ACK carries HMAC(Key-B+Key-A, R-B+R-A).
+   *
+   * \param alg The hmac algorithm
+   * \param localKey Key of the host sending the HMAC
+   * \param peerKey Key of the remote host
+   * \param localNonce Random number of the host sending the HMAC
+   * \param peerNonce Random number of the remote host
+   * \param hmac The leftmost MPTCP_HMAC_SIZE bytes of the HMAC
+   */
+  void
+  GenerateJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                    uint32_t localNonce, uint32_t peerNonce, uint8_t hmac[MPTCP_HMAC_SIZE]);
+
+  /**
+   * \brief Leftmost 64 bits of the HMAC, as sent in the SYN/ACK of MP_JOIN
+   *
+   * \see GenerateJoinHmac
+   * \return the truncated HMAC
+   */
+  uint64_t
+  GenerateTruncatedJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                             uint32_t localNonce, uint32_t peerNonce);
+
+  /**
+   * \brief Authenticates an ADD_ADDR option (\RFC{8684})
+   *
+   * \param alg The hmac algorithm
+   * \param senderKey Key of the host advertising the address
+   * \param receiverKey Key of the remote host
+   * \param msg Address ID, address and port
+   * \param size Size of msg, in bytes
+   * \return The rightmost 64 bits of HMAC(Key=(senderKey+receiverKey), Msg=msg)
+   */
+  uint64_t
+  GenerateAddAddressHmac( mptcp_crypto_alg_t alg, uint64_t senderKey, uint64_t receiverKey,
+                          const uint8_t* msg, uint32_t size);
+}
+
+#endif
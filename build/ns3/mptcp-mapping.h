@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Kashif Nadeem <kshfnadeem@gmail.com>
+ *          Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ *
+ */
+#ifndef MPTCP_MAPPING_H
+#define MPTCP_MAPPING_H
+
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <list>
+#include <set>
+#include <map>
+#include "ns3/object.h"
+#include "ns3/uinteger.h"
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/sequence-number.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/event-id.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-socket.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+
+namespace ns3
+{
+/**
+ *\brief A base class for implementation of mapping for mptcp.
+ *
+ * This class contains the functionality for sequence number mapping.
+ *
+ * This class maps TCP sequence numbers to subflow level sequnce number (SSN)
+ * and connection level sequence numbers (DSN)
+ * DSN=Data Sequence Number (mptcp option level)
+ * SSN=Subflow Sequence Number (TCP legacy seq nb)
+ */
+
+class MpTcpMapping
+{
+public:
+  MpTcpMapping(void);
+  virtual ~MpTcpMapping(void);
+
+  /**
+   * \brief Set subflow sequence number
+   * \param headSSN
+   */
+  void MapToSSN( SequenceNumber32 const& headSSN);
+
+  /**
+   * \return True if mappings share DSN space
+   * \param headSSN head SSN
+   * \param len 
+   */
+
+  virtual bool
+  OverlapRangeSSN(const SequenceNumber32& headSSN, const uint16_t& len) const;
+
+  virtual bool
+  OverlapRangeDSN(const SequenceNumber64& headDSN, const uint16_t& len) const;
+  void SetHeadDSN(SequenceNumber64 const&);
+
+  /**
+   * \brief Set mapping length
+   */
+  virtual void
+  SetMappingSize(uint16_t const&);
+
+  /**
+   * \param ssn Data seqNb
+   */
+  bool IsSSNInRange(SequenceNumber32 const& ssn) const;
+
+  /**
+   * \param dsn Data seqNb
+   */
+  bool IsDSNInRange(SequenceNumber64 const& dsn) const;
+
+  /**
+   * \param ssn Subflow sequence number
+   * \param dsn Data Sequence Number
+   * \return True if ssn belonged to this mapping, then a dsn would have been computed
+   *
+   */
+  bool
+  TranslateSSNToDSN(const SequenceNumber32& ssn, SequenceNumber64& dsn) const;
+
+  /**
+   * \return The last MPTCP sequence number included in the mapping
+   */
+  SequenceNumber64 TailDSN (void) const;
+
+  /**
+   * \return The last subflow sequence number included in the mapping
+   */
+  SequenceNumber32 TailSSN (void) const;
+
+  /**
+   * \brief Necessary for
+   * \brief std::set to sort mappings
+   * Compares ssn
+   * \brief Compares mapping based on their DSN number. It is required when inserting into a set
+   */
+  bool operator<(MpTcpMapping const& ) const;
+
+  /**
+   * \return MPTCP sequence number for the first mapped byte
+   */
+  virtual SequenceNumber64
+  HeadDSN() const;
+
+  /**
+   * \return subflow sequence number for the first mapped byte
+   */
+  virtual SequenceNumber32
+  HeadSSN() const;
+
+  /**
+   * \return mapping length
+   */
+  virtual uint16_t
+  GetLength() const ;
+
+  /**
+   * \brief Mapping are equal if everything concord, SSN/DSN and length
+   */
+  virtual bool operator==( const MpTcpMapping&) const;
+
+  /**
+   * \return Not ==
+   */
+  virtual bool operator!=( const MpTcpMapping& mapping) const;
+
+protected:
+  SequenceNumber64 m_dataSequenceNumber;   //!< MPTCP sequence number
+  SequenceNumber32 m_subflowSequenceNumber;  //!< subflow sequence number
+  uint16_t m_dataLevelLength;  //!< mapping length / size
+};
+
+/**
+ * \brief Depending on modifications allowed in upstream ns3, it may some day inherit from TcpTxbuffer etc ...
+ * \brief Meanwhile we have a pointer towards the buffers.
+ *
+ * \class MpTcpMappingContainer
+ * Mapping handling
+ * Once a mapping has been advertised on a subflow, it must be honored. If the remote host already received the data
+ * (because it was sent in parallel over another subflow), then the received data must be discarded.
+ *
+ * Mappings never overlap in SSN space and are appended almost always in SSN order,
+ * hence they are kept sorted by SSN in a contiguous ring buffer: appending and
+ * removing acked mappings from the front is O(1), SSN lookups are binary searches.
+ * DSN lookups go through a secondary index sorted by DSN, whose entries are removed
+ * lazily (an entry whose mapping is gone is skipped, and the index gets compacted
+ * once stale entries outnumber the live ones).
+ * Storage only grows (by doubling) so that steady state traffic does not allocate.
+ */
+
+class MpTcpMappingContainer
+{
+public:
+  MpTcpMappingContainer(void);
+  virtual ~MpTcpMappingContainer(void);
+
+  /**
+   * \brief Discard mappings which TailDSN() < maxDsn and TailSSN() < maxSSN
+   *
+   * This can be called only when dsn is in the meta socket Rx buffer and in order
+   * (since it may renegate some data when out of order).
+   * The mapping should also have been thoroughly fulfilled at the subflow level.
+   * Mappings are discarded from the lowest SSN and the process stops at the first mapping
+   * that does not match, so the cost is proportional to the number of discarded mappings.
+   * \return Number of mappings discarded. >= 0
+   */
+  uint32_t DiscardMappingsUpTo(const SequenceNumber64& maxDsn, const SequenceNumber32& maxSsn);
+
+  /**
+   * \brief When Buffers work in non renegotiable mode,
+   * it should be possible to remove them one by one
+   * \param mapping to be discarded
+   */
+  bool DiscardMapping(const MpTcpMapping& mapping);
+
+  /**
+   * \param firstUnmappedSsn last mapped SSN.
+   * \return true if non empty
+   */
+  bool FirstUnmappedSSN(SequenceNumber32& firstUnmappedSsn) const;
+
+  /**
+   * \brief For debug purpose. Dump all registered mappings
+   */
+  virtual void Dump() const;
+
+  /**
+   * \brief
+   * Should do no check
+   * The mapping
+   * \note Check for overlap.
+   * \return False if the ssn range overlaps with a registered mapping, true otherwise
+  **/
+  bool AddMapping(const MpTcpMapping& mapping);
+
+  /**
+   * \param l list
+   * \param m pass on the mapping you want to retrieve
+   */
+  bool
+  GetMappingForSSN(const SequenceNumber32& ssn, MpTcpMapping& m) const;
+
+  /**
+   * \brief Looks for the mapping covering a DSN.
+   * The same DSN may be mapped several times when data gets reinjected,
+   * in which case the mapping with the highest SSN is returned.
+   * \param dsn data sequence number to look for
+   * \param m mapping found, if any
+   * \return true if a mapping covers dsn
+   */
+  bool
+  GetMappingForDSN(const SequenceNumber64& dsn, MpTcpMapping& m) const;
+
+  /**
+   * \brief Lowest DSN still mapped, whichever the SSN of its mapping
+   * \param dsn head DSN of the mapping with the lowest DSN, if any
+   * \return false if no mapping is registered
+   */
+  bool LowestDSN(SequenceNumber64& dsn) const;
+
+  /**
+   * \param dsn
+   */
+  virtual bool GetMappingsStartingFromSSN(SequenceNumber32 ssn, std::set<MpTcpMapping>& mappings);
+
+  /**
+   * \return Number of registered mappings
+   */
+  uint32_t GetSize() const;
+
+  /**
+   * \return True if no mapping is registered
+   */
+  bool IsEmpty() const;
+
+protected:
+  /**
+   * \brief Entry of the DSN index
+   *
+   * Refers to a mapping through its head SSN, which stays valid when the ring moves.
+   */
+  struct DsnIndexEntry
+  {
+    SequenceNumber64 headDsn; //!< Head DSN of the mapping
+    SequenceNumber32 headSsn; //!< Head SSN of the mapping, identifies it in the ring
+  };
+
+  /**
+   * \brief Orders the DSN index by head DSN
+   */
+  static bool DsnIndexLess(const DsnIndexEntry& a, const DsnIndexEntry& b);
+
+  /**
+   * \return True if the entry still refers to a registered mapping
+   */
+  bool IsLiveEntry(const DsnIndexEntry& entry) const;
+
+  /**
+   * \param i logical position, 0 being the mapping with the lowest SSN
+   * \return the mapping stored at this position
+   */
+  const MpTcpMapping& At(uint32_t i) const;
+
+  /**
+   * \return Position of the first mapping whose head SSN is >= ssn (GetSize() if none)
+   */
+  uint32_t LowerBoundSSN(const SequenceNumber32& ssn) const;
+
+  /**
+   * \return Position of the first mapping whose head SSN is > ssn (GetSize() if none)
+   */
+  uint32_t UpperBoundSSN(const SequenceNumber32& ssn) const;
+
+  /**
+   * \brief Doubles the ring capacity, unrolling it so that the head ends up at slot 0
+   */
+  void Grow();
+
+  /**
+   * \brief Removes the mapping at logical position i, shifting the shorter side of the ring
+   */
+  void EraseAt(uint32_t i);
+
+  /**
+   * \brief Drops the DSN index entry of a discarded mapping
+   *
+   * The entry is erased right away when it is the first of the index, which is the common case
+   * as DSN and SSN mostly grow together; otherwise it is left stale.
+   */
+  void UnindexMapping(const MpTcpMapping& mapping);
+
+  /**
+   * \brief Rebuilds the DSN index without its stale entries
+   */
+  void CompactDsnIndex();
+
+  std::vector<MpTcpMapping> m_ring;  //!< Mappings sorted by SSN, capacity is a power of 2
+  uint32_t m_head;                   //!< Slot of the mapping with the lowest SSN
+  uint32_t m_size;                   //!< Number of mappings in the ring
+
+  std::vector<DsnIndexEntry> m_dsnIndex;  //!< Sorted by DSN, may hold stale entries
+  uint32_t m_dsnIndexBegin;               //!< First meaningful entry of m_dsnIndex
+  uint32_t m_dsnIndexStale;               //!< Number of stale entries after m_dsnIndexBegin
+};
+
+std::ostream& operator<<(std::ostream &os, const MpTcpMapping& mapping);
+
+/**
+ * \brief Infers a 64 bits DSN from its lower 32 bits, as sent in a DSS option
+ * without the DSNOfEightBytes/DataAckOf8Bytes flags
+ *
+ * \param dsn lower 32 bits of the DSN
+ * \param reference a DSN known to be less than 2^31 away, e.g. the next expected one
+ * \return The DSN with these lower bits closest to reference
+ */
+SequenceNumber64 ExpandDsn(uint32_t dsn, const SequenceNumber64& reference);
+
+} //namespace ns3
+#endif //MP_TCP_TYPEDEFS_H
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#ifndef MPTCP_SCHEDULER_BLEST_H
+#define MPTCP_SCHEDULER_BLEST_H
+
+#include "ns3/mptcp-scheduler.h"
+
+namespace ns3
+{
+
+/**
+ * \brief BLocking ESTimation-based scheduler
+ *
+ * Behaves like minRTT as long as the fastest subflow has some window left.
+ * Before sending on a slower subflow, it estimates how many bytes the fastest
+ * subflow would send during one RTT of the slower one:
+ * X = (cwnd_f + mss_f * (rtt_s/rtt_f - 1) / 2) * rtt_s/rtt_f
+ * If Lambda * X does not fit in the peer receive window next to the data the
+ * slow subflow would hold, sending on the slow subflow would block the fast one
+ * and the data waits for the fast subflow instead.
+ *
+ * See "BLEST: Blocking estimation-based MPTCP scheduler for heterogeneous networks",
+ * Ferlin et al., IFIP Networking 2016.
+ */
+class MpTcpSchedulerBlest : public MpTcpScheduler
+{
+
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSchedulerBlest();
+  virtual ~MpTcpSchedulerBlest ();
+
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments);
+
+protected:
+  /**
+   * \param state snapshot of the connection
+   * \param fast position of the fastest subflow
+   * \param slow position of the candidate subflow
+   * \return True if sending on slow could block the fastest subflow
+   */
+  virtual bool WouldBlock(const MpTcpSchedulerState& state, uint32_t fast, uint32_t slow) const;
+
+  double m_lambda;  //!< Scaling of the estimated amount of data sent on the fast subflow
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_BLEST_H */
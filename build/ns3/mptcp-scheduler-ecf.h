@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#ifndef MPTCP_SCHEDULER_ECF_H
+#define MPTCP_SCHEDULER_ECF_H
+
+#include "ns3/mptcp-scheduler.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Earliest Completion First scheduler
+ *
+ * Behaves like minRTT as long as the fastest subflow has some window left.
+ * Otherwise it compares the time needed to send the k pending bytes by waiting for
+ * the fastest subflow, (1 + k/cwnd_f) * rtt_f, with the time to get them through
+ * the slower subflow, rtt_s + delta (delta being the largest RTT variation).
+ * When waiting is faster and the slow subflow would not be done before the fastest
+ * one gets a new window (k/cwnd_s * rtt_s >= 2 rtt_f + delta), nothing is sent.
+ * Beta adds hysteresis once the scheduler started waiting.
+ *
+ * See "ECF: An MPTCP Path Scheduler to Manage Heterogeneous Paths", Lim et al., CoNEXT 2017.
+ */
+class MpTcpSchedulerEcf : public MpTcpScheduler
+{
+
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSchedulerEcf();
+  virtual ~MpTcpSchedulerEcf ();
+
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments);
+
+  virtual void Reset();
+
+protected:
+  /**
+   * \param state snapshot of the connection
+   * \param fast position of the fastest subflow
+   * \param slow position of the candidate subflow
+   * \return True if the pending data should wait for the fastest subflow
+   */
+  virtual bool ShouldWait(const MpTcpSchedulerState& state, uint32_t fast, uint32_t slow);
+
+  double m_beta;    //!< Hysteresis
+  bool m_waiting;   //!< True while the scheduler waits for the fastest subflow
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_ECF_H */
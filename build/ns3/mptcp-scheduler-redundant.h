@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#ifndef MPTCP_SCHEDULER_REDUNDANT_H
+#define MPTCP_SCHEDULER_REDUNDANT_H
+
+#include "ns3/mptcp-scheduler.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Sends the same data on every subflow
+ *
+ * Each new range is sent on all the subflows with some window left, the peer
+ * keeps the first copy it receives. Latency is the one of the fastest path at the cost of
+ * the capacity of the others.
+ * Backup subflows are used like the others.
+ */
+class MpTcpSchedulerRedundant : public MpTcpScheduler
+{
+
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSchedulerRedundant();
+  virtual ~MpTcpSchedulerRedundant ();
+
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments);
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_REDUNDANT_H */
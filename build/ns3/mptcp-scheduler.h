@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#ifndef MPTCP_SCHEDULER_H
+#define MPTCP_SCHEDULER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/sequence-number.h"
+#include "ns3/mptcp-range-set.h"
+
+namespace ns3
+{
+
+/**
+ * \brief What the scheduler knows about a subflow
+ */
+struct MpTcpSubflowState
+{
+  uint8_t  id;          //!< Index of the subflow, as in MpTcpSocketBase::GetSubflow
+  uint32_t cwnd;        //!< Congestion window (bytes)
+  uint32_t ssThresh;    //!< Slow start threshold (bytes)
+  uint32_t inFlight;    //!< Bytes in flight
+  uint32_t available;   //!< Bytes the subflow can send right away (free window, queued data deduced)
+  uint32_t segmentSize; //!< Segment size
+  Time     srtt;        //!< Smoothed RTT
+  Time     rttVar;      //!< RTT variation
+  bool     backup;      //!< Backup subflows only carry data when no other subflow is established
+};
+
+/**
+ * \brief Read-only snapshot of the connection passed to the scheduler
+ */
+struct MpTcpSchedulerState
+{
+  SequenceNumber64 nextTxSequence; //!< First DSN never sent
+  uint32_t pending;                //!< Bytes of the meta Tx buffer never sent
+  uint32_t window;                 //!< Bytes allowed by the peer receive window
+  uint32_t sendWindow;             //!< Peer receive window
+  uint32_t inFlight;               //!< Bytes sent and not acknowledged at the connection level
+  MpTcpRangeSet sentAhead;         //!< Ranges beyond nextTxSequence already sent
+  std::vector<MpTcpSubflowState> subflows;  //!< Established subflows
+};
+
+/**
+ * \brief A DSN range to send on a subflow
+ */
+struct MpTcpAssignment
+{
+  uint8_t subflowId;    //!< Index of the subflow
+  SequenceNumber64 dsn; //!< First DSN of the range
+  uint16_t length;      //!< Length of the range, it becomes a single DSS mapping
+};
+
+typedef std::vector<MpTcpAssignment> MpTcpAssignmentList;  //!< Decisions of a scheduler
+
+/**
+ * This class is responsible for
+ *
+ * The mptcp linux 0.90 scheduler is composed of mainly 2 functions:
+ * -get_available_subflow
+ * -get_next_segment
+ *
+ * Here we wanted to let a maximum number of possibilities for testing, for instance:
+ * - you can generate DSS for data that is not in the meta Tx buffer yet (in order to minimize the number of DSS sent).
+ * - you can send the
+ *
+ * The scheduler maps a dsn range to a subflow. It does not map the dsn to an ssn: this is done
+ * by the subflow when it actually receives the Tx data.
+ *
+ * The scheduler only sees a snapshot of the connection (MpTcpSchedulerState) and returns
+ * all its decisions at once, so it never touches the meta socket. It has to account for
+ * the window its own assignments consume. Ranges may start before nextTxSequence
+ * (e.g. redundant copies) or after it, e.g. to send on a slow subflow the data
+ * that should arrive after what the fast subflows are about to carry. The meta
+ * remembers such ranges (state.sentAhead) and skips them once it reaches them.
+ *
+ * \warn The decoupling between dsn & ssn mapping may prove hard to debug. There are
+ * some checks but you should be especially careful when writing a new scheduler.
+ */
+class MpTcpScheduler : public Object
+{
+
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual ~MpTcpScheduler() {}
+
+  /**
+   * \brief Decides which DSN ranges go on which subflows
+   * \param state snapshot of the connection
+   * \param assignments ranges to send, in order. Decisions are appended
+   * \see MpTcpSocketBase::SendPendingData
+   */
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments) = 0;
+
+  /**
+   * \brief Forgets the previous connection before serving a new one
+   *
+   * Schedulers are recycled by the node (see TcpL4Protocol::AllocateMpTcpScheduler),
+   * schedulers keeping state between two rounds have to clear it here.
+   */
+  virtual void Reset();
+
+protected:
+  /**
+   * \return True if backup subflows may be used, i.e. when all subflows are backups
+   */
+  static bool UseBackupSubflows(const MpTcpSchedulerState& state);
+
+  /**
+   * \brief Looks for the subflow with the lowest smoothed RTT
+   * \param state snapshot of the connection
+   * \param space bytes each subflow can still take
+   * \param withSpace ignore the subflows that can't take any more data
+   * \return The position of the subflow in state.subflows, -1 if none
+   */
+  static int FindFastestSubflow(const MpTcpSchedulerState& state, const std::vector<uint32_t>& space,
+                                bool withSpace);
+
+  /**
+   * \brief Prepares the bookkeeping of a new round of decisions
+   *
+   * Copies the space of each subflow into m_space and the meta counters.
+   */
+  void StartRound(const MpTcpSchedulerState& state);
+
+  /**
+   * \brief Assigns the next new bytes to a subflow, within its space and the meta window
+   * \param state snapshot of the connection
+   * \param i position of the subflow in state.subflows
+   * \param assignments where to append the decision
+   * \return number of bytes assigned
+   */
+  uint32_t AssignNewData(const MpTcpSchedulerState& state, uint32_t i, MpTcpAssignmentList& assignments);
+
+  /**
+   * \brief Assigns an arbitrary DSN range to a subflow, within its space
+   *
+   * Unlike AssignNewData, neither the next DSN nor the meta window are updated.
+   *
+   * \param state snapshot of the connection
+   * \param i position of the subflow in state.subflows
+   * \param dsn first DSN of the range
+   * \param length length of the range
+   * \param assignments where to append the decision
+   * \return number of bytes assigned
+   */
+  uint32_t AssignRange(const MpTcpSchedulerState& state, uint32_t i, const SequenceNumber64& dsn,
+                       uint32_t length, MpTcpAssignmentList& assignments);
+
+  std::vector<uint32_t> m_space;  //!< Bytes each subflow can still take during this round
+  SequenceNumber64 m_nextDsn;     //!< Next DSN to assign during this round
+  uint32_t m_pending;             //!< Bytes left to assign during this round
+  uint32_t m_window;              //!< Meta window left during this round
+};
+
+}
+
+#endif /* MPTCP_SCHEDULER_H */
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_STATS_H
+#define MPTCP_STATS_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+#include "ns3/traced-callback.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+class MpTcpSubflow;
+
+/**
+ * \brief Connection level statistics of an MPTCP connection
+ *
+ * Owned by the meta socket (see MpTcpSocketBase::GetStats) which notifies it when
+ * data gets scheduled, reinjected or received. Values are exposed as trace sources
+ * and through getters, MpTcpStatsHelper samples them into time series.
+ *
+ * Head-of-line blocking time is the time during which the meta receive buffer
+ * held out-of-order data waiting for a missing DSN.
+ */
+class MpTcpStats : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpStats ();
+  virtual ~MpTcpStats ();
+
+  /**
+   * TracedValue callback signature for 64 bits counters
+   * \param [in] oldValue original value of the traced variable
+   * \param [in] newValue new value of the traced variable
+   */
+  typedef void (* Uint64TracedValueCallback)(uint64_t oldValue, uint64_t newValue);
+
+  /**
+   * TracedCallback signature for data handed to a subflow
+   * \param [in] subflow the subflow
+   * \param [in] dsn head of the range
+   * \param [in] length length of the range
+   */
+  typedef void (* ScheduledTracedCallback)(Ptr<MpTcpSubflow> subflow, SequenceNumber64 dsn, uint32_t length);
+
+  /**
+   * \brief Data was handed to a subflow
+   * \param subflow the subflow
+   * \param dsn head of the range
+   * \param length length of the range
+   * \param reinjection true if the range had already been sent on another subflow
+   */
+  void NotifyScheduled (Ptr<MpTcpSubflow> subflow, SequenceNumber64 dsn, uint32_t length, bool reinjection);
+
+  /**
+   * \brief Data was extracted from a subflow
+   * \param dsn head of the range
+   * \param length length of the range
+   * \param expected next DSN expected in order by the meta
+   * \param duplicate true if the range had been received already
+   */
+  void NotifyReceived (SequenceNumber64 dsn, uint32_t length, SequenceNumber64 expected, bool duplicate);
+
+  /**
+   * \brief The meta receive buffer changed
+   * \param size bytes in the buffer
+   * \param blocked true if the buffer holds data beyond a missing DSN
+   */
+  void NotifyRxBuffer (uint32_t size, bool blocked);
+
+  /**
+   * \return Number of subflows which were scheduled data
+   */
+  uint32_t GetNSubflows (void) const;
+
+  /**
+   * \param i subflow number, in the order subflows got their first data
+   * \return Bytes handed to this subflow, reinjections included
+   */
+  uint64_t GetSubflowScheduledBytes (uint32_t i) const;
+
+  /**
+   * \return Bytes handed to all subflows
+   */
+  uint64_t GetScheduledBytes (void) const;
+
+  /**
+   * \return Number of reinjections
+   */
+  uint32_t GetReinjections (void) const;
+
+  /**
+   * \return Reinjected bytes
+   */
+  uint64_t GetReinjectedBytes (void) const;
+
+  /**
+   * \return Number of ranges received beyond the next expected DSN
+   */
+  uint32_t GetOutOfOrderArrivals (void) const;
+
+  /**
+   * \return Bytes received more than once
+   */
+  uint64_t GetDuplicateBytes (void) const;
+
+  /**
+   * \return Bytes in the meta receive buffer
+   */
+  uint32_t GetRxBufferOccupancy (void) const;
+
+  /**
+   * \return Total head-of-line blocking time, including the ongoing period if any
+   */
+  Time GetHolBlockingTime (void) const;
+
+protected:
+  TracedValue<uint64_t> m_scheduledBytes;     //!< Bytes handed to subflows
+  TracedValue<uint32_t> m_reinjections;       //!< Number of reinjections
+  TracedValue<uint64_t> m_reinjectedBytes;    //!< Reinjected bytes
+  TracedValue<uint32_t> m_outOfOrderArrivals; //!< Ranges received beyond the expected DSN
+  TracedValue<uint64_t> m_duplicateBytes;     //!< Bytes received more than once
+  TracedValue<uint32_t> m_rxBufferOccupancy;  //!< Bytes in the meta receive buffer
+  TracedValue<Time>     m_holBlockingTime;    //!< Completed head-of-line blocking periods
+  TracedCallback<Ptr<MpTcpSubflow>, SequenceNumber64, uint32_t> m_scheduledTrace; //!< Data handed to a subflow
+
+  std::vector<const MpTcpSubflow*> m_subflows;  //!< Subflows in the order they got data, not refcounted
+  std::vector<uint64_t> m_subflowBytes;         //!< Bytes handed to each subflow
+  bool m_blocked;                               //!< True during a head-of-line blocking period
+  Time m_blockedSince;                          //!< Start of the ongoing blocking period
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_STATS_H */
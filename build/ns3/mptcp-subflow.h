@@ -0,0 +1,526 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Kashif Nadeem <kshfnadeem@gmail.com>
+ *          Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_SUBFLOW_H
+#define MPTCP_SUBFLOW_H
+
+#include "ns3/trace-source-accessor.h"
+#include "ns3/sequence-number.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/event-id.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-socket.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-header.h"
+#include "ns3/mptcp-mapping.h"
+
+using namespace std;
+
+namespace ns3 {
+
+class MpTcpSocketBase;
+class TcpOptionMpTcpDSS;
+class TcpOptionMpTcpMain;
+class TcpSocketBase;
+class TcpOptionMpTcpAddAddress;
+class TcpOptionMpTcpChangePriority;
+class TcpOptionMpTcpRemoveAddress;
+class TcpOptionMpTcpFastClose;
+class TcpOptionMpTcpReset;
+
+/**
+ * \class MpTcpSubflow
+ */
+class MpTcpSubflow : public TcpSocketBase
+{
+public:
+
+  static TypeId
+  GetTypeId(void);
+
+  virtual TypeId GetInstanceTypeId(void) const;
+  virtual uint32_t GetTxAvailable (void) const;
+
+  /*
+   * This function to pass peer token to tcpsocketbase
+   */
+  uint32_t PeerToken();
+
+  /**
+   * \bfief the metasocket is the socket the application is talking to.
+   * \brief Every subflow is linked to that socket.
+   * \param The metasocket it is linked to
+   */
+  MpTcpSubflow();
+
+  MpTcpSubflow(const TcpSocketBase& sock);
+  MpTcpSubflow(const MpTcpSubflow&);
+  virtual ~MpTcpSubflow();
+  virtual uint32_t UnAckDataCount (void) const;
+  virtual uint32_t BytesInFlight (void) const;
+  virtual uint32_t AvailableWindow (void) const;
+  virtual uint32_t Window (void) const;          // Return the max possible number of unacked bytes
+
+  /**
+   * \brief will update the meta rwnd. Called by subflows whose
+   * \return true
+   */
+  virtual bool UpdateWindowSize (const TcpHeader& header);
+
+  /**
+   * \return Window of the meta socket, scaled by the factor of this subflow
+   */
+  virtual uint16_t AdvertisedWindowSize (bool scale = true) const;
+
+  /**
+   * \param metaSocket
+   */
+  virtual void
+  SetMeta(Ptr<MpTcpSocketBase> metaSocket);
+
+  /**
+   * \warning for prototyping purposes, we let the user free to advertise an IP that doesn't belong to the node
+   * (in reference to MPTCP connection agility).
+   * \note Maybe we should change this behavior
+   */
+  virtual void
+  AdvertiseAddress(const Address& address, uint16_t port);
+
+  /**
+   * \brief Send a REM_ADDR for the specific address.
+   * \see AdvertiseAddress
+   * \return false if no id associated with the address which likely means it was never advertised in the first place
+   */
+  virtual bool
+  StopAdvertisingAddress(const Address& address);
+
+  /**
+   * \brief This is important. This should first request data from the meta
+   */
+  virtual void
+  NotifySend (uint32_t spaceAvailable);
+
+  /**
+   * \brief for debug
+   */
+  void
+  DumpInfo() const;
+
+  /**
+   * \brief
+   * \note A Master socket is the first to initiate the connection, thus it will use the option MP_CAPABLE
+   *  during the 3WHS while any additionnal subflow must resort to the MP_JOIN option
+   * \return True if this subflow is the first (should be unique) subflow attempting to connect
+   */
+  virtual bool
+  IsMaster() const;
+
+  /**
+   * \return True if this subflow shall be used only when all the regular ones failed
+   */
+  virtual bool BackupSubflow() const;
+
+  /**
+   * \brief Sets the local priority of the subflow, the peer is not told
+   * \see SendMpPriority
+   */
+  void SetBackup(bool backup);
+
+  /**
+   * \brief Asks the peer to (not) use this subflow through an MP_PRIO option
+   * \param backup value of the B flag
+   */
+  void SendMpPriority(bool backup);
+
+  /**
+   * \brief Health of the path of the subflow, driven by the path manager
+   *
+   * - Active: regular scheduling.
+   * - PotentiallyFailed: a first RTO. The data the subflow holds is reinjected
+   *   and new data only goes there if no healthy subflow is left.
+   * - Failed: MpTcpPathManager::TimeoutThreshold RTOs in a row, an ICMP
+   *   destination unreachable or the interface going down. Nothing is
+   *   scheduled on the subflow, its own retransmissions keep probing the path.
+   * - Recovered: a suspected or failed subflow got a new acknowledgment. It is
+   *   used again and becomes Active once the data sent since is acknowledged,
+   *   an RTO in the meantime fails it at once.
+   */
+  enum HealthState
+  {
+    Active,
+    PotentiallyFailed,
+    Failed,
+    Recovered
+  };
+
+  /**
+   * \brief TracedValue callback signature for HealthState
+   * \param [in] oldValue original value of the traced variable
+   * \param [in] newValue new value of the traced variable
+   */
+  typedef void (* HealthTracedValueCallback)(const HealthState oldValue,
+                                             const HealthState newValue);
+
+  HealthState GetHealth() const;
+  void SetHealth(HealthState health);
+
+  /**
+   * \return True if the subflow is Active or Recovered
+   */
+  bool IsHealthy() const;
+
+  /**
+   * \return True if the path manager considers the path of this subflow as broken.
+   * No data is scheduled on such a subflow.
+   */
+  bool IsPathFailed() const;
+  void SetPathFailed(bool failed);
+
+  /**
+   * \brief Paces the subflow at a rate derived from its cwnd and srtt, as
+   * Linux does: twice cwnd/srtt in slow start, 1.2 times afterwards
+   * \param superSegments Send a burst of segments per pacing quantum instead
+   * of pacing every segment
+   */
+  void SetPacing(bool superSegments);
+
+  /**
+   * \return Number of retransmission timeouts since the last new acknowledgment
+   */
+  uint32_t GetConsecutiveTimeouts() const;
+
+  /**
+   * \return Ipv4Address or Ipv6Address of the endpoint, an invalid Address if none
+   */
+  Address GetLocalIp() const;
+  Address GetPeerIp() const;
+  virtual uint32_t SendPendingData (bool withAck = false);
+
+  /**
+   * \brief Disabled for now.
+   * SendMapping should be used instead.
+   */
+  virtual int Send (Ptr<Packet> p, uint32_t flags);  // Call by app to send data to network
+
+  /**
+   * \param dsn will set the dsn of the beginning of the data
+   * \param only_full_mappings Set to true if you want to extract only packets that match a whole mapping
+   * \param dsn returns the head DSN of the returned packet
+   *
+   * \return this can return an EmptyPacket if on close
+   */
+  virtual Ptr<Packet>
+  ExtractAtMostOneMapping(uint32_t maxSize, bool only_full_mappings, SequenceNumber64& dsn);
+
+  /**
+   * \brief used in previous implementation to notify meta of subflow closing.
+   * \brief See it that's worth keeping
+   */
+  virtual void ClosingOnEmpty(TcpHeader& header);
+  virtual void DeallocateEndPoint (void);
+  virtual void NewAck (SequenceNumber32 const& ack, bool resetRTO);
+  virtual void TimeWait (void);
+  virtual void DoRetransmit (void);
+  virtual int Listen (void);
+  virtual void ProcessListen (Ptr<Packet> packet, const TcpHeader& tcpHeader,
+                      const Address& fromAddress, const Address& toAddress);
+  /**
+   * \brief Will send MP_JOIN or MP_CAPABLE depending on if it is master or not
+   * \brief Updates the meta endpoint
+   * \see TcpSocketBase::CompleteFork
+   */
+  virtual void CompleteFork (Ptr<Packet> p, const TcpHeader& tcpHeader,
+                             const Address& fromAddress, const Address& toAddress);
+  virtual void ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
+                       const Address& fromAddress, const Address& toAddress);
+  virtual void ProcessSynSent(Ptr<Packet> packet, const TcpHeader& tcpHeader);
+  virtual void ProcessWait(Ptr<Packet> packet, const TcpHeader& tcpHeader);
+  virtual void Retransmit(void);
+
+  /**
+   * \bfief Parse DSS essentially
+   */
+  virtual int ProcessOptionMpTcpDSSEstablished (const MpTcpDss& dss);
+  /**
+   * \brief Authenticates the peer during the MP_JOIN handshake
+   *
+   * The subflow is reset if the HMAC of the SYN/ACK or of the third ACK
+   * does not match the one computed from both keys and nonces.
+   * \return 1 if the subflow was reset, 0 otherwise
+   */
+  virtual int ProcessOptionMpTcpJoin (const Ptr<const TcpOptionMpTcpMain> option);
+  virtual int ProcessOptionMpTcpCapable (const Ptr<const TcpOptionMpTcpMain> option);
+
+  /*
+   * \brief Process TcpOptionTcpAddAddress 
+   * \briefto add advertised address and create new subflows
+   * \param option MpTcpOptions
+   */
+  virtual int ProcessOptionMpTcpAddAddress (const Ptr<const TcpOptionMpTcpAddAddress> option);
+
+  /**
+   * \brief Updates the priority of this subflow, or of the subflows towards
+   * the address id carried by the option
+   */
+  virtual int ProcessOptionMpTcpPriority (const Ptr<const TcpOptionMpTcpChangePriority> option);
+
+  /**
+   * \brief Forwards the removed address ids to the meta
+   */
+  virtual int ProcessOptionMpTcpRemoveAddress (const Ptr<const TcpOptionMpTcpRemoveAddress> option);
+
+  /**
+   * \brief Closes the whole connection if the key matches ours
+   * \param option MP_FASTCLOSE
+   * \param onRst True if the option came on a RST, i.e., the subflow is already reset
+   * \return 1 if the connection was closed
+   */
+  virtual int ProcessOptionMpTcpFastClose (const Ptr<const TcpOptionMpTcpFastClose> option, bool onRst);
+
+  /**
+   * \brief Logs why the peer reset the subflow (\RFC{8684})
+   */
+  virtual int ProcessOptionMpTcpReset (const Ptr<const TcpOptionMpTcpReset> option);
+
+  /**
+   * \brief Helper functions: Connection set up
+   * \brief Common part of the two Bind(), i.e. set callback and remembering local addr:port
+   * \returns 0 on success, -1 on failure
+   */
+  virtual int SetupCallback (void);
+
+  /**
+   * \brief Called by the L3 protocol when it received a packet to pass on to TCP.
+   *
+   * \param packet the incoming packet
+   * \param header the packet's IPv4 header
+   * \param port the remote port
+   * \param incomingInterface the incoming interface
+   */
+  virtual void ForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port, Ptr<Ipv4Interface> incomingInterface);
+
+  /**
+   * \brief A destination unreachable fails the path at once
+   */
+  virtual void ForwardIcmp (Ipv4Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
+  virtual void ForwardIcmp6 (Ipv6Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
+
+protected:
+  friend class MpTcpSocketBase;
+  /**
+   * \brief This is a public function in TcpSocketBase but it shouldn't be public here !
+   */
+  virtual int Close(void);
+  virtual void CloseAndNotify(void);
+  virtual void GetMappedButMissingData(
+                std::set< MpTcpMapping >& missing
+                );
+
+  /**
+   * \brief Depending on if this subflow is master or not, we want to
+   * \brief trigger
+   * \brief Callbacks being private members
+   * \brief Overrides parent in order to warn meta
+   */
+  virtual void ConnectionSucceeded(void);
+  int DoConnect();
+
+  /**
+   * \brief In fact, instead of relying on IsMaster etc...
+   * \brief this should depend on meta's state , if it is wait or not
+   * \brief and thus it should be pushed in meta (would also remove the need for crypto accessors)
+   * \param header
+   */
+  virtual void AddOptionMpTcp3WHS(TcpHeader& hdr) const;
+
+  /**
+   * \brief Resets a subflow whose MP_JOIN failed authentication
+   */
+  void RejectJoin();
+
+  /**
+   * \brief Closes the subflow without going through the FIN exchange
+   * \param sendRst Send a RST to the peer (along with the pending options)
+   */
+  void Abort(bool sendRst);
+
+  /**
+   * \brief \RFC{8684} lets the first data segment of the connection ride on
+   * the MP_CAPABLE of the third ACK instead of a DSS, its DSN being implicit
+   * \return true if the pending mapping can be sent that way
+   */
+  bool SendsDataInCapable() const;
+
+  /**
+   * \brief Options of RST segments are otherwise never processed
+   */
+  virtual void DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
+                            const Address &toAddress);
+
+  virtual void ProcessClosing(Ptr<Packet> packet, const TcpHeader& tcpHeader);
+  virtual int ProcessOptionMpTcp (const Ptr<const TcpOption> option);
+  virtual int ProcessOptionMpTcpDss (const MpTcpDss& dss);
+  Ptr<MpTcpSocketBase> m_metaSocket;    //!< Meta
+  virtual void SendPacket(TcpHeader header, Ptr<Packet> p);
+
+public:
+  /**
+   * \return pointer to MpTcpSocketBase
+   */
+  virtual Ptr<MpTcpSocketBase> GetMeta() const;
+
+  /**
+   * \brief Not implemented
+   * \return false
+   */
+  virtual bool IsInfiniteMappingEnabled() const;
+
+  virtual void SendEmptyPacket (uint8_t flags); // Send a empty packet that carries a flag, e.g. ACK
+
+  /**
+   * \return RTT (in seconds) cached by the meta for the coupled congestion control
+   */
+  double GetCoupledRtt() const;
+
+  /**
+   * \return cwnd/rtt (in bytes per second) cached by the meta for the coupled congestion control
+   */
+  double GetCoupledRate() const;
+
+protected:
+
+  /////////////////////////////////////////////
+  //// DSS Mapping handling
+  /////////////////////////////////////////////
+
+  /**
+   * \brief Mapping is said "loose" because it is not tied to an SSN yet, this is the job
+   * \brief of this function: it will look for the FirstUnmappedSSN() and map the DSN to it.
+   *
+   * Thus you should call it with increased dsn.
+   * \param dsnHead
+   */
+  bool AddLooseMapping(SequenceNumber64 dsnHead, uint16_t length);
+
+  /**
+   * \brief If no mappings set yet, then it returns the tail ssn of the Tx buffer.
+   * \return Otherwise returns the last registered mapping TailSequence
+   */
+  SequenceNumber32 FirstUnmappedSSN();
+
+  /**
+   * \brief Looks for a mapping covering dsn that the peer did not acknowledge yet
+   * at the subflow level
+   * \param dsn
+   * \param mapping Set to the mapping found
+   * \return true if the subflow is still responsible for the delivery of dsn
+   */
+  bool GetUnackedMappingForDSN(SequenceNumber64 dsn, MpTcpMapping& mapping) const;
+
+  /**
+   * \brief Creates a DSS option if does not exist and configures it to have a dataack
+   */
+  virtual void AppendDSSAck();
+
+  /**
+   * \brief Corresponds to mptcp_write_dss_mapping and mptcp_write_dss_ack
+   */
+  virtual void AddMpTcpOptionDSS(TcpHeader& header);
+
+  virtual void AppendDSSFin();
+  virtual void AppendDSSMapping(const MpTcpMapping& mapping);
+  virtual void ReceivedAck(Ptr<Packet>, const TcpHeader&); // Received an ACK packet
+  virtual void ReceivedData (Ptr<Packet> packet, const TcpHeader& tcpHeader);
+  virtual uint32_t SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool withAck);
+  /**
+   * \brief The window advertised is the one of the meta, hence the scale
+   * factor derives from the meta Rx buffer.
+   */
+  virtual uint8_t CalculateWScale () const;
+  /**
+   * \brief The Tx buffer only holds placeholders of the size of the mapped data,
+   * the bytes are read from the meta send buffer through the mapping of seq.
+   */
+  virtual Ptr<Packet> GetPayload (Ptr<Packet> p, SequenceNumber32 seq);
+  virtual void ReTxTimeout();
+  /**
+   * \brief Overrides the TcpSocketBase that just handles the MP_CAPABLE option.
+   * \param header
+   */
+  virtual void AddMpTcpOptions (TcpHeader& header);
+
+  /**
+   * \brief should be able to use parent's one little by little
+   */
+  virtual void CancelAllTimers(void); // Cancel all timer when endpoint is deleted
+
+  /**
+   * \brief With super segments, about 1 ms of data at the pacing rate, at
+   * least 2 segments and at most 64 KB (tcp_tso_autosize in Linux)
+   * \return The size of the bursts, 0 if every segment is paced
+   */
+  virtual uint32_t GetPacingQuantum(void) const;
+
+  /**
+   * \brief Recomputes the pacing rate from cwnd and srtt
+   */
+  void UpdatePacingRate(void);
+
+  // Use Ptr here so that we don't have to unallocate memory manually
+  // MappingList
+  MpTcpMappingContainer m_TxMappings;  //!< List of mappings to send
+  MpTcpMappingContainer m_RxMappings;  //!< List of mappings to receive
+
+private:
+  // Delayed values to
+  uint8_t m_dssFlags;           //!< used to know if AddMpTcpOptions should send a flag
+  bool m_masterSocket;  //!< True if this is the first subflow established (with MP_CAPABLE)
+  MpTcpMapping m_dssMapping;    //!< Pending ds configuration to be sent in next packet
+  bool m_backupSubflow; //!< Priority
+  TracedValue<HealthState> m_health;  //!< Set by the path manager
+  SequenceNumber32 m_healthMark;      //!< Recovered until this sequence gets acknowledged
+  std::vector<Ptr<TcpOption> > m_pendingOptions;  //!< ADD_ADDR, REMOVE_ADDR, MP_PRIO waiting for room in a header
+  uint32_t m_localNonce;  //!< Random number sent in our MP_JOIN
+  uint32_t m_peerNonce;   //!< Random number received in the MP_JOIN of the peer
+  bool m_joinHmacPending; //!< The third ACK of MP_JOIN must carry our HMAC
+  int m_prefixCounter;  //!< Temporary variable to help with prefix generation . To remove later
+
+  // Values last accounted in the meta coupled congestion control aggregates
+  bool     m_ccRegistered;  //!< True if accounted in the meta aggregates
+  uint32_t m_ccCwnd;        //!< cwnd
+  double   m_ccRtt;         //!< srtt in seconds
+  double   m_ccRate;        //!< cwnd/rtt
+  double   m_ccCwndRtt2;    //!< cwnd/rtt^2
+  uint64_t m_ccLossInterval;  //!< bytes acked between losses
+  double   m_ccQuality;     //!< m_ccLossInterval^2/rtt
+
+  Time     m_lastPenalization;  //!< Last time the meta halved the window because of head of line blocking
+
+  bool     m_ratePacing;    //!< Pacing rate follows cwnd/srtt
+  bool     m_superSegments; //!< Send bursts of GetPacingQuantum bytes between pacing gaps
+
+};
+
+}
+#endif /* MP_TCP_SUBFLOW */
@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include <ns3/simulator-impl.h>
+#include <ns3/scheduler.h>
+#include <ns3/event-impl.h>
+#include <ns3/system-thread.h>
+#include <ns3/system-mutex.h>
+#include <ns3/ptr.h>
+
+#include "spsc-queue.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Parallel simulator implementation running the nodes in several
+ * threads of a single process.
+ *
+ * At the first Run(), the nodes are split into partitions:
+ *  - when some node has a non-zero system id, as for a distributed
+ *    simulation, a partition gathers the nodes of a system id;
+ *  - otherwise the nodes joined by channels which cannot be split are
+ *    grouped, and the groups are spread over MaxThreads partitions,
+ *    largest first.
+ *
+ * Only a PointToPointChannel with a positive delay is split between two
+ * partitions: the channels whose state is shared by their devices, like
+ * CsmaChannel, keep all their nodes in one partition. The smallest delay
+ * of the split channels is the lookahead.
+ *
+ * Each partition has its own scheduler and clock. The synchronization is
+ * conservative: the threads process the events of their partitions up to
+ * the end of a window, which is the earliest event of all partitions plus
+ * the lookahead, then wait for each other at a barrier. The events sent to
+ * a node of another partition go through a lock-free SpscQueue per pair of
+ * partitions, and are inserted in the schedulers of their receivers after
+ * a second barrier, in a fixed order so that a run does not depend on the
+ * interleaving of the threads.
+ *
+ * The events without a node context, like those scheduled by the main
+ * program, form a global partition run by the main thread alone, between
+ * windows.
+ *
+ * The models must not share mutable state between nodes of different
+ * partitions, and the packets sent to another partition must be copied
+ * with Packet::DeepCopy, as PointToPointChannel does when
+ * Simulator::IsRemoteContext() is \c true.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual EventId Reschedule (const EventId &id, const Time &delay);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+  virtual bool IsRemoteContext (uint32_t context) const;
+
+  /**
+   * \returns The number of partitions of the nodes, 0 before the first Run().
+   */
+  uint32_t GetNPartitions (void) const;
+  /**
+   * \returns The lookahead between the partitions, computed at the first Run().
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent to another partition. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /** Queue type of the events between two partitions. */
+  typedef SpscQueue<EventWithContext> EventQueue;
+
+  /** The events and the clock of a group of nodes. */
+  struct Partition
+  {
+    /** Index of the partition, the global partition comes last. */
+    uint32_t id;
+    /** The event priority queue. */
+    Ptr<Scheduler> events;
+    /** Next event unique id. */
+    uint32_t uid;
+    /** Unique id of the current event. */
+    uint32_t currentUid;
+    /** Timestamp of the current event. */
+    uint64_t currentTs;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /** The event count. */
+    uint64_t eventCount;
+    /** Number of events inserted but not yet scheduled. */
+    int unscheduledEvents;
+    /** Next uid of the packets created by the nodes, the id in the high bits. */
+    uint64_t packetUid;
+    /** Next stream of the random variables created by the nodes, the id in the high bits. */
+    uint64_t streamIndex;
+    /** The queues to the other partitions, indexed by their id. */
+    std::vector<EventQueue *> outgoing;
+    /** The simulator. */
+    MultithreadedSimulatorImpl *impl;
+  };
+
+  /** The work handed to the threads. */
+  enum Phase
+  {
+    PROCESS,  //!< Process the events of the window.
+    RECEIVE,  //!< Insert the events sent by the other partitions.
+    EXIT      //!< Terminate the thread.
+  };
+
+  /** Split the nodes into partitions and move their events. */
+  void BuildPartitions (void);
+  /**
+   * \param [in] context An event context.
+   * \returns The partition running the events of that context.
+   */
+  Partition *GetPartition (uint32_t context) const;
+  /** \returns The partition of the calling event, the global one outside of events. */
+  Partition *GetCurrentPartition (void) const;
+  /**
+   * Insert an event in the scheduler of a partition.
+   *
+   * \param [in] partition The partition.
+   * \param [in] context The event context.
+   * \param [in] ts The event timestamp.
+   * \param [in] event The event implementation.
+   * \returns The unique id of the event.
+   */
+  uint32_t Insert (Partition *partition, uint32_t context, uint64_t ts, EventImpl *event);
+  /**
+   * \param [in] partition A partition.
+   * \returns The timestamp of its next event, or ~0 if it has none.
+   */
+  uint64_t GetNextTs (const Partition *partition) const;
+  /**
+   * Process the next event of a partition.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessOneEvent (Partition *partition);
+  /**
+   * Process the events of a partition before the end of the window.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessWindow (Partition *partition);
+  /**
+   * Process the global events at a given time.
+   *
+   * \param [in] ts The time.
+   */
+  void ProcessGlobalEvents (uint64_t ts);
+  /**
+   * Insert the events sent to a partition by the other partitions.
+   *
+   * \param [in] partition The receiving partition.
+   */
+  void ReceiveEvents (Partition *partition);
+  /** Insert the events scheduled by threads outside of the simulation. */
+  void ProcessEventsFromThreads (void);
+  /**
+   * Have every thread run a phase on its partitions, and wait for them.
+   *
+   * \param [in] phase The phase.
+   */
+  void RunPhase (Phase phase);
+  /**
+   * Run a phase on the partitions of a thread.
+   *
+   * \param [in] thread The index of the thread, 0 for the main thread.
+   */
+  void DoPhase (uint32_t thread);
+  /** Body of the worker threads. */
+  void RunWorker (void);
+
+  /** The partition of the event run by the current thread, if any. */
+  static thread_local Partition *g_currentPartition;
+
+  /** The partitions of the nodes. */
+  std::vector<Partition *> m_partitions;
+  /** The partition of the events without a node context. */
+  Partition m_global;
+  /** Index of the partition of each node. */
+  std::vector<uint32_t> m_nodePartition;
+  /** Maximum number of threads, 0 for the number of hardware threads. */
+  uint32_t m_maxThreads;
+  /** Number of threads running the partitions, the main one included. */
+  uint32_t m_nThreads;
+  /** Smallest delay of the channels between partitions. */
+  uint64_t m_lookAhead;
+  /** End of the current window, excluded. */
+  uint64_t m_windowEnd;
+  /** The scheduler type of the partitions. */
+  ObjectFactory m_schedulerFactory;
+
+  /** The worker threads. */
+  std::vector<Ptr<SystemThread> > m_threads;
+  /** The phase the threads run. */
+  Phase m_phase;
+  /** Incremented to start a phase. */
+  std::atomic<uint32_t> m_generation;
+  /** Number of worker threads still running the phase. */
+  std::atomic<uint32_t> m_pending;
+  /** Index of the next worker thread to start. */
+  std::atomic<uint32_t> m_nextWorker;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** Flag set while Run() is executing. */
+  std::atomic<bool> m_running;
+
+  /** Events scheduled by threads outside of the simulation, relative timestamps. */
+  std::vector<EventWithContext> m_eventsFromThreads;
+  /** Mutex to control access to m_eventsFromThreads. */
+  SystemMutex m_eventsFromThreadsMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the destroy events, scheduled by any partition. */
+  mutable SystemMutex m_destroyEventsMutex;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,1141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Matthieu Coudron
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Kashif Nadeem <kshfnadeem@gmail.com>
+ *          Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+
+#ifndef TCP_OPTION_MPTCP_H
+#define TCP_OPTION_MPTCP_H
+
+#include "tcp-option.h"
+#include "tcp-header.h"
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/mptcp-crypto.h"
+#include "ns3/sequence-number.h"
+#include <vector>
+
+/**
+ * \ingroup mptcp
+ *
+ * Here are a few notations/acronyms used in the multipath tcp group
+ * - 3WHS = three way handshake (SYN/SYN+ACK/ACK)
+ * - DSN = Data Sequence Number
+ * - DSS = Data Sequence Signaling
+ */
+
+namespace ns3 {
+
+/**
+ * \brief Defines the TCP option of kind 30 (Multipath TCP) as in \RFC{6824}
+ *
+ * MPTCP signaling messages are all encoded under the same TCP option number 30.
+ * MPTCP then uses a subtype
+ *
+ * Both version 0 (\RFC{6824}) and version 1 (\RFC{8684}) encodings are
+ * supported: the version negotiated in MP_CAPABLE decides which one is sent,
+ * the parsers accept both.
+ */
+class TcpOptionMpTcpMain : public TcpOption
+{
+public:
+  /**
+   * List the different subtypes of MPTCP options
+   */
+  enum SubType
+  {
+    MP_CAPABLE,
+    MP_JOIN,
+    MP_DSS,
+    MP_ADD_ADDR,
+    MP_REMOVE_ADDR,
+    MP_PRIO,
+    MP_FAIL,
+    MP_FASTCLOSE,
+    MP_TCPRST       //!< \RFC{8684} only
+  };
+
+  TcpOptionMpTcpMain (void);
+  virtual ~TcpOptionMpTcpMain (void);
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * \brief Converts a list of mptcp subtypes
+   * \return Human readable string of subtypes
+   */
+  static std::string
+  SubTypeToString (const uint16_t& flags, const std::string& delimiter);
+
+  /**
+   * \brief Calls CreateObject with the template parameter with the class matching the given subtype
+   * \param Subtype of the MPTCP option to create
+   * \return An allocated but unconfigured option
+   */
+  static Ptr<TcpOption>
+  CreateMpTcpOption (const uint8_t& kind);
+
+  virtual uint32_t
+  GetSerializedSize (void) const = 0;
+
+  /** Get the subtype number assigned to this MPTCP option */
+  virtual uint8_t
+  GetKind (void) const;
+
+  virtual void
+  Serialize (Buffer::Iterator start) const = 0;
+
+  /**
+   * \return the MPTCP subtype of this class
+   */
+  virtual TcpOptionMpTcpMain::SubType
+  GetSubType (void) const = 0;
+
+protected:
+  /**
+   * \brief Serialize TCP option type & length of the option
+   *
+   * Let children write the subtype since Buffer iterators
+   * can't write less than 1 byte
+   * Should be called at the start of every subclass Serialize call
+   */
+  virtual void
+  SerializeRef (Buffer::Iterator& i) const;
+
+  /**
+   * \brief Factorizes ation reading/subtype check that each subclass should do.
+   * Should be called at the start of every subclass Deserialize
+   * \return length of the option
+   */
+  uint32_t
+  DeserializeRef (Buffer::Iterator& i) const;
+};
+
+  /**
+   * \tparam SUBTYPE should be an integer
+   */
+template<TcpOptionMpTcpMain::SubType SUBTYPE>
+class TcpOptionMpTcp : public TcpOptionMpTcpMain
+{
+public:
+  TcpOptionMpTcp () : TcpOptionMpTcpMain ()
+  {
+  }
+
+  virtual ~TcpOptionMpTcp (void)
+  {
+  }
+
+  /**
+   * \return MPTCP option type
+   */
+  virtual TcpOptionMpTcpMain::SubType
+  GetSubType (void) const
+  {
+    return SUBTYPE;
+  }
+};
+
+/**
+ * \brief The MP_CAPABLE option is carried on the SYN, SYN/ACK, and ACK packets of the first TCP connection
+ *  established by a MPTCP connection.
+ *
+ * This first subflow is sometimes called the *master* subflow. It embeds a key that will be used by later TCP connections (subflows)
+ * to authenticate themselves as they want to join the MPTCP connection.
+ *
+ * Here is how the initial 3WHS must look like:
+ *
+ * \verbatim
+Host A                                  Host B
+------                                  ------
+MP_CAPABLE            ->
+[A's key, flags]
+                    <-                MP_CAPABLE
+                                      [B's key, flags]
+ACK + MP_CAPABLE      ->
+[A's key, B's key, flags]
+
+\endverbatim
+
+Here is the format as defined in \RFC{6824}, flags C to H refer to the crypto algorithm.
+Only sha1 is defined and supported in the standard (same for ns3).
+
+\RFC{8684} (version 1) drops the key from the SYN (length 4), the H bit selects
+HMAC-SHA256 and the third ACK may carry the first data segment, in which case
+the option ends with the Data-Level Length of the payload (length 22):
+\verbatim
+Host A (client)                         Host B (server)
+MP_CAPABLE            ->
+[flags]
+                    <-                MP_CAPABLE
+                                      [B's key, flags]
+ACK + MP_CAPABLE (+ data) ->
+[A's key, B's key, flags, (data-level length)]
+\endverbatim
+
+\verbatim
+
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-------+---------------+
+|     Kind      |    Length     |Subtype|Version|A|B|C|D|E|F|G|H|
++---------------+---------------+-------+-------+---------------+
+|                   Option Sender's Key (64 bits)               |
+|                                                               |
+|                                                               |
++---------------------------------------------------------------+
+|                  Option Receiver's Key (64 bits)              |
+|                     (if option Length == 20)                  |
+|                                                               |
++-------------------------------+-------------------------------+
+|  Data-Level Length (16 bits)  |  Checksum (16 bits, optional) |
++-------------------------------+-------------------------------+
+\endverbatim
+ */
+class TcpOptionMpTcpCapable : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_CAPABLE>
+{
+public:
+  TcpOptionMpTcpCapable (void);
+  virtual ~TcpOptionMpTcpCapable (void);
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * Flags of the MP_CAPABLE option
+   */
+  enum Flags
+  {
+    HmacAlgorithm     = 0x01, /**< H bit: HMAC-SHA1 in version 0, HMAC-SHA256 in version 1 */
+    NoJoinToSource    = 0x20, /**< C bit (\RFC{8684}): do not open subflows towards the source address */
+    Extensibility     = 0x40, /**< B bit */
+    ChecksumRequired  = 0x80  /**< A bit */
+  };
+
+  bool operator== (const TcpOptionMpTcpCapable&) const;
+
+  /**
+   * \return MPTCP version proposed (SYN) or selected (SYN/ACK, ACK)
+   */
+  virtual uint8_t GetVersion (void) const;
+
+  /**
+   * \param version 0 for \RFC{6824}, 1 for \RFC{8684}
+   */
+  virtual void SetVersion (uint8_t version);
+
+  /**
+   * \return Flags A to H
+   */
+  virtual uint8_t GetFlags (void) const;
+
+  /**
+   * \param flags Flags A to H
+   */
+  virtual void SetFlags (uint8_t flags);
+
+  /**
+   * \note MPTCP Checksums are not used in ns3
+   * \return True if checksum is required
+   */
+  virtual bool IsChecksumRequired (void) const;
+
+  /**
+   * Set sender key. Useful for each step of the 3WHS
+   *
+   * \param senderKey sender key
+   */
+  virtual void SetSenderKey (const uint64_t& senderKey);
+
+  /**
+   * Set remote key. Useful only for the last ACK of the 3WHS.
+   *
+   * \param remoteKey remote key that was received in the SYN/ACK
+   */
+  virtual void SetPeerKey (const uint64_t& remoteKey);
+
+  /**
+   * \brief Can tell if the option contain the peer key based on the option length
+   * \return True if peer key available
+   */
+  virtual bool HasReceiverKey (void) const;
+
+  /**
+   * \brief A version 1 SYN carries no key
+   * \return True if sender key available
+   */
+  virtual bool HasSenderKey (void) const;
+
+  /**
+   * \brief Version 1 only: the option covers the payload of the segment
+   *
+   * The payload is mapped to the first byte of the data stream, hence no DSS is needed.
+   * \param length Data-Level Length, i.e., number of bytes of the payload
+   */
+  virtual void SetDataLength (uint16_t length);
+
+  /**
+   * \return True if the option maps the payload of the segment
+   */
+  virtual bool HasDataLength (void) const;
+
+  /**
+   * \return Data-Level Length
+   */
+  virtual uint16_t GetDataLength (void) const;
+
+  /**
+   * \return Sender's key
+   */
+  virtual uint64_t GetSenderKey (void) const;
+
+  /**
+   * \warn
+   * \return Sender's key
+   */
+  virtual uint64_t GetPeerKey (void) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+protected:
+  uint8_t m_version;    /**< MPTCP version (4 bytes) */
+  uint8_t m_flags;      /**< 8 bits bitfield (unused in the standard for now) */
+  uint64_t m_senderKey; /**< Sender key */
+  uint64_t m_remoteKey; /**< Peer key */
+  uint16_t m_dataLength; /**< Data-Level Length (version 1) */
+  uint32_t m_length;    /**< Stores the length of the option */
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpCapable (const TcpOptionMpTcpCapable&);
+  TcpOptionMpTcpCapable& operator= (const TcpOptionMpTcpCapable&);
+};
+
+/**
+ * \brief The MP_JOIN option is used to add new subflows to an existing MPTCP connection
+ *
+ * Once cryptographic keys have been exchanged and the first MPTCP Data Ack (in a DSS option) was received from the server (i.e. 2 RTTs),
+ * an MPTCP socket can decide to open/close subflows.
+ * The opening of new subflows is similar to the MP_CAPABLE 3WHS but it uses MP_JOIN option instead.
+ * The MP_JOIN embeds cryptographic data generated from a nonce and the keys sent through the initial MP_CAPABLE in
+ * order to be recognized by the remote host as valid connections (to prevent connection hijacking).
+ *
+ * An MP_JOIN is exchanged during the 3 modes of the 3WHS: Syn/SynAck/Ack and depending on the mode,
+ * the structure of the option is very different as can be seen in the following:
+ *
+ * MP_JOIN Option for Initial SYN:
+ * \verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----+-+---------------+
+|     Kind      |  Length = 12  |Subtype|     |B|   Address ID  |
++---------------+---------------+-------+-----+-+---------------+
+|                   Receiver's Token (32 bits)                  |
++---------------------------------------------------------------+
+|                Sender's Random Number (32 bits)               |
++---------------------------------------------------------------+
+\endverbatim
+
+MP_JOIN for responding SYN/ACK
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----+-+---------------+
+|     Kind      |  Length = 16  |Subtype|     |B|   Address ID  |
++---------------+---------------+-------+-----+-+---------------+
+|                                                               |
+|                Sender's Truncated HMAC (64 bits)              |
+|                                                               |
++---------------------------------------------------------------+
+|                Sender's Random Number (32 bits)               |
++---------------------------------------------------------------+
+
+\endverbatim
+MP_JOIN Option for third ACK:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----------------------+
+|     Kind      |  Length = 24  |Subtype|      (reserved)       |
++---------------+---------------+-------+-----------------------+
+|                                                               |
+|                                                               |
+|                   Sender's HMAC (160 bits)                    |
+|                                                               |
+|                                                               |
++---------------------------------------------------------------+
+\endverbatim
+
+To sum up a subflow 3WHS :
+\verbatim
+Host A                          Host B
+ |   SYN + MP_JOIN(Token-B, R-A)  |
+ |------------------------------->|
+ |<-------------------------------|
+ | SYN/ACK + MP_JOIN(HMAC-B, R-B) |
+ |                                |
+ |     ACK + MP_JOIN(HMAC-A)      |
+ |------------------------------->|
+ |<-------------------------------|
+ |             ACK                |
+
+HMAC-A = HMAC(Key=(Key-A+Key-B), Msg=(R-A+R-B))
+HMAC-B = HMAC(Key=(Key-B+Key-A), Msg=(R-B+R-A))
+\endverbatim
+or
+\verbatim
+  Host A                                  Host B
+  ------                                  ------
+  MP_JOIN               ->
+  [B's token, A's nonce,
+   A's Address ID, flags]
+                        <-                MP_JOIN
+                                          [B's HMAC, B's nonce,
+                                           B's Address ID, flags]
+  ACK + MP_JOIN         ->
+  [A's HMAC]
+
+                        <-                ACK
+\endverbatim
+**/
+class TcpOptionMpTcpJoin : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_JOIN>
+{
+
+public:
+  /**
+   * \enum State
+   * \brief The MPTCP standard assigns only one MP_JOIN subtype but depending on its rank
+   * during the 3 WHS, it can have very different meanings. In order to prevent misuse by the user,
+   * this option is very defensive and won't accept setter or getter calls for a rank that is
+   * not its current rank
+   * The enum values match the size (in bytes) of the option.
+   */
+  enum Mode
+  {
+    Uninitialized = 0,
+    Syn    = 12,  /**< peer token + nonce */
+    SynAck = 16,  /**< peer truncated hmac + nonce */
+    Ack    = 24   /**< Send sender full hmac */
+  };
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpJoin (void);
+  virtual ~TcpOptionMpTcpJoin (void);
+
+  virtual bool operator== (const TcpOptionMpTcpJoin&) const;
+
+  /**
+   * \return Mode (internal value) in which the option is configured
+   */
+  virtual Mode
+  GetMode (void) const;
+
+  /**
+   * \brief Available in Syn and SynAck modes
+   * \return nonce
+   */
+  virtual uint32_t
+  GetNonce (void) const;
+
+  /**
+   * \param nonce Random number used to prevent malicious subflow establishement from
+   * malicious nodes
+   */
+  virtual void
+  SetNonce (const uint32_t& nonce);
+
+  /**
+   * \note Available in SynAck mode only
+   */
+  virtual void SetTruncatedHmac (const uint64_t& );
+
+  /**
+   * \note Available in SynAck mode
+   */
+  virtual uint64_t GetTruncatedHmac (void) const;
+
+  /**
+   * \brief Returns hmac generated by the peer.
+   * \warning Available in Ack mode only
+   * \return the 160 bits HMAC carried by the third ACK
+   */
+  virtual const uint8_t* GetHmac (void) const;
+
+  /**
+   * \brief Available only in Ack mode. Sets Hmac computed from the nonce, tokens previously exchanged
+   * \warning Available in Ack mode only
+   * \param hmac
+   */
+  virtual void SetHmac (uint8_t hmac[20]);
+
+  /**
+   * \brief Set token computed from peer's key
+   * Used in the SYN message of the MP_JOIN 3WHS
+   */
+  virtual void
+  SetPeerToken (const uint32_t& token);
+
+  /**
+   * \return Peer token (the token being a hash of the key)
+   */
+  virtual uint32_t
+  GetPeerToken (void) const;
+
+  /**
+   * \brief Unique id assigned by the remote host to this subflow combination (ip,port).
+   * \return Identifier of the subflow
+   */
+  virtual uint8_t
+  GetAddressId (void) const;
+
+  /**
+   * \brief When a subflow joins a connection, it should advertise a unique identifier
+   * \param addrId unique identifier associated with this very subflow
+   */
+  virtual void
+  SetAddressId (const uint8_t& addrId);
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief When creating from scratch a, MP_CAPABLE option, to call first. Once a mode has been set,
+   * it is not possible to change. Depending on the chosen mode, some functions will trigger a fatal error
+   * to prevent ns3 from doing meaningless actions.
+   * \param mode Mode in which we want to configure the option: Syn or SynAck or Ack
+   */
+  virtual void SetMode (Mode s);
+
+protected:
+  Mode m_mode;          /**<  3 typs of MP_JOIN. Members will throw an exception if used in wrong mode. */
+  uint8_t m_addressId;  /**< Unique identifier assigend to this subflow */
+  uint8_t m_flags;      /**< Unused so far. */
+  uint32_t m_buffer[5]; /**< Memory buffer to register the data of the different modes */
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpJoin (const TcpOptionMpTcpJoin&);
+  TcpOptionMpTcpJoin& operator= (const TcpOptionMpTcpJoin&);
+};
+
+/**
+ * \brief DSS option (Data Sequence Signaling)
+ *
+ * This option can transport 3 different optional semantic information.
+ * First it is important to understand that MPTCP uses an additional sequence number space
+ * on top of TCP sequence numbers in order to reorder the bytes at the receiver.
+ * The DSS option is in charge of carrying MPTCP sequence number related information between
+ * the hosts.
+ * MPTCP sequence numbers are mapped to TCP sequence numbers through this option and
+ * are acked through this option as well. It it also this option that signals the end of
+ * the MPTCP connection (similar to the TCP FIN flag).
+ *
+ * \warn Note that members asserts that flag is enabled before returning any value.
+ *
+ * \note MPTCP sequence numbers are 8 bytes long but when conveyed through a TCP option,
+ *       they can be trimmed to 4 bytes in order to save TCP option space.
+ *
+ * \warn ns3 should allow to carry both 4 and 8 bytes but the initial implementation relied on 4 bytes
+ *       so you may find bugs
+ *
+ * \warn checksum are not supported since they make little sense in ns3 case
+ *
+ * Data Sequence Signal (DSS) Option
+\verbatim
+                      1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+ +---------------+---------------+-------+----------------------+
+ |     Kind      |    Length     |Subtype| (reserved) |F|m|M|a|A|
+ +---------------+---------------+-------+----------------------+
+ |           Data ACK (4 or 8 octets, depending on flags)       |
+ +--------------------------------------------------------------+
+ |   Data sequence number (4 or 8 octets, depending on flags)   |
+ +--------------------------------------------------------------+
+ |              Subflow Sequence Number (4 octets)              |
+ +-------------------------------+------------------------------+
+ |  Data-Level Length (2 octets) |      Checksum (2 octets)     |
+ +-------------------------------+------------------------------+
+
+\endverbatim
+*/
+class TcpOptionMpTcpDSS : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_DSS>,
+                          public MpTcpDss
+{
+
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpDSS (void);
+  /**
+   * \brief Wraps the content of an inline DSS
+   * \param dss content of the option
+   */
+  TcpOptionMpTcpDSS (const MpTcpDss& dss);
+  virtual ~TcpOptionMpTcpDSS (void);
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator ) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpDSS (const TcpOptionMpTcpDSS&);
+  TcpOptionMpTcpDSS& operator= (const TcpOptionMpTcpDSS&);
+};
+
+/**
+ * \brief Used to advertise new subflow possibilities
+ *
+ * This option signals to the peer an IP or a couple (IP, port) to which the peer could
+ * open a new subflow.
+ * Every combination (IP, port) must have a unique ID ("Address ID"), whose allocation is not specified
+ * in the standard.
+ *
+ * \see TcpOptionMpTcpRemoveAddress
+ *
+ * \note Only supports IPv4 version for now
+ *
+ * \note Though the port is optional in the RFC, ns3 implementation always include it, even if
+ * it's 0 for the sake of simplicity.
+ *
+ * In version 1 (\RFC{8684}) the IP version is deduced from the length and the
+ * nibble carries the E flag instead. The option is authenticated by the rightmost
+ * 64 bits of HMAC(Key=(Key-A+Key-B), Msg=(Address ID+Address+Port)) where A is
+ * the sender. The receiver echoes the option (E set, without HMAC) to acknowledge it.
+ *
+ * Add Address (ADD_ADDR) option:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-------+---------------+
+|     Kind      |     Length    |Subtype| IPVer |  Address ID   |
++---------------+---------------+-------+-------+---------------+
+|          Address (IPv4 - 4 octets / IPv6 - 16 octets)         |
++-------------------------------+-------------------------------+
+|   Port (2 octets, optional)   |
++-------------------------------+
+\endverbatim
+
+Version 1:
+\verbatim
++---------------+---------------+-------+-------+---------------+
+|     Kind      |     Length    |Subtype|(rsv)|E|  Address ID   |
++---------------+---------------+-------+-------+---------------+
+|          Address (IPv4 - 4 octets / IPv6 - 16 octets)         |
++-------------------------------+-------------------------------+
+|   Port (2 octets, optional)   |                               |
++-------------------------------+                               |
+|                Truncated HMAC (8 octets, if E=0)              |
+|                               +-------------------------------+
+|                               |
++-------------------------------+
+\endverbatim
+ */
+class TcpOptionMpTcpAddAddress : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_ADD_ADDR>
+{
+
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpAddAddress (void);
+  virtual ~TcpOptionMpTcpAddAddress (void);
+
+  /**
+   * \brief we always send the port, even if it's 0 ?
+   * \brief Expects InetXSocketAddress
+   * "port is specified, MPTCP SHOULD attempt to connect to the specified
+   * address on the same port as is already in use by the subflow on which
+   * the MP_ADD_ADDR signal was sent"
+   */
+  virtual void SetAddress (const Address& address, uint8_t addrId);
+
+  virtual bool operator== (const TcpOptionMpTcpAddAddress&) const;
+
+  /**
+   * \return IP version (i.e., 4 or 6)
+   */
+  virtual uint8_t GetAddressVersion (void) const;
+
+  /**
+   * \brief Return advertised InetSocketAddress.
+   * If port unset, ns3 sets it to 0
+   * \return
+   */
+  virtual InetSocketAddress GetAddress (void) const;
+
+  /**
+   * \see GetAddress
+   */
+  virtual Inet6SocketAddress GetAddress6 (void) const;
+
+  /**
+   * \return Address id assigned to the combination
+   */
+  virtual uint8_t GetAddressId (void) const;
+
+  /**
+   * \return 0 for the \RFC{6824} encoding, 1 for the \RFC{8684} one
+   */
+  virtual uint8_t GetVersion (void) const;
+
+  /**
+   * \brief Version 1: the option acknowledges an ADD_ADDR of the peer
+   * \param echo True to send an echo, that carries no HMAC
+   */
+  virtual void SetEcho (bool echo);
+
+  /**
+   * \return True if the option is an echo
+   */
+  virtual bool IsEcho (void) const;
+
+  /**
+   * \brief Switches the option to the version 1 encoding
+   * \param hmac rightmost 64 bits of the HMAC
+   */
+  virtual void SetTruncatedHmac (uint64_t hmac);
+
+  /**
+   * \return The truncated HMAC carried by a version 1 option
+   */
+  virtual uint64_t GetTruncatedHmac (void) const;
+
+  /**
+   * \brief Computes the HMAC authenticating the advertised address
+   * \param alg The hmac algorithm
+   * \param senderKey Key of the host advertising the address
+   * \param receiverKey Key of the remote host
+   * \return rightmost 64 bits of the HMAC
+   */
+  uint64_t ComputeTruncatedHmac (mptcp_crypto_alg_t alg, uint64_t senderKey, uint64_t receiverKey) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+protected:
+  uint8_t m_addressVersion; /**< IPversion (4 or 6) */
+  uint8_t m_addrId;
+  uint8_t m_version;  //!< MPTCP version of the encoding
+  bool m_echo;        //!< E flag (version 1)
+  uint64_t m_hmac;    //!< Truncated HMAC (version 1)
+  uint16_t m_port; /**< Optional value */ // changed from uint8_t to uint16_t
+  Ipv4Address m_address;  /**< Advertised IPv4 address */
+  Ipv6Address m_address6; //!< Advertised IPv6 address
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpAddAddress (const TcpOptionMpTcpAddAddress&);
+  TcpOptionMpTcpAddAddress& operator= (const TcpOptionMpTcpAddAddress&);
+};
+
+/**
+ * \see TcpOptionMpTcpAddAddress
+ *
+ * \brief Allow to remove joinable addresses
+ *
+ * In case ADD_ADDR was used to advertise an IP that is not valid anymore (e.g., because of roaming),
+ * this option allows to remove it from peer memory (and can remove a batch of them).
+ * The subflow should not exist yet (else you must use TCP FIN to close it).
+ *
+ * REMOVE_ADDR option:
+ * \verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-------+---------------+
+|     Kind      |  Length = 3+n |Subtype|(resvd)|   Address ID  | ...
++---------------+---------------+-------+-------+---------------+
+            (followed by n-1 Address IDs, if required)
+
+\endverbatim
+ */
+class TcpOptionMpTcpRemoveAddress : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_REMOVE_ADDR>
+{
+
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpRemoveAddress (void);
+  virtual ~TcpOptionMpTcpRemoveAddress (void);
+
+  /**
+   * As we do not know in advance the number of records, we pass a vector
+   * \param Returns the addresses into a vector. Empty it before use.
+   */
+  void GetAddresses (std::vector<uint8_t>& addresses) const;
+
+  /**
+   * Append an association id to remove from peer memory
+   * \param addressId The association (IP,port) id
+   */
+  void AddAddressId (uint8_t addressId);
+
+  virtual bool operator== (const TcpOptionMpTcpRemoveAddress&) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+protected:
+  std::vector<uint8_t> m_addressesId; /**< List of removed association ids */
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpRemoveAddress (const TcpOptionMpTcpRemoveAddress&);
+  TcpOptionMpTcpRemoveAddress& operator= (const TcpOptionMpTcpRemoveAddress&);
+};
+
+/**
+ * \brief Allow to (un)block emission from peer on this subflow
+ *
+ * MPTCP allows a host to advertise their preference about the links they would prefer to use.
+ * It is advertised as a boolean (B) that means "Please don't send data on this connection, except if
+ * there is a problem".
+ * The peer is free to ignore this preference.
+ * This option is unidirectional, i.e, an emitter may ask not to receive data
+ * on a subflow while transmitting on it.
+ *
+ * MP_PRIO option:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----+-+--------------+
+|     Kind      |     Length    |Subtype|     |B| AddrID (opt) |
++---------------+---------------+-------+-----+-+--------------+
+
+\endverbatim
+ *
+ */
+class TcpOptionMpTcpChangePriority : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_PRIO>
+{
+
+public:
+  /**
+   * Only one flag standardized
+   */
+  enum Flags
+  {
+    Backup = 1 /**< B bit (LSB), set it if you prefer not to receive data on path addressId*/
+  };
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpChangePriority (void);
+  virtual ~TcpOptionMpTcpChangePriority (void);
+
+  /**
+   * \brief All flags should be set at once.
+   *
+   * You can append flags by using SetFlags( option.GetFlags() | NewFlag)
+   *
+   * \example SetFlags(TcpOptionMpTcpChangePriority::Backup);
+   */
+  virtual void SetFlags (const uint8_t& flags);
+
+  /**
+   * \brief Optional. If you don't set addrId, the receiver considers the subflow on which the
+   * option was received
+   */
+  virtual void SetAddressId (const uint8_t& addrId);
+
+  /**
+   * \return True if an address id was set in the packet.
+   * \note Result depends on length of the option
+   */
+  virtual bool EmbeddedAddressId (void) const;
+
+  /**
+   * \return association id
+   * \warning will assert if addressId was not set. check it with \see EmbeddedAddressId
+   */
+  virtual uint8_t GetAddressId () const;
+
+  /**
+   * \return flags, i.e., the 4 LSB
+   */
+  virtual uint8_t GetFlags (void) const;
+
+  virtual bool operator== (const TcpOptionMpTcpChangePriority& ) const;
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \brief Length may be 3 or 4 (if addrId present)
+  */
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  TcpOptionMpTcpChangePriority (const TcpOptionMpTcpChangePriority&);
+  TcpOptionMpTcpChangePriority& operator= (const TcpOptionMpTcpChangePriority&);
+
+  uint8_t m_length;   /**< Length of this option */
+  uint8_t m_addrId;   //!< May be unset
+  uint8_t m_flags;    //!< On 4 bits
+};
+
+/**
+ * \brief MP_FASTCLOSE is the equivalent of TCP RST at the MPTCP level
+ *
+ * For example, if the operating system is running out of resources, MPTCP could send an
+ * MP_FASTCLOSE.
+ * In version 1 (\RFC{8684}), it is sent along with a RST on every subflow.
+ *
+ * MP_FASTCLOSE option:
+\verbatim
+                    1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----------------------+
+|     Kind      |    Length     |Subtype|      (reserved)       |
++---------------+---------------+-------+-----------------------+
+|                      Option Receiver's Key                    |
+|                            (64 bits)                          |
+|                                                               |
++---------------------------------------------------------------+
+
+\endverbatim
+**/
+class TcpOptionMpTcpFastClose : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_FASTCLOSE>
+{
+
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpFastClose (void);
+  virtual ~TcpOptionMpTcpFastClose (void);
+  virtual bool operator== (const TcpOptionMpTcpFastClose&) const;
+
+  /**
+  * \brief Set peer key to prevent spoofing a MP_FastClose.
+  * \param remoteKey key exchanged during the 3WHS.
+  */
+  virtual void SetPeerKey (const uint64_t& remoteKey);
+
+  /**
+  * \return peer's key
+  */
+  virtual uint64_t GetPeerKey (void) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  uint64_t m_peerKey; /**< Key of the remote host so that it accepts the RST */
+
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpFastClose (const TcpOptionMpTcpFastClose&);
+  TcpOptionMpTcpFastClose& operator= (const TcpOptionMpTcpFastClose&);
+};
+
+/**
+ * \brief Option used when a problem is noticed at any point during a connection (payload changed etc).
+ * A subflow would sends RST and MP_FAIL option
+ *
+ *
+ * Note that the MP_FAIL option requires the use of the full 64-bit sequence number, even if 32-bit sequence numbers are
+ * normally in use in the DSS signals on the path.
+ *
+ * Such a situation is likely to never happen in ns3 and thus this option is implemented as a reference only.
+ *
+ MP_FAIL option:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+----------------------+
+|     Kind      |   Length=12   |Subtype|      (reserved)      |
++---------------+---------------+-------+----------------------+
+|                                                              |
+|                 Data Sequence Number (8 octets)              |
+|                                                              |
++--------------------------------------------------------------+
+
+\endverbatim
+*/
+class TcpOptionMpTcpFail : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_FAIL>
+{
+
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpFail (void);
+  virtual ~TcpOptionMpTcpFail (void);
+
+  virtual bool operator== (const TcpOptionMpTcpFail& ) const;
+
+  /**
+   * \brief Set Data Sequence Number (DSN) until which the communication was fine
+   * \param dsn Last in-order ACK-1 received
+   */
+  virtual void SetDSN (const uint64_t& dsn);
+
+  /**
+   * \return DSN for which error was detected
+   */
+  virtual uint64_t GetDSN (void) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpFail (const TcpOptionMpTcpFail&);
+  TcpOptionMpTcpFail& operator= (const TcpOptionMpTcpFail&);
+
+  uint64_t m_dsn; /**< Last acked dsn */
+};
+
+/**
+ * \brief MP_TCPRST tells the peer why a subflow is reset (\RFC{8684} only)
+ *
+ * It is sent along with the TCP RST. The T flag tells whether the error is
+ * transient, i.e., whether the peer may try to reestablish the subflow.
+ *
+ * MP_TCPRST option:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----------------------+
+|     Kind      |    Length     |Subtype|U|V|W|T|    Reason     |
++---------------+---------------+-------+-----------------------+
+\endverbatim
+*/
+class TcpOptionMpTcpReset : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_TCPRST>
+{
+
+public:
+  /**
+   * Flags of the option
+   */
+  enum Flags
+  {
+    Transient = 1 /**< T bit, the subflow may be reestablished */
+  };
+
+  /**
+   * Reason codes
+   */
+  enum Reason
+  {
+    Unspecified = 0,          /**< Unspecified error */
+    MpTcpSpecific,            /**< MPTCP-specific error, e.g., authentication failure */
+    LackOfResources,          /**< Lack of resources */
+    AdministrativelyProhibited, /**< Administratively prohibited */
+    TooMuchOutstandingData,   /**< Too much outstanding data */
+    UnacceptablePerformance,  /**< Unacceptable performance */
+    MiddleboxInterference     /**< Middlebox interference */
+  };
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpReset (void);
+  virtual ~TcpOptionMpTcpReset (void);
+
+  virtual bool operator== (const TcpOptionMpTcpReset& ) const;
+
+  /**
+   * \param flags U, V, W, T flags
+   */
+  virtual void SetFlags (uint8_t flags);
+
+  /**
+   * \return U, V, W, T flags
+   */
+  virtual uint8_t GetFlags (void) const;
+
+  /**
+   * \param reason Why the subflow is reset
+   */
+  virtual void SetReason (uint8_t reason);
+
+  /**
+   * \return Why the subflow is reset
+   */
+  virtual uint8_t GetReason (void) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpReset (const TcpOptionMpTcpReset&);
+  TcpOptionMpTcpReset& operator= (const TcpOptionMpTcpReset&);
+
+  uint8_t m_flags;  //!< On 4 bits
+  uint8_t m_reason; //!< Reason code
+};
+
+/**
+ * \brief Like GetMpTcpOption but if does not find the option then it creates one
+ *       and append it to the the header
+ *
+ * \see GetMpTcpOption
+ * \return false if it had to create the option
+**/
+template<class T>
+bool
+GetOrCreateMpTcpOption (TcpHeader& header, Ptr<T>& ret)
+{
+  if (!GetTcpOption (header,ret))
+    {
+      ret = Create<T> ();
+      header.AppendOption (ret);
+      return false;
+    }
+  return true;
+}
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_MPTCP */
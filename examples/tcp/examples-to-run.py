@@ -14,6 +14,9 @@ cpp_examples = [
     ("tcp-nsc-zoo", "NSC_ENABLED == True", "False"),
     ("tcp-star-server", "True", "True"),
     ("tcp-variants-comparison", "True", "True"),
+    ("mptcp-benchmark --duration=1", "True", "False"),
+    ("mptcp-benchmark --scenario=wifi-lte --duration=1", "True", "False"),
+    ("mptcp-churn-benchmark --flows=50", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//          path 0
+//       +----------+
+//       |  path 1  |
+//   n0 -+----------+- n1
+//       |   ...    |
+//       +----------+
+//         path N-1
+//
+// Reference multi-homed scenarios for MPTCP, n0 sending to n1 with a
+// BulkSendApplication:
+//
+// - "paths": 2 to 8 point-to-point paths of the same rate. Path i has a one
+//   way delay of delay + i * delayStep and a packet loss rate of i * lossStep,
+//   hence path 0 is the fastest and lossless one.
+// - "wifi-lte": a WiFi-like path (high rate, short delay, residual losses)
+//   next to an LTE-like path (lower rate, long delay, deep buffer). Both are
+//   emulated with point-to-point links so that the scenario only depends on
+//   the modules of the TCP examples.
+//
+// The benchmark reports the goodput, the time the meta receive buffer spent
+// waiting for out of order data (reorder delay), the reinjected and duplicate
+// bytes, the number of simulated events per second of wall clock time and the
+// peak memory of the process.
+// With --output, results are appended to a CSV file so that runs of
+// successive versions can be compared to detect throughput or simulator
+// speed regressions.
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mptcp-helper.h"
+#include "ns3/mptcp-stats.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpBenchmark");
+
+/**
+ * \brief Characteristics of a path
+ */
+struct PathConfig
+{
+  std::string rate;   //!< Link rate
+  Time delay;         //!< One way delay
+  double loss;        //!< Packet loss rate in both directions
+  uint32_t queue;     //!< Device queue size, in packets
+};
+
+/**
+ * \brief Connects two nodes with one point-to-point link per path
+ * \param nodes the two end hosts
+ * \param paths the paths
+ * \return The address of the receiver on the first path
+ */
+static Ipv4Address
+BuildPaths (NodeContainer nodes, const std::vector<PathConfig> &paths)
+{
+  Ipv4AddressHelper address;
+  Ipv4Address receiver;
+  for (uint32_t i = 0; i < paths.size (); i++)
+    {
+      PointToPointHelper p2p;
+      p2p.SetDeviceAttribute ("DataRate", StringValue (paths[i].rate));
+      p2p.SetChannelAttribute ("Delay", TimeValue (paths[i].delay));
+      std::ostringstream size;
+      size << paths[i].queue << "p";
+      p2p.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", QueueSizeValue (QueueSize (size.str ())));
+      NetDeviceContainer devices = p2p.Install (nodes);
+      if (paths[i].loss > 0)
+        {
+          for (uint32_t j = 0; j < devices.GetN (); j++)
+            {
+              Ptr<RateErrorModel> em = CreateObject<RateErrorModel> ();
+              em->SetUnit (RateErrorModel::ERROR_UNIT_PACKET);
+              em->SetRate (paths[i].loss);
+              devices.Get (j)->SetAttribute ("ReceiveErrorModel", PointerValue (em));
+            }
+        }
+      std::ostringstream network;
+      network << "10.0." << i << ".0";
+      address.SetBase (network.str ().c_str (), "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      if (i == 0)
+        {
+          receiver = interfaces.GetAddress (1);
+        }
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  return receiver;
+}
+
+/**
+ * \param n number of paths
+ * \param rate rate of every path
+ * \param delay delay of the first path
+ * \param delayStep delay added per path
+ * \param lossStep loss rate added per path
+ * \return The "paths" reference scenario
+ */
+static std::vector<PathConfig>
+AsymmetricPaths (uint32_t n, std::string rate, Time delay, Time delayStep, double lossStep)
+{
+  std::vector<PathConfig> paths;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      PathConfig path;
+      path.rate = rate;
+      path.delay = delay + delayStep * i;
+      path.loss = lossStep * i;
+      path.queue = 100;
+      paths.push_back (path);
+    }
+  return paths;
+}
+
+/**
+ * \return The "wifi-lte" reference scenario
+ */
+static std::vector<PathConfig>
+WifiLtePaths (void)
+{
+  std::vector<PathConfig> paths (2);
+  paths[0].rate = "30Mbps";
+  paths[0].delay = MilliSeconds (5);
+  paths[0].loss = 0.005;
+  paths[0].queue = 100;
+  paths[1].rate = "10Mbps";
+  paths[1].delay = MilliSeconds (40);
+  paths[1].loss = 0.001;
+  paths[1].queue = 500;
+  return paths;
+}
+
+/**
+ * \param mode name of a path manager
+ * \return The path manager
+ */
+static MpTcpSocketBase::PathManagerMode
+ParsePathManager (std::string mode)
+{
+  if (mode == "Default")
+    {
+      return MpTcpSocketBase::Default;
+    }
+  if (mode == "nDiffPorts")
+    {
+      return MpTcpSocketBase::nDiffPorts;
+    }
+  NS_ABORT_MSG_UNLESS (mode == "FullMesh", "Unknown path manager " << mode);
+  return MpTcpSocketBase::FullMesh;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string scenario = "paths";
+  uint32_t nPaths = 2;
+  std::string rate = "10Mbps";
+  Time delay = MilliSeconds (10);
+  Time delayStep = MilliSeconds (10);
+  double lossStep = 0.001;
+  bool mptcp = true;
+  std::string scheduler = "ns3::MpTcpSchedulerRoundRobin";
+  std::string pathManager = "FullMesh";
+  std::string congestion = "ns3::MpTcpCongestionLia";
+  bool pacing = false;
+  bool superSegments = false;
+  Time duration = Seconds (10);
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("scenario", "Reference scenario: paths or wifi-lte", scenario);
+  cmd.AddValue ("paths", "Number of paths of the paths scenario (2 to 8)", nPaths);
+  cmd.AddValue ("rate", "Rate of the paths of the paths scenario", rate);
+  cmd.AddValue ("delay", "One way delay of the first path of the paths scenario", delay);
+  cmd.AddValue ("delayStep", "Delay added per path of the paths scenario", delayStep);
+  cmd.AddValue ("lossStep", "Loss rate added per path of the paths scenario", lossStep);
+  cmd.AddValue ("mptcp", "Use MPTCP, otherwise a single TCP connection on the first path", mptcp);
+  cmd.AddValue ("scheduler", "TypeId of the MPTCP scheduler", scheduler);
+  cmd.AddValue ("pathManager", "Path manager: Default, FullMesh or nDiffPorts", pathManager);
+  cmd.AddValue ("congestion", "TypeId of the coupled congestion control", congestion);
+  cmd.AddValue ("pacing", "Pace every subflow at a rate derived from its cwnd and srtt", pacing);
+  cmd.AddValue ("superSegments", "Paced subflows send bursts of segments per pacing quantum", superSegments);
+  cmd.AddValue ("duration", "Duration of the transfer", duration);
+  cmd.AddValue ("output", "CSV file the results are appended to", output);
+  cmd.Parse (argc, argv);
+
+  std::vector<PathConfig> paths;
+  if (scenario == "paths")
+    {
+      NS_ABORT_MSG_UNLESS (nPaths >= 2 && nPaths <= 8, "The paths scenario has 2 to 8 paths");
+      paths = AsymmetricPaths (nPaths, rate, delay, delayStep, lossStep);
+    }
+  else
+    {
+      NS_ABORT_MSG_UNLESS (scenario == "wifi-lte", "Unknown scenario " << scenario);
+      paths = WifiLtePaths ();
+    }
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 20));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 20));
+  Config::SetDefault ("ns3::MpTcpSocketBase::SubflowPacing", BooleanValue (pacing));
+  Config::SetDefault ("ns3::MpTcpSocketBase::SuperSegments", BooleanValue (superSegments));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  if (mptcp)
+    {
+      MpTcpHelper helper;
+      helper.SetScheduler (scheduler);
+      helper.SetPathManager (ParsePathManager (pathManager));
+      helper.SetCongestionControl (congestion);
+      helper.Install (nodes);
+    }
+  else
+    {
+      InternetStackHelper stack;
+      stack.Install (nodes);
+    }
+  Ipv4Address receiver = BuildPaths (nodes, paths);
+
+  uint16_t port = 5001;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (receiver, port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  source.SetAttribute ("SendSize", UintegerValue (1400));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0));
+  sourceApps.Stop (duration);
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0));
+  Ptr<PacketSink> packetSink = DynamicCast<PacketSink> (sinkApps.Get (0));
+
+  // the sink stops with the simulation so that the receiver meta is still alive
+  Simulator::Stop (duration);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t wallMs = std::max<int64_t> (clock.End (), 1);
+
+  double goodput = packetSink->GetTotalRx () * 8.0 / duration.GetSeconds () / 1e6;
+  // the listening socket upgrades itself into the receiver meta
+  Ptr<MpTcpSocketBase> meta = MpTcpHelper::GetMeta (packetSink->GetListeningSocket ());
+  double reorderDelay = meta ? meta->GetStats ()->GetHolBlockingTime ().GetSeconds () : 0;
+  uint32_t outOfOrder = meta ? meta->GetStats ()->GetOutOfOrderArrivals () : 0;
+  uint64_t duplicate = meta ? meta->GetStats ()->GetDuplicateBytes () : 0;
+  Ptr<MpTcpSocketBase> senderMeta = MpTcpHelper::GetMeta (DynamicCast<BulkSendApplication> (sourceApps.Get (0))->GetSocket ());
+  uint64_t reinjected = senderMeta ? senderMeta->GetStats ()->GetReinjectedBytes () : 0;
+  uint64_t events = Simulator::GetEventCount ();
+  double eventRate = events * 1000.0 / wallMs;
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  // kilobytes on Linux
+  long peakMemory = usage.ru_maxrss;
+
+  Simulator::Destroy ();
+
+  std::cout << std::fixed << std::setprecision (3)
+            << "scenario " << scenario << ", " << paths.size () << " paths, "
+            << (mptcp ? scheduler + " " + pathManager + " " + congestion : std::string ("TCP")) << std::endl
+            << "goodput         " << goodput << " Mbps" << std::endl
+            << "reorder delay   " << reorderDelay << " s (" << outOfOrder << " out of order arrivals)" << std::endl
+            << "reinjected      " << reinjected << " bytes (" << duplicate << " received twice)" << std::endl
+            << "events          " << events << " in " << wallMs << " ms, " << eventRate << " events/s" << std::endl
+            << "peak memory     " << peakMemory << " kB" << std::endl;
+
+  if (!output.empty ())
+    {
+      bool header = !std::ifstream (output.c_str ()).good ();
+      std::ofstream csv (output.c_str (), std::ios::app);
+      if (header)
+        {
+          csv << "scenario,paths,mptcp,scheduler,pathManager,congestion,pacing,superSegments,duration,"
+              << "goodputMbps,reorderDelay,outOfOrder,reinjectedBytes,duplicateBytes,events,wallMs,eventsPerSecond,peakMemoryKb" << std::endl;
+        }
+      csv << scenario << "," << paths.size () << "," << mptcp << "," << scheduler << ","
+          << pathManager << "," << congestion << "," << pacing << "," << superSegments << "," << duration.GetSeconds () << ","
+          << goodput << "," << reorderDelay << "," << outOfOrder << "," << reinjected << "," << duplicate << "," << events << ","
+          << wallMs << "," << eventRate << "," << peakMemory << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//          path 0
+//       +----------+
+//   n0 -+  path 1  +- n1
+//       +----------+
+//
+// Connection churn benchmark: n0 opens many short MPTCP connections to n1,
+// like a browser fetching web objects. Connections arrive following a Poisson
+// process, each one sends flowSize bytes then closes. Unlike mptcp-benchmark,
+// which measures a single long transfer, the cost measured here is dominated
+// by the setup and the teardown of the meta sockets, subflows, schedulers and
+// path managers.
+//
+// A listening socket turns itself into the meta of the first MPTCP connection
+// it accepts, hence n1 listens on a new port for every connection.
+//
+// The benchmark reports the number of completed connections, their mean
+// completion time, the number of connections simulated per second of wall
+// clock time, the number of simulated events per second of wall clock time
+// and the peak memory of the process.
+// With --output, results are appended to a CSV file.
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/mptcp-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpChurnBenchmark");
+
+/**
+ * \brief Opens short connections and records when they complete
+ */
+class ChurnClient
+{
+public:
+  /**
+   * \param client sending node
+   * \param server receiving node
+   * \param address address of the receiver
+   * \param flowSize bytes sent per connection
+   */
+  ChurnClient (Ptr<Node> client, Ptr<Node> server, Ipv4Address address, uint32_t flowSize);
+
+  /**
+   * \brief Schedules the connections
+   * \param flows number of connections
+   * \param interval mean time between two connections
+   * \param port first port the server listens on
+   * \return When the last connection starts
+   */
+  Time Start (uint32_t flows, Time interval, uint16_t port);
+
+  /**
+   * \return The number of connections whose bytes were all received
+   */
+  uint32_t GetCompleted (void) const;
+
+  /**
+   * \return The mean time between a connection request and its last byte received
+   */
+  Time GetMeanCompletionTime (void) const;
+
+private:
+  /**
+   * \brief State of a connection
+   */
+  struct Flow
+  {
+    Time start;           //!< When the connection was requested
+    uint32_t sent;        //!< Bytes accepted by the client socket
+    uint32_t received;    //!< Bytes read by the server
+    Ptr<Socket> client;   //!< Client socket, released once every byte is sent
+    Ptr<Socket> server;   //!< Listening socket, released once every byte is received
+  };
+
+  /**
+   * \brief Starts a connection
+   * \param id index of the connection
+   * \param port port the server listens on
+   */
+  void Open (uint32_t id, uint16_t port);
+  /**
+   * \brief Fills the send buffer of a client socket
+   * \param id index of the connection
+   * \param socket the client socket
+   * \param available room in the send buffer
+   */
+  void Send (uint32_t id, Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Reads what a server socket received
+   * \param id index of the connection
+   * \param socket the server socket
+   */
+  void Receive (uint32_t id, Ptr<Socket> socket);
+
+  Ptr<Node> m_clientNode;     //!< Sending node
+  Ptr<Node> m_serverNode;     //!< Receiving node
+  Ipv4Address m_address;      //!< Address of the receiver
+  uint32_t m_flowSize;        //!< Bytes sent per connection
+  std::vector<Flow> m_flows;  //!< Connections
+  uint32_t m_completed;       //!< Connections fully received
+  Time m_completionTime;      //!< Sum of the completion times
+};
+
+ChurnClient::ChurnClient (Ptr<Node> client, Ptr<Node> server, Ipv4Address address, uint32_t flowSize)
+  : m_clientNode (client),
+    m_serverNode (server),
+    m_address (address),
+    m_flowSize (flowSize),
+    m_completed (0)
+{
+}
+
+Time
+ChurnClient::Start (uint32_t flows, Time interval, uint16_t port)
+{
+  Ptr<ExponentialRandomVariable> arrivals = CreateObject<ExponentialRandomVariable> ();
+  arrivals->SetAttribute ("Mean", DoubleValue (interval.GetSeconds ()));
+  m_flows.resize (flows);
+  Time start = Seconds (0);
+  for (uint32_t i = 0; i < flows; i++)
+    {
+      start += Seconds (arrivals->GetValue ());
+      Simulator::Schedule (start, &ChurnClient::Open, this, i, port + i);
+    }
+  return start;
+}
+
+uint32_t
+ChurnClient::GetCompleted (void) const
+{
+  return m_completed;
+}
+
+Time
+ChurnClient::GetMeanCompletionTime (void) const
+{
+  return m_completed ? m_completionTime / m_completed : Time (0);
+}
+
+void
+ChurnClient::Open (uint32_t id, uint16_t port)
+{
+  Flow &flow = m_flows[id];
+  flow.start = Simulator::Now ();
+  flow.sent = 0;
+  flow.received = 0;
+
+  flow.server = Socket::CreateSocket (m_serverNode, TcpSocketFactory::GetTypeId ());
+  flow.server->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  flow.server->Listen ();
+  flow.server->SetRecvCallback (MakeCallback (&ChurnClient::Receive, this).Bind (id));
+
+  flow.client = Socket::CreateSocket (m_clientNode, TcpSocketFactory::GetTypeId ());
+  flow.client->Bind ();
+  flow.client->SetSendCallback (MakeCallback (&ChurnClient::Send, this).Bind (id));
+  flow.client->Connect (InetSocketAddress (m_address, port));
+}
+
+void
+ChurnClient::Send (uint32_t id, Ptr<Socket> socket, uint32_t available)
+{
+  Flow &flow = m_flows[id];
+  while (flow.sent < m_flowSize && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (m_flowSize - flow.sent, socket->GetTxAvailable ()), 1400u);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          return;
+        }
+      flow.sent += sent;
+    }
+  if (flow.sent == m_flowSize && flow.client)
+    {
+      socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+      socket->Close ();
+      flow.client = 0;
+    }
+}
+
+void
+ChurnClient::Receive (uint32_t id, Ptr<Socket> socket)
+{
+  Flow &flow = m_flows[id];
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      flow.received += packet->GetSize ();
+    }
+  if (flow.received == m_flowSize && flow.server)
+    {
+      m_completed++;
+      m_completionTime += Simulator::Now () - flow.start;
+      socket->Close ();
+      flow.server = 0;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t flows = 500;
+  uint32_t flowSize = 20000;
+  Time interval = MilliSeconds (10);
+  Time drain = Seconds (10);
+  std::string rate = "10Mbps";
+  Time delay = MilliSeconds (10);
+  Time delayStep = MilliSeconds (10);
+  std::string scheduler = "ns3::MpTcpSchedulerRoundRobin";
+  std::string congestion = "ns3::MpTcpCongestionLia";
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("flows", "Number of connections", flows);
+  cmd.AddValue ("flowSize", "Bytes sent per connection", flowSize);
+  cmd.AddValue ("interval", "Mean time between two connections", interval);
+  cmd.AddValue ("drain", "Time simulated after the last connection request", drain);
+  cmd.AddValue ("rate", "Rate of the paths", rate);
+  cmd.AddValue ("delay", "One way delay of the first path", delay);
+  cmd.AddValue ("delayStep", "Delay added on the second path", delayStep);
+  cmd.AddValue ("scheduler", "TypeId of the MPTCP scheduler", scheduler);
+  cmd.AddValue ("congestion", "TypeId of the coupled congestion control", congestion);
+  cmd.AddValue ("output", "CSV file the results are appended to", output);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  MpTcpHelper helper;
+  helper.SetScheduler (scheduler);
+  helper.SetPathManager (MpTcpSocketBase::FullMesh);
+  helper.SetCongestionControl (congestion);
+  helper.Install (nodes);
+
+  Ipv4AddressHelper address;
+  Ipv4Address receiver;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PointToPointHelper p2p;
+      p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+      p2p.SetChannelAttribute ("Delay", TimeValue (delay + delayStep * i));
+      NetDeviceContainer devices = p2p.Install (nodes);
+      std::ostringstream network;
+      network << "10.0." << i << ".0";
+      address.SetBase (network.str ().c_str (), "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      if (i == 0)
+        {
+          receiver = interfaces.GetAddress (1);
+        }
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  ChurnClient churn (nodes.Get (0), nodes.Get (1), receiver, flowSize);
+  Time last = churn.Start (flows, interval, 10000);
+
+  // closed connections keep probing the zero window of their peer
+  Simulator::Stop (last + drain);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t wallMs = std::max<int64_t> (clock.End (), 1);
+
+  uint32_t completed = churn.GetCompleted ();
+  double completionTime = churn.GetMeanCompletionTime ().GetSeconds ();
+  double connectionRate = completed * 1000.0 / wallMs;
+  uint64_t events = Simulator::GetEventCount ();
+  double eventRate = events * 1000.0 / wallMs;
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  // kilobytes on Linux
+  long peakMemory = usage.ru_maxrss;
+
+  Simulator::Destroy ();
+
+  std::cout << std::fixed << std::setprecision (3)
+            << flows << " connections of " << flowSize << " bytes, " << scheduler << " " << congestion << std::endl
+            << "completed       " << completed << ", mean completion time " << completionTime << " s" << std::endl
+            << "connections     " << connectionRate << " per wall clock second" << std::endl
+            << "events          " << events << " in " << wallMs << " ms, " << eventRate << " events/s" << std::endl
+            << "peak memory     " << peakMemory << " kB" << std::endl;
+
+  if (!output.empty ())
+    {
+      bool header = !std::ifstream (output.c_str ()).good ();
+      std::ofstream csv (output.c_str (), std::ios::app);
+      if (header)
+        {
+          csv << "flows,flowSize,interval,scheduler,congestion,completed,completionTime,"
+              << "connectionsPerSecond,events,wallMs,eventsPerSecond,peakMemoryKb" << std::endl;
+        }
+      csv << flows << "," << flowSize << "," << interval.GetSeconds () << "," << scheduler << ","
+          << congestion << "," << completed << "," << completionTime << "," << connectionRate << ","
+          << events << "," << wallMs << "," << eventRate << "," << peakMemory << std::endl;
+    }
+  return 0;
+}
@@ -25,10 +25,14 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "uinteger.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
+#include <iostream>
 
 
 /**
@@ -53,6 +57,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("ProfileSampling",
+                   "Profile the wall-clock time of one event in this many, "
+                   "on average; 0 disables the profiler.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::SetProfileSampling,
+                                         &DefaultSimulatorImpl::GetProfileSampling),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ProfileOutput",
+                   "File receiving the profile at Simulator::Destroy, "
+                   "the standard error if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileOutput),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -70,7 +87,9 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentUid = 0;
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
+  m_eventCount = 0;
   m_unscheduledEvents = 0;
+  m_cancelledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
 }
@@ -108,6 +127,7 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  PrintProfile ();
 }
 
 void
@@ -127,6 +147,41 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
   m_events = scheduler;
 }
 
+void
+DefaultSimulatorImpl::SetProfileSampling (uint32_t period)
+{
+  NS_LOG_FUNCTION (this << period);
+  m_profiler.SetPeriod (period);
+}
+
+uint32_t
+DefaultSimulatorImpl::GetProfileSampling (void) const
+{
+  return m_profiler.GetPeriod ();
+}
+
+void
+DefaultSimulatorImpl::PrintProfile (void) const
+{
+  if (m_profiler.GetPeriod () == 0)
+    {
+      return;
+    }
+  if (m_profileOutput.empty ())
+    {
+      m_profiler.Print (std::cerr, m_eventCount);
+      return;
+    }
+  std::ofstream os (m_profileOutput.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Cannot open " << m_profileOutput << ", printing the profile to the standard error");
+      m_profiler.Print (std::cerr, m_eventCount);
+      return;
+    }
+  m_profiler.Print (os, m_eventCount);
+}
+
 // System ID for non-distributed simulation is always zero
 uint32_t 
 DefaultSimulatorImpl::GetSystemId (void) const
@@ -146,7 +201,26 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  m_eventCount++;
+  if (next.impl->IsCancelled () && m_cancelledEvents > 0)
+    {
+      m_cancelledEvents--;
+    }
+  if (m_profiler.Sample ())
+    {
+      // the event may be deleted once invoked
+      EventProfiler::Key key = EventProfiler::GetKey (next.impl, next.key.m_context);
+      uint32_t uid = m_uid;
+      uint64_t allocations = EventProfiler::GetAllocations ();
+      EventProfiler::Clock::time_point start = EventProfiler::Clock::now ();
+      next.impl->Invoke ();
+      m_profiler.Record (key, start, m_uid - uid,
+                         EventProfiler::GetAllocations () - allocations);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -166,17 +240,16 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
+  // swap queues, the buffers keep their capacity
   {
     CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
+    m_eventsWithContext.swap (m_eventsWithContextSwap);
     m_eventsWithContextEmpty = true;
   }
-  while (!eventsWithContext.empty ())
+  for (EventsWithContext::const_iterator i = m_eventsWithContextSwap.begin ();
+       i != m_eventsWithContextSwap.end (); ++i)
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
+       const EventWithContext &event = *i;
        Scheduler::Event ev;
        ev.impl = event.event;
        ev.key.m_ts = m_currentTs + event.timestamp;
@@ -186,6 +259,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
        m_unscheduledEvents++;
        m_events->Insert (ev);
     }
+  m_eventsWithContextSwap.clear ();
 }
 
 void
@@ -362,9 +436,62 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () == 2)
+        {
+          // destroy events are not in the event list
+          return;
+        }
+      m_cancelledEvents++;
+      if (m_cancelledEvents >= MIN_CANCELLED_EVENTS
+          && m_cancelledEvents >= static_cast<uint32_t> (m_unscheduledEvents) / 2)
+        {
+          RemoveCancelledEvents ();
+        }
+    }
+}
+
+void
+DefaultSimulatorImpl::RemoveCancelledEvents (void)
+{
+  NS_LOG_FUNCTION (this << m_cancelledEvents << m_unscheduledEvents);
+  std::vector<Scheduler::Event> cancelled;
+  m_events->RemoveCancelled (cancelled);
+  m_unscheduledEvents -= cancelled.size ();
+  m_cancelledEvents = 0;
+  // the event list is consistent again before the events, and the
+  // objects they hold, are released
+  for (std::vector<Scheduler::Event>::const_iterator i = cancelled.begin ();
+       i != cancelled.end (); ++i)
+    {
+      i->impl->Unref ();
     }
 }
 
+EventId
+DefaultSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Reschedule Thread-unsafe invocation!");
+  NS_ASSERT_MSG (id.GetUid () != 2 && !IsExpired (id),
+                 "DefaultSimulatorImpl::Reschedule(): Event not pending");
+  NS_ASSERT_MSG (delay.IsPositive (), "DefaultSimulatorImpl::Reschedule(): Negative delay");
+  Time tAbsolute = delay + TimeStep (m_currentTs);
+
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  // a new uid keeps the order of an event cancelled and scheduled again
+  Scheduler::EventKey key;
+  key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  key.m_context = ev.key.m_context;
+  key.m_uid = m_uid;
+  m_uid++;
+  m_events->Reschedule (ev, key);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -411,4 +538,10 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 } // namespace ns3
@@ -26,10 +26,13 @@
 #include "event-impl.h"
 #include "system-thread.h"
 #include "system-mutex.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <string>
+#include <vector>
 
 /**
  * \file
@@ -43,6 +46,10 @@ namespace ns3 {
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * The wall-clock time of the events can be profiled by an EventProfiler,
+ * enabled by the \c ProfileSampling attribute. The profile is printed at
+ * Simulator::Destroy().
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -69,6 +76,7 @@ public:
   virtual EventId ScheduleDestroy (EventImpl *event);
   virtual void Remove (const EventId &id);
   virtual void Cancel (const EventId &id);
+  virtual EventId Reschedule (const EventId &id, const Time &delay);
   virtual bool IsExpired (const EventId &id) const;
   virtual void Run (void);
   virtual Time Now (void) const;
@@ -77,6 +85,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
@@ -85,6 +94,25 @@ private:
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /**
+   * Remove the cancelled events from the event list.
+   *
+   * Called by Cancel() once the cancelled events make up half of the
+   * event list, so that long runs pushing back timers do not fill the
+   * scheduler with dead events.
+   */
+  void RemoveCancelledEvents (void);
+  /**
+   * Set the sampling period of the profiler.
+   *
+   * \param [in] period The mean number of events per sample, 0 to disable
+   *             the profiler.
+   */
+  void SetProfileSampling (uint32_t period);
+  /** \returns The sampling period of the profiler. */
+  uint32_t GetProfileSampling (void) const;
+  /** Print the profile of the events, if enabled. */
+  void PrintProfile (void) const;
  
   /** Wrap an event with its execution context. */
   struct EventWithContext {
@@ -95,10 +123,20 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
-  /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
+  /**
+   * Container type for the events from a different context.
+   *
+   * The events are stored contiguously, and the two buffers are swapped
+   * by ProcessEventsWithContext() so that their storage is reused.
+   */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
   /** The container of events from a different context. */
   EventsWithContext m_eventsWithContext;
+  /**
+   * The buffer of events being moved into the main event queue,
+   * empty outside of ProcessEventsWithContext().
+   */
+  EventsWithContext m_eventsWithContextSwap;
   /**
    * Flag \c true if all events with context have been moved to the
    * primary event queue.
@@ -124,14 +162,28 @@ private:
   uint64_t m_currentTs;
   /** Execution context of the current event. */
   uint32_t m_currentContext;
+  /** The event count. */
+  uint64_t m_eventCount;
   /**
    * Number of events that have been inserted but not yet scheduled,
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /**
+   * Number of events cancelled since the last call to
+   * RemoveCancelledEvents() which may still be in the event list.
+   */
+  uint32_t m_cancelledEvents;
+  /** Number of cancelled events below which they are never removed at once. */
+  static const uint32_t MIN_CANCELLED_EVENTS = 1024;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** The profiler of the wall-clock time of the events. */
+  EventProfiler m_profiler;
+  /** File receiving the profile, the standard error if empty. */
+  std::string m_profileOutput;
 };
 
 } // namespace ns3
@@ -19,7 +19,9 @@
  */
 
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -66,4 +68,125 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+EventImpl::Function
+EventImpl::GetFunction (void) const
+{
+  Function function = { 0, { 0, 0 } };
+  return function;
+}
+
+namespace {
+
+/** Granularity of the size classes of event blocks. */
+const std::size_t EVENT_BLOCK_ALIGN = 16;
+/** Number of size classes, events larger than this go to ::operator new. */
+const std::size_t EVENT_BLOCK_CLASSES = 16;
+/** Free blocks kept at most per size class and per thread. */
+const uint32_t EVENT_BLOCK_MAX_FREE = 4096;
+
+/** A free block, linked to the next free block of its size class. */
+struct FreeEventBlock
+{
+  FreeEventBlock *next;  /**< The next free block. */
+};
+
+/**
+ * The free lists of a thread.
+ *
+ * A trivial type, so that it is usable at any time in the life of the
+ * thread, including while static objects are destroyed.
+ */
+struct EventBlockPool
+{
+  FreeEventBlock *head[EVENT_BLOCK_CLASSES];  /**< The free lists. */
+  uint32_t count[EVENT_BLOCK_CLASSES];        /**< Length of each list. */
+};
+
+/** The free lists of the current thread. */
+thread_local EventBlockPool g_eventBlockPool;
+
+/**
+ * Gives the free blocks of a thread back to the system when the thread
+ * exits, so that the threads of a parallel simulation do not leak them.
+ * Blocks freed afterwards, by static objects, stay in the lists.
+ */
+struct EventBlockPoolReleaser
+{
+  /** Make sure the releaser of the current thread is constructed. */
+  void Arm (void)
+  {
+  }
+  /** Free the blocks of the lists. */
+  ~EventBlockPoolReleaser ()
+  {
+    EventBlockPool &pool = g_eventBlockPool;
+    for (std::size_t i = 0; i < EVENT_BLOCK_CLASSES; i++)
+      {
+        while (pool.head[i] != 0)
+          {
+            FreeEventBlock *block = pool.head[i];
+            pool.head[i] = block->next;
+            ::operator delete (block);
+          }
+        pool.count[i] = 0;
+      }
+  }
+};
+
+/** The releaser of the current thread, constructed on first use. */
+thread_local EventBlockPoolReleaser g_eventBlockPoolReleaser;
+
+/**
+ * \param [in] size The size of an event.
+ * \returns The index of the size class of the event.
+ */
+inline std::size_t
+EventBlockClass (std::size_t size)
+{
+  return (size - 1) / EVENT_BLOCK_ALIGN;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (size_t size)
+{
+  EventProfiler::CountAllocation ();
+  std::size_t sizeClass = EventBlockClass (size);
+  if (sizeClass >= EVENT_BLOCK_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  EventBlockPool &pool = g_eventBlockPool;
+  FreeEventBlock *block = pool.head[sizeClass];
+  if (block == 0)
+    {
+      return ::operator new ((sizeClass + 1) * EVENT_BLOCK_ALIGN);
+    }
+  pool.head[sizeClass] = block->next;
+  pool.count[sizeClass]--;
+  return block;
+}
+
+void
+EventImpl::operator delete (void *ptr, size_t size)
+{
+  std::size_t sizeClass = EventBlockClass (size);
+  EventBlockPool &pool = g_eventBlockPool;
+  if (sizeClass >= EVENT_BLOCK_CLASSES
+      || pool.count[sizeClass] >= EVENT_BLOCK_MAX_FREE)
+    {
+      ::operator delete (ptr);
+      return;
+    }
+  if (pool.count[sizeClass] == 0)
+    {
+      g_eventBlockPoolReleaser.Arm ();
+    }
+  FreeEventBlock *block = static_cast<FreeEventBlock *> (ptr);
+  block->next = pool.head[sizeClass];
+  pool.head[sizeClass] = block;
+  pool.count[sizeClass]++;
+}
+
 } // namespace ns3
@@ -21,6 +21,8 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
+#include <typeinfo>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +68,47 @@ public:
    */
   bool IsCancelled (void);
 
+  /** The function called by an event, which tells events apart in profiles. */
+  struct Function
+  {
+    /** The dynamic type of the object of a class method, 0 for a function. */
+    const std::type_info *object;
+    /** The representation of the function or class method pointer, zero padded. */
+    uintptr_t pointer[2];
+  };
+  /**
+   * Identify the function called by the event.
+   *
+   * This is only called for the events sampled by an EventProfiler.
+   *
+   * \returns The function, all zeros if unknown.
+   */
+  virtual Function GetFunction (void) const;
+
+  /**
+   * Allocate the memory of an event.
+   *
+   * Events are small and short-lived: most of them are freed as soon as
+   * they are invoked. Their memory is served from per-thread lists of free
+   * blocks, one per size class of 16 bytes up to 256 bytes, so that
+   * scheduling an event does not usually go through the system allocator.
+   * Larger events get their memory from the global operator new.
+   *
+   * \param [in] size The size of the dynamic type of the event.
+   * \returns The allocated memory.
+   */
+  static void * operator new (size_t size);
+  /**
+   * Release the memory of an event.
+   *
+   * The block goes to the free list of the calling thread, which
+   * may differ from the one which allocated it.
+   *
+   * \param [in] ptr The memory returned by operator new.
+   * \param [in] size The size of the dynamic type of the event.
+   */
+  static void operator delete (void *ptr, size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "simulator.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <cxxabi.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+// dladdr() is in the C library of these platforms, no need to link libdl
+#if defined (__APPLE__) || \
+  (defined (__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34)))
+#define NS3_EVENT_PROFILER_DLADDR 1
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/** Number of functions listed by node. */
+const uint32_t TOP_FUNCTIONS_BY_NODE = 3;
+
+/**
+ * Demangle a C++ name.
+ *
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or \p mangled if it cannot be demangled.
+ */
+std::string
+Demangle (const char *mangled)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status != 0)
+    {
+      return mangled;
+    }
+  std::string name (demangled);
+  std::free (demangled);
+  return name;
+}
+
+/**
+ * Extract the type of the function from the name of an event made by
+ * MakeEvent(), which is local to the MakeEvent() instance.
+ *
+ * \param [in] event The demangled name of the event type.
+ * \returns The type of the first argument of MakeEvent(), or \p event.
+ */
+std::string
+GetSignature (const std::string &event)
+{
+  std::string::size_type start = event.find ("MakeEvent");
+  if (start == std::string::npos)
+    {
+      return event;
+    }
+  start += 9;
+  if (start >= event.size () || (event[start] != '<' && event[start] != '('))
+    {
+      return event;
+    }
+  start++;
+  int depth = 0;
+  for (std::string::size_type i = start; i < event.size (); i++)
+    {
+      char c = event[i];
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if ((c == '>' || c == ')') && depth > 0)
+        {
+          depth--;
+        }
+      else if (depth == 0 && (c == ',' || c == '>' || c == ')'))
+        {
+          return event.substr (start, i - start);
+        }
+    }
+  return event;
+}
+
+/** Total of the measures of a function or a node. */
+struct Total
+{
+  uint64_t samples;      //!< Number of sampled events.
+  uint64_t ns;           //!< Wall-clock time, in nanoseconds.
+  uint64_t scheduled;    //!< Events scheduled.
+  uint64_t allocations;  //!< Allocations made.
+};
+
+/**
+ * Order of the profile lines: most time first.
+ *
+ * \param [in] a A line.
+ * \param [in] b Another line.
+ * \returns \c true if \p a comes first.
+ */
+bool
+MoreTime (const std::pair<std::string, Total> &a, const std::pair<std::string, Total> &b)
+{
+  if (a.second.ns != b.second.ns)
+    {
+      return a.second.ns > b.second.ns;
+    }
+  return a.first < b.first;
+}
+
+} // unnamed namespace
+
+thread_local uint64_t EventProfiler::m_allocations = 0;
+
+bool
+EventProfiler::Key::operator < (const Key &o) const
+{
+  if (context != o.context)
+    {
+      return context < o.context;
+    }
+  if (event != o.event)
+    {
+      return event->before (*o.event);
+    }
+  if (function.object != o.function.object)
+    {
+      return function.object == 0 || (o.function.object != 0 && function.object->before (*o.function.object));
+    }
+  if (function.pointer[0] != o.function.pointer[0])
+    {
+      return function.pointer[0] < o.function.pointer[0];
+    }
+  return function.pointer[1] < o.function.pointer[1];
+}
+
+EventProfiler::EventProfiler ()
+  : m_period (0),
+    m_countdown (0),
+    m_state (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::SetPeriod (uint32_t period)
+{
+  NS_LOG_FUNCTION (this << period);
+  m_period = period;
+  m_measures.clear ();
+  // a fixed seed: the sampled events do not depend on the random variables
+  m_state = 0x9e3779b97f4a7c15ULL;
+  m_countdown = 0;
+  if (m_period != 0)
+    {
+      Rearm ();
+    }
+}
+
+uint32_t
+EventProfiler::GetPeriod (void) const
+{
+  return m_period;
+}
+
+bool
+EventProfiler::Rearm (void)
+{
+  // xorshift64, uniform interval in [1, 2 * period - 1]
+  m_state ^= m_state << 13;
+  m_state ^= m_state >> 7;
+  m_state ^= m_state << 17;
+  m_countdown = 1 + m_state % (2 * static_cast<uint64_t> (m_period) - 1);
+  return true;
+}
+
+EventProfiler::Key
+EventProfiler::GetKey (const EventImpl *event, uint32_t context)
+{
+  Key key;
+  key.event = &typeid (*event);
+  key.function = event->GetFunction ();
+  key.context = context;
+  return key;
+}
+
+void
+EventProfiler::Record (const Key &key, Clock::time_point start, uint32_t scheduled,
+                       uint64_t allocations)
+{
+  Clock::duration elapsed = Clock::now () - start;
+  Measure &measure = m_measures[key];
+  measure.samples++;
+  measure.ns += std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+  measure.scheduled += scheduled;
+  measure.allocations += allocations;
+}
+
+std::string
+EventProfiler::GetName (const Key &key)
+{
+  std::string object;
+  if (key.function.object != 0)
+    {
+      object = Demangle (key.function.object->name ());
+    }
+#ifdef NS3_EVENT_PROFILER_DLADDR
+  Dl_info info;
+  if (dladdr (reinterpret_cast<void *> (key.function.pointer[0]), &info) != 0
+      && info.dli_sname != 0
+      && info.dli_saddr == reinterpret_cast<void *> (key.function.pointer[0]))
+    {
+      std::string name = Demangle (info.dli_sname);
+      if (!object.empty () && name.compare (0, object.size () + 2, object + "::") != 0)
+        {
+          // a method inherited by the class of the object
+          name += " on " + object;
+        }
+      return name;
+    }
+#endif
+  std::ostringstream oss;
+  if (!object.empty ())
+    {
+      oss << object << ": ";
+    }
+  oss << GetSignature (Demangle (key.event->name ()));
+  if (key.function.pointer[0] != 0)
+    {
+      oss << " [0x" << std::hex << key.function.pointer[0] << "]";
+    }
+  return oss.str ();
+}
+
+void
+EventProfiler::Print (std::ostream &os, uint64_t eventCount) const
+{
+  NS_LOG_FUNCTION (this << eventCount);
+  Total zero = { 0, 0, 0, 0 };
+  Total total = zero;
+  std::map<std::string, Total> byFunction;
+  std::map<uint32_t, Total> byNode;
+  std::map<uint32_t, std::map<std::string, Total> > byNodeFunction;
+  std::map<Key, std::string> names;
+  for (std::map<Key, Measure>::const_iterator i = m_measures.begin (); i != m_measures.end (); ++i)
+    {
+      // the name of a function does not depend on the context
+      Key function = i->first;
+      function.context = 0;
+      std::map<Key, std::string>::iterator name = names.find (function);
+      if (name == names.end ())
+        {
+          name = names.insert (std::make_pair (function, GetName (function))).first;
+        }
+      Total *totals[] = {
+        &total,
+        &byFunction.insert (std::make_pair (name->second, zero)).first->second,
+        &byNode.insert (std::make_pair (i->first.context, zero)).first->second,
+        &byNodeFunction[i->first.context].insert (std::make_pair (name->second, zero)).first->second
+      };
+      for (uint32_t j = 0; j < sizeof (totals) / sizeof (totals[0]); j++)
+        {
+          totals[j]->samples += i->second.samples;
+          totals[j]->ns += i->second.ns;
+          totals[j]->scheduled += i->second.scheduled;
+          totals[j]->allocations += i->second.allocations;
+        }
+    }
+
+  os << "Event profile: 1 in " << m_period << " events sampled, " << total.samples
+     << " of " << eventCount << " events" << std::endl;
+  if (total.samples == 0)
+    {
+      return;
+    }
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::fixed;
+
+  std::vector<std::pair<std::string, Total> > functions (byFunction.begin (), byFunction.end ());
+  std::sort (functions.begin (), functions.end (), MoreTime);
+  os << "Flat profile, estimated:" << std::endl
+     << "   %time     time(s)      events   us/event   sched/event  allocs/event  function" << std::endl;
+  for (std::vector<std::pair<std::string, Total> >::const_iterator i = functions.begin ();
+       i != functions.end (); ++i)
+    {
+      const Total &t = i->second;
+      os << std::setprecision (2) << std::setw (8) << 100.0 * t.ns / std::max<uint64_t> (total.ns, 1)
+         << std::setprecision (3) << std::setw (12) << 1e-9 * t.ns * m_period
+         << std::setw (12) << t.samples * m_period
+         << std::setprecision (2) << std::setw (11) << 1e-3 * t.ns / t.samples
+         << std::setw (14) << static_cast<double> (t.scheduled) / t.samples
+         << std::setw (14) << static_cast<double> (t.allocations) / t.samples
+         << "  " << i->first << std::endl;
+    }
+
+  os << "Per-node profile, estimated:" << std::endl
+     << "    node   %time     time(s)      events  hottest functions" << std::endl;
+  for (std::map<uint32_t, Total>::const_iterator i = byNode.begin (); i != byNode.end (); ++i)
+    {
+      const Total &t = i->second;
+      os << std::setw (8);
+      if (i->first == Simulator::NO_CONTEXT)
+        {
+          os << "-";
+        }
+      else
+        {
+          os << i->first;
+        }
+      os << std::setprecision (2) << std::setw (8) << 100.0 * t.ns / std::max<uint64_t> (total.ns, 1)
+         << std::setprecision (3) << std::setw (12) << 1e-9 * t.ns * m_period
+         << std::setw (12) << t.samples * m_period << " ";
+      const std::map<std::string, Total> &nodeFunctions = byNodeFunction.find (i->first)->second;
+      std::vector<std::pair<std::string, Total> > top (nodeFunctions.begin (), nodeFunctions.end ());
+      std::sort (top.begin (), top.end (), MoreTime);
+      for (uint32_t j = 0; j < top.size () && j < TOP_FUNCTIONS_BY_NODE; j++)
+        {
+          os << (j == 0 ? " " : ", ") << top[j].first << " ("
+             << std::setprecision (0) << 100.0 * top[j].second.ns / std::max<uint64_t> (t.ns, 1) << "%)";
+        }
+      os << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+} // namespace ns3
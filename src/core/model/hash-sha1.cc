@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy, memset
+
+#include "log.h"
+#include "hash-sha1.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Sha1 implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Hash-Sha1");
+
+namespace Hash {
+
+namespace Function {
+
+namespace {
+
+/**
+ * \param x word to rotate
+ * \param n number of bits
+ * \return x rotated left by n bits
+ */
+inline uint32_t
+Rotl (uint32_t x, int n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+/**
+ * \param p 4 bytes in network order
+ * \return the decoded word
+ */
+inline uint32_t
+ReadBe32 (const uint8_t * p)
+{
+  return (static_cast<uint32_t> (p[0]) << 24) | (static_cast<uint32_t> (p[1]) << 16)
+         | (static_cast<uint32_t> (p[2]) << 8) | static_cast<uint32_t> (p[3]);
+}
+
+/**
+ * \param p where to write 4 bytes in network order
+ * \param x word to encode
+ */
+inline void
+WriteBe32 (uint8_t * p, uint32_t x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+} // anonymous namespace
+
+const std::size_t Sha1::DIGEST_SIZE;
+const std::size_t Sha1::BLOCK_SIZE;
+
+Sha1::Sha1 ()
+{
+  clear ();
+}
+
+void
+Sha1::clear (void)
+{
+  m_state[0] = 0x67452301;
+  m_state[1] = 0xefcdab89;
+  m_state[2] = 0x98badcfe;
+  m_state[3] = 0x10325476;
+  m_state[4] = 0xc3d2e1f0;
+  m_length = 0;
+}
+
+void
+Sha1::Transform (const uint8_t * block)
+{
+  // 16 words rolling schedule instead of the 80 words of the standard
+  uint32_t w[16];
+  for (int i = 0; i < 16; ++i)
+    {
+      w[i] = ReadBe32 (block + 4 * i);
+    }
+
+  uint32_t a = m_state[0];
+  uint32_t b = m_state[1];
+  uint32_t c = m_state[2];
+  uint32_t d = m_state[3];
+  uint32_t e = m_state[4];
+
+  for (int i = 0; i < 80; ++i)
+    {
+      if (i >= 16)
+        {
+          w[i & 15] = Rotl (w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+        }
+      uint32_t f, k;
+      if (i < 20)
+        {
+          f = (b & c) | (~b & d);
+          k = 0x5a827999;
+        }
+      else if (i < 40)
+        {
+          f = b ^ c ^ d;
+          k = 0x6ed9eba1;
+        }
+      else if (i < 60)
+        {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8f1bbcdc;
+        }
+      else
+        {
+          f = b ^ c ^ d;
+          k = 0xca62c1d6;
+        }
+      uint32_t t = Rotl (a, 5) + f + e + k + w[i & 15];
+      e = d;
+      d = c;
+      c = Rotl (b, 30);
+      b = a;
+      a = t;
+    }
+
+  m_state[0] += a;
+  m_state[1] += b;
+  m_state[2] += c;
+  m_state[3] += d;
+  m_state[4] += e;
+}
+
+void
+Sha1::Update (const uint8_t * data, std::size_t size)
+{
+  std::size_t used = m_length % BLOCK_SIZE;
+  m_length += size;
+
+  if (used)
+    {
+      std::size_t fill = std::min (size, BLOCK_SIZE - used);
+      memcpy (m_block + used, data, fill);
+      data += fill;
+      size -= fill;
+      if (used + fill < BLOCK_SIZE)
+        {
+          return;
+        }
+      Transform (m_block);
+    }
+  for (; size >= BLOCK_SIZE; data += BLOCK_SIZE, size -= BLOCK_SIZE)
+    {
+      Transform (data);
+    }
+  memcpy (m_block, data, size);
+}
+
+void
+Sha1::Final (uint8_t digest[DIGEST_SIZE]) const
+{
+  // Pad a copy so that the caller may keep on hashing
+  Sha1 ctx (*this);
+  uint64_t bits = m_length * 8;
+  uint8_t pad[BLOCK_SIZE + 8];
+  std::size_t padLen = BLOCK_SIZE - ((m_length + 8) % BLOCK_SIZE);
+  memset (pad, 0, sizeof (pad));
+  pad[0] = 0x80;
+  for (int i = 0; i < 8; ++i)
+    {
+      pad[padLen + i] = bits >> (56 - 8 * i);
+    }
+  ctx.Update (pad, padLen + 8);
+
+  for (int i = 0; i < 5; ++i)
+    {
+      WriteBe32 (digest + 4 * i, ctx.m_state[i]);
+    }
+}
+
+uint32_t
+Sha1::GetHash32  (const char * buffer, const std::size_t size)
+{
+  uint8_t digest[DIGEST_SIZE];
+  Update (reinterpret_cast<const uint8_t *> (buffer), size);
+  Final (digest);
+  return ReadBe32 (digest);
+}
+
+uint64_t
+Sha1::GetHash64  (const char * buffer, const std::size_t size)
+{
+  uint8_t digest[DIGEST_SIZE];
+  Update (reinterpret_cast<const uint8_t *> (buffer), size);
+  Final (digest);
+  return (static_cast<uint64_t> (ReadBe32 (digest)) << 32) | ReadBe32 (digest + 4);
+}
+
+void
+Sha1::Digest (const uint8_t * data, std::size_t size, uint8_t digest[DIGEST_SIZE])
+{
+  Sha1 ctx;
+  ctx.Update (data, size);
+  ctx.Final (digest);
+}
+
+void
+Sha1::Hmac (const uint8_t * key, std::size_t keySize,
+            const uint8_t * msg, std::size_t msgSize,
+            uint8_t mac[DIGEST_SIZE])
+{
+  NS_LOG_FUNCTION (keySize << msgSize);
+  uint8_t pad[BLOCK_SIZE];
+  memset (pad, 0, sizeof (pad));
+  if (keySize > BLOCK_SIZE)
+    {
+      Digest (key, keySize, pad);
+    }
+  else
+    {
+      memcpy (pad, key, keySize);
+    }
+
+  Sha1 inner;
+  for (std::size_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      pad[i] ^= 0x36;
+    }
+  inner.Update (pad, BLOCK_SIZE);
+  inner.Update (msg, msgSize);
+  inner.Final (mac);
+
+  Sha1 outer;
+  for (std::size_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      pad[i] ^= 0x36 ^ 0x5c;
+    }
+  outer.Update (pad, BLOCK_SIZE);
+  outer.Update (mac, DIGEST_SIZE);
+  outer.Final (mac);
+}
+
+}  // namespace Function
+
+}  // namespace Hash
+
+}  // namespace ns3
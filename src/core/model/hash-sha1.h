@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+
+#ifndef HASH_SHA1_H
+#define HASH_SHA1_H
+
+#include <stdint.h>
+#include "hash-function.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Sha1 declaration.
+ */
+
+namespace ns3 {
+
+namespace Hash {
+
+namespace Function {
+
+/**
+ *  \ingroup hash
+ *
+ *  \brief SHA-1 hash function implementation (FIPS 180-4)
+ *
+ *  Besides the Hash::Implementation interface, where the 32 and 64-bit
+ *  hashes are the leftmost bits of the digest read in network order,
+ *  the class exposes the full 160-bit digest and HMAC-SHA1 (\rfc{2104}),
+ *  as needed by the MPTCP token, IDSN and MP_JOIN authentication.
+ *
+ *  The context lives in the object and no memory is ever allocated,
+ *  so the static Digest and Hmac helpers can run on the stack.
+ */
+class Sha1 : public Implementation
+{
+public:
+  /** Size of the digest, in bytes */
+  static const std::size_t DIGEST_SIZE = 20;
+  /** Size of a message block, in bytes */
+  static const std::size_t BLOCK_SIZE = 64;
+
+  /**
+   * Constructor
+   */
+  Sha1 ();
+  /**
+   * Compute 32-bit hash of a byte buffer
+   *
+   * Call clear () between calls to GetHash32() to reset the
+   * internal state and hash each buffer separately.
+   *
+   * If you don't call clear() between calls to GetHash32,
+   * you can hash successive buffers.  The final return value
+   * will be the cumulative hash across all calls.
+   *
+   * \param [in] buffer pointer to the beginning of the buffer
+   * \param [in] size length of the buffer, in bytes
+   * \return most significant 32 bits of the digest
+   */
+  uint32_t  GetHash32  (const char * buffer, const std::size_t size);
+  /**
+   * Compute 64-bit hash of a byte buffer.
+   *
+   * \copydetails GetHash32
+   */
+  uint64_t  GetHash64  (const char * buffer, const std::size_t size);
+  /**
+   * Restore initial state
+   */
+  virtual void clear (void);
+
+  /**
+   * Append bytes to the message being hashed
+   *
+   * \param [in] data pointer to the beginning of the bytes
+   * \param [in] size number of bytes
+   */
+  void Update (const uint8_t * data, std::size_t size);
+  /**
+   * Compute the digest of the bytes appended so far
+   *
+   * The internal state is left untouched, hence more bytes may be
+   * appended afterwards.
+   *
+   * \param [out] digest the DIGEST_SIZE bytes of the digest
+   */
+  void Final (uint8_t digest[DIGEST_SIZE]) const;
+
+  /**
+   * \brief One shot digest of a buffer
+   * \param [in] data pointer to the beginning of the buffer
+   * \param [in] size length of the buffer, in bytes
+   * \param [out] digest the DIGEST_SIZE bytes of the digest
+   */
+  static void Digest (const uint8_t * data, std::size_t size, uint8_t digest[DIGEST_SIZE]);
+  /**
+   * \brief HMAC-SHA1 of a message, see \rfc{2104}
+   * \param [in] key pointer to the key
+   * \param [in] keySize length of the key, in bytes
+   * \param [in] msg pointer to the message
+   * \param [in] msgSize length of the message, in bytes
+   * \param [out] mac the DIGEST_SIZE bytes of the HMAC
+   */
+  static void Hmac (const uint8_t * key, std::size_t keySize,
+                    const uint8_t * msg, std::size_t msgSize,
+                    uint8_t mac[DIGEST_SIZE]);
+
+private:
+  /**
+   * Process one full message block
+   * \param [in] block BLOCK_SIZE bytes of the message
+   */
+  void Transform (const uint8_t * block);
+
+  uint32_t m_state[5];            //!< Intermediate hash value
+  uint64_t m_length;              //!< Number of bytes hashed so far
+  uint8_t m_block[BLOCK_SIZE];    //!< Bytes waiting for a full block
+
+};  // class Sha1
+
+}  // namespace Function
+
+}  // namespace Hash
+
+}  // namespace ns3
+
+#endif  /* HASH_SHA1_H */
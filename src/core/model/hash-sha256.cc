@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+
+#include <algorithm>  // std::min
+#include <cstring>  // memcpy, memset
+
+#include "log.h"
+#include "hash-sha256.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Sha256 implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Hash-Sha256");
+
+namespace Hash {
+
+namespace Function {
+
+namespace {
+
+/**
+ * \param x word to rotate
+ * \param n number of bits
+ * \return x rotated right by n bits
+ */
+inline uint32_t
+Rotr (uint32_t x, int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+/**
+ * \param p 4 bytes in network order
+ * \return the decoded word
+ */
+inline uint32_t
+ReadBe32 (const uint8_t * p)
+{
+  return (static_cast<uint32_t> (p[0]) << 24) | (static_cast<uint32_t> (p[1]) << 16)
+         | (static_cast<uint32_t> (p[2]) << 8) | static_cast<uint32_t> (p[3]);
+}
+
+/**
+ * \param p where to write 4 bytes in network order
+ * \param x word to encode
+ */
+inline void
+WriteBe32 (uint8_t * p, uint32_t x)
+{
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+} // anonymous namespace
+
+const std::size_t Sha256::DIGEST_SIZE;
+const std::size_t Sha256::BLOCK_SIZE;
+
+Sha256::Sha256 ()
+{
+  clear ();
+}
+
+void
+Sha256::clear (void)
+{
+  m_state[0] = 0x6a09e667;
+  m_state[1] = 0xbb67ae85;
+  m_state[2] = 0x3c6ef372;
+  m_state[3] = 0xa54ff53a;
+  m_state[4] = 0x510e527f;
+  m_state[5] = 0x9b05688c;
+  m_state[6] = 0x1f83d9ab;
+  m_state[7] = 0x5be0cd19;
+  m_length = 0;
+}
+
+void
+Sha256::Transform (const uint8_t * block)
+{
+  static const uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+  };
+
+  // 16 words rolling schedule instead of the 64 words of the standard
+  uint32_t w[16];
+  for (int i = 0; i < 16; ++i)
+    {
+      w[i] = ReadBe32 (block + 4 * i);
+    }
+
+  uint32_t a = m_state[0];
+  uint32_t b = m_state[1];
+  uint32_t c = m_state[2];
+  uint32_t d = m_state[3];
+  uint32_t e = m_state[4];
+  uint32_t f = m_state[5];
+  uint32_t g = m_state[6];
+  uint32_t h = m_state[7];
+
+  for (int i = 0; i < 64; ++i)
+    {
+      if (i >= 16)
+        {
+          uint32_t w15 = w[(i + 1) & 15];
+          uint32_t w2 = w[(i + 14) & 15];
+          uint32_t s0 = Rotr (w15, 7) ^ Rotr (w15, 18) ^ (w15 >> 3);
+          uint32_t s1 = Rotr (w2, 17) ^ Rotr (w2, 19) ^ (w2 >> 10);
+          w[i & 15] += s0 + w[(i + 9) & 15] + s1;
+        }
+      uint32_t t1 = h + (Rotr (e, 6) ^ Rotr (e, 11) ^ Rotr (e, 25))
+        + ((e & f) ^ (~e & g)) + k[i] + w[i & 15];
+      uint32_t t2 = (Rotr (a, 2) ^ Rotr (a, 13) ^ Rotr (a, 22))
+        + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+  m_state[0] += a;
+  m_state[1] += b;
+  m_state[2] += c;
+  m_state[3] += d;
+  m_state[4] += e;
+  m_state[5] += f;
+  m_state[6] += g;
+  m_state[7] += h;
+}
+
+void
+Sha256::Update (const uint8_t * data, std::size_t size)
+{
+  std::size_t used = m_length % BLOCK_SIZE;
+  m_length += size;
+
+  if (used)
+    {
+      std::size_t fill = std::min (size, BLOCK_SIZE - used);
+      memcpy (m_block + used, data, fill);
+      data += fill;
+      size -= fill;
+      if (used + fill < BLOCK_SIZE)
+        {
+          return;
+        }
+      Transform (m_block);
+    }
+  for (; size >= BLOCK_SIZE; data += BLOCK_SIZE, size -= BLOCK_SIZE)
+    {
+      Transform (data);
+    }
+  memcpy (m_block, data, size);
+}
+
+void
+Sha256::Final (uint8_t digest[DIGEST_SIZE]) const
+{
+  // Pad a copy so that the caller may keep on hashing
+  Sha256 ctx (*this);
+  uint64_t bits = m_length * 8;
+  uint8_t pad[BLOCK_SIZE + 8];
+  std::size_t padLen = BLOCK_SIZE - ((m_length + 8) % BLOCK_SIZE);
+  memset (pad, 0, sizeof (pad));
+  pad[0] = 0x80;
+  for (int i = 0; i < 8; ++i)
+    {
+      pad[padLen + i] = bits >> (56 - 8 * i);
+    }
+  ctx.Update (pad, padLen + 8);
+
+  for (int i = 0; i < 8; ++i)
+    {
+      WriteBe32 (digest + 4 * i, ctx.m_state[i]);
+    }
+}
+
+uint32_t
+Sha256::GetHash32  (const char * buffer, const std::size_t size)
+{
+  uint8_t digest[DIGEST_SIZE];
+  Update (reinterpret_cast<const uint8_t *> (buffer), size);
+  Final (digest);
+  return ReadBe32 (digest);
+}
+
+uint64_t
+Sha256::GetHash64  (const char * buffer, const std::size_t size)
+{
+  uint8_t digest[DIGEST_SIZE];
+  Update (reinterpret_cast<const uint8_t *> (buffer), size);
+  Final (digest);
+  return (static_cast<uint64_t> (ReadBe32 (digest)) << 32) | ReadBe32 (digest + 4);
+}
+
+void
+Sha256::Digest (const uint8_t * data, std::size_t size, uint8_t digest[DIGEST_SIZE])
+{
+  Sha256 ctx;
+  ctx.Update (data, size);
+  ctx.Final (digest);
+}
+
+void
+Sha256::Hmac (const uint8_t * key, std::size_t keySize,
+            const uint8_t * msg, std::size_t msgSize,
+            uint8_t mac[DIGEST_SIZE])
+{
+  NS_LOG_FUNCTION (keySize << msgSize);
+  uint8_t pad[BLOCK_SIZE];
+  memset (pad, 0, sizeof (pad));
+  if (keySize > BLOCK_SIZE)
+    {
+      Digest (key, keySize, pad);
+    }
+  else
+    {
+      memcpy (pad, key, keySize);
+    }
+
+  Sha256 inner;
+  for (std::size_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      pad[i] ^= 0x36;
+    }
+  inner.Update (pad, BLOCK_SIZE);
+  inner.Update (msg, msgSize);
+  inner.Final (mac);
+
+  Sha256 outer;
+  for (std::size_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      pad[i] ^= 0x36 ^ 0x5c;
+    }
+  outer.Update (pad, BLOCK_SIZE);
+  outer.Update (mac, DIGEST_SIZE);
+  outer.Final (mac);
+}
+
+}  // namespace Function
+
+}  // namespace Hash
+
+}  // namespace ns3
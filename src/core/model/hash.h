@@ -29,6 +29,8 @@
 #include "hash-function.h"
 #include "hash-murmur3.h"
 #include "hash-fnv.h"
+#include "hash-sha1.h"
+#include "hash-sha256.h"
 
 /**
  * \file
@@ -126,6 +126,8 @@ HeapScheduler::Exch (std::size_t a, std::size_t b)
   Event tmp (m_heap[a]);
   m_heap[a] = m_heap[b];
   m_heap[b] = tmp;
+  m_index[m_heap[a].key.m_uid] = a;
+  m_index[m_heap[b].key.m_uid] = b;
 }
 
 bool
@@ -150,10 +152,10 @@ HeapScheduler::IsEmpty (void) const
 }
 
 void
-HeapScheduler::BottomUp (void)
+HeapScheduler::BottomUp (std::size_t start)
 {
-  NS_LOG_FUNCTION (this);
-  std::size_t index = Last ();
+  NS_LOG_FUNCTION (this << start);
+  std::size_t index = start;
   while (!IsRoot (index)
          && IsLessStrictly (index, Parent (index)))
     {
@@ -203,7 +205,8 @@ HeapScheduler::Insert (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
   m_heap.push_back (ev);
-  BottomUp ();
+  m_index[ev.key.m_uid] = Last ();
+  BottomUp (Last ());
 }
 
 Scheduler::Event
@@ -219,6 +222,7 @@ HeapScheduler::RemoveNext (void)
   Event next = m_heap[Root ()];
   Exch (Root (), Last ());
   m_heap.pop_back ();
+  m_index.erase (next.key.m_uid);
   TopDown (Root ());
   return next;
 }
@@ -228,20 +232,61 @@ void
 HeapScheduler::Remove (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
-  std::size_t uid = ev.key.m_uid;
-  for (std::size_t i = 1; i < m_heap.size (); i++)
+  std::unordered_map<uint32_t, std::size_t>::iterator index = m_index.find (ev.key.m_uid);
+  NS_ASSERT (index != m_index.end ());
+  std::size_t i = index->second;
+  NS_ASSERT (m_heap[i].impl == ev.impl);
+  Exch (i, Last ());
+  m_heap.pop_back ();
+  m_index.erase (ev.key.m_uid);
+  if (i <= Last ())
     {
-      if (uid == m_heap[i].key.m_uid)
+      // the former last item may belong above or below i
+      TopDown (i);
+      BottomUp (i);
+    }
+}
+
+void
+HeapScheduler::Reschedule (const Event &ev, const EventKey &newKey)
+{
+  NS_LOG_FUNCTION (this << &ev << newKey.m_ts);
+  std::unordered_map<uint32_t, std::size_t>::iterator index = m_index.find (ev.key.m_uid);
+  NS_ASSERT (index != m_index.end ());
+  std::size_t i = index->second;
+  NS_ASSERT (m_heap[i].impl == ev.impl);
+  m_index.erase (index);
+  m_index[newKey.m_uid] = i;
+  // decrease or increase the key in place
+  m_heap[i].key = newKey;
+  TopDown (i);
+  BottomUp (i);
+}
+
+void
+HeapScheduler::RemoveCancelled (std::vector<Scheduler::Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  std::size_t last = Root ();
+  for (std::size_t i = Root (); i < m_heap.size (); i++)
+    {
+      if (m_heap[i].impl->IsCancelled ())
         {
-          NS_ASSERT (m_heap[i].impl == ev.impl);
-          Exch (i, Last ());
-          m_heap.pop_back ();
-          TopDown (i);
-          return;
+          cancelled.push_back (m_heap[i]);
+          m_index.erase (m_heap[i].key.m_uid);
+        }
+      else
+        {
+          m_index[m_heap[i].key.m_uid] = last;
+          m_heap[last++] = m_heap[i];
         }
     }
-  NS_ASSERT (false);
+  m_heap.resize (last);
+  // rebuild the heap from the bottom, in linear time
+  for (std::size_t i = Parent (Last ()); i >= Root (); i--)
+    {
+      TopDown (i);
+    }
 }
 
 } // namespace ns3
-
@@ -24,6 +24,7 @@
 #include "scheduler.h"
 #include <stdint.h>
 #include <vector>
+#include <unordered_map>
 
 /**
  * \file
@@ -49,6 +50,8 @@ namespace ns3 {
  *    the index of the root is 1.
  *  - It uses a slightly non-standard while loop for top-down heapify
  *    to move one if statement out of the loop.
+ *  - It keeps the index of each event in the heap, by uid, so that an
+ *    event is removed or rescheduled in O(log(n)) without searching it.
  */
 class HeapScheduler : public Scheduler
 {
@@ -70,6 +73,8 @@ public:
   virtual Scheduler::Event PeekNext (void) const;
   virtual Scheduler::Event RemoveNext (void);
   virtual void Remove (const Scheduler::Event &ev);
+  virtual void Reschedule (const Scheduler::Event &ev, const Scheduler::EventKey &newKey);
+  virtual void RemoveCancelled (std::vector<Scheduler::Event> &cancelled);
 
 private:
   /** Event list type:  vector of Events, managed as a heap. */
@@ -151,8 +156,12 @@ private:
    * \param [in] b The second item.
    */
   inline void Exch (std::size_t a, std::size_t b);
-  /** Percolate a newly inserted Last item to its proper position. */ 
-  void BottomUp (void);
+  /**
+   * Percolate an item up to its proper position.
+   *
+   * \param [in] start The index of the item, Last when it was just inserted.
+   */
+  void BottomUp (std::size_t start);
   /**
    * Percolate a deletion bubble down the heap.
    *
@@ -162,6 +171,8 @@ private:
 
   /** The event list. */
   BinaryHeap m_heap;
+  /** The index in m_heap of each event, by uid. */
+  std::unordered_map<uint32_t, std::size_t> m_index;
 };
 
 } // namespace ns3
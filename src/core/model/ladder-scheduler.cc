@@ -0,0 +1,390 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+/**
+ * \ingroup scheduler
+ * Order of the events in Bottom: latest first.
+ *
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \c a is later than \c b
+ */
+static bool
+EventIsLater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key > b.key;
+}
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart (uint32_t rung) const
+{
+  const Rung &r = m_rungs[rung];
+  return r.start + r.current * r.width;
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  // a rung covers what its parent was dequeuing when it was spawned,
+  // so the first rung whose current bucket is not later than ts is the right one
+  uint32_t i = 0;
+  while (i < m_nRungs && ts < CurrentStart (i))
+    {
+      i++;
+    }
+  return i;
+}
+
+void
+LadderScheduler::SpawnRung (uint64_t start, uint64_t span, const Bucket &events)
+{
+  NS_LOG_FUNCTION (this << start << span << events.size ());
+  NS_ASSERT (m_nRungs < MAX_RUNGS && span > 0 && !events.empty ());
+
+  Rung &r = m_rungs[m_nRungs++];
+  uint64_t nBuckets = std::min<uint64_t> (events.size (), MAX_BUCKETS);
+  r.width = span / nBuckets + (span % nBuckets ? 1 : 0);
+  r.nBuckets = (span + r.width - 1) / r.width;
+  r.start = start;
+  r.current = 0;
+  if (r.buckets.size () < r.nBuckets)
+    {
+      r.buckets.resize (r.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      uint64_t bucket = (i->key.m_ts - start) / r.width;
+      NS_ASSERT (bucket < r.nBuckets);
+      r.buckets[bucket].push_back (*i);
+    }
+}
+
+void
+LadderScheduler::TransferTop (void)
+{
+  NS_LOG_FUNCTION (this << m_top.size ());
+  NS_ASSERT (m_nRungs == 0 && m_bottom.empty ());
+  DropMovedFromTop ();
+  NS_ASSERT (!m_top.empty ());
+
+  uint64_t minTs = m_top.front ().key.m_ts;
+  uint64_t maxTs = minTs;
+  for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+    {
+      minTs = std::min (minTs, i->key.m_ts);
+      maxTs = std::max (maxTs, i->key.m_ts);
+    }
+
+  if (m_top.size () <= THRESHOLD)
+    {
+      m_bottom.swap (m_top);
+      std::sort (m_bottom.begin (), m_bottom.end (), EventIsLater);
+      m_topStart = maxTs + 1;
+    }
+  else
+    {
+      // the bucket width is the mean spacing of the events
+      SpawnRung (minTs, maxTs - minTs + 1, m_top);
+      const Rung &r = m_rungs[0];
+      m_topStart = r.start + r.nBuckets * r.width;
+      m_top.clear ();
+    }
+  NS_LOG_LOGIC ("top starts at " << m_topStart);
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          TransferTop ();
+          continue;
+        }
+      Rung &r = m_rungs[m_nRungs - 1];
+      while (r.current < r.nBuckets && r.buckets[r.current].empty ())
+        {
+          r.current++;
+        }
+      if (r.current == r.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = r.buckets[r.current];
+      uint64_t bucketStart = CurrentStart (m_nRungs - 1);
+      r.current++;
+      if (bucket.size () > THRESHOLD && r.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+          SpawnRung (bucketStart, r.width, bucket);
+          bucket.clear ();
+        }
+      else
+        {
+          // the bucket gets the storage of the empty bottom
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (), EventIsLater);
+        }
+    }
+}
+
+void
+LadderScheduler::InsertBottom (const Scheduler::Event &ev)
+{
+  Bucket::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, EventIsLater);
+  m_bottom.insert (i, ev);
+
+  if (m_bottom.size () > THRESHOLD && m_nRungs < MAX_RUNGS)
+    {
+      // many events were scheduled in the near future, spread them over a
+      // rung ending where the lowest rung, or Top, resumes
+      uint64_t end = m_nRungs ? CurrentStart (m_nRungs - 1) : m_topStart;
+      uint64_t start = m_bottom.back ().key.m_ts;
+      if (end - start > 1)
+        {
+          SpawnRung (start, end - start, m_bottom);
+          m_bottom.clear ();
+        }
+    }
+}
+
+bool
+LadderScheduler::RemoveFromBucket (Bucket &bucket, const Scheduler::Event &ev)
+{
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::RemoveCancelledFromBucket (Bucket &bucket, std::vector<Scheduler::Event> &cancelled)
+{
+  Bucket::iterator last = bucket.begin ();
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (i->impl->IsCancelled ())
+        {
+          cancelled.push_back (*i);
+        }
+      else
+        {
+          *last++ = *i;
+        }
+    }
+  bucket.erase (last, bucket.end ());
+}
+
+void
+LadderScheduler::DropMovedFromTop (void)
+{
+  if (m_movedFromTop.empty ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_movedFromTop.size ());
+  Bucket::iterator last = m_top.begin ();
+  for (Bucket::iterator i = m_top.begin (); i != m_top.end (); ++i)
+    {
+      if (m_movedFromTop.erase (i->key.m_uid) == 0)
+        {
+          *last++ = *i;
+        }
+    }
+  m_top.erase (last, m_top.end ());
+  NS_ASSERT (m_movedFromTop.empty ());
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+    }
+  else
+    {
+      uint32_t rung = FindRung (ts);
+      if (rung < m_nRungs)
+        {
+          Rung &r = m_rungs[rung];
+          uint64_t bucket = (ts - r.start) / r.width;
+          NS_ASSERT (bucket < r.nBuckets);
+          r.buckets[bucket].push_back (ev);
+        }
+      else
+        {
+          InsertBottom (ev);
+        }
+    }
+  m_size++;
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  // moving events down the ladder does not change the content
+  const_cast<LadderScheduler *> (this)->FillBottom ();
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  FillBottom ();
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_size--;
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  bool found;
+  if (ts >= m_topStart)
+    {
+      found = RemoveFromBucket (m_top, ev);
+    }
+  else
+    {
+      uint32_t rung = FindRung (ts);
+      if (rung < m_nRungs)
+        {
+          Rung &r = m_rungs[rung];
+          found = RemoveFromBucket (r.buckets[(ts - r.start) / r.width], ev);
+        }
+      else
+        {
+          Bucket::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, EventIsLater);
+          found = i != m_bottom.end () && i->key.m_uid == ev.key.m_uid;
+          if (found)
+            {
+              m_bottom.erase (i);
+            }
+        }
+    }
+  NS_ASSERT (found);
+  m_size--;
+}
+
+void
+LadderScheduler::Reschedule (const Event &ev, const EventKey &newKey)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << newKey.m_ts);
+  NS_ASSERT (!IsEmpty ());
+  if (ev.key.m_ts < m_topStart)
+    {
+      // the buckets of the ladder and Bottom are small
+      Scheduler::Reschedule (ev, newKey);
+      return;
+    }
+  m_movedFromTop.insert (ev.key.m_uid);
+  Event moved = ev;
+  moved.key = newKey;
+  Insert (moved);
+  // the entry left in Top does not count
+  m_size--;
+}
+
+void
+LadderScheduler::RemoveCancelled (std::vector<Scheduler::Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  // the moved entries share their event with the live ones
+  DropMovedFromTop ();
+  std::size_t before = cancelled.size ();
+  RemoveCancelledFromBucket (m_top, cancelled);
+  for (uint32_t rung = 0; rung < m_nRungs; rung++)
+    {
+      Rung &r = m_rungs[rung];
+      for (uint32_t bucket = r.current; bucket < r.nBuckets; bucket++)
+        {
+          RemoveCancelledFromBucket (r.buckets[bucket], cancelled);
+        }
+    }
+  RemoveCancelledFromBucket (m_bottom, cancelled);
+  m_size -= cancelled.size () - before;
+}
+
+} // namespace ns3
@@ -52,6 +52,10 @@ protected:
     {
       (*m_function)();
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
 private:
     F m_function;
   } *ev = new EventFunctionImpl0 (f);
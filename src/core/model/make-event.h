@@ -317,6 +317,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 #include "event-impl.h"
 #include "type-traits.h"
 
+#include <algorithm>
+#include <cstring>
+#include <typeinfo>
+
 namespace ns3 {
 
 /**
@@ -355,6 +359,25 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup events
+ * Helper for the GetFunction() methods of the events made by MakeEvent.
+ *
+ * \tparam F \deduced The function or class method pointer type.
+ * \param [in] object The dynamic type of the object of a class method,
+ *             0 for a function.
+ * \param [in] function The function or class method pointer.
+ * \returns The function called by the event.
+ */
+template <typename F>
+EventImpl::Function
+MakeEventFunction (const std::type_info *object, F function)
+{
+  EventImpl::Function f = { object, { 0, 0 } };
+  std::memcpy (f.pointer, &function, std::min (sizeof (F), sizeof (f.pointer)));
+  return f;
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -375,6 +398,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -405,6 +432,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -436,6 +467,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -469,6 +504,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -504,6 +543,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -542,6 +585,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -582,6 +629,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (&typeid (EventMemberImplObjTraits<OBJ>::GetReference (m_obj)), m_function);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -617,6 +668,10 @@ private:
     {
       (*m_function)(m_a1);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -647,6 +702,10 @@ private:
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -680,6 +739,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -715,6 +778,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -752,6 +819,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -791,6 +862,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual EventImpl::Function GetFunction (void) const
+    {
+      return MakeEventFunction (0, m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -89,6 +89,7 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_currentUid = 0;
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
+  m_eventCount = 0;
   m_unscheduledEvents = 0;
 
   m_main = SystemThread::Self();
@@ -349,6 +350,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
+    m_eventCount++;
 
     // 
     // We're about to run the event and we've done our best to synchronize this
@@ -755,6 +757,36 @@ RealtimeSimulatorImpl::Cancel (const EventId &id)
     }
 }
 
+EventId
+RealtimeSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay);
+
+  Scheduler::EventKey key;
+  EventImpl *impl = id.PeekEventImpl ();
+  {
+    CriticalSection cs (m_mutex);
+    NS_ASSERT_MSG (id.GetUid () != 2 && !IsExpired (id),
+                   "RealtimeSimulatorImpl::Reschedule(): Event not pending");
+    NS_ASSERT_MSG (delay.IsPositive (), "RealtimeSimulatorImpl::Reschedule(): Negative delay");
+    Time tAbsolute = Simulator::Now () + delay;
+
+    Scheduler::Event ev;
+    ev.impl = impl;
+    ev.key.m_ts = id.GetTs ();
+    ev.key.m_context = id.GetContext ();
+    ev.key.m_uid = id.GetUid ();
+    key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+    key.m_context = ev.key.m_context;
+    key.m_uid = m_uid;
+    m_uid++;
+    m_events->Reschedule (ev, key);
+    m_synchronizer->Signal ();
+  }
+
+  return EventId (impl, key.m_ts, key.m_context, key.m_uid);
+}
+
 bool
 RealtimeSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -817,6 +849,12 @@ RealtimeSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+RealtimeSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 void 
 RealtimeSimulatorImpl::SetSynchronizationMode (enum SynchronizationMode mode)
 {
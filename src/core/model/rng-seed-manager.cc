@@ -24,6 +24,8 @@
 #include "config.h"
 #include "log.h"
 
+#include <atomic>
+
 /**
  * \file
  * \ingroup randomvariable
@@ -37,9 +39,15 @@ NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
 /**
  * \relates RngSeedManager
  * The next random number generator stream number to use
- * for automatic assignment.
+ * for automatic assignment. Random variables may be created
+ * by several simulation threads at once.
+ */
+static std::atomic<uint64_t> g_nextStreamIndex (0);
+/**
+ * \relates RngSeedManager
+ * The next stream number of the calling thread, if it has its own.
  */
-static uint64_t g_nextStreamIndex = 0;
+static thread_local uint64_t *g_threadStreamIndex = 0;
 /**
  * \relates RngSeedManager
  * The random number generator seed number global value.  This is used to
@@ -100,9 +108,17 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
-  return next;
+  if (g_threadStreamIndex != 0)
+    {
+      return (*g_threadStreamIndex)++;
+    }
+  return g_nextStreamIndex++;
+}
+
+void RngSeedManager::SetThreadStreamCounter (uint64_t *counter)
+{
+  NS_LOG_FUNCTION (counter);
+  g_threadStreamIndex = counter;
 }
 
 } // namespace ns3
@@ -105,6 +105,20 @@ public:
    */
   static uint64_t GetNextStreamIndex(void);
 
+  /**
+   * Assign the streams of the random variables created by the calling
+   * thread from a counter of its own.
+   *
+   * The global counter is shared by all the threads, so the streams it
+   * assigns depend on how the threads interleave. A simulator running
+   * groups of nodes in several threads gives each group a counter, whose
+   * high bits identify the group, to assign the same streams in every run.
+   *
+   * \param [in] counter The next stream index, incremented for each
+   *             assignment, or 0 to use the global counter again.
+   */
+  static void SetThreadStreamCounter (uint64_t *counter);
+
 };
 
 /** Alias for compatibility. */
@@ -19,6 +19,7 @@
  */
 
 #include "scheduler.h"
+#include "event-impl.h"
 #include "assert.h"
 #include "log.h"
 
@@ -49,4 +50,38 @@ Scheduler::GetTypeId (void)
   return tid;
 }
 
+void
+Scheduler::Reschedule (const Event &ev, const EventKey &newKey)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid << newKey.m_ts);
+  Remove (ev);
+  Event moved;
+  moved.impl = ev.impl;
+  moved.key = newKey;
+  Insert (moved);
+}
+
+void
+Scheduler::RemoveCancelled (std::vector<Event> &cancelled)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Event> live;
+  while (!IsEmpty ())
+    {
+      Event ev = RemoveNext ();
+      if (ev.impl->IsCancelled ())
+        {
+          cancelled.push_back (ev);
+        }
+      else
+        {
+          live.push_back (ev);
+        }
+    }
+  for (std::vector<Event>::const_iterator i = live.begin (); i != live.end (); ++i)
+    {
+      Insert (*i);
+    }
+}
+
 } // namespace ns3
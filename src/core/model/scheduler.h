@@ -22,6 +22,7 @@
 #define SCHEDULER_H
 
 #include <stdint.h>
+#include <vector>
 #include "object.h"
 
 /**
@@ -135,6 +136,37 @@ public:
    * \param [in] ev The event to remove
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * Move a specific event to a new position in the event list.
+   *
+   * The event keeps its EventImpl, hence the reference the event list
+   * holds on it. The default implementation removes the event and
+   * inserts it again with its new key; subclasses override it when they
+   * can do better than Remove(), which is linear in some of them.
+   * Timers pushed back on every packet call this method often, so it
+   * should not cost more than inserting an event.
+   *
+   * This method cannot be invoked if the list is empty.
+   *
+   * \param [in] ev The event to move.
+   * \param [in] newKey The new key of the event.
+   */
+  virtual void Reschedule (const Event &ev, const EventKey &newKey);
+  /**
+   * Remove all the cancelled events from the event list.
+   *
+   * EventImpl::Cancel only marks an event, which otherwise stays in the
+   * event list until it is removed by RemoveNext(). This method gets rid
+   * of them at once, in a single pass over the event list for the
+   * subclasses which override it. The default implementation removes all
+   * the events and inserts the live ones again.
+   *
+   * As with the other Remove methods, the caller is responsible for
+   * the references held on the EventImpl of the removed events.
+   *
+   * \param [out] cancelled The removed events are appended to this vector.
+   */
+  virtual void RemoveCancelled (std::vector<Event> &cancelled);
 };
 
 /**
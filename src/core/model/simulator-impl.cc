@@ -42,4 +42,10 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+bool
+SimulatorImpl::IsRemoteContext (uint32_t context) const
+{
+  return false;
+}
+
 } // namespace ns3
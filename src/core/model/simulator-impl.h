@@ -75,6 +75,8 @@ public:
   virtual void Remove (const EventId &id) = 0;
   /** \copydoc Simulator::Cancel */
   virtual void Cancel (const EventId &id) = 0;
+  /** \copydoc Simulator::Reschedule */
+  virtual EventId Reschedule (const EventId &id, const Time &delay) = 0;
   /** \copydoc Simulator::IsExpired */
   virtual bool IsExpired (const EventId &id) const = 0;
   /** \copydoc Simulator::Run */
@@ -99,6 +101,15 @@ public:
   virtual uint32_t GetSystemId () const = 0; 
   /** \copydoc Simulator::GetContext */
   virtual uint32_t GetContext (void) const = 0;
+  /** \copydoc Simulator::GetEventCount */
+  virtual uint64_t GetEventCount (void) const = 0;
+  /**
+   * \copydoc Simulator::IsRemoteContext
+   *
+   * The events of all the contexts are run by the same thread, unless
+   * a subclass overrides this method.
+   */
+  virtual bool IsRemoteContext (uint32_t context) const;
 };
 
 } // namespace ns3
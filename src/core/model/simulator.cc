@@ -352,6 +352,15 @@ Simulator::Cancel (const EventId &id)
   return GetImpl ()->Cancel (id);
 }
 
+EventId
+Simulator::Reschedule (const EventId &id, const Time &delay)
+{
+#ifdef ENABLE_DES_METRICS
+  DesMetrics::Get ()->Trace (Now (), delay);
+#endif
+  return GetImpl ()->Reschedule (id, delay);
+}
+
 bool 
 Simulator::IsExpired (const EventId &id)
 {
@@ -380,6 +389,18 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+uint64_t
+Simulator::GetEventCount (void)
+{
+  return GetImpl ()->GetEventCount ();
+}
+
+bool
+Simulator::IsRemoteContext (uint32_t context)
+{
+  return GetImpl ()->IsRemoteContext (context);
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
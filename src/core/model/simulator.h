@@ -184,6 +184,30 @@ public:
    */
   static uint32_t GetContext (void);
 
+  /**
+   * Get the number of events executed.
+   *
+   * Together with the wall clock time of a run, this gives the
+   * execution speed of the simulator.
+   *
+   * \returns The total number of events executed.
+   */
+  static uint64_t GetEventCount (void);
+
+  /**
+   * Check whether the events of a context are run by another thread
+   * than the current event.
+   *
+   * The objects handed over to such a context, like the packets sent
+   * to another node, must not be shared with the current context:
+   * they must be copied with their data, as by Packet::DeepCopy.
+   *
+   * @param [in] context The context, normally a node id.
+   * @returns \c true if the events of \p context are run by another
+   *          thread, which only happens with a multithreaded simulator.
+   */
+  static bool IsRemoteContext (uint32_t context);
+
   /**
    * Context enum values.
    *
@@ -1233,6 +1257,26 @@ public:
    */
   static void Cancel (const EventId &id);
 
+  /**
+   * Move an event to a new expiration time.
+   *
+   * This method has the same visible effect as cancelling the event
+   * and scheduling the same function with the same arguments again,
+   * but it moves the event in the event list instead of leaving a
+   * cancelled event behind, in place when the Scheduler supports it.
+   * It is meant for timers which are pushed back over and over.
+   * The event keeps its context.
+   *
+   * Once moved, the event is identified by the returned EventId only.
+   * Note that it is not possible to reschedule events which have
+   * expired or which were scheduled for the "destroy" time.
+   *
+   * @param [in] id The event to move.
+   * @param [in] delay The delay from now after which the event expires.
+   * @returns The EventId of the moved event.
+   */
+  static EventId Reschedule (const EventId &id, const Time &delay);
+
   /**
    * Check if an event has already run or been cancelled.
    *
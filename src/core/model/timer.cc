@@ -173,6 +173,28 @@ Timer::Schedule (Time delay)
   m_event = m_impl->Schedule (delay);
 }
 
+void
+Timer::Reschedule (void)
+{
+  NS_LOG_FUNCTION (this);
+  Reschedule (m_delay);
+}
+
+void
+Timer::Reschedule (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (m_impl != 0);
+  if (IsRunning ())
+    {
+      m_event = Simulator::Reschedule (m_event, delay);
+    }
+  else
+    {
+      m_event = m_impl->Schedule (delay);
+    }
+}
+
 void
 Timer::Suspend (void)
 {
@@ -248,6 +248,22 @@ public:
    * Timer::SetDelay), function, and arguments.
    */
   void Schedule (Time delay);
+  /**
+   * Push back or bring forward the timer using the currently-configured
+   * delay.
+   *
+   * \see Reschedule(Time)
+   */
+  void Reschedule (void);
+  /**
+   * \param [in] delay the delay to use
+   *
+   * If the timer is running, move its event to expire after the specified
+   * delay: the event keeps the arguments it was scheduled with, and no
+   * cancelled event is left in the event list as with Cancel followed by
+   * Schedule. Otherwise, schedule a new event as Schedule(Time) does.
+   */
+  void Reschedule (Time delay);
 
   /**
    * Cancel the timer and save the amount of time left until it was
@@ -18,7 +18,9 @@
  * Author: Peter D. Barnes, Jr. <pdbarnes@llnl.gov>
  */
 
+#include <cstring>
 #include <iomanip>
+#include <sstream>
 #include <string>
 
 #include "ns3/test.h"
@@ -258,6 +260,136 @@ Murmur3TestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup hash-tests
+ * Lowercase hexadecimal representation of a digest
+ * \param [in] digest the digest bytes
+ * \param [in] size the number of bytes
+ * \returns the hexadecimal string
+ */
+std::string
+ToHex (const uint8_t * digest, std::size_t size)
+{
+  std::ostringstream oss;
+  for (std::size_t i = 0; i < size; ++i)
+    {
+      oss << std::hex << std::setw (2) << std::setfill ('0')
+          << static_cast<uint32_t> (digest[i]);
+    }
+  return oss.str ();
+}
+
+/**
+ * \ingroup hash-tests
+ * Test SHA-1 and HMAC-SHA1 against the FIPS 180 and \rfc{2202} vectors
+ */
+class Sha1TestCase : public HashTestCase
+{
+public:
+  /** Constructor. */
+  Sha1TestCase ();
+  /** Destructor. */
+  virtual ~Sha1TestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+Sha1TestCase::Sha1TestCase ()
+  : HashTestCase ("Sha1: ")
+{
+}
+
+Sha1TestCase::~Sha1TestCase ()
+{
+}
+
+void
+Sha1TestCase::DoRun (void)
+{
+  Hasher hasher = Hasher ( Create<Hash::Function::Sha1> () );
+  hash32Reference = 0x02746702;  // Sha1(key)
+  Check ( "SHA1", hasher.clear ().GetHash32 (key));
+
+  hash64Reference = 0x027467025beb664bULL;
+  Check ( "SHA1", hasher.clear ().GetHash64 (key));
+
+  uint8_t digest[Hash::Function::Sha1::DIGEST_SIZE];
+  std::string msg = "abc";
+  Hash::Function::Sha1::Digest ((const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "a9993e364706816aba3e25717850c26c9cd0d89d", "FIPS 180 one block");
+
+  msg = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  Hash::Function::Sha1::Digest ((const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "84983e441c3bd26ebaae4aa1f95129e5e54670f1", "FIPS 180 two blocks");
+
+  uint8_t hmacKey[80];
+  memset (hmacKey, 0x0b, 20);
+  msg = "Hi There";
+  Hash::Function::Sha1::Hmac (hmacKey, 20, (const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "b617318655057264e28bc0b6fb378c8ef146be00", "RFC 2202 case 1");
+
+  memset (hmacKey, 0xaa, 80);
+  msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+  Hash::Function::Sha1::Hmac (hmacKey, 80, (const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "aa4ae5e15272d00e95705637ce8a3b55ed402112", "RFC 2202 case 6");
+}
+
+
+/**
+ * \ingroup hash-tests
+ * Test SHA-256 and HMAC-SHA256 against the FIPS 180 and \rfc{4231} vectors
+ */
+class Sha256TestCase : public HashTestCase
+{
+public:
+  /** Constructor. */
+  Sha256TestCase ();
+  /** Destructor. */
+  virtual ~Sha256TestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+Sha256TestCase::Sha256TestCase ()
+  : HashTestCase ("Sha256: ")
+{
+}
+
+Sha256TestCase::~Sha256TestCase ()
+{
+}
+
+void
+Sha256TestCase::DoRun (void)
+{
+  Hasher hasher = Hasher ( Create<Hash::Function::Sha256> () );
+  hash32Reference = 0xc9c85caa;  // Sha256(key)
+  Check ( "SHA256", hasher.clear ().GetHash32 (key));
+
+  hash64Reference = 0xc9c85caa5a93aad2ULL;
+  Check ( "SHA256", hasher.clear ().GetHash64 (key));
+
+  uint8_t digest[Hash::Function::Sha256::DIGEST_SIZE];
+  std::string msg = "abc";
+  Hash::Function::Sha256::Digest ((const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+                         "FIPS 180 one block");
+
+  uint8_t hmacKey[20];
+  memset (hmacKey, 0x0b, 20);
+  msg = "Hi There";
+  Hash::Function::Sha256::Hmac (hmacKey, 20, (const uint8_t *) msg.data (), msg.size (), digest);
+  NS_TEST_EXPECT_MSG_EQ (ToHex (digest, sizeof (digest)),
+                         "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+                         "RFC 4231 case 1");
+}
+
+
 /**
  * \ingroup hash-tests
  * Simple hash function based on the GNU sum program.
@@ -436,6 +568,8 @@ IncrementalTestCase::DoRun (void)
   DoHash ( "default", Hasher ( ) );
   DoHash ( "murmur3", Hasher ( Create<Hash::Function::Murmur3> () ) );
   DoHash ( "FNV1a",   Hasher ( Create<Hash::Function::Fnv1a> () ) );
+  DoHash ( "SHA1",    Hasher ( Create<Hash::Function::Sha1> () ) );
+  DoHash ( "SHA256",  Hasher ( Create<Hash::Function::Sha256> () ) );
 }
 
 
@@ -456,6 +590,8 @@ HashTestSuite::HashTestSuite ()
   AddTestCase (new DefaultHashTestCase);
   AddTestCase (new Murmur3TestCase);
   AddTestCase (new Fnv1aTestCase);
+  AddTestCase (new Sha1TestCase);
+  AddTestCase (new Sha256TestCase);
   AddTestCase (new IncrementalTestCase);
   AddTestCase (new Hash32FunctionPtrTestCase);
   AddTestCase (new Hash64FunctionPtrTestCase);
@@ -19,10 +19,19 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -461,6 +470,417 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestEvent : public EventImpl
+{
+protected:
+  virtual void Notify (void)
+  {
+  }
+};
+
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  uint32_t Random (void);
+  void Insert (uint64_t ts);
+  void CheckNext (void);
+  void RemoveRandom (void);
+  void RescheduleRandom (void);
+  void CancelRandom (void);
+  void RemoveCancelled (void);
+  Ptr<Scheduler> m_scheduler;
+  std::set<std::pair<uint64_t, uint32_t> > m_reference;
+  std::vector<Scheduler::Event> m_pending;
+  uint32_t m_cancelled;
+  uint64_t m_now;
+  uint32_t m_uid;
+  uint32_t m_random;
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the order of insertions and removals with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Random (void)
+{
+  // xorshift, enough to spread the time stamps
+  m_random ^= m_random << 13;
+  m_random ^= m_random >> 17;
+  m_random ^= m_random << 5;
+  return m_random;
+}
+
+void
+SchedulerOrderTestCase::Insert (uint64_t ts)
+{
+  Scheduler::Event ev;
+  ev.impl = new SchedulerOrderTestEvent ();
+  ev.key.m_ts = ts;
+  ev.key.m_uid = m_uid++;
+  ev.key.m_context = 0;
+  m_scheduler->Insert (ev);
+  m_reference.insert (std::make_pair (ts, ev.key.m_uid));
+  m_pending.push_back (ev);
+}
+
+void
+SchedulerOrderTestCase::CheckNext (void)
+{
+  Scheduler::Event peek = m_scheduler->PeekNext ();
+  Scheduler::Event ev = m_scheduler->RemoveNext ();
+  NS_TEST_ASSERT_MSG_EQ (peek.key.m_uid, ev.key.m_uid, "PeekNext and RemoveNext disagree");
+  m_now = ev.key.m_ts;
+  if (ev.impl->IsCancelled ())
+    {
+      m_cancelled--;
+      ev.impl->Unref ();
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (ev.key.m_ts, m_reference.begin ()->first, "Wrong time stamp");
+  NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, m_reference.begin ()->second, "Wrong event");
+  m_reference.erase (m_reference.begin ());
+  for (std::vector<Scheduler::Event>::iterator i = m_pending.begin (); i != m_pending.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          *i = m_pending.back ();
+          m_pending.pop_back ();
+          break;
+        }
+    }
+  ev.impl->Unref ();
+}
+
+void
+SchedulerOrderTestCase::RemoveRandom (void)
+{
+  uint32_t index = Random () % m_pending.size ();
+  Scheduler::Event ev = m_pending[index];
+  m_scheduler->Remove (ev);
+  m_reference.erase (std::make_pair (ev.key.m_ts, ev.key.m_uid));
+  m_pending[index] = m_pending.back ();
+  m_pending.pop_back ();
+  ev.impl->Unref ();
+}
+
+void
+SchedulerOrderTestCase::RescheduleRandom (void)
+{
+  const uint64_t spans[] = { 1, 10, 1000, 1000000, 1000000000 };
+  uint32_t index = Random () % m_pending.size ();
+  Scheduler::Event &ev = m_pending[index];
+  Scheduler::EventKey key;
+  key.m_ts = m_now + Random () % spans[Random () % 5];
+  key.m_uid = m_uid++;
+  key.m_context = 0;
+  m_scheduler->Reschedule (ev, key);
+  m_reference.erase (std::make_pair (ev.key.m_ts, ev.key.m_uid));
+  m_reference.insert (std::make_pair (key.m_ts, key.m_uid));
+  ev.key = key;
+}
+
+void
+SchedulerOrderTestCase::CancelRandom (void)
+{
+  uint32_t index = Random () % m_pending.size ();
+  Scheduler::Event ev = m_pending[index];
+  ev.impl->Cancel ();
+  m_cancelled++;
+  m_reference.erase (std::make_pair (ev.key.m_ts, ev.key.m_uid));
+  m_pending[index] = m_pending.back ();
+  m_pending.pop_back ();
+}
+
+void
+SchedulerOrderTestCase::RemoveCancelled (void)
+{
+  std::vector<Scheduler::Event> cancelled;
+  m_scheduler->RemoveCancelled (cancelled);
+  NS_TEST_ASSERT_MSG_EQ (cancelled.size (), m_cancelled, "Cancelled events left");
+  for (std::vector<Scheduler::Event>::iterator i = cancelled.begin (); i != cancelled.end (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (i->impl->IsCancelled (), true, "Live event removed");
+      i->impl->Unref ();
+    }
+  m_cancelled = 0;
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  m_scheduler = m_schedulerFactory.Create<Scheduler> ();
+  m_now = 0;
+  m_uid = 4;
+  m_cancelled = 0;
+  m_random = 2463534242U;
+
+  // a mix of near, far and simultaneous events, like timers and packets
+  const uint64_t spans[] = { 1, 10, 1000, 1000000, 1000000000 };
+  const uint32_t rounds = m_schedulerFactory.GetTypeId () == ListScheduler::GetTypeId () ? 2000 : 20000;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Insert (Random () % spans[i % 5]);
+    }
+  for (uint32_t i = 0; i < rounds; i++)
+    {
+      uint32_t op = Random () % 20;
+      if (op < 9 || m_pending.empty ())
+        {
+          Insert (m_now + Random () % spans[Random () % 5]);
+        }
+      else if (op < 15)
+        {
+          CheckNext ();
+        }
+      else if (op < 17)
+        {
+          RemoveRandom ();
+        }
+      else if (op < 18)
+        {
+          RescheduleRandom ();
+        }
+      else if (op < 19)
+        {
+          CancelRandom ();
+        }
+      else if (Random () % 8 == 0)
+        {
+          RemoveCancelled ();
+        }
+      if (m_pending.size () != m_reference.size ())
+        {
+          break;
+        }
+    }
+  while (!m_scheduler->IsEmpty ())
+    {
+      CheckNext ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_reference.size (), 0, "Events lost");
+  NS_TEST_ASSERT_MSG_EQ (m_cancelled, 0, "Cancelled events lost");
+  m_scheduler = 0;
+}
+
+class SimulatorRescheduleTestCase : public TestCase
+{
+public:
+  /** An argument counting its destructions. */
+  class Token : public SimpleRefCount<Token>
+  {
+  public:
+    Token (uint32_t *destroyed) : m_destroyed (destroyed) {}
+    ~Token () { (*m_destroyed)++; }
+    uint32_t *m_destroyed;
+  };
+  SimulatorRescheduleTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Record (uint32_t id);
+  void Hold (Ptr<Token> token);
+  std::vector<std::pair<Time, uint32_t> > m_runs;
+  uint32_t m_held;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorRescheduleTestCase::SimulatorRescheduleTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check rescheduling and the removal of cancelled events with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorRescheduleTestCase::Record (uint32_t id)
+{
+  m_runs.push_back (std::make_pair (Simulator::Now (), id));
+}
+
+void
+SimulatorRescheduleTestCase::Hold (Ptr<Token> token)
+{
+  m_held++;
+}
+
+void
+SimulatorRescheduleTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+  m_held = 0;
+
+  EventId a = Simulator::Schedule (Seconds (10), &SimulatorRescheduleTestCase::Record, this, 1);
+  Simulator::Schedule (Seconds (5), &SimulatorRescheduleTestCase::Record, this, 2);
+  EventId c = Simulator::Schedule (Seconds (5), &SimulatorRescheduleTestCase::Record, this, 3);
+  EventId movedA = Simulator::Reschedule (a, Seconds (2));
+  NS_TEST_ASSERT_MSG_EQ (movedA.PeekEventImpl (), a.PeekEventImpl (), "The event should be moved, not copied");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetDelayLeft (movedA), Seconds (2), "Wrong expiration time");
+  // pushed back behind the event scheduled at the same time
+  EventId movedC = Simulator::Reschedule (c, Seconds (5));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_runs.size (), 3, "Moved events should run once");
+  NS_TEST_ASSERT_MSG_EQ ((m_runs[0] == std::make_pair (Seconds (2), 1u)), true, "Event not brought forward");
+  NS_TEST_ASSERT_MSG_EQ ((m_runs[1] == std::make_pair (Seconds (5), 2u)), true, "Wrong order");
+  NS_TEST_ASSERT_MSG_EQ ((m_runs[2] == std::make_pair (Seconds (5), 3u)), true, "Wrong order");
+  NS_TEST_ASSERT_MSG_EQ (movedC.IsExpired (), true, "");
+
+  // cancelled events go away long before they would have expired
+  uint32_t destroyed = 0;
+  std::vector<EventId> events;
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      events.push_back (Simulator::Schedule (Seconds (1 + i), &SimulatorRescheduleTestCase::Hold,
+                                             this, Create<Token> (&destroyed)));
+    }
+  for (uint32_t i = 0; i < 2500; i++)
+    {
+      events[i].Cancel ();
+      events[i] = EventId ();
+    }
+  NS_TEST_ASSERT_MSG_GT (destroyed, 1000, "Cancelled events not removed from the event list");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_held, 500, "Wrong events removed");
+  events.clear ();
+  NS_TEST_ASSERT_MSG_EQ (destroyed, 3000, "Events leaked");
+  Simulator::Destroy ();
+}
+
+class EventMemoryTestCase : public TestCase
+{
+public:
+  /** An argument too large for the free lists of events. */
+  struct Large
+  {
+    uint8_t data[300];
+  };
+  EventMemoryTestCase ();
+  virtual void DoRun (void);
+  void Count (int value);
+  void CountLarge (Large large);
+  int m_count;
+};
+
+EventMemoryTestCase::EventMemoryTestCase ()
+  : TestCase ("Check that the memory of the events is reused")
+{
+}
+
+void
+EventMemoryTestCase::Count (int value)
+{
+  m_count += value;
+}
+
+void
+EventMemoryTestCase::CountLarge (Large large)
+{
+  m_count += large.data[299];
+}
+
+void
+EventMemoryTestCase::DoRun (void)
+{
+  m_count = 0;
+  EventId first = Simulator::Schedule (Seconds (1), &EventMemoryTestCase::Count, this, 1);
+  EventImpl *memory = first.PeekEventImpl ();
+  first = EventId ();
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "Event not invoked");
+
+  EventId second = Simulator::Schedule (Seconds (1), &EventMemoryTestCase::Count, this, 2);
+  NS_TEST_ASSERT_MSG_EQ (second.PeekEventImpl (), memory, "Memory of the invoked event not reused");
+  Simulator::Cancel (second);
+  second = EventId ();
+
+  Large large;
+  large.data[299] = 4;
+  Simulator::Schedule (Seconds (1), &EventMemoryTestCase::CountLarge, this, large);
+  Simulator::Schedule (Seconds (2), &EventMemoryTestCase::Count, this, 8);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 13, "Events not invoked");
+  Simulator::Destroy ();
+}
+
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+  virtual void DoRun (void);
+  void Work (uint32_t hops);
+  void Idle (void);
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the profile of the wall-clock time of the events")
+{
+}
+
+void
+EventProfilerTestCase::Work (uint32_t hops)
+{
+  if (hops > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &EventProfilerTestCase::Work, this, hops - 1);
+    }
+}
+
+void
+EventProfilerTestCase::Idle (void)
+{
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  std::string output = CreateTempDirFilename ("event-profile.txt");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileSampling", UintegerValue (1));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileOutput", StringValue (output));
+  Simulator::ScheduleWithContext (7, Seconds (1), &EventProfilerTestCase::Work, this, 99);
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      Simulator::ScheduleWithContext (9, Seconds (2 + i), &EventProfilerTestCase::Idle, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileSampling", UintegerValue (0));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileOutput", StringValue (""));
+
+  std::ifstream is (output.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (is.is_open (), true, "Profile not written");
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline (is, line))
+    {
+      lines.push_back (line);
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines.size (), 9, "Expected a header, two functions and two nodes");
+  NS_TEST_ASSERT_MSG_EQ (lines[0], "Event profile: 1 in 1 events sampled, 150 of 150 events", "Events not all sampled");
+  NS_TEST_ASSERT_MSG_NE (lines[2].find ("sched/event"), std::string::npos, "No scheduled events column in " << lines[2]);
+  NS_TEST_ASSERT_MSG_NE (lines[2].find ("allocs/event"), std::string::npos, "No allocations column in " << lines[2]);
+  uint32_t work = lines[3].find ("EventProfilerTestCase::Work") == std::string::npos ? 4 : 3;
+  std::istringstream flat (lines[work]);
+  double percent, seconds, perEvent, scheduled, allocations;
+  uint64_t events;
+  flat >> percent >> seconds >> events >> perEvent >> scheduled >> allocations;
+  NS_TEST_ASSERT_MSG_EQ (events, 100, "Wrong count of " << lines[work]);
+  NS_TEST_ASSERT_MSG_EQ_TOL (scheduled, 0.99, 0.001, "Wrong scheduled events of " << lines[work]);
+  // one event allocated by each scheduled event
+  NS_TEST_ASSERT_MSG_EQ_TOL (allocations, 0.99, 0.001, "Wrong allocations of " << lines[work]);
+  NS_TEST_ASSERT_MSG_NE (lines[7 - work].find ("EventProfilerTestCase::Idle"), std::string::npos,
+                         "Function not named in " << lines[7 - work]);
+  std::istringstream node (lines[7]);
+  uint32_t context;
+  node >> context >> percent >> seconds >> events;
+  NS_TEST_ASSERT_MSG_EQ (context, 7, "Wrong node in " << lines[7]);
+  NS_TEST_ASSERT_MSG_EQ (events, 100, "Wrong count of node 7");
+  NS_TEST_ASSERT_MSG_NE (lines[8].find ("       9"), std::string::npos, "Node 9 missing");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -477,5 +897,23 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    TypeId schedulers[] = {
+      ListScheduler::GetTypeId (),
+      MapScheduler::GetTypeId (),
+      HeapScheduler::GetTypeId (),
+      CalendarScheduler::GetTypeId (),
+      LadderScheduler::GetTypeId ()
+    };
+    for (uint32_t i = 0; i < sizeof (schedulers) / sizeof (schedulers[0]); i++)
+      {
+        factory.SetTypeId (schedulers[i]);
+        AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+        AddTestCase (new SimulatorRescheduleTestCase (factory), TestCase::QUICK);
+      }
+    AddTestCase (new EventMemoryTestCase (), TestCase::QUICK);
+    AddTestCase (new EventProfilerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
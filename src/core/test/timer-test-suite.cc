@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include <vector>
 
 namespace {
 void bari (int)
@@ -208,6 +209,61 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class TimerRescheduleTestCase : public TestCase
+{
+public:
+  TimerRescheduleTestCase ();
+  virtual void DoRun (void);
+  void Expire (int value);
+  void PushBack (Timer *timer);
+  std::vector<Time> m_expirations;
+  int m_value;
+};
+
+TimerRescheduleTestCase::TimerRescheduleTestCase ()
+  : TestCase ("Check that a running timer is moved by Reschedule")
+{
+}
+void
+TimerRescheduleTestCase::Expire (int value)
+{
+  m_expirations.push_back (Simulator::Now ());
+  m_value = value;
+}
+void
+TimerRescheduleTestCase::PushBack (Timer *timer)
+{
+  NS_TEST_ASSERT_MSG_EQ (timer->IsRunning (), true, "");
+  timer->SetArguments (2);
+  timer->Reschedule (Seconds (10.0));
+  NS_TEST_ASSERT_MSG_EQ (timer->IsRunning (), true, "");
+  NS_TEST_ASSERT_MSG_EQ (timer->GetDelayLeft (), Seconds (10.0), "");
+}
+void
+TimerRescheduleTestCase::DoRun (void)
+{
+  Timer timer = Timer (Timer::CANCEL_ON_DESTROY);
+  timer.SetFunction (&TimerRescheduleTestCase::Expire, this);
+  timer.SetArguments (1);
+  timer.SetDelay (Seconds (5.0));
+  // not running: same as Schedule
+  timer.Reschedule ();
+  NS_TEST_ASSERT_MSG_EQ (timer.GetDelayLeft (), Seconds (5.0), "");
+  Simulator::Schedule (Seconds (1.0), &TimerRescheduleTestCase::PushBack, this, &timer);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expirations.size (), 1, "The timer should expire once");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[0], Seconds (11.0), "The timer should expire at its new time");
+  NS_TEST_ASSERT_MSG_EQ (m_value, 1, "The event keeps the arguments it was scheduled with");
+
+  // bring the timer forward
+  timer.Reschedule (Seconds (10.0));
+  timer.Reschedule (Seconds (3.0));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expirations.size (), 2, "The timer should expire once");
+  NS_TEST_ASSERT_MSG_EQ (m_expirations[1], Seconds (14.0), "The timer should expire at its new time");
+  Simulator::Destroy ();
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -216,5 +272,6 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerRescheduleTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
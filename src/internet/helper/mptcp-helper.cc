@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/type-id.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpHelper");
+
+MpTcpHelper::MpTcpHelper ()
+  : m_scheduler ("ns3::MpTcpSchedulerRoundRobin"),
+    m_congestionControl ("ns3::MpTcpCongestionLia"),
+    m_pathManager (MpTcpSocketBase::FullMesh),
+    m_version (1)
+{
+}
+
+void
+MpTcpHelper::SetScheduler (std::string type)
+{
+  TypeId tid;
+  NS_ABORT_MSG_UNLESS (TypeId::LookupByNameFailSafe (type, &tid), "Unknown scheduler " << type);
+  m_scheduler = type;
+}
+
+void
+MpTcpHelper::SetPathManager (MpTcpSocketBase::PathManagerMode mode)
+{
+  m_pathManager = mode;
+}
+
+void
+MpTcpHelper::SetCongestionControl (std::string type)
+{
+  TypeId tid;
+  NS_ABORT_MSG_UNLESS (TypeId::LookupByNameFailSafe (type, &tid), "Unknown congestion control " << type);
+  m_congestionControl = type;
+}
+
+void
+MpTcpHelper::SetVersion (uint8_t version)
+{
+  m_version = version;
+}
+
+void
+MpTcpHelper::Configure (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Config::SetDefault ("ns3::TcpSocketBase::EnableMpTcp", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocketBase::MpTcpVersion", UintegerValue (m_version));
+  Config::SetDefault ("ns3::MpTcpSocketBase::Scheduler", TypeIdValue (TypeId::LookupByName (m_scheduler)));
+  Config::SetDefault ("ns3::MpTcpSocketBase::CongestionControl", TypeIdValue (TypeId::LookupByName (m_congestionControl)));
+  Config::SetDefault ("ns3::MpTcpSocketBase::PathManagerMode", EnumValue (m_pathManager));
+}
+
+void
+MpTcpHelper::Install (Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node);
+  if (!node->GetObject<Ipv4> () && !node->GetObject<Ipv6> ())
+    {
+      InternetStackHelper stack;
+      stack.Install (node);
+    }
+  Configure ();
+}
+
+void
+MpTcpHelper::Install (NodeContainer c) const
+{
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Install (*i);
+    }
+  Configure ();
+}
+
+void
+MpTcpHelper::InstallAll (void) const
+{
+  Install (NodeContainer::GetGlobal ());
+}
+
+Ptr<MpTcpSocketBase>
+MpTcpHelper::GetMeta (Ptr<Socket> socket)
+{
+  return DynamicCast<MpTcpSocketBase> (socket);
+}
+
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_HELPER_H
+#define MPTCP_HELPER_H
+
+#include <string>
+#include "ns3/ptr.h"
+#include "ns3/node-container.h"
+#include "ns3/mptcp-socket-base.h"
+
+namespace ns3 {
+
+class Socket;
+
+/**
+ * \brief Enables MPTCP on nodes with a given scheduler, path manager and
+ * coupled congestion control
+ *
+ * Meta sockets are created when a TCP socket upgrades itself upon the
+ * MP_CAPABLE handshake, hence they cannot be configured through an object
+ * factory. The helper sets the attribute defaults of TcpSocketBase and
+ * MpTcpSocketBase instead: its settings apply to every socket created after
+ * Install, on all nodes.
+ *
+ * \code
+ *   MpTcpHelper mptcp;
+ *   mptcp.SetScheduler ("ns3::MpTcpSchedulerFastestRTT");
+ *   mptcp.SetPathManager (MpTcpSocketBase::FullMesh);
+ *   mptcp.SetCongestionControl ("ns3::MpTcpCongestionOlia");
+ *   mptcp.Install (nodes);
+ * \endcode
+ */
+class MpTcpHelper
+{
+public:
+  MpTcpHelper ();
+
+  /**
+   * \param type TypeId name of a subclass of MpTcpScheduler
+   */
+  void SetScheduler (std::string type);
+
+  /**
+   * \param mode path manager opening the additional subflows
+   */
+  void SetPathManager (MpTcpSocketBase::PathManagerMode mode);
+
+  /**
+   * \param type TypeId name of a subclass of MpTcpCongestionOps coupling the subflows
+   */
+  void SetCongestionControl (std::string type);
+
+  /**
+   * \param version MPTCP version proposed in the MP_CAPABLE handshake
+   */
+  void SetVersion (uint8_t version);
+
+  /**
+   * \brief Aggregates an internet stack to the nodes lacking one and enables MPTCP
+   * \param c the nodes
+   */
+  void Install (NodeContainer c) const;
+
+  /**
+   * \brief Aggregates an internet stack to the node if it lacks one and enables MPTCP
+   * \param node the node
+   */
+  void Install (Ptr<Node> node) const;
+
+  /**
+   * \brief Install on every node of the simulation
+   */
+  void InstallAll (void) const;
+
+  /**
+   * \brief Sets the attribute defaults without touching any node
+   */
+  void Configure (void) const;
+
+  /**
+   * \param socket a socket returned by the TCP socket factory, e.g. the
+   * listening socket of a PacketSink
+   * \return The meta socket once the socket was upgraded, 0 otherwise
+   */
+  static Ptr<MpTcpSocketBase> GetMeta (Ptr<Socket> socket);
+
+private:
+  std::string m_scheduler;                      //!< TypeId name of the scheduler
+  std::string m_congestionControl;              //!< TypeId name of the coupled congestion control
+  MpTcpSocketBase::PathManagerMode m_pathManager; //!< Path manager
+  uint8_t m_version;                            //!< Proposed MPTCP version
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_HELPER_H */
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-stats-helper.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-stats.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpStatsHelper");
+
+/**
+ * \brief Writes a value in host byte order
+ * \param os the stream
+ * \param value the value
+ */
+template <typename T>
+static void
+WriteRaw (std::ostream *os, T value)
+{
+  os->write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+MpTcpStatsHelper::MpTcpStatsHelper ()
+  : m_interval (MilliSeconds (100)),
+    m_format (CSV)
+{
+}
+
+void
+MpTcpStatsHelper::SetSamplingInterval (Time interval)
+{
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  m_interval = interval;
+}
+
+void
+MpTcpStatsHelper::SetFormat (Format format)
+{
+  m_format = format;
+}
+
+void
+MpTcpStatsHelper::Install (Ptr<MpTcpSocketBase> meta, std::string filename) const
+{
+  std::ios::openmode mode = std::ios::out;
+  if (m_format == BINARY)
+    {
+      mode |= std::ios::binary;
+    }
+  Install (meta, Create<OutputStreamWrapper> (filename, mode));
+}
+
+void
+MpTcpStatsHelper::Install (Ptr<MpTcpSocketBase> meta, Ptr<OutputStreamWrapper> stream) const
+{
+  NS_LOG_FUNCTION (this << meta << stream);
+  NS_ASSERT (meta);
+  if (m_format == CSV)
+    {
+      WriteCsvHeader (stream);
+    }
+  Simulator::ScheduleNow (&MpTcpStatsHelper::Sample, meta->GetStats (), stream, m_format, m_interval);
+}
+
+void
+MpTcpStatsHelper::WriteCsvHeader (Ptr<OutputStreamWrapper> stream)
+{
+  *stream->GetStream () << "time,rxBuffer,holBlocking,outOfOrder,reinjections,reinjectedBytes,"
+                        << "duplicateBytes,scheduledBytes,subflows,subflowBytes..." << std::endl;
+}
+
+void
+MpTcpStatsHelper::WriteSample (Ptr<const MpTcpStats> stats, Ptr<OutputStreamWrapper> stream, Format format)
+{
+  std::ostream *os = stream->GetStream ();
+  if (format == CSV)
+    {
+      *os << Simulator::Now ().GetSeconds ()
+          << "," << stats->GetRxBufferOccupancy ()
+          << "," << stats->GetHolBlockingTime ().GetSeconds ()
+          << "," << stats->GetOutOfOrderArrivals ()
+          << "," << stats->GetReinjections ()
+          << "," << stats->GetReinjectedBytes ()
+          << "," << stats->GetDuplicateBytes ()
+          << "," << stats->GetScheduledBytes ()
+          << "," << stats->GetNSubflows ();
+      for (uint32_t i = 0; i < stats->GetNSubflows (); i++)
+        {
+          *os << "," << stats->GetSubflowScheduledBytes (i);
+        }
+      *os << std::endl;
+      return;
+    }
+
+  WriteRaw<double> (os, Simulator::Now ().GetSeconds ());
+  WriteRaw<uint32_t> (os, stats->GetRxBufferOccupancy ());
+  WriteRaw<double> (os, stats->GetHolBlockingTime ().GetSeconds ());
+  WriteRaw<uint32_t> (os, stats->GetOutOfOrderArrivals ());
+  WriteRaw<uint32_t> (os, stats->GetReinjections ());
+  WriteRaw<uint64_t> (os, stats->GetReinjectedBytes ());
+  WriteRaw<uint64_t> (os, stats->GetDuplicateBytes ());
+  WriteRaw<uint64_t> (os, stats->GetScheduledBytes ());
+  WriteRaw<uint32_t> (os, stats->GetNSubflows ());
+  for (uint32_t i = 0; i < stats->GetNSubflows (); i++)
+    {
+      WriteRaw<uint64_t> (os, stats->GetSubflowScheduledBytes (i));
+    }
+}
+
+void
+MpTcpStatsHelper::Sample (Ptr<MpTcpStats> stats, Ptr<OutputStreamWrapper> stream, Format format, Time interval)
+{
+  WriteSample (stats, stream, format);
+  Simulator::Schedule (interval, &MpTcpStatsHelper::Sample, stats, stream, format, interval);
+}
+
+} // namespace ns3
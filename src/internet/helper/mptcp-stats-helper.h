@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_STATS_HELPER_H
+#define MPTCP_STATS_HELPER_H
+
+#include <string>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/output-stream-wrapper.h"
+
+namespace ns3 {
+
+class MpTcpSocketBase;
+class MpTcpStats;
+
+/**
+ * \brief Samples the statistics of MPTCP connections into time series
+ *
+ * Each sample holds, in this order: the time in seconds, the meta receive buffer
+ * occupancy, the head-of-line blocking time in seconds, the number of out-of-order
+ * arrivals, the number of reinjections, the reinjected bytes, the duplicate bytes,
+ * the bytes handed to subflows, the number of subflows and then the bytes handed to
+ * each subflow.
+ *
+ * In CSV, a header line names the fixed columns and each sample is a line.
+ * In binary, a sample is written in host byte order as: double, uint32, double,
+ * uint32, uint32, uint64, uint64, uint64, uint32 followed by one uint64 per subflow.
+ *
+ * Like the flow monitor, sampling goes on until the simulation is stopped with
+ * Simulator::Stop.
+ */
+class MpTcpStatsHelper
+{
+public:
+  /**
+   * \brief Output formats
+   */
+  enum Format
+  {
+    CSV,    //!< Comma separated values, one line per sample
+    BINARY  //!< Compact fixed-size records
+  };
+
+  MpTcpStatsHelper ();
+
+  /**
+   * \param interval time between two samples
+   */
+  void SetSamplingInterval (Time interval);
+
+  /**
+   * \param format output format
+   */
+  void SetFormat (Format format);
+
+  /**
+   * \brief Starts sampling the statistics of a connection into a file
+   * \param meta the meta socket of the connection
+   * \param filename the output file, overwritten
+   */
+  void Install (Ptr<MpTcpSocketBase> meta, std::string filename) const;
+
+  /**
+   * \brief Starts sampling the statistics of a connection into a stream
+   * \param meta the meta socket of the connection
+   * \param stream where to write the samples
+   */
+  void Install (Ptr<MpTcpSocketBase> meta, Ptr<OutputStreamWrapper> stream) const;
+
+  /**
+   * \brief Writes a single sample
+   * \param stats the statistics to sample
+   * \param stream where to write the sample
+   * \param format output format
+   */
+  static void WriteSample (Ptr<const MpTcpStats> stats, Ptr<OutputStreamWrapper> stream, Format format);
+
+  /**
+   * \brief Writes the CSV header line
+   * \param stream where to write the header
+   */
+  static void WriteCsvHeader (Ptr<OutputStreamWrapper> stream);
+
+private:
+  /**
+   * \brief Writes a sample and schedules the next one
+   * \param stats the statistics to sample
+   * \param stream where to write the sample
+   * \param format output format
+   * \param interval time between two samples
+   */
+  static void Sample (Ptr<MpTcpStats> stats, Ptr<OutputStreamWrapper> stream, Format format, Time interval);
+
+  Time m_interval;   //!< Time between two samples
+  Format m_format;   //!< Output format
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_STATS_HELPER_H */
@@ -81,6 +81,14 @@ Ipv4L3Protocol::GetTypeId (void)
                      "Drop ipv4 packet",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_dropTrace),
                      "ns3::Ipv4L3Protocol::DropTracedCallback")
+    .AddTraceSource ("InterfaceUp",
+                     "An interface was brought up",
+                     MakeTraceSourceAccessor (&Ipv4L3Protocol::m_interfaceUpTrace),
+                     "ns3::Ipv4L3Protocol::InterfaceTracedCallback")
+    .AddTraceSource ("InterfaceDown",
+                     "An interface was brought down",
+                     MakeTraceSourceAccessor (&Ipv4L3Protocol::m_interfaceDownTrace),
+                     "ns3::Ipv4L3Protocol::InterfaceTracedCallback")
     .AddAttribute ("InterfaceList",
                    "The set of Ipv4 interfaces associated to this Ipv4 stack.",
                    ObjectVectorValue (),
@@ -1319,6 +1327,7 @@ Ipv4L3Protocol::SetUp (uint32_t i)
         {
           m_routingProtocol->NotifyInterfaceUp (i);
         }
+      m_interfaceUpTrace (m_node->GetObject<Ipv4> (), i);
     }
   else
     {
@@ -1337,6 +1346,7 @@ Ipv4L3Protocol::SetDown (uint32_t ifaceIndex)
     {
       m_routingProtocol->NotifyInterfaceDown (ifaceIndex);
     }
+  m_interfaceDownTrace (m_node->GetObject<Ipv4> (), ifaceIndex);
 }
 
 bool 
@@ -259,6 +259,15 @@ public:
     (const Ipv4Header & header, Ptr<const Packet> packet,
      DropReason reason, Ptr<Ipv4> ipv4,
      uint32_t interface);
+
+  /**
+   * TracedCallback signature for interface state changes.
+   *
+   * \param [in] ipv4
+   * \param [in] interface The index of the interface brought up or down
+   */
+  typedef void (* InterfaceTracedCallback)
+    (Ptr<Ipv4> ipv4, uint32_t interface);
    
 protected:
 
@@ -487,6 +496,10 @@ private:
   /// \deprecated The non-const \c Ptr<Ipv4> argument is deprecated
   /// and will be changed to \c Ptr<const Ipv4> in a future release.
   TracedCallback<const Ipv4Header &, Ptr<const Packet>, DropReason, Ptr<Ipv4>, uint32_t> m_dropTrace;
+  /// Trace of interfaces brought up
+  TracedCallback<Ptr<Ipv4>, uint32_t> m_interfaceUpTrace;
+  /// Trace of interfaces brought down
+  TracedCallback<Ptr<Ipv4>, uint32_t> m_interfaceDownTrace;
 
   Ptr<Ipv4RoutingProtocol> m_routingProtocol; //!< Routing protocol associated with the stack
 
@@ -102,6 +102,14 @@ TypeId Ipv6L3Protocol::GetTypeId ()
                      "Drop IPv6 packet",
                      MakeTraceSourceAccessor (&Ipv6L3Protocol::m_dropTrace),
                      "ns3::Ipv6L3Protocol::DropTracedCallback")
+    .AddTraceSource ("InterfaceUp",
+                     "An interface was brought up",
+                     MakeTraceSourceAccessor (&Ipv6L3Protocol::m_interfaceUpTrace),
+                     "ns3::Ipv6L3Protocol::InterfaceTracedCallback")
+    .AddTraceSource ("InterfaceDown",
+                     "An interface was brought down",
+                     MakeTraceSourceAccessor (&Ipv6L3Protocol::m_interfaceDownTrace),
+                     "ns3::Ipv6L3Protocol::InterfaceTracedCallback")
 
     .AddTraceSource ("SendOutgoing",
                      "A newly-generated packet by this node is "
@@ -536,6 +544,7 @@ void Ipv6L3Protocol::SetUp (uint32_t i)
         {
           m_routingProtocol->NotifyInterfaceUp (i);
         }
+      m_interfaceUpTrace (m_node->GetObject<Ipv6> (), i);
     }
   else
     {
@@ -554,6 +563,7 @@ void Ipv6L3Protocol::SetDown (uint32_t i)
     {
       m_routingProtocol->NotifyInterfaceDown (i);
     }
+  m_interfaceDownTrace (m_node->GetObject<Ipv6> (), i);
 }
 
 void Ipv6L3Protocol::SetupLoopback ()
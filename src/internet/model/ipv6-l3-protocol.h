@@ -407,6 +407,15 @@ public:
      DropReason reason, Ptr<Ipv6> ipv6,
      uint32_t interface);
 
+  /**
+   * TracedCallback signature for interface state changes.
+   *
+   * \param [in] ipv6
+   * \param [in] interface The index of the interface brought up or down
+   */
+  typedef void (* InterfaceTracedCallback)
+    (Ptr<Ipv6> ipv6, uint32_t interface);
+
   /**
    * Adds a multicast address to the list of addresses to pass to local deliver.
    * \param address the address.
@@ -541,6 +550,16 @@ private:
    */ 
   TracedCallback<const Ipv6Header &, Ptr<const Packet>, DropReason, Ptr<Ipv6>, uint32_t> m_dropTrace;
 
+  /**
+   * \brief Callback to trace interfaces brought up.
+   */
+  TracedCallback<Ptr<Ipv6>, uint32_t> m_interfaceUpTrace;
+
+  /**
+   * \brief Callback to trace interfaces brought down.
+   */
+  TracedCallback<Ptr<Ipv6>, uint32_t> m_interfaceDownTrace;
+
   /// Trace of sent packets
   TracedCallback<const Ipv6Header &, Ptr<const Packet>, uint32_t> m_sendOutgoingTrace;
   /// Trace of unicast forwarded packets
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-congestion-balia.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionBalia");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpCongestionBalia);
+
+TypeId
+MpTcpCongestionBalia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpCongestionBalia")
+    .SetParent<MpTcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpCongestionBalia> ()
+  ;
+  return tid;
+}
+
+MpTcpCongestionBalia::MpTcpCongestionBalia (void)
+  : MpTcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionBalia::MpTcpCongestionBalia (const MpTcpCongestionBalia& sock)
+  : MpTcpCongestionOps (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionBalia::~MpTcpCongestionBalia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpCongestionBalia::GetName () const
+{
+  return "MpTcpCongestionBalia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpCongestionBalia::Fork (void)
+{
+  return CopyObject<MpTcpCongestionBalia> (this);
+}
+
+double
+MpTcpCongestionBalia::ComputeAlpha () const
+{
+  if (!m_metaSock)
+    {
+      return 1;
+    }
+  double rate = m_subflow->GetCoupledRate ();
+  if (rate <= 0)
+    {
+      return 1;
+    }
+  return m_metaSock->GetCoupledMaxRate () / rate;
+}
+
+uint32_t
+MpTcpCongestionBalia::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                   uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+  double decrease = bytesInFlight / 2.0 * std::min (ComputeAlpha (), 1.5);
+  uint32_t ssThresh = bytesInFlight - static_cast<uint32_t> (std::min (decrease, (double) bytesInFlight));
+  return std::max (2 * tcb->m_segmentSize, ssThresh);
+}
+
+double
+MpTcpCongestionBalia::ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  double mss = tcb->m_segmentSize;
+  double sumRate = m_metaSock->GetCoupledSumRate ();
+  double rtt = GetSubflowRtt ();
+  if (sumRate <= 0 || rtt <= 0)
+    {
+      return MpTcpCongestionOps::ComputeIncrease (tcb, segmentsAcked);
+    }
+  double alpha = ComputeAlpha ();
+  double increase = tcb->m_cWnd.Get () * mss * mss / (rtt * rtt * sumRate * sumRate);
+  increase *= (1 + alpha) / 2 * (4 + alpha) / 5;
+  NS_LOG_LOGIC ("alpha=" << alpha << " increase=" << increase << " per segment");
+  return increase * segmentsAcked;
+}
+
+} // namespace ns3
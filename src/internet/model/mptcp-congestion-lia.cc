@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-congestion-lia.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionLia");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpCongestionLia);
+
+TypeId
+MpTcpCongestionLia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpCongestionLia")
+    .SetParent<MpTcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpCongestionLia> ()
+  ;
+  return tid;
+}
+
+MpTcpCongestionLia::MpTcpCongestionLia (void)
+  : MpTcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionLia::MpTcpCongestionLia (const MpTcpCongestionLia& sock)
+  : MpTcpCongestionOps (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionLia::~MpTcpCongestionLia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpCongestionLia::GetName () const
+{
+  return "MpTcpCongestionLia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpCongestionLia::Fork (void)
+{
+  return CopyObject<MpTcpCongestionLia> (this);
+}
+
+double
+MpTcpCongestionLia::ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  double bytesAcked = static_cast<double> (segmentsAcked) * tcb->m_segmentSize;
+  double uncoupled = bytesAcked * tcb->m_segmentSize / tcb->m_cWnd.Get ();
+  double sumRate = m_metaSock->GetCoupledSumRate ();
+  if (sumRate <= 0)
+    {
+      return uncoupled;
+    }
+  double coupled = m_metaSock->GetCoupledMaxCwndOverRtt2 () * bytesAcked * tcb->m_segmentSize
+    / (sumRate * sumRate);
+  NS_LOG_LOGIC ("coupled=" << coupled << " uncoupled=" << uncoupled);
+  return std::min (coupled, uncoupled);
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-congestion-olia.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionOlia");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpCongestionOlia);
+
+TypeId
+MpTcpCongestionOlia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpCongestionOlia")
+    .SetParent<MpTcpCongestionOps> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpCongestionOlia> ()
+  ;
+  return tid;
+}
+
+MpTcpCongestionOlia::MpTcpCongestionOlia (void)
+  : MpTcpCongestionOps (),
+    m_lastInterval (0),
+    m_currentInterval (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionOlia::MpTcpCongestionOlia (const MpTcpCongestionOlia& sock)
+  : MpTcpCongestionOps (sock),
+    m_lastInterval (sock.m_lastInterval),
+    m_currentInterval (sock.m_currentInterval)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionOlia::~MpTcpCongestionOlia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpCongestionOlia::GetName () const
+{
+  return "MpTcpCongestionOlia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpCongestionOlia::Fork (void)
+{
+  return CopyObject<MpTcpCongestionOlia> (this);
+}
+
+void
+MpTcpCongestionOlia::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                                const Time& rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+  m_currentInterval += static_cast<uint64_t> (segmentsAcked) * tcb->m_segmentSize;
+  if (m_metaSock)
+    {
+      m_metaSock->UpdateCoupledLossInterval (m_subflow, std::max (m_lastInterval, m_currentInterval));
+    }
+}
+
+uint32_t
+MpTcpCongestionOlia::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                  uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+  m_lastInterval = m_currentInterval;
+  m_currentInterval = 0;
+  if (m_metaSock)
+    {
+      m_metaSock->UpdateCoupledLossInterval (m_subflow, m_lastInterval);
+    }
+  return TcpNewReno::GetSsThresh (tcb, bytesInFlight);
+}
+
+double
+MpTcpCongestionOlia::ComputeAlpha () const
+{
+  uint32_t nbPaths = m_metaSock->GetCoupledNSubflows ();
+  Ptr<MpTcpSubflow> best = m_metaSock->GetCoupledBestSubflow ();
+  Ptr<MpTcpSubflow> maxWindow = m_metaSock->GetCoupledMaxCwndSubflow ();
+
+  if (nbPaths < 2 || best == 0 || best == maxWindow)
+    {
+      // B\M is empty
+      return 0;
+    }
+  if (m_subflow == best)
+    {
+      return 1.0 / nbPaths;
+    }
+  if (m_subflow == maxWindow)
+    {
+      return -1.0 / nbPaths;
+    }
+  return 0;
+}
+
+double
+MpTcpCongestionOlia::ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  double mss = tcb->m_segmentSize;
+  double cwnd = tcb->m_cWnd.Get ();
+  double sumRate = m_metaSock->GetCoupledSumRate ();
+  double rtt = GetSubflowRtt ();
+  if (sumRate <= 0 || rtt <= 0)
+    {
+      return MpTcpCongestionOps::ComputeIncrease (tcb, segmentsAcked);
+    }
+  double increase = cwnd * mss * mss / (rtt * rtt * sumRate * sumRate);
+  increase += ComputeAlpha () * mss * mss / cwnd;
+  NS_LOG_LOGIC ("increase=" << increase << " per segment");
+  return increase * segmentsAcked;
+}
+
+} // namespace ns3
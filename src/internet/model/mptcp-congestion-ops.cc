@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-congestion-ops.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionOps");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpCongestionOps);
+
+TypeId
+MpTcpCongestionOps::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpCongestionOps")
+    .SetParent<TcpNewReno> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpCongestionOps> ()
+  ;
+  return tid;
+}
+
+MpTcpCongestionOps::MpTcpCongestionOps (void)
+  : TcpNewReno (),
+    m_metaSock (0),
+    m_subflow (0),
+    m_cwndCnt (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+/* A forked instance has to be attached again by the meta */
+MpTcpCongestionOps::MpTcpCongestionOps (const MpTcpCongestionOps& sock)
+  : TcpNewReno (sock),
+    m_metaSock (0),
+    m_subflow (0),
+    m_cwndCnt (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionOps::~MpTcpCongestionOps (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpCongestionOps::GetName () const
+{
+  return "MpTcpCongestionOps";
+}
+
+void
+MpTcpCongestionOps::SetMeta (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> subflow)
+{
+  NS_LOG_FUNCTION (this << meta << subflow);
+  NS_ASSERT (meta && subflow);
+  m_metaSock = PeekPointer (meta);
+  m_subflow = PeekPointer (subflow);
+}
+
+Ptr<TcpCongestionOps>
+MpTcpCongestionOps::Fork (void)
+{
+  return CopyObject<MpTcpCongestionOps> (this);
+}
+
+double
+MpTcpCongestionOps::GetSubflowRtt () const
+{
+  NS_ASSERT (m_subflow);
+  return m_subflow->GetCoupledRtt ();
+}
+
+double
+MpTcpCongestionOps::ComputeIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) const
+{
+  // Uncoupled increase, i.e. NewReno
+  return static_cast<double> (segmentsAcked) * tcb->m_segmentSize * tcb->m_segmentSize / tcb->m_cWnd.Get ();
+}
+
+void
+MpTcpCongestionOps::CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  if (segmentsAcked == 0)
+    {
+      return;
+    }
+
+  if (!m_metaSock)
+    {
+      TcpNewReno::CongestionAvoidance (tcb, segmentsAcked);
+      return;
+    }
+
+  m_cwndCnt += ComputeIncrease (tcb, segmentsAcked);
+  if (m_cwndCnt >= 1.0)
+    {
+      uint32_t adder = static_cast<uint32_t> (m_cwndCnt);
+      m_cwndCnt -= adder;
+      tcb->m_cWnd += adder;
+      NS_LOG_INFO ("In coupled CongAvoid, updated to cwnd " << tcb->m_cWnd <<
+                   " ssthresh " << tcb->m_ssThresh);
+    }
+  else if (m_cwndCnt <= -1.0)
+    {
+      // OLIA may move window away from a subflow
+      uint32_t decrease = static_cast<uint32_t> (-m_cwndCnt);
+      m_cwndCnt += decrease;
+      tcb->m_cWnd = std::max (tcb->m_cWnd.Get () - std::min (decrease, tcb->m_cWnd.Get ()),
+                              tcb->m_segmentSize);
+      NS_LOG_INFO ("In coupled CongAvoid, decreased to cwnd " << tcb->m_cWnd);
+    }
+}
+
+} // namespace ns3
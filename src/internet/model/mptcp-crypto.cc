@@ -21,68 +21,130 @@
  */
 
 #include <stdint.h>
+#include <cstring>
 #include "ns3/mptcp-crypto.h"
 #include "ns3/log.h"
-#include "ns3/node.h"
-#include "ns3/buffer.h"
 #include "ns3/assert.h"
-#include <cstddef> 
-
-#ifdef HAVE_CRYPTO
-    #include <gcrypt.h>
-#else
-    #include <functional>
-    #include <iostream>
-    #include <string>
-#endif
+#include "ns3/fatal-error.h"
+#include "ns3/hash-sha1.h"
+#include "ns3/hash-sha256.h"
 
 NS_LOG_COMPONENT_DEFINE ("MpTcpCrypto");
 
 namespace ns3 {
 
-/* https://www.gnupg.org/documentation/manuals/gcrypt/Working-with-hash-algorithms.html#Working-with-hash-algorithms */
+namespace {
+
+void
+WriteHtonU64 (uint8_t* p, uint64_t value)
+{
+  for (int i = 0; i < 8; ++i)
+    {
+      p[i] = value >> (56 - 8 * i);
+    }
+}
+
 void
-GenerateTokenForKey( mptcp_crypto_alg_t ns_alg, uint64_t key, uint32_t& token, uint64_t& idsn)
+WriteHtonU32 (uint8_t* p, uint32_t value)
+{
+  for (int i = 0; i < 4; ++i)
+    {
+      p[i] = value >> (24 - 8 * i);
+    }
+}
+
+uint64_t
+ReadNtohU64 (const uint8_t* p)
+{
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i)
+    {
+      value = (value << 8) | p[i];
+    }
+  return value;
+}
+
+/* Computes HMAC(Key=(key1+key2), Msg=msg) and returns the size of the digest */
+uint32_t
+ComputeHmac (mptcp_crypto_alg_t alg, uint64_t key1, uint64_t key2,
+             const uint8_t* msg, uint32_t size, uint8_t digest[Hash::Function::Sha256::DIGEST_SIZE])
+{
+  uint8_t key[16];
+
+  WriteHtonU64(key, key1);
+  WriteHtonU64(key + 8, key2);
+  switch(alg)
+    {
+      case HMAC_SHA1:
+        Hash::Function::Sha1::Hmac(key, sizeof(key), msg, size, digest);
+        return Hash::Function::Sha1::DIGEST_SIZE;
+      case HMAC_SHA256:
+        Hash::Function::Sha256::Hmac(key, sizeof(key), msg, size, digest);
+        return Hash::Function::Sha256::DIGEST_SIZE;
+      default:
+        NS_FATAL_ERROR("Unsupported algorithm " << alg);
+    }
+  return 0;
+}
+
+} // anonymous namespace
+
+void
+GenerateTokenForKey( mptcp_crypto_alg_t alg, uint64_t key, uint32_t& token, uint64_t& idsn)
 {
   NS_LOG_LOGIC("Generating token/key from key=" << key);
-  #ifdef HAVE_CRYPTO
-  gcry_md_algos gcry_algo = GCRY_MD_SHA1;
-  static const int KEY_SIZE_IN_BYTES = sizeof(key);
-
-  /* converts the key into a buffer */
-  Buffer keyBuff;
-  keyBuff.AddAtStart(KEY_SIZE_IN_BYTES);
-  Buffer::Iterator it = keyBuff.Begin();
-  it.WriteHtonU64(key);
-  int hash_length = gcry_md_get_algo_dlen( gcry_algo );
-  unsigned char digest[ 20 ];
-  Buffer digestBuf; /* to store the generated hash */
-  digestBuf.AddAtStart(hash_length);
-  /*
-   * gcry_md_hash_buffer (int algo, void *digest, const void *buffer, size_t length);
-   * gcry_md_hash_buffer is a shortcut function to calculate a message digest of a buffer.
-   * This function does not require a context and immediately returns the message digest
-   * of the length bytes at buffer. digest must be allocated by the caller,
-   * large enough to hold the message digest yielded by the the specified algorithm algo.
-   * This required size may be obtained by using the function gcry_md_get_algo_dlen.
-   */
-
-  gcry_md_hash_buffer( GCRY_MD_SHA1, digest, keyBuff.PeekData(), KEY_SIZE_IN_BYTES );
-  Buffer::Iterator it_digest = digestBuf.Begin();
-  it_digest.Write( digest , hash_length ); // strlen( (const char*)digest)
-  it_digest = digestBuf.Begin();
-  token = it_digest.ReadNtohU32();
-  it_digest.Next( 8 );
-  idsn = it_digest.ReadNtohU64();
-  #else
-  /* the cryptographic library is not available so we rely on a ns3 specific implementation
-   * that does not comply with the standard.
-   * In the following, the idsn = the key (could be 0) and the token a truncated key
-   */
-
-  idsn = key;
-  token = (uint32_t)key;
-  #endif // HAVE_CRYPTO
+  uint8_t keyBuf[8];
+  uint8_t digest[Hash::Function::Sha256::DIGEST_SIZE];
+  uint32_t digestSize;
+
+  WriteHtonU64(keyBuf, key);
+  switch(alg)
+    {
+      case HMAC_SHA1:
+        Hash::Function::Sha1::Digest(keyBuf, sizeof(keyBuf), digest);
+        digestSize = Hash::Function::Sha1::DIGEST_SIZE;
+        break;
+      case HMAC_SHA256:
+        Hash::Function::Sha256::Digest(keyBuf, sizeof(keyBuf), digest);
+        digestSize = Hash::Function::Sha256::DIGEST_SIZE;
+        break;
+      default:
+        NS_FATAL_ERROR("Unsupported algorithm " << alg);
+    }
+
+  token = static_cast<uint32_t>(ReadNtohU64(digest) >> 32);
+  idsn = ReadNtohU64(digest + digestSize - 8);
+}
+
+void
+GenerateJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                  uint32_t localNonce, uint32_t peerNonce, uint8_t hmac[MPTCP_HMAC_SIZE])
+{
+  uint8_t msg[8];
+  uint8_t digest[Hash::Function::Sha256::DIGEST_SIZE];
+
+  WriteHtonU32(msg, localNonce);
+  WriteHtonU32(msg + 4, peerNonce);
+  ComputeHmac(alg, localKey, peerKey, msg, sizeof(msg), digest);
+  memcpy(hmac, digest, MPTCP_HMAC_SIZE);
+}
+
+uint64_t
+GenerateTruncatedJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                           uint32_t localNonce, uint32_t peerNonce)
+{
+  uint8_t hmac[MPTCP_HMAC_SIZE];
+  GenerateJoinHmac(alg, localKey, peerKey, localNonce, peerNonce, hmac);
+  return ReadNtohU64(hmac);
+}
+
+uint64_t
+GenerateAddAddressHmac( mptcp_crypto_alg_t alg, uint64_t senderKey, uint64_t receiverKey,
+                        const uint8_t* msg, uint32_t size)
+{
+  uint8_t digest[Hash::Function::Sha256::DIGEST_SIZE];
+  uint32_t digestSize = ComputeHmac(alg, senderKey, receiverKey, msg, size, digest);
+  return ReadNtohU64(digest + digestSize - 8);
 }
 
 } // end of 'ns3'
@@ -23,6 +23,8 @@
 #ifndef MPTCP_CRYPTO_H
 #define MPTCP_CRYPTO_H
 
+#include <stdint.h>
+
   /**
    * Token:  A locally unique identifier given to a multipath connection
    * by a host.  May also be referred to as a "Connection ID".
@@ -41,25 +43,30 @@
 namespace ns3
 {
   /**
-   * \brief Only SHA1 is defined in the RFC up to now.
+   * \brief Hash algorithms negotiated in MP_CAPABLE
+   *
+   * SHA-1 is the only one defined by \rfc{6824}, \rfc{8684} replaces it by SHA-256.
    */
   enum mptcp_crypto_alg_t
   {
-    HMAC_SHA1 = 1 /**< Default choice */
-    /* more may come in the future depending on the standardization */
+    HMAC_SHA1 = 1,  /**< Default choice */
+    HMAC_SHA256 = 2 /**< MPTCP version 1 */
   };
 
   /**
-   * \brief This function generates the token and idsn based on the passed key
+   * \brief Size in bytes of the HMAC carried by the third ACK of MP_JOIN
    *
-   * \note This function operates in different modes depending on if the library libgcrypt
-   *   was available when running ./waf config . The result conforms to the standard when libgcrypt
-   *  is present, otherwise it relies on a simpler incompatible ns3 implementation.
+   * HMAC-SHA256 is truncated to the leftmost 160 bits by \rfc{8684}.
+   */
+  static const uint32_t MPTCP_HMAC_SIZE = 20;
+
+  /**
+   * \brief This function generates the token and idsn based on the passed key
    *
-   * In the case of sha1 (only one standardized), the token MUST be a truncated (most
-   * significant 32 bits) SHA-1 hash according to \rfc{6824}.
-   * The least significant 64 bits of the SHA-1 hash
-   * of the key MUST be used as the initial data sequence number.
+   * The token is the most significant 32 bits of the hash of the key,
+   * the least significant 64 bits of that same hash are the initial data
+   * sequence number, as specified by \rfc{6824} (SHA-1) and \rfc{8684} (SHA-256).
+   * The key is hashed in network byte order.
    *
    * \param alg The hmac algorith m to use to generate the hash
    * \param key Given key for a connection
@@ -68,6 +75,47 @@ namespace ns3
    */
   void
   GenerateTokenForKey( mptcp_crypto_alg_t alg, uint64_t key, uint32_t& token, uint64_t& idsn);
+
+  /**
+   * \brief Computes the HMAC authenticating a MP_JOIN handshake
+   *
+   * HMAC-A = HMAC(Key=(Key-A+Key-B), Msg=(R-A+R-B)) where A is the host sending
+   * the HMAC, hence the SYN/ACK carries HMAC(Key-B+Key-A, R-B+R-A).
+   *
+   * \param alg The hmac algorithm
+   * \param localKey Key of the host sending the HMAC
+   * \param peerKey Key of the remote host
+   * \param localNonce Random number of the host sending the HMAC
+   * \param peerNonce Random number of the remote host
+   * \param hmac The leftmost MPTCP_HMAC_SIZE bytes of the HMAC
+   */
+  void
+  GenerateJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                    uint32_t localNonce, uint32_t peerNonce, uint8_t hmac[MPTCP_HMAC_SIZE]);
+
+  /**
+   * \brief Leftmost 64 bits of the HMAC, as sent in the SYN/ACK of MP_JOIN
+   *
+   * \see GenerateJoinHmac
+   * \return the truncated HMAC
+   */
+  uint64_t
+  GenerateTruncatedJoinHmac( mptcp_crypto_alg_t alg, uint64_t localKey, uint64_t peerKey,
+                             uint32_t localNonce, uint32_t peerNonce);
+
+  /**
+   * \brief Authenticates an ADD_ADDR option (\RFC{8684})
+   *
+   * \param alg The hmac algorithm
+   * \param senderKey Key of the host advertising the address
+   * \param receiverKey Key of the remote host
+   * \param msg Address ID, address and port
+   * \param size Size of msg, in bytes
+   * \return The rightmost 64 bits of HMAC(Key=(senderKey+receiverKey), Msg=msg)
+   */
+  uint64_t
+  GenerateAddAddressHmac( mptcp_crypto_alg_t alg, uint64_t senderKey, uint64_t receiverKey,
+                          const uint8_t* msg, uint32_t size);
 }
 
 #endif
@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#include "mptcp-dss.h"
+#include "tcp-option-mptcp.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpDss");
+
+MpTcpDss::MpTcpDss ()
+  : m_hasChecksum (false),
+    m_checksum (0),
+    m_flags (0),
+    m_dataAck (0),
+    m_dsn (0),
+    m_ssn (0),
+    m_dataLevelLength (0)
+{
+}
+
+void
+MpTcpDss::TruncateDSS (bool truncate)
+{
+  NS_ASSERT_MSG (m_flags & DSNMappingPresent, "Call it only after setting the mapping");
+
+  if (truncate)
+    {
+      m_flags &=  ~(0xff & DSNOfEightBytes);
+    }
+  else
+    {
+      m_flags |= DSNOfEightBytes;
+    }
+}
+
+void
+MpTcpDss::SetMapping (uint64_t headDsn, uint32_t headSsn, uint16_t length, bool enable_dfin)
+{
+  NS_ASSERT_MSG ( !(m_flags & DataFin), "For now you can't set mapping after enabling datafin");
+  m_dsn = headDsn;
+  m_ssn = headSsn;
+  // += in case there is a datafin
+  m_dataLevelLength = length;
+  m_flags |= DSNMappingPresent;
+
+  if (enable_dfin)
+    {
+      m_flags |= DataFin;
+    }
+}
+
+void
+MpTcpDss::GetMapping (uint64_t& dsn, uint32_t& ssn, uint16_t& length) const
+{
+  NS_ASSERT ( (m_flags & DSNMappingPresent) && !IsInfiniteMapping () );
+  ssn = m_ssn;
+  dsn = m_dsn;
+  length = m_dataLevelLength;
+  if (GetFlags () & DataFin)
+    {
+      length--;
+    }
+}
+
+uint32_t
+MpTcpDss::GetSerializedSize (void) const
+{
+  uint32_t len = GetSizeFromFlags (m_flags) + ((m_hasChecksum) ? 2 : 0);
+  return len;
+}
+
+uint64_t
+MpTcpDss::GetDataAck (void) const
+{
+  NS_ASSERT_MSG ( m_flags & DataAckPresent, "Can't request DataAck value when DataAck flag was not set. Check for its presence first" );
+  return m_dataAck;
+}
+
+void
+MpTcpDss::SetChecksum (const uint16_t& checksum)
+{
+  m_hasChecksum = checksum;
+}
+
+uint16_t
+MpTcpDss::GetChecksum (void) const
+{
+  NS_ASSERT (m_hasChecksum);
+  return m_checksum;
+}
+
+void
+MpTcpDss::Print (std::ostream& os) const
+{
+  os << " MP_DSS: ";
+  if (GetFlags () & DataAckPresent)
+    {
+      os << "Acknowledges [" << GetDataAck () << "] ";
+      if (GetFlags () & DataAckOf8Bytes)
+        {
+          os << "(8bytes DACK)";
+        }
+    }
+
+  if (GetFlags () & DSNMappingPresent)
+    {
+
+      if (IsInfiniteMapping ())
+        {
+          os << " Infinite Mapping";
+        }
+      else if (GetFlags () & DataFin)
+        {
+          os << "Has datafin for seq [" << GetDataFinDSN () << "]";
+        }
+      os << " DSN:" << m_dsn << " length=" << m_dataLevelLength;
+      if (GetFlags () & DSNOfEightBytes)
+        {
+          os << "(8bytes mapping)";
+        }
+    }
+}
+
+void
+MpTcpDss::Serialize (Buffer::Iterator i) const
+{
+  i.WriteU8 (TcpOption::MPTCP);
+  i.WriteU8 (GetSerializedSize ());
+  i.WriteU8 ( TcpOptionMpTcpMain::MP_DSS << 4);
+  i.WriteU8 ( m_flags );
+
+  if ( m_flags & DataAckPresent)
+    {
+      if ( m_flags & DataAckOf8Bytes)
+        {
+          i.WriteHtonU64 ( m_dataAck );
+        }
+      else
+        {
+          i.WriteHtonU32 ( static_cast<uint32_t>(m_dataAck) );
+        }
+    }
+
+  if (m_flags & DSNMappingPresent)
+    {
+
+      if ( m_flags & DSNOfEightBytes)
+        {
+          i.WriteHtonU64 ( m_dsn );
+        }
+      else
+        {
+          i.WriteHtonU32 ( m_dsn );
+        }
+
+      // Write relative SSN
+      i.WriteHtonU32 ( m_ssn );
+      i.WriteHtonU16 ( m_dataLevelLength );
+    }
+  if (m_hasChecksum)
+    {
+      i.WriteHtonU16 ( m_checksum );
+    }
+}
+
+uint32_t
+MpTcpDss::GetSizeFromFlags (uint16_t flags)
+{
+  uint32_t length = 4;
+
+  if ( flags & DataAckPresent)
+    {
+      length += 4;
+      if ( flags & DataAckOf8Bytes)
+        {
+          length += 4;
+        }
+    }
+  if ( flags & DSNMappingPresent)
+    {
+      length += 10; /* data length (2) + ssn (4) + DSN min size (4) */
+      if ( flags & DSNOfEightBytes)
+        {
+          length += 4;
+        }
+    }
+  return length;
+}
+
+uint32_t
+MpTcpDss::Deserialize (Buffer::Iterator i)
+{
+  uint8_t kind = i.ReadU8 ();
+  NS_ASSERT (kind == TcpOption::MPTCP);
+  uint32_t length = static_cast<uint32_t>(i.ReadU8 ());
+  uint8_t subtype_and_reserved = i.ReadU8 ();
+
+  NS_ASSERT ( (subtype_and_reserved >> 4) == TcpOptionMpTcpMain::MP_DSS );
+  m_flags = i.ReadU8 ();
+  uint32_t shouldBeLength = GetSizeFromFlags (m_flags);
+  NS_ASSERT (shouldBeLength == length || shouldBeLength + 2 == length);
+
+  m_hasChecksum = (shouldBeLength + 2 == length);
+  if ( m_flags & DataAckPresent)
+    {
+      if ( m_flags & DataAckOf8Bytes)
+        {
+          m_dataAck = i.ReadNtohU64 ();
+        }
+      else
+        {
+          m_dataAck = i.ReadNtohU32 ();
+        }
+    }
+  // Read mapping
+  if (m_flags & DSNMappingPresent)
+    {
+
+      if ( m_flags & DSNOfEightBytes)
+        {
+          m_dsn = i.ReadNtohU64 ();
+        }
+      else
+        {
+          m_dsn = i.ReadNtohU32 ();
+        }
+      m_ssn = i.ReadNtohU32 ();
+      m_dataLevelLength = i.ReadNtohU16 ();
+    }
+
+  if (m_hasChecksum)
+    {
+      m_checksum = i.ReadNtohU16 ( );
+    }
+
+  return length;
+}
+
+uint8_t
+MpTcpDss::GetFlags (void) const
+{
+  return m_flags;
+}
+
+/*
+Note that when the DATA_FIN is not attached to a TCP segment
+containing data, the Data Sequence Signal MUST have a subflow
+sequence number of 0, a Data-Level Length of 1, and the data sequence
+number that corresponds with the DATA_FIN itself
+*/
+bool
+MpTcpDss::DataFinMappingOnly () const
+{
+  return (m_flags & DataFin) && m_dataLevelLength == 1 && m_ssn == 0;
+}
+
+bool
+MpTcpDss::IsInfiniteMapping () const
+{
+  // The checksum, in such a case, will also be set to zero
+  return (GetFlags () & DSNMappingPresent) && m_dataLevelLength == 0;
+}
+
+uint64_t
+MpTcpDss::GetDataFinDSN () const
+{
+  NS_ASSERT ( GetFlags () & DataFin);
+
+  if (DataFinMappingOnly ())
+    {
+      return m_dsn;
+    }
+  else
+    {
+      return m_dsn + m_dataLevelLength;
+    }
+}
+
+void
+MpTcpDss::SetDataAck (const uint64_t& dack, const bool& send_as_32bits)
+{
+  NS_LOG_LOGIC (this << dack);
+
+  m_dataAck = dack;
+  m_flags |= DataAckPresent;
+
+  if (send_as_32bits)
+    {
+      m_dataAck = static_cast<uint32_t> (m_dataAck);
+    }
+  else
+    {
+      m_flags |= DataAckOf8Bytes;
+    }
+}
+
+bool
+MpTcpDss::operator== (const MpTcpDss& opt) const
+{
+  bool ret = m_flags == opt.m_flags;
+  ret &= opt.m_checksum == m_checksum;
+  ret &= opt.m_dsn == m_dsn;
+  ret &= opt.m_ssn == m_ssn;
+  ret &= opt.m_dataAck == m_dataAck;
+  return ( ret );
+}
+
+} // namespace ns3
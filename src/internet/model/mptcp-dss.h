@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#ifndef MPTCP_DSS_H
+#define MPTCP_DSS_H
+
+#include <stdint.h>
+#include <ostream>
+#include "ns3/buffer.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mptcp
+ * \brief Content of a Data Sequence Signal (DSS) option, as a plain value
+ *
+ * A DSS is sent with every MPTCP data segment and ACK. TcpHeader keeps it
+ * inline (see TcpHeader::SetMpTcpDss) rather than in its list of TcpOption
+ * objects, so that neither building nor parsing a segment allocates it.
+ * TcpOptionMpTcpDSS wraps the same fields for the generic option path.
+ *
+ * \see TcpOptionMpTcpDSS for the wire format
+ */
+class MpTcpDss
+{
+public:
+  /**
+   * \brief Each value represents the offset of a flag in LSB order
+   * \see TcpOptionMpTcpDSS
+   */
+  enum FLAG
+  {
+    DataAckPresent  = 1,       //!< matches the "A" in previous packet format
+    DataAckOf8Bytes = 2,       //!< a
+    DSNMappingPresent = 4,     //!< M bit
+    DSNOfEightBytes   = 8,     //!< m bit
+    DataFin           = 16,    //!< F . set to indicate end of communication
+    CheckSumPresent   = 32     //!< Not computed for now
+
+  };
+
+  MpTcpDss (void);
+
+  /**
+   * \brief Upon detecting an error, an MPTCP connection can fallback to legacy TCP.
+   * \return True if the mapping has a null data level length
+   */
+  bool IsInfiniteMapping () const;
+
+  /**
+   * \brief when DataFin is set, the data level length is increased by one.
+   * \return True if the mapping present is just because of the datafin
+   */
+  bool DataFinMappingOnly () const;
+
+  /**
+   * \brief Chooses between 32 and 64 bits DSN in the mapping
+   * \param truncate true to send the lower 32 bits of the DSN
+   */
+  void TruncateDSS (bool truncate);
+
+  /**
+   * \brief This returns a copy
+   * \warning Asserts if flags
+   */
+  void GetMapping (uint64_t& dsn, uint32_t& ssn, uint16_t& length) const;
+
+  /**
+   * \brief
+   * \param enable_dfin Set to true to signal a DATA_FIN
+   * \warn Mapping can be set only once, otherwise it will crash ns3
+   */
+  void SetMapping (uint64_t headDsn, uint32_t headSsn, uint16_t length, bool enable_dfin);
+
+  /**
+   * \brief A DSS length depends on what content it embeds. This is defined by the flags.
+   * \return All flags
+   */
+  uint8_t GetFlags (void) const;
+
+  /**
+   * \brief Set seq nb of acked data at MPTP level
+   * \param dack Sequence number of the dataack
+   * \param send_as_32bits Decides if the DACK should be sent as a 32 bits number
+   */
+  void SetDataAck (const uint64_t& dack, const bool& send_as_32bits = true);
+
+  /**
+   * \brief Get data ack value
+   * \warning  check the flags to know if the returned value is a 32 or 64 bits DSN
+   */
+  uint64_t GetDataAck (void) const;
+
+  /**
+   * \brief Unimplemented
+   */
+  void SetChecksum (const uint16_t&);
+
+  /**
+   * \brief Unimplemented
+   */
+  uint16_t GetChecksum (void) const;
+
+  /**
+  * \return If DFIN is set, returns its associated DSN
+  *
+  * \warning check the flags to know if it returns a 32 or 64 bits DSN
+  */
+  uint64_t GetDataFinDSN () const;
+
+  /**
+   * \brief Print the content of the option
+   * \param os output stream
+   */
+  void Print (std::ostream &os) const;
+
+  /**
+   * \brief Writes the option, kind and length included
+   * \param i where to write
+   */
+  void Serialize (Buffer::Iterator i) const;
+
+  /**
+   * \brief Reads the option, kind and length included
+   * \param i where to read from
+   * \return The length read from the option
+   */
+  uint32_t Deserialize (Buffer::Iterator i);
+
+  /**
+   * \return Size of the option, kind and length included
+   */
+  uint32_t GetSerializedSize (void) const;
+
+  /**
+  * \brief the DSS option size can change a lot
+  * The DSS size depends if it embeds a DataAck, a mapping, in 32 bits
+  *  or in 64 bits. This can compute the size depending on the flags
+  * \param flags flags of the DSS option
+  */
+  static uint32_t GetSizeFromFlags (uint16_t flags);
+
+  bool operator== (const MpTcpDss&) const;
+
+protected:
+  bool m_hasChecksum;   //!< true if checksums enabled
+  uint16_t m_checksum;  //!< valeu of the checksum
+  uint8_t m_flags;  //!< bitfield
+
+  // In fact for now we use only 32 LSB
+  uint64_t m_dataAck;           /**< Can be On 32 bits dependings on the flags **/
+  uint64_t m_dsn;               /**< Data Sequence Number (Can be On 32 bits dependings on the flags) */
+  uint32_t m_ssn;               /**< Subflow Sequence Number, always 32bits */
+  uint16_t m_dataLevelLength;   /**< Length of the mapping and/or +1 if DFIN */
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_DSS_H */
@@ -40,7 +40,7 @@ TypeId
 MpTcpFullMesh::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns::MpTcpFullMesh")
-    .SetParent<Object> ()
+    .SetParent<MpTcpPathManager> ()
     .AddConstructor<MpTcpFullMesh> ()
     .SetGroupName ("Internet")
 
@@ -49,7 +49,7 @@ MpTcpFullMesh::GetTypeId (void)
 }
 
 MpTcpFullMesh::MpTcpFullMesh (void)
-  : Object()
+  : MpTcpPathManager()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -74,4 +74,27 @@ MpTcpFullMesh::CreateMesh(Ptr<MpTcpSocketBase> meta)
   meta->CreateSubflowsForMesh();
 }
 
+void
+MpTcpFullMesh::OnFullyEstablished(Ptr<MpTcpSocketBase> meta)
+{
+  NS_LOG_FUNCTION(this << meta);
+  CreateMesh(meta);
+}
+
+void
+MpTcpFullMesh::OnLocalAddressUp(Ptr<MpTcpSocketBase> meta, const Address& address)
+{
+  NS_LOG_FUNCTION(this << meta << address);
+  MpTcpPathManager::OnLocalAddressUp(meta, address);
+  // the address may be new, pairs already meshed are skipped
+  CreateMesh(meta);
+}
+
+void
+MpTcpFullMesh::OnRemoteAddressAdded(Ptr<MpTcpSocketBase> meta, const Address& address, uint16_t port, uint8_t id)
+{
+  NS_LOG_FUNCTION(this << meta << address << port << (int)id);
+  meta->CreateSubflowsForMesh();
+}
+
 } //namespace ns3
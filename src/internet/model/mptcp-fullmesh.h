@@ -23,6 +23,7 @@
 #define MPTCP_FULLMESH_H
 
 #include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-path-manager.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/object.h"
 
@@ -38,8 +39,11 @@ namespace ns3 {
  * sender and receiver. This class makes calls to add addresses of the local 
  * host to the container. Makes call to the function CreateSubflowsForMesh
  * from MPTCP socket base to create subflows
+ *
+ * The mesh is extended whenever the peer advertises a new address or a local
+ * interface goes up.
  */
-class MpTcpFullMesh : public Object
+class MpTcpFullMesh : public MpTcpPathManager
 {
 public:
   /**
@@ -65,6 +69,10 @@ public:
 
   virtual void CreateMesh(Ptr<MpTcpSocketBase> meta);
 
+  virtual void OnFullyEstablished (Ptr<MpTcpSocketBase> meta);
+  virtual void OnLocalAddressUp (Ptr<MpTcpSocketBase> meta, const Address& address);
+  virtual void OnRemoteAddressAdded (Ptr<MpTcpSocketBase> meta, const Address& address, uint16_t port, uint8_t id);
+
 };
 
 } //namespace ns3
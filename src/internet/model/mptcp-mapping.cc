@@ -34,9 +34,6 @@ NS_LOG_COMPONENT_DEFINE("MpTcpMapping");
 namespace ns3
 {
 
-// brief sorted on DSNs
-typedef std::set<MpTcpMapping> MappingList;
-
 MpTcpMapping::MpTcpMapping()
   : m_dataSequenceNumber(0),
     m_subflowSequenceNumber(0),
@@ -77,6 +74,14 @@ operator<<(std::ostream& os, const MpTcpMapping& mapping)
   return os;
 }
 
+SequenceNumber64
+ExpandDsn(uint32_t dsn, const SequenceNumber64& reference)
+{
+  // signed distance between the lower bits, as for SequenceNumber32
+  int32_t delta = static_cast<int32_t>(dsn - static_cast<uint32_t>(reference.GetValue()));
+  return reference + delta;
+}
+
 void
 MpTcpMapping::SetHeadDSN(SequenceNumber64 const& dsn)
 {
@@ -182,6 +187,10 @@ MpTcpMapping::OverlapRangeDSN(const SequenceNumber64& headDSN, const uint16_t& l
 ///////////////////////////////////////////////////////////
 ///// MpTcpMappingContainer
 MpTcpMappingContainer::MpTcpMappingContainer(void)
+  : m_head(0),
+    m_size(0),
+    m_dsnIndexBegin(0),
+    m_dsnIndexStale(0)
 {
   NS_LOG_LOGIC(this);
 }
@@ -191,38 +200,238 @@ MpTcpMappingContainer::~MpTcpMappingContainer(void)
   NS_LOG_LOGIC(this);
 }
 
+uint32_t
+MpTcpMappingContainer::GetSize() const
+{
+  return m_size;
+}
+
+bool
+MpTcpMappingContainer::IsEmpty() const
+{
+  return m_size == 0;
+}
+
+const MpTcpMapping&
+MpTcpMappingContainer::At(uint32_t i) const
+{
+  NS_ASSERT(i < m_size);
+  return m_ring[(m_head + i) & (m_ring.size() - 1)];
+}
+
+uint32_t
+MpTcpMappingContainer::LowerBoundSSN(const SequenceNumber32& ssn) const
+{
+  uint32_t low = 0;
+  uint32_t high = m_size;
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    if(At(mid).HeadSSN() < ssn)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+uint32_t
+MpTcpMappingContainer::UpperBoundSSN(const SequenceNumber32& ssn) const
+{
+  uint32_t low = 0;
+  uint32_t high = m_size;
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    if(ssn < At(mid).HeadSSN())
+    {
+      high = mid;
+    }
+    else
+    {
+      low = mid + 1;
+    }
+  }
+  return low;
+}
+
+void
+MpTcpMappingContainer::Grow()
+{
+  uint32_t capacity = std::max<uint32_t>(8, 2 * m_ring.size());
+  NS_LOG_LOGIC(this << " growing mapping ring to " << capacity);
+  std::vector<MpTcpMapping> ring(capacity);
+  for(uint32_t i = 0; i < m_size; ++i)
+  {
+    ring[i] = At(i);
+  }
+  m_ring.swap(ring);
+  m_head = 0;
+}
+
+void
+MpTcpMappingContainer::EraseAt(uint32_t pos)
+{
+  NS_ASSERT(pos < m_size);
+  const uint32_t mask = m_ring.size() - 1;
+  if(pos < m_size / 2)
+  {
+    // move the mappings before pos one slot forward
+    for(uint32_t i = pos; i > 0; --i)
+    {
+      m_ring[(m_head + i) & mask] = m_ring[(m_head + i - 1) & mask];
+    }
+    m_head = (m_head + 1) & mask;
+  }
+  else
+  {
+    for(uint32_t i = pos; i + 1 < m_size; ++i)
+    {
+      m_ring[(m_head + i) & mask] = m_ring[(m_head + i + 1) & mask];
+    }
+  }
+  m_size--;
+}
+
+bool
+MpTcpMappingContainer::DsnIndexLess(const DsnIndexEntry& a, const DsnIndexEntry& b)
+{
+  return a.headDsn < b.headDsn;
+}
+
+bool
+MpTcpMappingContainer::IsLiveEntry(const DsnIndexEntry& entry) const
+{
+  uint32_t pos = LowerBoundSSN(entry.headSsn);
+  return (pos < m_size
+          && At(pos).HeadSSN() == entry.headSsn
+          && At(pos).HeadDSN() == entry.headDsn);
+}
+
+void
+MpTcpMappingContainer::UnindexMapping(const MpTcpMapping& mapping)
+{
+  if(m_size == 0)
+  {
+    m_dsnIndex.clear();
+    m_dsnIndexBegin = 0;
+    m_dsnIndexStale = 0;
+    return;
+  }
+
+  if(m_dsnIndexBegin < m_dsnIndex.size()
+     && m_dsnIndex[m_dsnIndexBegin].headSsn == mapping.HeadSSN()
+     && m_dsnIndex[m_dsnIndexBegin].headDsn == mapping.HeadDSN())
+  {
+    m_dsnIndexBegin++;
+  }
+  else
+  {
+    m_dsnIndexStale++;
+  }
+
+  if(m_dsnIndexStale > m_size)
+  {
+    CompactDsnIndex();
+  }
+  else if(2 * m_dsnIndexBegin > m_dsnIndex.size())
+  {
+    m_dsnIndex.erase(m_dsnIndex.begin(), m_dsnIndex.begin() + m_dsnIndexBegin);
+    m_dsnIndexBegin = 0;
+  }
+}
+
+void
+MpTcpMappingContainer::CompactDsnIndex()
+{
+  NS_LOG_LOGIC(this << " compacting DSN index (" << m_dsnIndexStale << " stale entries)");
+  std::vector<DsnIndexEntry>::iterator out = m_dsnIndex.begin();
+  for(uint32_t i = m_dsnIndexBegin; i < m_dsnIndex.size(); ++i)
+  {
+    if(IsLiveEntry(m_dsnIndex[i]))
+    {
+      *out++ = m_dsnIndex[i];
+    }
+  }
+  m_dsnIndex.erase(out, m_dsnIndex.end());
+  m_dsnIndexBegin = 0;
+  m_dsnIndexStale = 0;
+}
+
 void
 MpTcpMappingContainer::Dump() const
 {
   NS_LOG_UNCOND("\n==== Dumping list of mappings ====");
-  for( MappingList::const_iterator it = m_mappings.begin(); it != m_mappings.end(); it++ )
+  for(uint32_t i = 0; i < m_size; ++i)
   {
-    NS_LOG_UNCOND( *it );
+    NS_LOG_UNCOND( At(i) );
   }
   NS_LOG_UNCOND("==== End of dump ====\n");
 }
 
-//! should return a boolean
 bool
 MpTcpMappingContainer::AddMapping(const MpTcpMapping& mapping)
 {
   NS_LOG_LOGIC("Adding mapping " << mapping);
 
   NS_ASSERT(mapping.GetLength() != 0);
-  std::pair<MappingList::iterator,bool> res = m_mappings.insert( mapping);
+  uint32_t pos = LowerBoundSSN(mapping.HeadSSN());
+  if( (pos < m_size && At(pos).OverlapRangeSSN(mapping.HeadSSN(), mapping.GetLength()))
+     || (pos > 0 && At(pos - 1).OverlapRangeSSN(mapping.HeadSSN(), mapping.GetLength())))
+  {
+    return false;
+  }
+
+  if(m_size == m_ring.size())
+  {
+    Grow();
+  }
+  const uint32_t mask = m_ring.size() - 1;
+  if(pos == 0 && m_size > 0)
+  {
+    m_head = (m_head - 1) & mask;
+  }
+  else
+  {
+    // Mappings are mostly appended, in which case nothing moves
+    for(uint32_t i = m_size; i > pos; --i)
+    {
+      m_ring[(m_head + i) & mask] = m_ring[(m_head + i - 1) & mask];
+    }
+  }
+  m_ring[(m_head + pos) & mask] = mapping;
+  m_size++;
 
-  return res.second;
+  DsnIndexEntry entry;
+  entry.headDsn = mapping.HeadDSN();
+  entry.headSsn = mapping.HeadSSN();
+  if(m_dsnIndexBegin == m_dsnIndex.size() || !DsnIndexLess(entry, m_dsnIndex.back()))
+  {
+    m_dsnIndex.push_back(entry);
+  }
+  else
+  {
+    // reinjected data, or mappings received out of order
+    m_dsnIndex.insert(std::upper_bound(m_dsnIndex.begin() + m_dsnIndexBegin, m_dsnIndex.end(),
+                                       entry, &MpTcpMappingContainer::DsnIndexLess),
+                      entry);
+  }
+  return true;
 }
 
 bool
 MpTcpMappingContainer::FirstUnmappedSSN(SequenceNumber32& ssn) const
 {
   NS_LOG_FUNCTION_NOARGS();
-  if(m_mappings.empty())
+  if(m_size == 0)
   {
       return false;
   }
-  ssn = m_mappings.rbegin()->TailSSN() + 1;
+  ssn = At(m_size - 1).TailSSN() + 1;
   return true;
 }
 
@@ -230,7 +439,30 @@ bool
 MpTcpMappingContainer::DiscardMapping(const MpTcpMapping& mapping)
 {
   NS_LOG_LOGIC("discard mapping "<< mapping);
-  return m_mappings.erase(mapping);
+  uint32_t pos = LowerBoundSSN(mapping.HeadSSN());
+  if(pos == m_size || At(pos) != mapping)
+  {
+    return false;
+  }
+  EraseAt(pos);
+  UnindexMapping(mapping);
+  return true;
+}
+
+uint32_t
+MpTcpMappingContainer::DiscardMappingsUpTo(const SequenceNumber64& maxDsn, const SequenceNumber32& maxSsn)
+{
+  NS_LOG_FUNCTION(this << maxDsn << maxSsn);
+  uint32_t nbDiscarded = 0;
+  while(m_size > 0 && At(0).TailSSN() < maxSsn && At(0).TailDSN() < maxDsn)
+  {
+    MpTcpMapping mapping = At(0);
+    m_head = (m_head + 1) & (m_ring.size() - 1);
+    m_size--;
+    UnindexMapping(mapping);
+    nbDiscarded++;
+  }
+  return nbDiscarded;
 }
 
 bool
@@ -238,12 +470,10 @@ MpTcpMappingContainer::GetMappingsStartingFromSSN(SequenceNumber32 ssn, std::set
 {
   NS_LOG_FUNCTION(this << ssn );
   missing.clear();
-  //http://www.cplusplus.com/reference/algorithm/equal_range/
-  MpTcpMapping temp;
-  temp.MapToSSN(ssn);
-  MappingList::const_iterator it = std::lower_bound( m_mappings.begin(), m_mappings.end(), temp);
-
-  std::copy(it, m_mappings.end(), std::inserter(missing, missing.begin()));
+  for(uint32_t i = LowerBoundSSN(ssn); i < m_size; ++i)
+  {
+    missing.insert(missing.end(), At(i));
+  }
   return false;
 }
 
@@ -251,17 +481,61 @@ bool
 MpTcpMappingContainer::GetMappingForSSN(const SequenceNumber32& ssn, MpTcpMapping& mapping) const
 {
   NS_LOG_FUNCTION(this << ssn);
-  if(m_mappings.empty())
+  // last mapping starting at or before ssn
+  uint32_t pos = UpperBoundSSN(ssn);
+  if(pos == 0)
     return false;
-  MpTcpMapping temp;
-  temp.MapToSSN(ssn);
-
-  // Returns the first that is not less
-  // upper_bound returns the greater
-  MappingList::const_iterator it = std::upper_bound( m_mappings.begin(), m_mappings.end(), temp);
-  it--;
-  mapping = *it;
-  return mapping.IsSSNInRange( ssn );               // IsSSNInRange() return ( (HeadSSN() <= ssn) && (TailSSN() >= ssn) );
+  mapping = At(pos - 1);
+  return mapping.IsSSNInRange( ssn );
+}
+
+bool
+MpTcpMappingContainer::LowestDSN(SequenceNumber64& dsn) const
+{
+  NS_LOG_FUNCTION(this);
+  // stale entries are few, see UnindexMapping
+  for(uint32_t i = m_dsnIndexBegin; i < m_dsnIndex.size(); ++i)
+  {
+    if(IsLiveEntry(m_dsnIndex[i]))
+    {
+      dsn = m_dsnIndex[i].headDsn;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+MpTcpMappingContainer::GetMappingForDSN(const SequenceNumber64& dsn, MpTcpMapping& mapping) const
+{
+  NS_LOG_FUNCTION(this << dsn);
+  DsnIndexEntry key;
+  key.headDsn = dsn;
+  std::vector<DsnIndexEntry>::const_iterator first = m_dsnIndex.begin() + m_dsnIndexBegin;
+  std::vector<DsnIndexEntry>::const_iterator it = std::upper_bound(first, m_dsnIndex.end(), key,
+                                                                   &MpTcpMappingContainer::DsnIndexLess);
+  // A mapping is at most 0xffff long, so only the entries starting
+  // in [dsn - 0xffff, dsn] may cover dsn
+  bool found = false;
+  while(it != first)
+  {
+    --it;
+    if(it->headDsn + 0xffff < dsn)
+    {
+      break;
+    }
+    if(!IsLiveEntry(*it))
+    {
+      continue;
+    }
+    const MpTcpMapping& candidate = At(LowerBoundSSN(it->headSsn));
+    if(candidate.IsDSNInRange(dsn) && (!found || mapping.HeadSSN() < candidate.HeadSSN()))
+    {
+      mapping = candidate;
+      found = true;
+    }
+  }
+  return found;
 }
 
 } // namespace ns3
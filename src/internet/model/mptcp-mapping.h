@@ -166,8 +166,14 @@ protected:
  * Mapping handling
  * Once a mapping has been advertised on a subflow, it must be honored. If the remote host already received the data
  * (because it was sent in parallel over another subflow), then the received data must be discarded.
- * Could be fun implemented as an interval tree
- * http://www.geeksforgeeks.org/interval-tree/
+ *
+ * Mappings never overlap in SSN space and are appended almost always in SSN order,
+ * hence they are kept sorted by SSN in a contiguous ring buffer: appending and
+ * removing acked mappings from the front is O(1), SSN lookups are binary searches.
+ * DSN lookups go through a secondary index sorted by DSN, whose entries are removed
+ * lazily (an entry whose mapping is gone is skipped, and the index gets compacted
+ * once stale entries outnumber the live ones).
+ * Storage only grows (by doubling) so that steady state traffic does not allocate.
  */
 
 class MpTcpMappingContainer
@@ -182,8 +188,11 @@ public:
    * This can be called only when dsn is in the meta socket Rx buffer and in order
    * (since it may renegate some data when out of order).
    * The mapping should also have been thoroughly fulfilled at the subflow level.
+   * Mappings are discarded from the lowest SSN and the process stops at the first mapping
+   * that does not match, so the cost is proportional to the number of discarded mappings.
    * \return Number of mappings discarded. >= 0
    */
+  uint32_t DiscardMappingsUpTo(const SequenceNumber64& maxDsn, const SequenceNumber32& maxSsn);
 
   /**
    * \brief When Buffers work in non renegotiable mode,
@@ -208,7 +217,7 @@ public:
    * Should do no check
    * The mapping
    * \note Check for overlap.
-   * \return False if the dsn range overlaps with a registered mapping, true otherwise
+   * \return False if the ssn range overlaps with a registered mapping, true otherwise
   **/
   bool AddMapping(const MpTcpMapping& mapping);
 
@@ -219,17 +228,120 @@ public:
   bool
   GetMappingForSSN(const SequenceNumber32& ssn, MpTcpMapping& m) const;
 
+  /**
+   * \brief Looks for the mapping covering a DSN.
+   * The same DSN may be mapped several times when data gets reinjected,
+   * in which case the mapping with the highest SSN is returned.
+   * \param dsn data sequence number to look for
+   * \param m mapping found, if any
+   * \return true if a mapping covers dsn
+   */
+  bool
+  GetMappingForDSN(const SequenceNumber64& dsn, MpTcpMapping& m) const;
+
+  /**
+   * \brief Lowest DSN still mapped, whichever the SSN of its mapping
+   * \param dsn head DSN of the mapping with the lowest DSN, if any
+   * \return false if no mapping is registered
+   */
+  bool LowestDSN(SequenceNumber64& dsn) const;
+
   /**
    * \param dsn
    */
   virtual bool GetMappingsStartingFromSSN(SequenceNumber32 ssn, std::set<MpTcpMapping>& mappings);
 
+  /**
+   * \return Number of registered mappings
+   */
+  uint32_t GetSize() const;
+
+  /**
+   * \return True if no mapping is registered
+   */
+  bool IsEmpty() const;
+
 protected:
+  /**
+   * \brief Entry of the DSN index
+   *
+   * Refers to a mapping through its head SSN, which stays valid when the ring moves.
+   */
+  struct DsnIndexEntry
+  {
+    SequenceNumber64 headDsn; //!< Head DSN of the mapping
+    SequenceNumber32 headSsn; //!< Head SSN of the mapping, identifies it in the ring
+  };
+
+  /**
+   * \brief Orders the DSN index by head DSN
+   */
+  static bool DsnIndexLess(const DsnIndexEntry& a, const DsnIndexEntry& b);
+
+  /**
+   * \return True if the entry still refers to a registered mapping
+   */
+  bool IsLiveEntry(const DsnIndexEntry& entry) const;
+
+  /**
+   * \param i logical position, 0 being the mapping with the lowest SSN
+   * \return the mapping stored at this position
+   */
+  const MpTcpMapping& At(uint32_t i) const;
+
+  /**
+   * \return Position of the first mapping whose head SSN is >= ssn (GetSize() if none)
+   */
+  uint32_t LowerBoundSSN(const SequenceNumber32& ssn) const;
+
+  /**
+   * \return Position of the first mapping whose head SSN is > ssn (GetSize() if none)
+   */
+  uint32_t UpperBoundSSN(const SequenceNumber32& ssn) const;
+
+  /**
+   * \brief Doubles the ring capacity, unrolling it so that the head ends up at slot 0
+   */
+  void Grow();
+
+  /**
+   * \brief Removes the mapping at logical position i, shifting the shorter side of the ring
+   */
+  void EraseAt(uint32_t i);
 
-    std::set<MpTcpMapping> m_mappings;     //!< it is a set ordered by SSN
+  /**
+   * \brief Drops the DSN index entry of a discarded mapping
+   *
+   * The entry is erased right away when it is the first of the index, which is the common case
+   * as DSN and SSN mostly grow together; otherwise it is left stale.
+   */
+  void UnindexMapping(const MpTcpMapping& mapping);
+
+  /**
+   * \brief Rebuilds the DSN index without its stale entries
+   */
+  void CompactDsnIndex();
+
+  std::vector<MpTcpMapping> m_ring;  //!< Mappings sorted by SSN, capacity is a power of 2
+  uint32_t m_head;                   //!< Slot of the mapping with the lowest SSN
+  uint32_t m_size;                   //!< Number of mappings in the ring
+
+  std::vector<DsnIndexEntry> m_dsnIndex;  //!< Sorted by DSN, may hold stale entries
+  uint32_t m_dsnIndexBegin;               //!< First meaningful entry of m_dsnIndex
+  uint32_t m_dsnIndexStale;               //!< Number of stale entries after m_dsnIndexBegin
 };
 
 std::ostream& operator<<(std::ostream &os, const MpTcpMapping& mapping);
 
+/**
+ * \brief Infers a 64 bits DSN from its lower 32 bits, as sent in a DSS option
+ * without the DSNOfEightBytes/DataAckOf8Bytes flags
+ *
+ * \param dsn lower 32 bits of the DSN
+ * \param reference a DSN known to be less than 2^31 away, e.g. the next expected one
+ * \return The DSN with these lower bits closest to reference
+ */
+SequenceNumber64 ExpandDsn(uint32_t dsn, const SequenceNumber64& reference);
+
 } //namespace ns3
 #endif //MP_TCP_TYPEDEFS_H
@@ -40,7 +40,7 @@ TypeId
 MpTcpNdiffPorts::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns::MpTcpNdiffPorts")
-    .SetParent<Object> ()
+    .SetParent<MpTcpPathManager> ()
     .SetGroupName ("Internet")
     .AddConstructor<MpTcpNdiffPorts> ()
     .AddAttribute ("MaxSubflows", "Maximum number of sub-flows per each mptcp connection",
@@ -53,7 +53,7 @@ MpTcpNdiffPorts::GetTypeId (void)
 }
 
 MpTcpNdiffPorts::MpTcpNdiffPorts (void)
-  : Object()
+  : MpTcpPathManager()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -74,8 +74,8 @@ MpTcpNdiffPorts::CreateSubflows (Ptr<MpTcpSocketBase> meta, uint16_t localport,
 { 
   NS_LOG_FUNCTION(this<< meta << localport<< remoteport);
 
-  uint16_t port1 = meta->m_endPoint->GetLocalPort();
-  uint16_t port2 = meta->m_endPoint->GetPeerPort ();
+  uint16_t port1 = meta->GetLocalPort();
+  uint16_t port2 = meta->GetPeerPort ();
   std::cout<<"port1 and port2 "<<port1<<":"<<port2<<" localport and remoteport "<<localport<<":"<<remoteport<<std::endl;
   for (int i = 0; i < m_maxSubflows; i++)
     {
@@ -91,4 +91,11 @@ MpTcpNdiffPorts::CreateSubflows (Ptr<MpTcpSocketBase> meta, uint16_t localport,
     }
 }
 
+void
+MpTcpNdiffPorts::OnFullyEstablished(Ptr<MpTcpSocketBase> meta)
+{
+  NS_LOG_FUNCTION(this << meta);
+  CreateSubflows(meta, meta->GetLocalPort(), meta->GetPeerPort());
+}
+
 } //namespace ns3
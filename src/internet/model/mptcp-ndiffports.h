@@ -24,6 +24,7 @@
 #define MPTCP_NDIFFPORTS_H
 
 #include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-path-manager.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/object.h"
 
@@ -42,7 +43,7 @@ class MpTcpSocketBase;
  * from MpTcpSocketBase to create subflows with different source and destination
  * port pairs
  */
-class MpTcpNdiffPorts : public Object
+class MpTcpNdiffPorts : public MpTcpPathManager
 {
 public:
   /**
@@ -71,6 +72,8 @@ public:
 
   void CreateSubflows (Ptr<MpTcpSocketBase> meta, uint16_t localport, uint16_t remoteport);
 
+  virtual void OnFullyEstablished (Ptr<MpTcpSocketBase> meta);
+
   uint8_t m_maxSubflows {3} ;  //!< Maximum number of subflows per mptcp connection
 
 };
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-path-manager.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/socket.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpPathManager");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpPathManager);
+
+TypeId
+MpTcpPathManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpPathManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpPathManager> ()
+    .AddAttribute ("TimeoutThreshold",
+                   "Number of consecutive retransmission timeouts after which "
+                   "the path of a subflow is considered as failed",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&MpTcpPathManager::m_rtoThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+MpTcpPathManager::MpTcpPathManager (void)
+  : Object (),
+    m_rtoThreshold (2)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpPathManager::~MpTcpPathManager (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpTcpPathManager::OnFullyEstablished (Ptr<MpTcpSocketBase> meta)
+{
+  NS_LOG_FUNCTION (this << meta);
+}
+
+void
+MpTcpPathManager::OnSubflowEstablished (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  // a new regular subflow may make the promoted backups useless
+  UpdateBackupPromotion (meta);
+}
+
+void
+MpTcpPathManager::OnSubflowClosed (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  UpdateBackupPromotion (meta);
+}
+
+void
+MpTcpPathManager::OnSubflowTimeout (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf, uint32_t timeouts)
+{
+  NS_LOG_FUNCTION (this << meta << sf << timeouts);
+  if (sf->IsPathFailed ())
+    {
+      return;
+    }
+  // a recovered subflow timing out again is not given another chance
+  if (timeouts >= m_rtoThreshold || sf->GetHealth () == MpTcpSubflow::Recovered)
+    {
+      NS_LOG_INFO ("Subflow " << sf << " timed out " << timeouts << " times in a row");
+      FailSubflow (meta, sf);
+    }
+  else if (sf->GetHealth () == MpTcpSubflow::Active)
+    {
+      SuspectSubflow (meta, sf);
+    }
+}
+
+void
+MpTcpPathManager::OnSubflowRecovered (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  if (!sf->IsHealthy ())
+    {
+      RecoverSubflow (meta, sf);
+    }
+}
+
+void
+MpTcpPathManager::OnSubflowUnreachable (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  if (!sf->IsPathFailed ())
+    {
+      FailSubflow (meta, sf);
+    }
+}
+
+void
+MpTcpPathManager::OnLocalAddressUp (Ptr<MpTcpSocketBase> meta, const Address& address)
+{
+  NS_LOG_FUNCTION (this << meta << address);
+  // copy since recovering sends data and may move subflows
+  MpTcpSocketBase::SubflowList subflows = meta->m_subflows[MpTcpSocketBase::Established];
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin (); it != subflows.end (); ++it)
+    {
+      if ((*it)->IsPathFailed () && (*it)->GetLocalIp () == address)
+        {
+          RecoverSubflow (meta, *it);
+        }
+    }
+}
+
+void
+MpTcpPathManager::OnLocalAddressDown (Ptr<MpTcpSocketBase> meta, const Address& address)
+{
+  NS_LOG_FUNCTION (this << meta << address);
+  MpTcpSocketBase::SubflowList subflows = meta->m_subflows[MpTcpSocketBase::Established];
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin (); it != subflows.end (); ++it)
+    {
+      if (!(*it)->IsPathFailed () && (*it)->GetLocalIp () == address)
+        {
+          FailSubflow (meta, *it);
+        }
+    }
+}
+
+void
+MpTcpPathManager::OnRemoteAddressAdded (Ptr<MpTcpSocketBase> meta, const Address& address, uint16_t port, uint8_t id)
+{
+  NS_LOG_FUNCTION (this << meta << address << port << (int)id);
+}
+
+void
+MpTcpPathManager::OnRemoteAddressRemoved (Ptr<MpTcpSocketBase> meta, const Address& address)
+{
+  NS_LOG_FUNCTION (this << meta << address);
+  MpTcpSocketBase::SubflowList subflows = meta->m_subflows[MpTcpSocketBase::Established];
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin (); it != subflows.end (); ++it)
+    {
+      if ((*it)->GetPeerIp () != address)
+        {
+          continue;
+        }
+      if (!(*it)->IsPathFailed ())
+        {
+          FailSubflow (meta, *it);
+        }
+      // Close is only public through the Socket interface
+      Ptr<Socket> sock = *it;
+      sock->Close ();
+    }
+}
+
+void
+MpTcpPathManager::SuspectSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  sf->SetHealth (MpTcpSubflow::PotentiallyFailed);
+  meta->ReinjectSubflowData (sf);
+  meta->SendPendingData (true);
+}
+
+void
+MpTcpPathManager::FailSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  sf->SetHealth (MpTcpSubflow::Failed);
+  meta->ReinjectSubflowData (sf);
+  UpdateBackupPromotion (meta);
+  meta->SendPendingData (true);
+}
+
+void
+MpTcpPathManager::RecoverSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION (this << meta << sf);
+  sf->SetHealth (MpTcpSubflow::Recovered);
+  UpdateBackupPromotion (meta);
+  meta->SendPendingData (true);
+}
+
+void
+MpTcpPathManager::UpdateBackupPromotion (Ptr<MpTcpSocketBase> meta)
+{
+  NS_LOG_FUNCTION (this << meta);
+  const MpTcpSocketBase::SubflowList& subflows = meta->m_subflows[MpTcpSocketBase::Established];
+  bool regularLeft = false;
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin (); it != subflows.end (); ++it)
+    {
+      if (!(*it)->IsPathFailed () && !(*it)->BackupSubflow ())
+        {
+          regularLeft = true;
+          break;
+        }
+    }
+  if (regularLeft != meta->m_backupsPromoted)
+    {
+      return;
+    }
+  meta->m_backupsPromoted = !regularLeft;
+  NS_LOG_INFO ((meta->m_backupsPromoted ? "Promoting" : "Demoting") << " backup subflows");
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin (); it != subflows.end (); ++it)
+    {
+      if (!(*it)->IsPathFailed () && (*it)->BackupSubflow ())
+        {
+          (*it)->SendMpPriority (!meta->m_backupsPromoted);
+        }
+    }
+}
+
+} // namespace ns3
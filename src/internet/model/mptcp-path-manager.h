@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_PATH_MANAGER_H
+#define MPTCP_PATH_MANAGER_H
+
+#include "ns3/object.h"
+#include "ns3/address.h"
+
+namespace ns3 {
+
+class MpTcpSocketBase;
+class MpTcpSubflow;
+
+/**
+ * \ingroup mptcp
+ *
+ * \brief Base class of the MPTCP path managers
+ *
+ * A meta socket gets its path manager once the connection is fully
+ * established (see MpTcpSocketBase::PathManagerMode). The meta then forwards
+ * it the events that may change the set of usable paths:
+ * - the local interfaces going up or down (Ipv4L3Protocol/Ipv6L3Protocol
+ *   "InterfaceUp" and "InterfaceDown" trace sources),
+ * - subflows experiencing retransmission timeouts, receiving an ICMP
+ *   destination unreachable or recovering,
+ * - the addresses advertised or removed by the peer (ADD_ADDR/REMOVE_ADDR).
+ *
+ * This base class opens no subflow but handles failover, following the
+ * MpTcpSubflow::HealthState of the subflows. A subflow gets suspected on its
+ * first RTO: its unacknowledged data is reinjected on the other subflows,
+ * which get the new data as long as they are healthy. After
+ * TimeoutThreshold RTOs, on an ICMP destination unreachable or when its
+ * interface goes down, the subflow fails: it is excluded from the scheduling
+ * and, when no regular subflow is left, the backup subflows get promoted (an
+ * MP_PRIO clearing the B flag is sent to the peer). They are demoted again as
+ * soon as a regular path recovers.
+ *
+ * A failed subflow is not closed: its own retransmissions keep probing the
+ * path and the subflow gets back in use on the next acknowledgment.
+ * Together with subflows opened on new interfaces, this gives a
+ * make-before-break handover.
+ *
+ * Path managers keep no per connection state, all of it lives in the meta
+ * given to each event. Hence the connections of a node share a single path
+ * manager per TypeId (see TcpL4Protocol::GetMpTcpPathManager).
+ */
+class MpTcpPathManager : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpPathManager (void);
+  virtual ~MpTcpPathManager (void);
+
+  /**
+   * \brief Called once the connection is fully established, i.e. subflows can be joined
+   * \param meta the connection
+   */
+  virtual void OnFullyEstablished (Ptr<MpTcpSocketBase> meta);
+
+  /**
+   * \brief A subflow entered the ESTABLISHED state
+   */
+  virtual void OnSubflowEstablished (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief A subflow got definitely closed
+   */
+  virtual void OnSubflowClosed (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief The retransmission timer of a subflow expired
+   * \param timeouts Number of consecutive expirations without new acknowledgment
+   */
+  virtual void OnSubflowTimeout (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf, uint32_t timeouts);
+
+  /**
+   * \brief A suspected or failed subflow received new acknowledgments
+   */
+  virtual void OnSubflowRecovered (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief A subflow received an ICMP destination unreachable
+   */
+  virtual void OnSubflowUnreachable (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief An interface holding a local address went up
+   * \param address Ipv4Address or Ipv6Address
+   */
+  virtual void OnLocalAddressUp (Ptr<MpTcpSocketBase> meta, const Address& address);
+
+  /**
+   * \brief An interface holding a local address went down
+   * \param address Ipv4Address or Ipv6Address
+   */
+  virtual void OnLocalAddressDown (Ptr<MpTcpSocketBase> meta, const Address& address);
+
+  /**
+   * \brief The peer advertised a new address
+   * \param address Ipv4Address or Ipv6Address
+   * \param port advertised port
+   * \param id address id chosen by the peer
+   */
+  virtual void OnRemoteAddressAdded (Ptr<MpTcpSocketBase> meta, const Address& address, uint16_t port, uint8_t id);
+
+  /**
+   * \brief The peer removed one of its addresses
+   * \param address Ipv4Address or Ipv6Address
+   */
+  virtual void OnRemoteAddressRemoved (Ptr<MpTcpSocketBase> meta, const Address& address);
+
+protected:
+  /**
+   * \brief Reinjects what a subflow holds and prefers the healthy subflows for new data
+   */
+  virtual void SuspectSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Stops scheduling data on a subflow and reinjects what it holds
+   */
+  virtual void FailSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Schedules data on a failed subflow again
+   */
+  virtual void RecoverSubflow (Ptr<MpTcpSocketBase> meta, Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Promotes the backup subflows when no healthy regular subflow is
+   * left, demotes them otherwise. MP_PRIO options are sent on transitions only.
+   */
+  virtual void UpdateBackupPromotion (Ptr<MpTcpSocketBase> meta);
+
+  uint32_t m_rtoThreshold;  //!< Consecutive RTOs after which a path is considered failed
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_PATH_MANAGER_H */
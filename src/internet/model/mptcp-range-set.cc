@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-range-set.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpRangeSet");
+
+namespace ns3 {
+
+MpTcpRangeSet::MpTcpRangeSet ()
+  : m_bytes (0)
+{
+}
+
+MpTcpRangeSet::RangeMap::const_iterator
+MpTcpRangeSet::Find (const SequenceNumber64& seq) const
+{
+  // last range whose head is <= seq
+  RangeMap::const_iterator it = m_ranges.upper_bound (seq);
+  if (it == m_ranges.begin ())
+    {
+      return m_ranges.end ();
+    }
+  --it;
+  return (seq < it->second) ? it : m_ranges.end ();
+}
+
+uint32_t
+MpTcpRangeSet::Add (const SequenceNumber64& head, const SequenceNumber64& tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+  if (tail <= head)
+    {
+      return 0;
+    }
+  uint64_t before = m_bytes;
+  SequenceNumber64 newHead = head;
+  SequenceNumber64 newTail = tail;
+
+  // a range ending at or after head may be merged with the new one
+  RangeMap::iterator it = m_ranges.upper_bound (head);
+  if (it != m_ranges.begin ())
+    {
+      RangeMap::iterator prev = it;
+      --prev;
+      if (prev->second >= head)
+        {
+          it = prev;
+        }
+    }
+  while (it != m_ranges.end () && it->first <= newTail)
+    {
+      newHead = std::min (newHead, it->first);
+      newTail = std::max (newTail, it->second);
+      m_bytes -= it->second - it->first;
+      m_ranges.erase (it++);
+    }
+  m_ranges[newHead] = newTail;
+  m_bytes += newTail - newHead;
+  NS_ASSERT (m_bytes >= before);
+  return static_cast<uint32_t> (m_bytes - before);
+}
+
+void
+MpTcpRangeSet::GetGaps (const SequenceNumber64& head, const SequenceNumber64& tail,
+                        std::vector<MpTcpDsnRange>& gaps) const
+{
+  SequenceNumber64 cur = SkipCovered (head);
+  RangeMap::const_iterator it = m_ranges.upper_bound (cur);
+  while (cur < tail)
+    {
+      SequenceNumber64 end = (it == m_ranges.end ()) ? tail : std::min (it->first, tail);
+      gaps.push_back (MpTcpDsnRange (cur, end));
+      if (it == m_ranges.end ())
+        {
+          break;
+        }
+      cur = it->second;
+      ++it;
+    }
+}
+
+bool
+MpTcpRangeSet::Contains (const SequenceNumber64& seq) const
+{
+  return Find (seq) != m_ranges.end ();
+}
+
+SequenceNumber64
+MpTcpRangeSet::SkipCovered (const SequenceNumber64& seq) const
+{
+  RangeMap::const_iterator it = Find (seq);
+  return (it == m_ranges.end ()) ? seq : it->second;
+}
+
+bool
+MpTcpRangeSet::GetNextHead (const SequenceNumber64& seq, SequenceNumber64& head) const
+{
+  RangeMap::const_iterator it = m_ranges.upper_bound (seq);
+  if (it == m_ranges.end ())
+    {
+      return false;
+    }
+  head = it->first;
+  return true;
+}
+
+void
+MpTcpRangeSet::DiscardUpTo (const SequenceNumber64& seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  RangeMap::iterator it = m_ranges.begin ();
+  while (it != m_ranges.end () && it->first < seq)
+    {
+      m_bytes -= it->second - it->first;
+      if (it->second > seq)
+        {
+          // keep the part above seq
+          SequenceNumber64 tail = it->second;
+          m_ranges.erase (it);
+          m_ranges[seq] = tail;
+          m_bytes += tail - seq;
+          break;
+        }
+      m_ranges.erase (it++);
+    }
+}
+
+void
+MpTcpRangeSet::Clear ()
+{
+  m_ranges.clear ();
+  m_bytes = 0;
+}
+
+uint64_t
+MpTcpRangeSet::GetBytes () const
+{
+  return m_bytes;
+}
+
+uint32_t
+MpTcpRangeSet::GetSize () const
+{
+  return m_ranges.size ();
+}
+
+bool
+MpTcpRangeSet::IsEmpty () const
+{
+  return m_ranges.empty ();
+}
+
+MpTcpRangeSet::ConstIterator
+MpTcpRangeSet::Begin () const
+{
+  return m_ranges.begin ();
+}
+
+MpTcpRangeSet::ConstIterator
+MpTcpRangeSet::End () const
+{
+  return m_ranges.end ();
+}
+
+std::ostream&
+operator<< (std::ostream& os, const MpTcpRangeSet& ranges)
+{
+  for (MpTcpRangeSet::ConstIterator it = ranges.Begin (); it != ranges.End (); ++it)
+    {
+      os << "[" << it->first << "-" << it->second << "[";
+    }
+  return os;
+}
+
+} // namespace ns3
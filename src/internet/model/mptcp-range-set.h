@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_RANGE_SET_H
+#define MPTCP_RANGE_SET_H
+
+#include <map>
+#include <vector>
+#include <utility>
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \brief A DSN range [head, tail[
+ */
+typedef std::pair<SequenceNumber64, SequenceNumber64> MpTcpDsnRange;
+
+/**
+ * \brief Set of disjoint DSN ranges, in the spirit of SACK blocks
+ *
+ * Adjacent or overlapping ranges are merged when added so that the set holds
+ * as many ranges as there are holes. Lookups are logarithmic in the number of ranges.
+ *
+ * The receiver uses it to know which parts of the out of order data it already
+ * holds (see MpTcpReassemblyQueue), the sender to remember the ranges it sent
+ * ahead of m_nextTxSequence.
+ */
+class MpTcpRangeSet
+{
+public:
+  typedef std::map<SequenceNumber64, SequenceNumber64> RangeMap;  //!< head -> tail
+  typedef RangeMap::const_iterator ConstIterator;                  //!< Iterator over ranges
+
+  MpTcpRangeSet ();
+
+  /**
+   * \brief Adds [head, tail[ to the set, merging it with the ranges it touches
+   * \return number of bytes that were not in the set yet
+   */
+  uint32_t Add (const SequenceNumber64& head, const SequenceNumber64& tail);
+
+  /**
+   * \brief Lists the parts of [head, tail[ not covered by the set, in order
+   * \param gaps where the ranges are appended
+   */
+  void GetGaps (const SequenceNumber64& head, const SequenceNumber64& tail,
+                std::vector<MpTcpDsnRange>& gaps) const;
+
+  /**
+   * \return True if seq belongs to one of the ranges
+   */
+  bool Contains (const SequenceNumber64& seq) const;
+
+  /**
+   * \return seq if it is not covered, else the tail of the range covering it
+   */
+  SequenceNumber64 SkipCovered (const SequenceNumber64& seq) const;
+
+  /**
+   * \brief Looks for the first range starting strictly after seq
+   * \param head set to the head of that range
+   * \return false if there is none
+   */
+  bool GetNextHead (const SequenceNumber64& seq, SequenceNumber64& head) const;
+
+  /**
+   * \brief Forgets everything below seq, a range covering seq is cut
+   */
+  void DiscardUpTo (const SequenceNumber64& seq);
+
+  void Clear ();
+
+  /**
+   * \return Number of bytes covered
+   */
+  uint64_t GetBytes () const;
+
+  /**
+   * \return Number of disjoint ranges
+   */
+  uint32_t GetSize () const;
+
+  bool IsEmpty () const;
+
+  ConstIterator Begin () const;
+  ConstIterator End () const;
+
+private:
+  /**
+   * \return The range covering seq, or End ()
+   */
+  RangeMap::const_iterator Find (const SequenceNumber64& seq) const;
+
+  RangeMap m_ranges;  //!< Disjoint, non adjacent ranges
+  uint64_t m_bytes;   //!< Bytes covered by m_ranges
+};
+
+std::ostream& operator<< (std::ostream& os, const MpTcpRangeSet& ranges);
+
+} // namespace ns3
+
+#endif /* MPTCP_RANGE_SET_H */
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-reassembly-queue.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpReassemblyQueue");
+
+namespace ns3 {
+
+MpTcpReassemblyQueue::MpTcpReassemblyQueue ()
+  : m_nextDsn (0),
+    m_size (0)
+{
+}
+
+uint32_t
+MpTcpReassemblyQueue::Add (Ptr<Packet> p, const SequenceNumber64& dsn, const SequenceNumber64& maxDsn)
+{
+  NS_LOG_FUNCTION (this << p << dsn << maxDsn);
+  SequenceNumber64 head = std::max (dsn, m_nextDsn);
+  SequenceNumber64 tail = std::min (dsn + p->GetSize (), maxDsn);
+  if (tail <= head)
+    {
+      NS_LOG_LOGIC ("Nothing new in [" << dsn << ", +" << p->GetSize () << ")");
+      return 0;
+    }
+
+  std::vector<MpTcpDsnRange> gaps;
+  m_ranges.GetGaps (head, tail, gaps);
+  uint32_t added = 0;
+  for (std::vector<MpTcpDsnRange>::const_iterator it = gaps.begin (); it != gaps.end (); ++it)
+    {
+      uint32_t length = it->second - it->first;
+      Ptr<Packet> fragment = p;
+      if (length != p->GetSize ())
+        {
+          fragment = p->CreateFragment (it->first - dsn, length);
+        }
+      NS_ASSERT (m_data.find (it->first) == m_data.end ());
+      m_data[it->first] = fragment;
+      added += length;
+    }
+  uint32_t covered = m_ranges.Add (head, tail);
+  NS_ASSERT (covered == added);
+  m_size += added;
+  NS_LOG_LOGIC ("Stored " << added << " bytes, holding " << m_ranges << " next=" << m_nextDsn);
+  return added;
+}
+
+Ptr<Packet>
+MpTcpReassemblyQueue::Extract (SequenceNumber64& dsn)
+{
+  NS_LOG_FUNCTION (this);
+  FragmentMap::iterator it = m_data.begin ();
+  if (it == m_data.end () || it->first != m_nextDsn)
+    {
+      return 0;
+    }
+  Ptr<Packet> p = it->second;
+  dsn = it->first;
+  m_data.erase (it);
+  m_size -= p->GetSize ();
+  m_nextDsn = dsn + p->GetSize ();
+  m_ranges.DiscardUpTo (m_nextDsn);
+  return p;
+}
+
+void
+MpTcpReassemblyQueue::DiscardUpTo (const SequenceNumber64& dsn)
+{
+  NS_LOG_FUNCTION (this << dsn);
+  if (dsn <= m_nextDsn)
+    {
+      return;
+    }
+  m_nextDsn = dsn;
+  m_ranges.DiscardUpTo (dsn);
+  FragmentMap::iterator it = m_data.begin ();
+  while (it != m_data.end () && it->first < dsn)
+    {
+      Ptr<Packet> p = it->second;
+      SequenceNumber64 head = it->first;
+      m_size -= p->GetSize ();
+      m_data.erase (it++);
+      if (head + p->GetSize () > dsn)
+        {
+          // keep the end of the fragment
+          Ptr<Packet> rest = p->CreateFragment (dsn - head, (head + p->GetSize ()) - dsn);
+          m_data[dsn] = rest;
+          m_size += rest->GetSize ();
+          break;
+        }
+    }
+}
+
+SequenceNumber64
+MpTcpReassemblyQueue::GetNextDsn () const
+{
+  return m_nextDsn;
+}
+
+bool
+MpTcpReassemblyQueue::IsHeadAvailable () const
+{
+  return !m_data.empty () && m_data.begin ()->first == m_nextDsn;
+}
+
+uint32_t
+MpTcpReassemblyQueue::Size () const
+{
+  return m_size;
+}
+
+bool
+MpTcpReassemblyQueue::IsEmpty () const
+{
+  return m_data.empty ();
+}
+
+const MpTcpRangeSet&
+MpTcpReassemblyQueue::GetRanges () const
+{
+  return m_ranges;
+}
+
+} // namespace ns3
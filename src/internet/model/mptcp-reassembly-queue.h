@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#ifndef MPTCP_REASSEMBLY_QUEUE_H
+#define MPTCP_REASSEMBLY_QUEUE_H
+
+#include <map>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/sequence-number.h"
+#include "ns3/mptcp-range-set.h"
+
+namespace ns3 {
+
+/**
+ * \brief Connection level reassembly of the data received on all the subflows
+ *
+ * Subflows hand over their in order data as soon as they get it, whatever its
+ * DSN. The queue keeps what lies beyond the next expected DSN until the holes
+ * are filled, then the meta socket moves the contiguous head into its receive buffer.
+ *
+ * Fragments are indexed by their head DSN and never overlap. Which DSN are already
+ * held is tracked separately as merged ranges (MpTcpRangeSet), so that an insertion
+ * only looks at the holes the new data fills: a packet is stored as is unless part
+ * of it was already received, in which case only the new parts are fragmented.
+ */
+class MpTcpReassemblyQueue
+{
+public:
+  MpTcpReassemblyQueue ();
+
+  /**
+   * \brief Stores the parts of p not received yet
+   * \param p data received
+   * \param dsn DSN of the first byte of p
+   * \param maxDsn first DSN beyond the receive window, data past it is dropped
+   * \return Number of new bytes stored, 0 if everything was a duplicate
+   */
+  uint32_t Add (Ptr<Packet> p, const SequenceNumber64& dsn, const SequenceNumber64& maxDsn);
+
+  /**
+   * \brief Pops the fragment starting at the next expected DSN
+   * \param dsn set to the DSN of the fragment
+   * \return 0 if the next expected DSN has not been received yet
+   */
+  Ptr<Packet> Extract (SequenceNumber64& dsn);
+
+  /**
+   * \brief Forgets the data below dsn, which becomes the next expected DSN
+   *
+   * Does nothing if dsn is below the next expected DSN.
+   */
+  void DiscardUpTo (const SequenceNumber64& dsn);
+
+  /**
+   * \return First DSN not delivered yet
+   */
+  SequenceNumber64 GetNextDsn () const;
+
+  /**
+   * \return True if the next expected DSN is available
+   */
+  bool IsHeadAvailable () const;
+
+  /**
+   * \return Number of bytes held
+   */
+  uint32_t Size () const;
+
+  /**
+   * \return True if nothing is held
+   */
+  bool IsEmpty () const;
+
+  /**
+   * \return DSN ranges held, in order
+   */
+  const MpTcpRangeSet& GetRanges () const;
+
+private:
+  typedef std::map<SequenceNumber64, Ptr<Packet> > FragmentMap; //!< Head DSN -> data
+
+  FragmentMap m_data;       //!< Non overlapping fragments
+  MpTcpRangeSet m_ranges;   //!< DSN held, merged
+  SequenceNumber64 m_nextDsn; //!< First DSN not delivered yet
+  uint32_t m_size;          //!< Bytes held
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_REASSEMBLY_QUEUE_H */
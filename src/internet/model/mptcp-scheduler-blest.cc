@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#include "ns3/mptcp-scheduler-blest.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerBlest");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerBlest);
+
+TypeId
+MpTcpSchedulerBlest::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerBlest")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerBlest> ()
+    .AddAttribute ("Lambda",
+                   "Scaling of the estimation of the data sent on the fastest subflow",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&MpTcpSchedulerBlest::m_lambda),
+                   MakeDoubleChecker<double> (0))
+  ;
+  return tid;
+}
+
+MpTcpSchedulerBlest::MpTcpSchedulerBlest()
+  : MpTcpScheduler(),
+    m_lambda(1.0)
+{
+  NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerBlest::~MpTcpSchedulerBlest (void)
+{
+  NS_LOG_FUNCTION(this);
+}
+
+bool
+MpTcpSchedulerBlest::WouldBlock(const MpTcpSchedulerState& state, uint32_t fast, uint32_t slow) const
+{
+  const MpTcpSubflowState& f = state.subflows[fast];
+  const MpTcpSubflowState& s = state.subflows[slow];
+  if (f.srtt.IsZero())
+    {
+      return false;
+    }
+  double ratio = s.srtt.GetSeconds() / f.srtt.GetSeconds();
+  double fastBytes = (f.cwnd + f.segmentSize * (ratio - 1) / 2) * ratio;
+
+  // space left in the send window once the slow subflow got its segment
+  uint32_t slowBytes = s.inFlight + s.segmentSize;
+  double availableSpace = (slowBytes < state.sendWindow) ? state.sendWindow - slowBytes : 0;
+  NS_LOG_LOGIC("Fast subflow would send " << fastBytes << " bytes, " << availableSpace << " available");
+  return m_lambda * fastBytes > availableSpace;
+}
+
+void
+MpTcpSchedulerBlest::Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments)
+{
+  NS_LOG_FUNCTION(this);
+  StartRound(state);
+
+  while (m_pending > 0 && m_window > 0)
+    {
+      int fast = FindFastestSubflow(state, m_space, false);
+      int id = FindFastestSubflow(state, m_space, true);
+      if (id < 0)
+        {
+          return;
+        }
+      if (id != fast && WouldBlock(state, fast, id))
+        {
+          NS_LOG_DEBUG("Waiting for the fastest subflow");
+          return;
+        }
+      AssignNewData(state, id, assignments);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#include <algorithm>
+#include "ns3/mptcp-scheduler-ecf.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerEcf");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerEcf);
+
+TypeId
+MpTcpSchedulerEcf::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerEcf")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerEcf> ()
+    .AddAttribute ("Beta",
+                   "Hysteresis applied once the scheduler waits for the fastest subflow",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&MpTcpSchedulerEcf::m_beta),
+                   MakeDoubleChecker<double> (0))
+  ;
+  return tid;
+}
+
+MpTcpSchedulerEcf::MpTcpSchedulerEcf()
+  : MpTcpScheduler(),
+    m_beta(0.25),
+    m_waiting(false)
+{
+  NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerEcf::~MpTcpSchedulerEcf (void)
+{
+  NS_LOG_FUNCTION(this);
+}
+
+void
+MpTcpSchedulerEcf::Reset()
+{
+  NS_LOG_FUNCTION(this);
+  MpTcpScheduler::Reset();
+  m_waiting = false;
+}
+
+bool
+MpTcpSchedulerEcf::ShouldWait(const MpTcpSchedulerState& state, uint32_t fast, uint32_t slow)
+{
+  const MpTcpSubflowState& f = state.subflows[fast];
+  const MpTcpSubflowState& s = state.subflows[slow];
+  if (f.cwnd == 0 || s.cwnd == 0)
+    {
+      return false;
+    }
+  double rttF = f.srtt.GetSeconds();
+  double rttS = s.srtt.GetSeconds();
+  double delta = std::max(f.rttVar, s.rttVar).GetSeconds();
+  double k = m_pending;
+  double n = 1 + k / f.cwnd;
+
+  if (n * rttF < (1 + (m_waiting ? m_beta : 0)) * (rttS + delta))
+    {
+      if (k / s.cwnd * rttS >= 2 * rttF + delta)
+        {
+          m_waiting = true;
+          return true;
+        }
+    }
+  else
+    {
+      m_waiting = false;
+    }
+  return false;
+}
+
+void
+MpTcpSchedulerEcf::Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments)
+{
+  NS_LOG_FUNCTION(this);
+  StartRound(state);
+
+  while (m_pending > 0 && m_window > 0)
+    {
+      int fast = FindFastestSubflow(state, m_space, false);
+      int id = FindFastestSubflow(state, m_space, true);
+      if (id < 0)
+        {
+          return;
+        }
+      if (id != fast && ShouldWait(state, fast, id))
+        {
+          NS_LOG_DEBUG("Waiting for the fastest subflow");
+          return;
+        }
+      AssignNewData(state, id, assignments);
+    }
+}
+
+} // namespace ns3
@@ -21,8 +21,6 @@
  *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
  */
 #include "ns3/mptcp-scheduler-fastest-rtt.h"
-#include "ns3/mptcp-subflow.h"
-#include "ns3/mptcp-socket-base.h"
 #include "ns3/log.h"
 
 NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerFastestRTT");
@@ -30,17 +28,14 @@ NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerFastestRTT");
 namespace ns3
 {
 
-static inline
-SequenceNumber64 SEQ32TO64(SequenceNumber32 seq)
-{
-  return SequenceNumber64( seq.GetValue());
-}
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerFastestRTT);
 
 TypeId
 MpTcpSchedulerFastestRTT::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::MpTcpSchedulerFastestRTT")
     .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
     .AddConstructor<MpTcpSchedulerFastestRTT> ()
   ;
 
@@ -48,8 +43,7 @@ MpTcpSchedulerFastestRTT::GetTypeId (void)
 }
 
 MpTcpSchedulerFastestRTT::MpTcpSchedulerFastestRTT()
-  : MpTcpScheduler(),
-    m_metaSock(0)
+  : MpTcpScheduler()
 {
   NS_LOG_FUNCTION(this);
 }
@@ -60,85 +54,21 @@ MpTcpSchedulerFastestRTT::~MpTcpSchedulerFastestRTT (void)
 }
 
 void
-MpTcpSchedulerFastestRTT::SetMeta(Ptr<MpTcpSocketBase> metaSock)
-{
-  NS_ASSERT(metaSock);
-  NS_ASSERT_MSG(m_metaSock == 0, "SetMeta already called");
-  m_metaSock = metaSock;
-}
-
-int
-MpTcpSchedulerFastestRTT::FindFastestSubflowWithFreeWindow() const
-{
-  NS_LOG_FUNCTION_NOARGS();
-  int id = -1;
-
-  Time lowestEstimate = Time::Max();
-  for (int i = 0; i < (int) m_metaSock->GetNActiveSubflows() ; i++ )
-    {
-      Ptr<MpTcpSubflow> sf = m_metaSock->GetSubflow(i);
-      if(sf->AvailableWindow() <= 0)
-      {
-        continue;
-      }
-      if(sf->m_rtt->GetEstimate () < lowestEstimate)
-      {
-        lowestEstimate = sf->m_rtt->GetEstimate ();
-        id = i;
-      }
-   }
-  return id;
-}
-
-Ptr<MpTcpSubflow>
-MpTcpSchedulerFastestRTT::GetSubflowToUseForEmptyPacket()
-{
-  NS_ASSERT(m_metaSock->GetNActiveSubflows() > 0 );
-  return  m_metaSock->GetSubflow(0);
-}
-
-bool
-MpTcpSchedulerFastestRTT::GenerateMapping(int& activeSubflowArrayId, SequenceNumber64& dsn, uint16_t& length)
+MpTcpSchedulerFastestRTT::Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments)
 {
   NS_LOG_FUNCTION(this);
-  NS_ASSERT(m_metaSock);
-
-  uint32_t amountOfDataToSend = 0;
-  //! Tx data not sent to subflows yet
-  SequenceNumber32 metaNextTxSeq = m_metaSock->Getvalue_nextTxSeq();
-  amountOfDataToSend = m_metaSock->m_txBuffer->SizeFromSequence( metaNextTxSeq );
-  uint32_t metaWindow = m_metaSock->AvailableWindow();
-  if (amountOfDataToSend <= 0)
-    {
-      NS_LOG_DEBUG("Nothing to send from meta");
-      return false;
-    }
-  if (metaWindow <= 0)
-   {
-     return false;
-    }
-
-  int id = FindFastestSubflowWithFreeWindow();
-  if(id < 0)
-    {
-      NS_LOG_DEBUG("No valid subflow");
-      return false;
-    }
-  Ptr<MpTcpSubflow> subflow = m_metaSock->GetSubflow(id);
-  uint32_t subflowWindow = subflow->AvailableWindow();
-  uint32_t canSend = std::min( subflowWindow, metaWindow);
+  StartRound(state);
 
-  //! Can't send more than SegSize
-  //metaWindow en fait on s'en fout du SegSize ?
-  if (canSend > 0)
+  while (m_pending > 0 && m_window > 0)
     {
-      dsn = SEQ32TO64(metaNextTxSeq);
-      canSend = std::min(canSend, amountOfDataToSend);
-      // For now we limit ourselves to a per packet basis
-      length = std::min(canSend, subflow->GetSegSize());
-      return true;
+      int id = FindFastestSubflow(state, m_space, true);
+      if (id < 0)
+        {
+          NS_LOG_DEBUG("No valid subflow");
+          return;
+        }
+      AssignNewData(state, id, assignments);
     }
-  return false;
 }
 
 } // namespace ns3
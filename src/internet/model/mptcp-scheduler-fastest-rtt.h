@@ -25,15 +25,13 @@
 #include "ns3/mptcp-scheduler.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
-#include "ns3/mptcp-scheduler-fastest-rtt.h"
-#include <vector>
-#include <list>
 
 namespace ns3
 {
-class MpTcpSocketBase;
-class MpTcpSubflow;
 
+/**
+ * \brief Fills the subflows by increasing smoothed RTT (minRTT)
+ */
 class MpTcpSchedulerFastestRTT : public MpTcpScheduler
 {
 
@@ -43,7 +41,6 @@ public:
 
   MpTcpSchedulerFastestRTT();
   virtual ~MpTcpSchedulerFastestRTT ();
-  void SetMeta(Ptr<MpTcpSocketBase> metaSock);
 
   /**
    * \brief This function is responsible for generating a list of packets to send
@@ -53,26 +50,10 @@ public:
    * mappings.
    * It is of utmost importance to generate a perfect mapping !!! Any deviation
    * from the foreseen mapping will trigger an error and crash the simulator
-   *
-   * \warn This function MUST NOT fiddle with metasockInternal
-   * subflowId: pair(start,size)
-   */
-  virtual bool GenerateMapping(int& activeSubflowArrayId, SequenceNumber64& dsn, uint16_t& length);
-
-  /**
-   * \return -1 if could not find a valid subflow, the subflow id otherwise
    */
-  virtual int FindFastestSubflowWithFreeWindow() const;
-
-  /**
-   * \return Index of subflow to use
-   */
-  virtual Ptr<MpTcpSubflow> GetSubflowToUseForEmptyPacket();
-
-protected:
-  Ptr<MpTcpSocketBase> m_metaSock;  //!<
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments);
 };
 
 } // end of 'ns3'
 
-#endif /* MPTCP_SCHEDULER_ROUND_ROBIN_H */
+#endif /* MPTCP_SCHEDULER_FASTEST_RTT_H */
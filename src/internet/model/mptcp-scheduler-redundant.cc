@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#include <algorithm>
+#include "ns3/mptcp-scheduler-redundant.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerRedundant");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerRedundant);
+
+TypeId
+MpTcpSchedulerRedundant::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerRedundant")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerRedundant> ()
+  ;
+  return tid;
+}
+
+MpTcpSchedulerRedundant::MpTcpSchedulerRedundant()
+  : MpTcpScheduler()
+{
+  NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerRedundant::~MpTcpSchedulerRedundant (void)
+{
+  NS_LOG_FUNCTION(this);
+}
+
+void
+MpTcpSchedulerRedundant::Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments)
+{
+  NS_LOG_FUNCTION(this);
+  StartRound(state);
+
+  while (m_pending > 0 && m_window > 0)
+    {
+      uint32_t length = std::min(std::min(m_pending, m_window), (uint32_t) 0xffff);
+      uint32_t sent = 0;
+      for (uint32_t i = 0; i < state.subflows.size(); i++)
+        {
+          uint32_t copy = AssignRange(state, i, m_nextDsn, length, assignments);
+          sent = std::max(sent, copy);
+        }
+      if (sent == 0)
+        {
+          return;
+        }
+      m_pending -= sent;
+      m_window -= sent;
+      m_nextDsn += sent;
+    }
+}
+
+} // namespace ns3
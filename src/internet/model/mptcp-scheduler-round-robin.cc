@@ -22,8 +22,6 @@
  */
 
 #include "ns3/mptcp-scheduler-round-robin.h"
-#include "ns3/mptcp-subflow.h"
-#include "ns3/mptcp-socket-base.h"
 #include "ns3/log.h"
 
 NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerRoundRobin");
@@ -31,17 +29,14 @@ NS_LOG_COMPONENT_DEFINE("MpTcpSchedulerRoundRobin");
 namespace ns3
 {
 
-static inline
-SequenceNumber64 SEQ32TO64(SequenceNumber32 seq)
-{
-  return SequenceNumber64( seq.GetValue());
-}
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerRoundRobin);
 
 TypeId
 MpTcpSchedulerRoundRobin::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::MpTcpSchedulerRoundRobin")
     .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
     .AddConstructor<MpTcpSchedulerRoundRobin> ()
   ;
   return tid;
@@ -49,8 +44,7 @@ MpTcpSchedulerRoundRobin::GetTypeId (void)
 
 MpTcpSchedulerRoundRobin::MpTcpSchedulerRoundRobin() :
   MpTcpScheduler(),
-  m_lastUsedFlowId(0),
-  m_metaSock(0)
+  m_lastUsedFlowId(0)
 {
   NS_LOG_FUNCTION(this);
 }
@@ -61,68 +55,38 @@ MpTcpSchedulerRoundRobin::~MpTcpSchedulerRoundRobin (void)
 }
 
 void
-MpTcpSchedulerRoundRobin::SetMeta(Ptr<MpTcpSocketBase> metaSock)
+MpTcpSchedulerRoundRobin::Reset()
 {
-  NS_ASSERT(metaSock);
-  NS_ASSERT_MSG(m_metaSock == 0, "SetMeta already called");
-  m_metaSock = metaSock;
-}
-
-Ptr<MpTcpSubflow>
-MpTcpSchedulerRoundRobin::GetSubflowToUseForEmptyPacket()
-{
-  NS_ASSERT(m_metaSock->GetNActiveSubflows() > 0 );
-  return  m_metaSock->GetSubflow(0);
+  NS_LOG_FUNCTION(this);
+  MpTcpScheduler::Reset();
+  m_lastUsedFlowId = 0;
 }
 
-/* We assume scheduler can't send data on subflows, so it can just generate mappings */
-bool
-MpTcpSchedulerRoundRobin::GenerateMapping(int& activeSubflowArrayId, SequenceNumber64& dsn, uint16_t& length)
+void
+MpTcpSchedulerRoundRobin::Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments)
 {
   NS_LOG_FUNCTION(this);
-  NS_ASSERT(m_metaSock);
 
-  int nbOfSubflows = m_metaSock->GetNActiveSubflows();
-  int attempt = 0;
-  uint32_t amountOfDataToSend = 0;
-
-  //! Tx data not sent to subflows yet
-  SequenceNumber32 metaNextTxSeq = m_metaSock->Getvalue_nextTxSeq(); 
-  amountOfDataToSend = m_metaSock->m_txBuffer->SizeFromSequence( metaNextTxSeq );
-  uint32_t metaWindow = m_metaSock->AvailableWindow();
-
-  if(amountOfDataToSend <= 0)
-   {
-     NS_LOG_DEBUG("Nothing to send from meta");
-     return false;
-   }
-
-  if(metaWindow <= 0)
-   {
-     NS_LOG_DEBUG("No meta window available (TODO should be in persist state ?)");
-     return false;
-   }
-  while(attempt < nbOfSubflows)
-     {
-       attempt++;
-       m_lastUsedFlowId = (m_lastUsedFlowId + 1) % nbOfSubflows;
-       Ptr<MpTcpSubflow> subflow = m_metaSock->GetSubflow(m_lastUsedFlowId);
-       uint32_t subflowWindow = subflow->AvailableWindow();
-       uint32_t canSend = std::min( subflowWindow, metaWindow);
-
-       //! Can't send more than SegSize
-       //metaWindow en fait on s'en fout du SegSize ?
-       if(canSend > 0)
+  uint32_t nbOfSubflows = state.subflows.size();
+  if (nbOfSubflows == 0)
+    {
+      return;
+    }
+  StartRound(state);
+  bool useBackup = UseBackupSubflows(state);
+
+  for (uint32_t attempt = 0; attempt < nbOfSubflows && m_pending > 0 && m_window > 0; attempt++)
+    {
+      m_lastUsedFlowId = (m_lastUsedFlowId + 1) % nbOfSubflows;
+      if (state.subflows[m_lastUsedFlowId].backup && !useBackup)
+        {
+          continue;
+        }
+      // the window of a subflow may exceed the length of a mapping
+      while (AssignNewData(state, m_lastUsedFlowId, assignments) > 0)
         {
-          activeSubflowArrayId = m_lastUsedFlowId;
-          dsn = SEQ32TO64(metaNextTxSeq);
-          canSend = std::min(canSend, amountOfDataToSend);
-          // For now we limit ourselves to a per packet basis
-          length = std::min(canSend, subflow->GetSegSize());
-          return true;
         }
-     }
-  return false;
+    }
 }
 
 } // end of 'ns3'
@@ -26,16 +26,13 @@
 #include "ns3/mptcp-scheduler.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
-#include "ns3/mptcp-scheduler-round-robin.h"
-#include <vector>
-#include <list>
 
 namespace ns3
 {
 
-class MpTcpSocketBase;
-class MpTcpSubflow;
-
+/**
+ * \brief Gives the whole free window of each subflow in turn
+ */
 class MpTcpSchedulerRoundRobin : public MpTcpScheduler
 {
 
@@ -45,7 +42,6 @@ public:
 
   MpTcpSchedulerRoundRobin();
   virtual ~MpTcpSchedulerRoundRobin ();
-  void SetMeta(Ptr<MpTcpSocketBase> metaSock);
 
   /**
    * \brief This function is responsible for generating a list of packets to send
@@ -55,21 +51,13 @@ public:
    * mappings.
    * It is of utmost importance to generate a perfect mapping !!! Any deviation
    * from the foreseen mapping will trigger an error and crash the simulator
-   *
-   *  \warn This function MUST NOT fiddle with metasockInternal
-   * subflowId: pair(start,size)
    */
-  virtual bool GenerateMapping(int& activeSubflowArrayId, SequenceNumber64& dsn, uint16_t& length);
+  virtual void Schedule(const MpTcpSchedulerState& state, MpTcpAssignmentList& assignments);
 
-  /**
-   * \brief chooseSubflowForRetransmit
-   * \return Index of subflow to use
-   */
-  virtual Ptr<MpTcpSubflow> GetSubflowToUseForEmptyPacket();
+  virtual void Reset();
 
 protected:
   uint8_t  m_lastUsedFlowId;        //!< keep track of last used subflow
-  Ptr<MpTcpSocketBase> m_metaSock;  //!<
 };
 
 } // end of 'ns3'
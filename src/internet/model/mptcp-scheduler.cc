@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Matthieu Coudron <matthieu.coudron@lip6.fr>
+ */
+#include <algorithm>
+#include "ns3/mptcp-scheduler.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE("MpTcpScheduler");
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpScheduler);
+
+TypeId
+MpTcpScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+void
+MpTcpScheduler::Reset()
+{
+  NS_LOG_FUNCTION(this);
+  // keeps the capacity for the next connection
+  m_space.clear();
+  m_nextDsn = SequenceNumber64(0);
+  m_pending = 0;
+  m_window = 0;
+}
+
+bool
+MpTcpScheduler::UseBackupSubflows(const MpTcpSchedulerState& state)
+{
+  for (std::vector<MpTcpSubflowState>::const_iterator it = state.subflows.begin(); it != state.subflows.end(); ++it)
+    {
+      if (!it->backup)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+int
+MpTcpScheduler::FindFastestSubflow(const MpTcpSchedulerState& state, const std::vector<uint32_t>& space,
+                                   bool withSpace)
+{
+  bool useBackup = UseBackupSubflows(state);
+  int id = -1;
+  for (uint32_t i = 0; i < state.subflows.size(); i++)
+    {
+      const MpTcpSubflowState& sf = state.subflows[i];
+      if ((sf.backup && !useBackup) || (withSpace && space[i] == 0))
+        {
+          continue;
+        }
+      if (id < 0 || sf.srtt < state.subflows[id].srtt)
+        {
+          id = i;
+        }
+    }
+  return id;
+}
+
+void
+MpTcpScheduler::StartRound(const MpTcpSchedulerState& state)
+{
+  m_space.resize(state.subflows.size());
+  for (uint32_t i = 0; i < state.subflows.size(); i++)
+    {
+      m_space[i] = state.subflows[i].available;
+    }
+  m_nextDsn = state.nextTxSequence;
+  m_pending = state.pending;
+  m_window = state.window;
+}
+
+uint32_t
+MpTcpScheduler::AssignNewData(const MpTcpSchedulerState& state, uint32_t i, MpTcpAssignmentList& assignments)
+{
+  NS_ASSERT(i < state.subflows.size());
+  // Ranges already sent ahead are not sent again
+  SequenceNumber64 next = state.sentAhead.SkipCovered(m_nextDsn);
+  uint32_t skipped = std::min<uint32_t>(next - m_nextDsn, m_pending);
+  m_pending -= skipped;
+  m_nextDsn += skipped;
+
+  // The subflow splits the mapping into segments, up to the 16 bits
+  // data-level length of the DSS option
+  uint32_t length = std::min(std::min(m_space[i], m_pending), std::min<uint32_t>(m_window, 0xffff));
+  SequenceNumber64 aheadHead;
+  if (state.sentAhead.GetNextHead(m_nextDsn, aheadHead))
+    {
+      length = std::min<uint32_t>(length, aheadHead - m_nextDsn);
+    }
+  length = AssignRange(state, i, m_nextDsn, length, assignments);
+
+  m_pending -= length;
+  m_window -= length;
+  m_nextDsn += length;
+  return length;
+}
+
+uint32_t
+MpTcpScheduler::AssignRange(const MpTcpSchedulerState& state, uint32_t i, const SequenceNumber64& dsn,
+                            uint32_t length, MpTcpAssignmentList& assignments)
+{
+  NS_ASSERT(i < state.subflows.size());
+  length = std::min(std::min(length, m_space[i]), (uint32_t) 0xffff);
+  if (length == 0)
+    {
+      return 0;
+    }
+  MpTcpAssignment assignment;
+  assignment.subflowId = state.subflows[i].id;
+  assignment.dsn = dsn;
+  assignment.length = length;
+  assignments.push_back(assignment);
+  NS_LOG_LOGIC("Assigning DSN " << dsn << " len=" << length << " to subflow " << (int) assignment.subflowId);
+
+  m_space[i] -= length;
+  return length;
+}
+
+} // namespace ns3
@@ -29,9 +29,15 @@
 #include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/enum.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/inet6-socket-address.h"
 #include "ns3/error-model.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
@@ -46,6 +52,9 @@
 #include "ns3/trace-helper.h"
 #include "ns3/mptcp-ndiffports.h"
 #include "ns3/mptcp-fullmesh.h"
+#include "ns3/mptcp-path-manager.h"
+#include "ns3/mptcp-congestion-lia.h"
+#include "ns3/mptcp-stats.h"
 
 using namespace std;
 
@@ -84,6 +93,20 @@ GetMapping(Ptr<TcpOptionMpTcpDSS> dss)
   return mapping;
 }
 
+//! Honours Config::SetDefault for metas constructed without the attribute system (UpgradeToMeta)
+template <typename T>
+static T
+GetAttributeDefault(std::string name)
+{
+  struct TypeId::AttributeInformation info;
+  bool ok = MpTcpSocketBase::GetTypeId().LookupAttributeByName(name, &info);
+  NS_ASSERT(ok);
+  // Config::SetDefault stores a value of the type of the checker
+  Ptr<const T> value = DynamicCast<const T>(info.initialValue);
+  NS_ASSERT(value);
+  return *value;
+}
+
 TypeId
 MpTcpSocketBase::GetTypeId(void)
 {
@@ -98,9 +121,45 @@ MpTcpSocketBase::GetTypeId(void)
                MakeTypeIdChecker ())
       .AddAttribute ("Scheduler",
                "How to generate the mappings",
-               TypeIdValue (MpTcpScheduler::GetTypeId ()),
+               TypeIdValue (MpTcpSchedulerRoundRobin::GetTypeId ()),
                MakeTypeIdAccessor (&MpTcpSocketBase::m_schedulerTypeId),
                MakeTypeIdChecker ())
+      .AddAttribute ("CongestionControl",
+               "Congestion control of the subflows. Algorithms inheriting "
+               "MpTcpCongestionOps are coupled, others run independently on each subflow",
+               TypeIdValue (MpTcpCongestionLia::GetTypeId ()),
+               MakeTypeIdAccessor (&MpTcpSocketBase::m_congestionTypeId),
+               MakeTypeIdChecker ())
+      .AddAttribute ("OpportunisticReinjection",
+               "Reinject the oldest unacknowledged data on a faster subflow "
+               "when the peer receive window blocks the connection",
+               BooleanValue (true),
+               MakeBooleanAccessor (&MpTcpSocketBase::m_opportunisticReinjection),
+               MakeBooleanChecker ())
+      .AddAttribute ("Penalization",
+               "Halve the window of the subflow blocking the connection, at most once per RTT",
+               BooleanValue (true),
+               MakeBooleanAccessor (&MpTcpSocketBase::m_penalization),
+               MakeBooleanChecker ())
+      .AddAttribute ("Dss64Bits",
+               "Send the DSN and the DATA_ACK of DSS options on 8 bytes. "
+               "Otherwise only their lower 4 bytes are sent and the peer infers the rest",
+               BooleanValue (false),
+               MakeBooleanAccessor (&MpTcpSocketBase::m_dss64Bits),
+               MakeBooleanChecker ())
+      .AddAttribute ("SubflowPacing",
+               "Pace each subflow at a rate derived from its own cwnd and srtt, "
+               "so that subflows sharing a bottleneck do not burst into it together",
+               BooleanValue (false),
+               MakeBooleanAccessor (&MpTcpSocketBase::m_subflowPacing),
+               MakeBooleanChecker ())
+      .AddAttribute ("SuperSegments",
+               "Paced subflows send their segments back to back by bursts of about "
+               "1 ms at the pacing rate (2 segments to 64 KB), like TSO, instead of "
+               "pacing every segment",
+               BooleanValue (false),
+               MakeBooleanAccessor (&MpTcpSocketBase::m_superSegments),
+               MakeBooleanChecker ())
      .AddAttribute("PathManagerMode",
               "Mechanism for establishing new sub-flows",
               EnumValue (MpTcpSocketBase::FullMesh),
@@ -122,19 +181,39 @@ static const std::string containerNames[MpTcpSocketBase::Maximum] = {
 MpTcpSocketBase::MpTcpSocketBase(const TcpSocketBase& sock)
   : TcpSocketBase(sock),
     m_peerToken(0),
+    m_pathManager(static_cast<PathManagerMode>(GetAttributeDefault<EnumValue>("PathManagerMode").Get())),
     m_peerKey(0),
     m_doChecksum(false),
     m_receivedDSS(false),
-    m_multipleSubflows(false)
+    m_multipleSubflows(false),
+    m_schedulerTypeId(GetAttributeDefault<TypeIdValue>("Scheduler").Get()),
+    m_congestionTypeId(GetAttributeDefault<TypeIdValue>("CongestionControl").Get()),
+    m_opportunisticReinjection(GetAttributeDefault<BooleanValue>("OpportunisticReinjection").Get()),
+    m_penalization(GetAttributeDefault<BooleanValue>("Penalization").Get()),
+    m_dss64Bits(GetAttributeDefault<BooleanValue>("Dss64Bits").Get()),
+    m_subflowPacing(GetAttributeDefault<BooleanValue>("SubflowPacing").Get()),
+    m_superSegments(GetAttributeDefault<BooleanValue>("SuperSegments").Get()),
+    m_ccNSubflows(0),
+    m_ccTotalCwnd(0),
+    m_ccSumRate(0),
+    m_ccMaxRate(0),
+    m_ccMaxCwndRtt2(0),
+    m_ccMaxCwnd(0),
+    m_ccMaxQuality(0)
 {
   NS_LOG_FUNCTION(this);
   NS_LOG_LOGIC("Copying from TcpSocketBase");
   CreateScheduler(m_schedulerTypeId);
+  m_stats = CreateObject<MpTcpStats>();
+  // The DSN space starts where the TCP sequence space of the master stands
+  m_txHeadDsn = SEQ32TO64(m_txBuffer->HeadSequence());
+  m_rxReassembly.DiscardUpTo(SEQ32TO64(m_rxBuffer->NextRxSequence()));
 }
 
 MpTcpSocketBase::MpTcpSocketBase(const MpTcpSocketBase& sock) 
   : TcpSocketBase(sock),
     m_peerToken(sock.m_peerToken),
+    m_pathManager(sock.m_pathManager),
     m_peerKey(sock.m_peerKey),
     m_doChecksum(sock.m_doChecksum),
     m_receivedDSS(sock.m_receivedDSS),
@@ -144,12 +223,28 @@ MpTcpSocketBase::MpTcpSocketBase(const MpTcpSocketBase& sock)
     m_joinRequest(sock.m_joinRequest),
     m_subflowCreated(sock.m_subflowCreated),
     m_subflowTypeId(sock.m_subflowTypeId),
-   m_schedulerTypeId(sock.m_schedulerTypeId)
+    m_schedulerTypeId(sock.m_schedulerTypeId),
+    m_congestionTypeId(sock.m_congestionTypeId),
+    m_opportunisticReinjection(sock.m_opportunisticReinjection),
+    m_penalization(sock.m_penalization),
+    m_dss64Bits(sock.m_dss64Bits),
+    m_subflowPacing(sock.m_subflowPacing),
+    m_superSegments(sock.m_superSegments),
+    m_txHeadDsn(sock.m_txHeadDsn),
+    m_ccNSubflows(0),
+    m_ccTotalCwnd(0),
+    m_ccSumRate(0),
+    m_ccMaxRate(0),
+    m_ccMaxCwndRtt2(0),
+    m_ccMaxCwnd(0),
+    m_ccMaxQuality(0)
 {
   NS_LOG_FUNCTION(this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
   //! Scheduler may have some states, thus generate a new one
   CreateScheduler(m_schedulerTypeId);
+  m_stats = CreateObject<MpTcpStats>();
+  m_rxReassembly.DiscardUpTo(sock.m_rxReassembly.GetNextDsn());
 }
 
 MpTcpSocketBase::MpTcpSocketBase()
@@ -161,12 +256,28 @@ MpTcpSocketBase::MpTcpSocketBase()
     m_multipleSubflows(false),
     fLowStartTime(0),
     m_subflowTypeId(MpTcpSubflow::GetTypeId ()),
-    m_schedulerTypeId(MpTcpSchedulerRoundRobin::GetTypeId())
+    m_schedulerTypeId(MpTcpSchedulerRoundRobin::GetTypeId()),
+    m_congestionTypeId(MpTcpCongestionLia::GetTypeId()),
+    m_opportunisticReinjection(true),
+    m_penalization(true),
+    m_dss64Bits(false),
+    m_subflowPacing(false),
+    m_superSegments(false),
+    m_ccNSubflows(0),
+    m_ccTotalCwnd(0),
+    m_ccSumRate(0),
+    m_ccMaxRate(0),
+    m_ccMaxCwndRtt2(0),
+    m_ccMaxCwnd(0),
+    m_ccMaxQuality(0)
 {
   NS_LOG_FUNCTION(this);
 
   //not considered as an Object
   CreateScheduler(m_schedulerTypeId);
+  m_stats = CreateObject<MpTcpStats>();
+  m_txHeadDsn = SEQ32TO64(m_txBuffer->HeadSequence());
+  m_rxReassembly.DiscardUpTo(SEQ32TO64(m_rxBuffer->NextRxSequence()));
   m_subflowConnectionSucceeded  = MakeNullCallback<void, Ptr<MpTcpSubflow> >();
   m_subflowConnectionFailure    = MakeNullCallback<void, Ptr<MpTcpSubflow> >();
 }
@@ -176,10 +287,20 @@ MpTcpSocketBase::~MpTcpSocketBase(void)
   NS_LOG_FUNCTION(this);
   m_node = 0;
 
-  if( m_scheduler )
-  {
-
-  }
+  if (m_scheduler && m_tcp)
+    {
+      m_tcp->RecycleMpTcpScheduler(m_scheduler);
+    }
+  if (m_interfaceTraces)
+    {
+      m_interfaceTraces->TraceDisconnectWithoutContext("InterfaceUp", MakeCallback(&MpTcpSocketBase::OnInterfaceUp, this));
+      m_interfaceTraces->TraceDisconnectWithoutContext("InterfaceDown", MakeCallback(&MpTcpSocketBase::OnInterfaceDown, this));
+    }
+  if (m_interfaceTraces6)
+    {
+      m_interfaceTraces6->TraceDisconnectWithoutContext("InterfaceUp", MakeCallback(&MpTcpSocketBase::OnInterfaceUp6, this));
+      m_interfaceTraces6->TraceDisconnectWithoutContext("InterfaceDown", MakeCallback(&MpTcpSocketBase::OnInterfaceDown6, this));
+    }
   m_subflowConnectionSucceeded = MakeNullCallback<void, Ptr<MpTcpSubflow> >();
   m_subflowCreated = MakeNullCallback<void, Ptr<MpTcpSubflow> >();
   m_subflowConnectionSucceeded = MakeNullCallback<void, Ptr<MpTcpSubflow> >();
@@ -188,13 +309,50 @@ MpTcpSocketBase::~MpTcpSocketBase(void)
 void
 MpTcpSocketBase::CreateScheduler(TypeId schedulerTypeId)
 {
-  NS_LOG_FUNCTION(this);
-  NS_LOG_WARN("Overriding scheduler choice");
+  NS_LOG_FUNCTION(this << schedulerTypeId);
+  if (m_tcp)
+    {
+      m_scheduler = m_tcp->AllocateMpTcpScheduler(schedulerTypeId);
+      return;
+    }
   ObjectFactory schedulerFactory;
-  schedulerTypeId = MpTcpSchedulerRoundRobin::GetTypeId();
   schedulerFactory.SetTypeId(schedulerTypeId);
   m_scheduler = schedulerFactory.Create<MpTcpScheduler>();
-  m_scheduler->SetMeta(this);
+}
+
+void
+MpTcpSocketBase::FillSchedulerState(MpTcpSchedulerState& state) const
+{
+  NS_LOG_FUNCTION(this);
+  state.nextTxSequence = TxDsn(m_tcb->m_nextTxSequence);
+  state.pending = m_txBuffer->SizeFromSequence(m_tcb->m_nextTxSequence);
+  state.window = AvailableWindow();
+  state.sendWindow = m_rWnd;
+  state.inFlight = UnAckDataCount();
+  state.sentAhead = m_txSentAhead;
+  state.subflows.resize(GetNActiveSubflows());
+  for (uint32_t i = 0; i < state.subflows.size(); i++)
+    {
+      Ptr<MpTcpSubflow> sf = GetSubflow(i);
+      MpTcpSubflowState& sfState = state.subflows[i];
+      sfState.id = i;
+      sfState.cwnd = sf->m_tcb->m_cWnd;
+      sfState.ssThresh = sf->m_tcb->m_ssThresh;
+      sfState.inFlight = sf->BytesInFlight();
+      // data queued in the subflow already uses part of its window
+      uint32_t queued = sf->m_txBuffer->SizeFromSequence(sf->m_tcb->m_nextTxSequence);
+      uint32_t window = sf->AvailableWindow();
+      sfState.available = std::min(window > queued ? window - queued : 0, sf->GetTxAvailable());
+      sfState.segmentSize = sf->GetSegSize();
+      sfState.srtt = sf->m_rtt->GetEstimate();
+      sfState.rttVar = sf->m_rtt->GetVariation();
+      // an unhealthy path counts as a backup one so that the healthy backups get used
+      sfState.backup = sf->BackupSubflow() || !sf->IsHealthy();
+      if (sf->IsPathFailed())
+        {
+          sfState.available = 0;
+        }
+    }
 }
 
 void
@@ -203,13 +361,276 @@ MpTcpSocketBase::SetPathManager(PathManagerMode pathManager)
   m_pathManager = pathManager;
 }
 
+void
+MpTcpSocketBase::SetPathManager(Ptr<MpTcpPathManager> pathManager)
+{
+  NS_LOG_FUNCTION(this << pathManager);
+  m_pathManagerImpl = pathManager;
+}
+
+Ptr<MpTcpPathManager>
+MpTcpSocketBase::GetPathManager() const
+{
+  return m_pathManagerImpl;
+}
+
+bool
+MpTcpSocketBase::BackupsPromoted() const
+{
+  return m_backupsPromoted;
+}
+
+Ptr<MpTcpPathManager>
+MpTcpSocketBase::CreatePathManager() const
+{
+  NS_LOG_FUNCTION(this);
+  // the default one does not open subflows but still handles failover
+  TypeId tid = MpTcpPathManager::GetTypeId();
+  switch (m_pathManager)
+    {
+      case FullMesh:
+        tid = MpTcpFullMesh::GetTypeId();
+        break;
+      case nDiffPorts:
+        tid = MpTcpNdiffPorts::GetTypeId();
+        break;
+      case Default:
+        break;
+      default:
+        NS_LOG_WARN(" Wrong selection of Path Manger");
+        break;
+    }
+  if (m_tcp)
+    {
+      return m_tcp->GetMpTcpPathManager(tid);
+    }
+  ObjectFactory pathManagerFactory;
+  pathManagerFactory.SetTypeId(tid);
+  return pathManagerFactory.Create<MpTcpPathManager>();
+}
+
+void
+MpTcpSocketBase::ConnectInterfaceTraces()
+{
+  NS_LOG_FUNCTION(this);
+  Ptr<Node> node = GetNode();
+  Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+  if (ipv4 && !m_interfaceTraces)
+    {
+      ipv4->TraceConnectWithoutContext("InterfaceUp", MakeCallback(&MpTcpSocketBase::OnInterfaceUp, this));
+      ipv4->TraceConnectWithoutContext("InterfaceDown", MakeCallback(&MpTcpSocketBase::OnInterfaceDown, this));
+      m_interfaceTraces = ipv4;
+    }
+  Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol>();
+  if (ipv6 && !m_interfaceTraces6)
+    {
+      ipv6->TraceConnectWithoutContext("InterfaceUp", MakeCallback(&MpTcpSocketBase::OnInterfaceUp6, this));
+      ipv6->TraceConnectWithoutContext("InterfaceDown", MakeCallback(&MpTcpSocketBase::OnInterfaceDown6, this));
+      m_interfaceTraces6 = ipv6;
+    }
+}
+
+void
+MpTcpSocketBase::OnInterfaceUp(Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_LOG_FUNCTION(this << interface);
+  if (!m_pathManagerImpl || m_state == CLOSED)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < ipv4->GetNAddresses(interface); i++)
+    {
+      Ipv4Address address = ipv4->GetAddress(interface, i).GetLocal();
+      if (address != Ipv4Address::GetLoopback())
+        {
+          m_pathManagerImpl->OnLocalAddressUp(this, address);
+        }
+    }
+}
+
+void
+MpTcpSocketBase::OnInterfaceDown(Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_LOG_FUNCTION(this << interface);
+  if (!m_pathManagerImpl || m_state == CLOSED)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < ipv4->GetNAddresses(interface); i++)
+    {
+      Ipv4Address address = ipv4->GetAddress(interface, i).GetLocal();
+      if (address != Ipv4Address::GetLoopback())
+        {
+          m_pathManagerImpl->OnLocalAddressDown(this, address);
+        }
+    }
+}
+
+void
+MpTcpSocketBase::OnInterfaceUp6(Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  NS_LOG_FUNCTION(this << interface);
+  if (!m_pathManagerImpl || m_state == CLOSED)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < ipv6->GetNAddresses(interface); i++)
+    {
+      Ipv6InterfaceAddress address = ipv6->GetAddress(interface, i);
+      if (address.GetScope() == Ipv6InterfaceAddress::GLOBAL)
+        {
+          m_pathManagerImpl->OnLocalAddressUp(this, address.GetAddress());
+        }
+    }
+}
+
+void
+MpTcpSocketBase::OnInterfaceDown6(Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  NS_LOG_FUNCTION(this << interface);
+  if (!m_pathManagerImpl || m_state == CLOSED)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < ipv6->GetNAddresses(interface); i++)
+    {
+      Ipv6InterfaceAddress address = ipv6->GetAddress(interface, i);
+      if (address.GetScope() == Ipv6InterfaceAddress::GLOBAL)
+        {
+          m_pathManagerImpl->OnLocalAddressDown(this, address.GetAddress());
+        }
+    }
+}
+
+void
+MpTcpSocketBase::OnSubflowTimeout(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowTimeout(this, sf, sf->GetConsecutiveTimeouts());
+    }
+}
+
+void
+MpTcpSocketBase::OnSubflowRecovered(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowRecovered(this, sf);
+    }
+  else
+    {
+      sf->SetPathFailed(false);
+    }
+}
+
+void
+MpTcpSocketBase::OnSubflowUnreachable(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowUnreachable(this, sf);
+    }
+}
+
+/* Mappings get discarded once acked at both levels, so those left from the
+   head of the subflow Tx buffer were not acknowledged by the peer subflow */
+void
+MpTcpSocketBase::ReinjectSubflowData(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  SequenceNumber32 head = sf->m_txBuffer->HeadSequence();
+  std::set<MpTcpMapping> mappings;
+  sf->m_TxMappings.GetMappingsStartingFromSSN(head, mappings);
+  MpTcpMapping first;
+  if (sf->m_TxMappings.GetMappingForSSN(head, first))
+    {
+      mappings.insert(first);
+    }
+  for (std::set<MpTcpMapping>::const_iterator it = mappings.begin(); it != mappings.end(); ++it)
+    {
+      SequenceNumber64 dsnHead = std::max(it->HeadDSN(), m_txHeadDsn);
+      SequenceNumber64 dsnTail = it->TailDSN() + 1;
+      if (dsnHead < dsnTail)
+        {
+          NS_LOG_LOGIC("Reinjecting " << *it << " held by " << sf);
+          ReinjectRange(dsnHead, dsnTail - dsnHead);
+        }
+    }
+}
+
+Ptr<Packet>
+MpTcpSocketBase::GetTxData(const SequenceNumber64& dsn, uint32_t length) const
+{
+  NS_LOG_FUNCTION(this << dsn << length);
+  Ptr<Packet> p = m_txBuffer->PeekFromSequence(length, SEQ64TO32(dsn));
+  NS_ASSERT_MSG(p->GetSize() == length, "Data mapped at " << dsn << " is not buffered anymore");
+  return p;
+}
+
+void
+MpTcpSocketBase::ReleaseTxData()
+{
+  NS_LOG_FUNCTION(this);
+  SequenceNumber64 release = m_txHeadDsn;
+  for (int i = 0; i < Maximum; ++i)
+    {
+      for (SubflowList::const_iterator it = m_subflows[i].begin(); it != m_subflows[i].end(); ++it)
+        {
+          SequenceNumber64 lowest;
+          if ((*it)->m_TxMappings.LowestDSN(lowest))
+            {
+              release = std::min(release, lowest);
+            }
+        }
+    }
+  if (TxDsn(m_txBuffer->HeadSequence()) < release)
+    {
+      NS_LOG_LOGIC("Releasing send buffer up to " << release);
+      m_txBuffer->DiscardUpTo(SEQ64TO32(release));
+    }
+}
+
+bool
+MpTcpSocketBase::HasSubflow(const Address& localAddress, const Address& remoteAddress) const
+{
+  for (int i = 0; i < Maximum; ++i)
+    {
+      for (SubflowList::const_iterator it = m_subflows[i].begin(); it != m_subflows[i].end(); ++it)
+        {
+          if ((*it)->GetLocalIp() == localAddress && (*it)->GetPeerIp() == remoteAddress)
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+uint8_t
+MpTcpSocketBase::GetLocalAddressId(const Address& address)
+{
+  std::map<Address, uint8_t>::const_iterator it = m_localAddressIds.find(address);
+  if (it != m_localAddressIds.end())
+    {
+      return it->second;
+    }
+  uint8_t id = (address == GetLocalIp()) ? 0 : m_localAddressIds.size() + 1;
+  m_localAddressIds[address] = id;
+  return id;
+}
+
 int
 MpTcpSocketBase::ConnectNewSubflow(const Address &local, const Address &remote)
 {
-  NS_ASSERT_MSG(InetSocketAddress::IsMatchingType(local) && InetSocketAddress::IsMatchingType(remote), "only support ipv4");
+  NS_ASSERT_MSG((InetSocketAddress::IsMatchingType(local) && InetSocketAddress::IsMatchingType(remote))
+                || (Inet6SocketAddress::IsMatchingType(local) && Inet6SocketAddress::IsMatchingType(remote)),
+                "Both ends of a subflow must be of the same address family");
 
-  NS_LOG_LOGIC("Trying to add a new subflow " << InetSocketAddress::ConvertFrom(local).GetIpv4()
-                << "->" << InetSocketAddress::ConvertFrom(remote).GetIpv4());
+  NS_LOG_LOGIC("Trying to add a new subflow " << local << "->" << remote);
   // not constructed properly since MpTcpSocketBase creation is hackish
   // and does not call CompleteConstruct
   m_subflowTypeId = MpTcpSubflow::GetTypeId();
@@ -282,7 +703,7 @@ MpTcpSocketBase::SetPeerKey(uint64_t remoteKey)
   uint64_t idsn = 0;
   m_peerKey = remoteKey;
   // use the one  from mptcp-crypo.h
-  GenerateTokenForKey(HMAC_SHA1, m_peerKey, m_peerToken, idsn);  
+  GenerateTokenForKey(GetMpTcpCryptoAlg(), m_peerKey, m_peerToken, idsn);
 }
 
 // in fact it just calls SendPendingData()
@@ -318,7 +739,13 @@ MpTcpSocketBase::OnSubflowClosed(Ptr<MpTcpSubflow> subflow, bool reset)
   {
     NS_FATAL_ERROR("Case not handled yet.");
   }
-  SubflowList::iterator it = std::remove(m_subflows[Closing].begin(), m_subflows[Closing].end(), subflow);
+  RemoveCoupledAggregates(subflow);
+  m_subflows[Closing].erase(std::remove(m_subflows[Closing].begin(), m_subflows[Closing].end(), subflow),
+                            m_subflows[Closing].end());
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowClosed(this, subflow);
+    }
 }
 
 void
@@ -326,6 +753,7 @@ MpTcpSocketBase::DumpRxBuffers(Ptr<MpTcpSubflow> sf) const
 {
   NS_LOG_INFO("=> Dumping meta RxBuffer ");
   m_rxBuffer->Dump();
+  NS_LOG_INFO("=> Out of order: " << m_rxReassembly.GetRanges());
   for(int i = 0; i < (int)GetNActiveSubflows(); ++i)
   {
     Ptr<MpTcpSubflow> sf = GetSubflow(i);
@@ -346,38 +774,14 @@ MpTcpSocketBase::OnSubflowRecv(Ptr<MpTcpSubflow> sf)
   DumpRxBuffers(sf);
   SequenceNumber32 expectedDSN = m_rxBuffer->NextRxSequence();
 
-  /* Extract one by one mappings from subflow */
-  while(true)
-  {
-    Ptr<Packet> p;
-    SequenceNumber64 dsn;
-    uint32_t canRead = m_rxBuffer->MaxBufferSize() - m_rxBuffer->Size();
+  ExtractSubflowData(sf);
 
-    if(canRead <= 0)
-    {
-      NS_LOG_LOGIC("No free space in meta Rx Buffer");
-      break;
-    }
-    /* Todo tell if we stop to extract only between mapping boundaries or if Extract */
-    p = sf->ExtractAtMostOneMapping(canRead, true, dsn);
-    if (p->GetSize() == 0)
-    {
-      NS_LOG_DEBUG("packet extracted empty.");
-      break;
-    }
-    // THIS MUST WORK. else we removed the data from subflow buffer so it would be lost
-    // Pb here, htis will be extracted but will not be saved into the main buffer
-    // Notify app to receive if necessary
-    if(!m_rxBuffer->Add(p, SEQ64TO32(dsn)))
-    {
-      NS_FATAL_ERROR("Data might have been lost");
-    }
-  }
   NS_LOG_INFO("=> Dumping RxBuffers after extraction");
   DumpRxBuffers(sf);
   if (expectedDSN < m_rxBuffer->NextRxSequence())
     {
       NS_LOG_LOGIC("The Rxbuffer advanced");
+      AutoTuneRcvBuf();
 
       // NextRxSeq advanced, we have something to send to the app
       if (!m_shutdownRecv)
@@ -394,12 +798,315 @@ MpTcpSocketBase::OnSubflowRecv(Ptr<MpTcpSubflow> sf)
    }
 }
 
+/* Data is extracted from the subflow whatever its DSN: out of order data waits
+   in the reassembly queue instead of in the subflow, so that a slow subflow
+   does not prevent the others from handing over their data. */
+uint32_t
+MpTcpSocketBase::ExtractSubflowData(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  uint32_t extracted = 0;
+
+  /* Extract one by one mappings from subflow */
+  while(true)
+  {
+    uint32_t used = m_rxBuffer->Size() + m_rxReassembly.Size();
+    uint32_t canRead = m_rxBuffer->MaxBufferSize() > used ? m_rxBuffer->MaxBufferSize() - used : 0;
+    if(canRead == 0)
+    {
+      NS_LOG_LOGIC("No free space in meta Rx Buffer");
+      break;
+    }
+    // mappings may be larger than the free space: extract what fits
+    SequenceNumber64 dsn;
+    Ptr<Packet> p = sf->ExtractAtMostOneMapping(canRead, false, dsn);
+    if (p->GetSize() == 0)
+    {
+      NS_LOG_DEBUG("packet extracted empty.");
+      break;
+    }
+    extracted += p->GetSize();
+
+    // Nothing new means the whole range was already received, e.g., on another
+    // subflow when the peer reinjected it
+    SequenceNumber64 expected = RxDsn(m_rxBuffer->NextRxSequence());
+    m_rxReassembly.DiscardUpTo(expected);
+    bool duplicate = (m_rxReassembly.Add(p, dsn, RxDsn(m_rxBuffer->MaxRxSequence())) == 0);
+    if(duplicate)
+    {
+      NS_LOG_LOGIC("Dropping duplicate data [" << dsn << ", +" << p->GetSize() << ")");
+    }
+    m_stats->NotifyReceived(dsn, p->GetSize(), expected, duplicate);
+
+    // Hands the contiguous head over to the receive buffer
+    SequenceNumber64 head;
+    Ptr<Packet> inOrder;
+    while ((inOrder = m_rxReassembly.Extract(head)))
+    {
+      bool ok = m_rxBuffer->Add(inOrder, SEQ64TO32(head));
+      NS_ASSERT_MSG(ok, "In order data must fit in the receive window");
+    }
+  }
+  m_stats->NotifyRxBuffer(m_rxBuffer->Size() + m_rxReassembly.Size(), !m_rxReassembly.IsEmpty());
+  return extracted;
+}
+
+uint32_t
+MpTcpSocketBase::PullSubflowData()
+{
+  NS_LOG_FUNCTION(this);
+  uint32_t extracted = 0;
+  for(uint32_t i = 0; i < GetNActiveSubflows(); ++i)
+  {
+    Ptr<MpTcpSubflow> sf = GetSubflow(i);
+    if (sf->GetRxAvailable() > 0)
+    {
+      extracted += ExtractSubflowData(sf);
+    }
+  }
+  return extracted;
+}
+
+const MpTcpReassemblyQueue&
+MpTcpSocketBase::GetReassemblyQueue() const
+{
+  return m_rxReassembly;
+}
+
+SequenceNumber64
+MpTcpSocketBase::TxDsn(const SequenceNumber32& seq) const
+{
+  return ExpandDsn(seq.GetValue(), m_txHeadDsn);
+}
+
+SequenceNumber64
+MpTcpSocketBase::RxDsn(const SequenceNumber32& seq) const
+{
+  return ExpandDsn(seq.GetValue(), m_rxReassembly.GetNextDsn());
+}
+
+/* add a MakeBoundCallback that accepts a member function as first input */
+static void
+onSubflowNewCwnd(
+  Ptr<MpTcpSocketBase> meta,
+  Ptr<MpTcpSubflow> sf,
+  uint32_t oldCwnd,
+  uint32_t newCwnd
+  )
+{
+  meta->OnSubflowNewCwnd("CongestionWindow", sf, oldCwnd, newCwnd);
+}
+
+void
+MpTcpSocketBase::OnSubflowNewCwnd(std::string context, Ptr<MpTcpSubflow> sf, uint32_t oldCwnd, uint32_t newCwnd)
+{
+  NS_LOG_LOGIC("Subflow " << sf << " updated window from " << oldCwnd << " to " << newCwnd );
+  // Incremental version of ComputeTotalCWND
+  UpdateCoupledAggregates(sf);
+  m_tcb->m_cWnd = m_ccTotalCwnd;
+}
+
+uint64_t
+MpTcpSocketBase::GetCoupledTotalCwnd() const
+{
+  return m_ccTotalCwnd;
+}
+
+double
+MpTcpSocketBase::GetCoupledSumRate() const
+{
+  return m_ccSumRate;
+}
+
+double
+MpTcpSocketBase::GetCoupledMaxRate() const
+{
+  return m_ccMaxRate;
+}
+
+double
+MpTcpSocketBase::GetCoupledMaxCwndOverRtt2() const
+{
+  return m_ccMaxCwndRtt2;
+}
+
+uint32_t
+MpTcpSocketBase::GetCoupledNSubflows() const
+{
+  return m_ccNSubflows;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocketBase::GetCoupledMaxCwndSubflow() const
+{
+  return m_ccMaxCwndSubflow;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocketBase::GetCoupledBestSubflow() const
+{
+  return m_ccBestSubflow;
+}
+
 void
-MpTcpSocketBase::OnSubflowNewCwnd(std::string context, uint32_t oldCwnd, uint32_t newCwnd)
+MpTcpSocketBase::UpdateCoupledLossInterval(Ptr<MpTcpSubflow> sf, uint64_t bytes)
 {
-  NS_LOG_LOGIC("Subflow updated window from " << oldCwnd << " to " << newCwnd );
-  // maybe ComputeTotalCWND should be left
-  m_tcb->m_cWnd = ComputeTotalCWND();
+  NS_LOG_FUNCTION(this << sf << bytes);
+  sf->m_ccLossInterval = bytes;
+  UpdateCoupledAggregates(sf);
+}
+
+void
+MpTcpSocketBase::UpdateCoupledAggregates(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  uint32_t cwnd = sf->m_tcb->m_cWnd.Get();
+  double rtt = sf->m_rtt->GetEstimate().GetSeconds();
+  if (rtt <= 0)
+  {
+    // No estimate yet, keep the previous one
+    rtt = sf->m_ccRtt;
+  }
+  double rate = (rtt > 0) ? cwnd / rtt : 0;
+  double cwndRtt2 = (rtt > 0) ? rate / rtt : 0;
+  double lossInterval = static_cast<double>(sf->m_ccLossInterval);
+  double quality = (rtt > 0) ? lossInterval * lossInterval / rtt : 0;
+
+  if (sf->m_ccRegistered)
+  {
+    m_ccTotalCwnd -= sf->m_ccCwnd;
+    m_ccSumRate -= sf->m_ccRate;
+  }
+  else
+  {
+    sf->m_ccRegistered = true;
+    m_ccNSubflows++;
+  }
+  m_ccTotalCwnd += cwnd;
+  m_ccSumRate += rate;
+  if (m_ccSumRate < 0)
+  {
+    // floating point drift
+    m_ccSumRate = 0;
+  }
+
+  // A maximum needs a full recomputation only when the subflow holding it decreases
+  bool recompute = (sf == m_ccMaxRateSubflow && rate < sf->m_ccRate)
+    || (sf == m_ccMaxCwndRtt2Subflow && cwndRtt2 < sf->m_ccCwndRtt2)
+    || (sf == m_ccMaxCwndSubflow && cwnd < sf->m_ccCwnd)
+    || (sf == m_ccBestSubflow && quality < sf->m_ccQuality);
+
+  sf->m_ccCwnd = cwnd;
+  sf->m_ccRtt = rtt;
+  sf->m_ccRate = rate;
+  sf->m_ccCwndRtt2 = cwndRtt2;
+  sf->m_ccQuality = quality;
+
+  if (recompute)
+  {
+    RecomputeCoupledMaxima();
+    return;
+  }
+  if (rate >= m_ccMaxRate)
+  {
+    m_ccMaxRate = rate;
+    m_ccMaxRateSubflow = sf;
+  }
+  if (cwndRtt2 >= m_ccMaxCwndRtt2)
+  {
+    m_ccMaxCwndRtt2 = cwndRtt2;
+    m_ccMaxCwndRtt2Subflow = sf;
+  }
+  if (cwnd >= m_ccMaxCwnd)
+  {
+    m_ccMaxCwnd = cwnd;
+    m_ccMaxCwndSubflow = sf;
+  }
+  if (quality > m_ccMaxQuality)
+  {
+    m_ccMaxQuality = quality;
+    m_ccBestSubflow = sf;
+  }
+}
+
+void
+MpTcpSocketBase::RemoveCoupledAggregates(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  if (!sf->m_ccRegistered)
+  {
+    return;
+  }
+  sf->m_ccRegistered = false;
+  m_ccNSubflows--;
+  m_ccTotalCwnd -= sf->m_ccCwnd;
+  m_ccSumRate = std::max(0.0, m_ccSumRate - sf->m_ccRate);
+  m_tcb->m_cWnd = m_ccTotalCwnd;
+  RecomputeCoupledMaxima();
+}
+
+void
+MpTcpSocketBase::RecomputeCoupledMaxima()
+{
+  NS_LOG_FUNCTION(this);
+  m_ccMaxRate = 0;
+  m_ccMaxCwndRtt2 = 0;
+  m_ccMaxCwnd = 0;
+  m_ccMaxQuality = 0;
+  m_ccMaxRateSubflow = 0;
+  m_ccMaxCwndRtt2Subflow = 0;
+  m_ccMaxCwndSubflow = 0;
+  m_ccBestSubflow = 0;
+  for (int i = 0; i < Maximum; i++)
+  {
+    for (SubflowList::const_iterator it = m_subflows[i].begin(); it != m_subflows[i].end(); it++)
+    {
+      Ptr<MpTcpSubflow> sf = *it;
+      if (!sf->m_ccRegistered)
+      {
+        continue;
+      }
+      if (!m_ccMaxRateSubflow || sf->m_ccRate > m_ccMaxRate)
+      {
+        m_ccMaxRate = sf->m_ccRate;
+        m_ccMaxRateSubflow = sf;
+      }
+      if (!m_ccMaxCwndRtt2Subflow || sf->m_ccCwndRtt2 > m_ccMaxCwndRtt2)
+      {
+        m_ccMaxCwndRtt2 = sf->m_ccCwndRtt2;
+        m_ccMaxCwndRtt2Subflow = sf;
+      }
+      if (!m_ccMaxCwndSubflow || sf->m_ccCwnd > m_ccMaxCwnd)
+      {
+        m_ccMaxCwnd = sf->m_ccCwnd;
+        m_ccMaxCwndSubflow = sf;
+      }
+      if (sf->m_ccQuality > m_ccMaxQuality)
+      {
+        m_ccMaxQuality = sf->m_ccQuality;
+        m_ccBestSubflow = sf;
+      }
+    }
+  }
+}
+
+Ptr<TcpCongestionOps>
+MpTcpSocketBase::CreateSubflowCongestionControl(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf << m_congestionTypeId);
+  if (!m_congestionTypeId.IsChildOf(MpTcpCongestionOps::GetTypeId())
+      && m_congestionTypeId != MpTcpCongestionOps::GetTypeId())
+  {
+    // Uncoupled: every subflow runs its own copy of the meta algorithm
+    ObjectFactory factory;
+    factory.SetTypeId(m_congestionTypeId);
+    return factory.Create<TcpCongestionOps>();
+  }
+  ObjectFactory factory;
+  factory.SetTypeId(m_congestionTypeId);
+  Ptr<MpTcpCongestionOps> cc = factory.Create<MpTcpCongestionOps>();
+  cc->SetMeta(this, sf);
+  return cc;
 }
 
 /* add a MakeBoundCallback that accepts a member function as first input */
@@ -411,7 +1118,7 @@ onSubflowNewState(
   TcpSocket::TcpStates_t newState
   )
 {
-  NS_LOG_UNCOND("onSubflowNewState wrapper");
+  NS_LOG_LOGIC("onSubflowNewState wrapper");
     meta->OnSubflowNewState(
       "context", sf, oldState, newState);
 }
@@ -494,7 +1201,7 @@ MpTcpSocketBase::AddSubflow(Ptr<MpTcpSubflow> sflow)
   NS_LOG_FUNCTION(sflow);
   Ptr<MpTcpSubflow> sf = sflow;
   bool ok;
-  ok = sf->TraceConnect ("CongestionWindow", "CongestionWindow", MakeCallback(&MpTcpSocketBase::OnSubflowNewCwnd, this));
+  ok = sf->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback(&onSubflowNewCwnd, this, sf));
   NS_ASSERT_MSG(ok, "Tracing mandatory to update the MPTCP global congestion window");
 
   //! We need to act on certain subflow state transitions according to doc "There is not a version with bound arguments."
@@ -523,7 +1230,11 @@ MpTcpSocketBase::AddSubflow(Ptr<MpTcpSubflow> sflow)
   sf->SetAcceptCallback (
                          MakeNullCallback<bool, Ptr<Socket>, const Address &>(),
                          MakeCallback (&MpTcpSocketBase::OnSubflowCreated,this));
-  sf->SetCongestionControlAlgorithm(this->m_congestionControl);
+  sf->SetCongestionControlAlgorithm(CreateSubflowCongestionControl(sf));
+  if (m_subflowPacing)
+    {
+      sf->SetPacing(m_superSegments);
+    }
   m_subflows[Others].push_back( sf );
 }
 
@@ -557,13 +1268,60 @@ MpTcpSocketBase::NotifyJoinRequest (const Address &from, const Address & toAddre
 bool
 MpTcpSocketBase::OwnIP(const Address& address) const
 {
-  NS_LOG_FUNCTION(this);
-  NS_ASSERT_MSG(Ipv4Address::IsMatchingType(address), "only ipv4 supported for now");
-  Ipv4Address ip = Ipv4Address::ConvertFrom(address);
+  NS_LOG_FUNCTION(this << address);
   Ptr<Node> node = GetNode();
-  Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
-  return (ipv4->GetInterfaceForAddress(ip) >= 0);
-  return false;
+  if (Ipv4Address::IsMatchingType(address))
+  {
+    Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+    return ipv4 && (ipv4->GetInterfaceForAddress(Ipv4Address::ConvertFrom(address)) >= 0);
+  }
+  NS_ASSERT_MSG(Ipv6Address::IsMatchingType(address), "Expects an Ipv4Address or an Ipv6Address");
+  Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol>();
+  return ipv6 && (ipv6->GetInterfaceForAddress(Ipv6Address::ConvertFrom(address)) >= 0);
+}
+
+Address
+MpTcpSocketBase::GetLocalIp() const
+{
+  if (m_endPoint)
+  {
+    return m_endPoint->GetLocalAddress();
+  }
+  NS_ASSERT_MSG(m_endPoint6, "No endpoint allocated yet");
+  return m_endPoint6->GetLocalAddress();
+}
+
+Address
+MpTcpSocketBase::GetPeerIp() const
+{
+  if (m_endPoint)
+  {
+    return m_endPoint->GetPeerAddress();
+  }
+  NS_ASSERT_MSG(m_endPoint6, "No endpoint allocated yet");
+  return m_endPoint6->GetPeerAddress();
+}
+
+uint16_t
+MpTcpSocketBase::GetLocalPort() const
+{
+  if (m_endPoint)
+  {
+    return m_endPoint->GetLocalPort();
+  }
+  NS_ASSERT_MSG(m_endPoint6, "No endpoint allocated yet");
+  return m_endPoint6->GetLocalPort();
+}
+
+uint16_t
+MpTcpSocketBase::GetPeerPort() const
+{
+  if (m_endPoint)
+  {
+    return m_endPoint->GetPeerPort();
+  }
+  NS_ASSERT_MSG(m_endPoint6, "No endpoint allocated yet");
+  return m_endPoint6->GetPeerPort();
 }
 
 Ipv4EndPoint*
@@ -575,9 +1333,37 @@ MpTcpSocketBase::NewSubflowRequest(
   Ptr<const TcpOptionMpTcpJoin> join
 )
 {
-  NS_LOG_LOGIC("Received request for a new subflow while in state " << TcpStateName[m_state]);
   NS_ASSERT_MSG(InetSocketAddress::IsMatchingType(fromAddress) && InetSocketAddress::IsMatchingType(toAddress),
                 "Source and destination addresses should be of the same type");
+  Ptr<MpTcpSubflow> subflow = AcceptSubflowRequest(p, tcpHeader, fromAddress, toAddress, join);
+  return subflow ? subflow->m_endPoint : 0;
+}
+
+Ipv6EndPoint*
+MpTcpSocketBase::NewSubflowRequest6(
+  Ptr< Packet> p,
+  const TcpHeader & tcpHeader,
+  const Address & fromAddress,
+  const Address & toAddress,
+  Ptr<const TcpOptionMpTcpJoin> join
+)
+{
+  NS_ASSERT_MSG(Inet6SocketAddress::IsMatchingType(fromAddress) && Inet6SocketAddress::IsMatchingType(toAddress),
+                "Source and destination addresses should be of the same type");
+  Ptr<MpTcpSubflow> subflow = AcceptSubflowRequest(p, tcpHeader, fromAddress, toAddress, join);
+  return subflow ? subflow->m_endPoint6 : 0;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocketBase::AcceptSubflowRequest(
+  Ptr< Packet> p,
+  const TcpHeader & tcpHeader,
+  const Address & fromAddress,
+  const Address & toAddress,
+  Ptr<const TcpOptionMpTcpJoin> join
+)
+{
+  NS_LOG_LOGIC("Received request for a new subflow while in state " << TcpStateName[m_state]);
   NS_ASSERT(join);
   NS_ASSERT(join->GetPeerToken() == GetLocalToken());
 
@@ -587,7 +1373,9 @@ MpTcpSocketBase::NewSubflowRequest(
     NS_LOG_WARN("Received an MP_JOIN while meta not fully established yet.");
     return 0;
   }
-  Ipv4Address ip = InetSocketAddress::ConvertFrom(toAddress).GetIpv4();
+  Address ip = InetSocketAddress::IsMatchingType(toAddress)
+    ? Address(InetSocketAddress::ConvertFrom(toAddress).GetIpv4())
+    : Address(Inet6SocketAddress::ConvertFrom(toAddress).GetIpv6());
   if(!OwnIP(ip))
   {
     NS_LOG_WARN("This host does not own the ip " << ip);
@@ -605,9 +1393,11 @@ MpTcpSocketBase::NewSubflowRequest(
   Ptr<Socket> sock = m_tcp->CreateSocket(m_congestionControl, m_subflowTypeId);
   subflow = DynamicCast<MpTcpSubflow>(sock);
   AddSubflow(subflow);
+  subflow->m_localNonce = rand();
+  subflow->m_peerNonce = join->GetNonce();
   // Call it now so that endpoint gets allocated
   subflow->CompleteFork(p, tcpHeader, fromAddress, toAddress);
-  return subflow->m_endPoint;
+  return subflow;
 }
 
 /* Create a new subflow with different source and destination port pairs */
@@ -615,52 +1405,42 @@ bool
 MpTcpSocketBase::CreateSingleSubflow(uint16_t randomSourcePort, uint16_t randomDestinationPort)
 {
   NS_LOG_FUNCTION(this << randomSourcePort << randomDestinationPort);
-  Ptr<MpTcpSubflow> subflow;
-  Ptr<Socket> sock = m_tcp->CreateSocket(m_congestionControl, MpTcpSubflow::GetTypeId());
-  subflow = DynamicCast<MpTcpSubflow>(sock); 
-  AddSubflow(subflow);
-
-  // Set up subflow based on different source ports
-  Ipv4Address sAddr = m_endPoint->GetLocalAddress();
-  uint16_t sPort = randomSourcePort ;
-  Ipv4Address dAddr = m_endPoint->GetPeerAddress();
-  uint16_t dPort = randomDestinationPort;
-  NS_LOG_INFO("Creating Subflow with: sAddr "<< sAddr<<" sPort "<<sPort<< "dAddr "<<dAddr<<" dPort "<<dPort);
-  subflow->m_tcb->m_cWnd = m_tcb->m_segmentSize;
-  subflow->m_state = SYN_SENT;
-  subflow->m_synCount = m_synCount;
-  subflow->m_synCount = m_synRetries;
-  subflow->m_dataRetrCount = m_dataRetries;
-  subflow->m_endPoint = m_tcp->Allocate(GetBoundNetDevice (), sAddr, sPort, dAddr, dPort);
-  NS_LOG_INFO ("subflow endPoiont "<< subflow->m_endPoint);
-  m_endPoint = subflow->m_endPoint;
-  subflow->SetupCallback();
-  bool result = m_tcp->AddSocket(this);
-  if(!result)
-  {
-    NS_LOG_INFO("InitiateSinglesubflow/ Can't add socket: already registered ? Can be because of mptcp");
-  }
-  subflow->SendEmptyPacket(TcpHeader::SYN); 
-  return true;
+  return InitiateSubflow(GetLocalIp(), randomSourcePort, GetPeerIp(), randomDestinationPort);
 }
- 
-/* Create a new subflow with different source and destination IP pairs */
+
+/* Create a new subflow with different source and destination IP pairs.
+   Only pairs of the same family are meshed, a dual stack host thus opens
+   subflows over both IPv4 and IPv6 */
 bool
 MpTcpSocketBase::CreateSubflowsForMesh()
 {
-  Ipv4Address sAddr = m_endPoint->GetLocalAddress();
-  Ipv4Address dAddr = m_endPoint->GetPeerAddress();
-  uint16_t sPort    = m_endPoint->GetLocalPort ();
-  uint16_t dPort    = m_endPoint->GetPeerPort (); 
+  Address sAddr = GetLocalIp();
+  Address dAddr = GetPeerIp();
+  uint16_t sPort    = GetLocalPort ();
+  uint16_t dPort    = GetPeerPort ();
+  bool result = true;
 
   for ( auto it = LocalAddressInfo.begin(); it != LocalAddressInfo.end(); it++ )
     {
       // To get hold of the class pointers:
-      Ipv4Address localAddress = it->first;
+      Address localAddress = it->first;
       for ( auto it = RemoteAddressInfo.begin(); it != RemoteAddressInfo.end(); it++ )
         {
           // To get hold of the class pointers:
-          Ipv4Address remoteAddress = it->first;
+          Address remoteAddress = it->first;
+          if (Ipv4Address::IsMatchingType(localAddress) != Ipv4Address::IsMatchingType(remoteAddress))
+           {
+             continue;
+           }
+          if ( (sAddr == localAddress) && (dAddr == remoteAddress) )
+           {
+             continue;
+           }
+          if (HasSubflow(localAddress, remoteAddress))
+           {
+             NS_LOG_LOGIC("Pair " << localAddress << " " << remoteAddress << " already meshed");
+             continue;
+           }
           uint16_t localPort = rand() % 65000;
           uint16_t remotePort = rand() % 65000;
           if (localPort == sPort)
@@ -673,32 +1453,66 @@ MpTcpSocketBase::CreateSubflowsForMesh()
               NS_LOG_UNCOND("Generated random port is the same as meta subflow's peer port, increment by +1");
               remotePort++;
             }
-          if ( (sAddr == localAddress) && (dAddr == remoteAddress) )
-           {
-             continue;
-           }
-          // Set up subflow based on different source ports
-          Ptr<MpTcpSubflow> subflow;
-          Ptr<Socket> sock = m_tcp->CreateSocket(m_congestionControl, MpTcpSubflow::GetTypeId());
-          subflow = DynamicCast<MpTcpSubflow>(sock); 
-          AddSubflow(subflow); 
-          subflow->m_tcb->m_cWnd = m_tcb->m_segmentSize;
-          subflow->m_state = SYN_SENT;
-          subflow->m_synCount = m_synCount;
-          subflow->m_synCount = m_synRetries;
-          subflow->m_dataRetrCount = m_dataRetries;
-          subflow->m_endPoint = m_tcp->Allocate(GetBoundNetDevice (), localAddress, localPort, remoteAddress, remotePort);
-          NS_LOG_INFO ("subflow endPoiont "<< subflow->m_endPoint);
-          m_endPoint = subflow->m_endPoint;
-          subflow->SetupCallback();
-          bool result = m_tcp->AddSocket(this);
-          if(!result)
-          {
-            NS_LOG_INFO("InitiateSinglesubflow/ Can't add socket: already registered ? Can be because of mptcp");
-          }
-          subflow->SendEmptyPacket(TcpHeader::SYN); 
+          result = InitiateSubflow(localAddress, localPort, remoteAddress, remotePort) && result;
        }
     }
+  return result;
+}
+
+bool
+MpTcpSocketBase::InitiateSubflow(const Address& localAddress, uint16_t localPort,
+                                 const Address& remoteAddress, uint16_t remotePort)
+{
+  NS_LOG_FUNCTION(this << localAddress << localPort << remoteAddress << remotePort);
+  NS_ASSERT_MSG(Ipv4Address::IsMatchingType(localAddress) == Ipv4Address::IsMatchingType(remoteAddress),
+                "Both ends of a subflow must be of the same address family");
+
+  Ptr<MpTcpSubflow> subflow;
+  Ptr<Socket> sock = m_tcp->CreateSocket(m_congestionControl, MpTcpSubflow::GetTypeId());
+  subflow = DynamicCast<MpTcpSubflow>(sock);
+  AddSubflow(subflow);
+  subflow->m_localNonce = rand();
+  subflow->m_tcb->m_cWnd = m_tcb->m_segmentSize;
+  subflow->m_state = SYN_SENT;
+  subflow->m_synCount = m_synCount;
+  subflow->m_synCount = m_synRetries;
+  subflow->m_dataRetrCount = m_dataRetries;
+  if (Ipv4Address::IsMatchingType(localAddress))
+    {
+      subflow->m_endPoint = m_tcp->Allocate(GetBoundNetDevice (), Ipv4Address::ConvertFrom(localAddress), localPort,
+                                            Ipv4Address::ConvertFrom(remoteAddress), remotePort);
+      NS_LOG_INFO ("subflow endPoint "<< subflow->m_endPoint);
+      if (subflow->m_endPoint == 0)
+        {
+          return false;
+        }
+      // the meta keeps pointing to an endpoint of the master's family
+      if (m_endPoint)
+        {
+          m_endPoint = subflow->m_endPoint;
+        }
+    }
+  else
+    {
+      subflow->m_endPoint6 = m_tcp->Allocate6(GetBoundNetDevice (), Ipv6Address::ConvertFrom(localAddress), localPort,
+                                              Ipv6Address::ConvertFrom(remoteAddress), remotePort);
+      NS_LOG_INFO ("subflow endPoint6 "<< subflow->m_endPoint6);
+      if (subflow->m_endPoint6 == 0)
+        {
+          return false;
+        }
+      if (m_endPoint6)
+        {
+          m_endPoint6 = subflow->m_endPoint6;
+        }
+    }
+  subflow->SetupCallback();
+  bool result = m_tcp->AddSocket(this);
+  if(!result)
+  {
+    NS_LOG_INFO("InitiateSubflow/ Can't add socket: already registered ? Can be because of mptcp");
+  }
+  subflow->SendEmptyPacket(TcpHeader::SYN);
   return true;
 }
 
@@ -706,12 +1520,61 @@ void
 MpTcpSocketBase::SendFastClose(Ptr<MpTcpSubflow> sf)
 {
   NS_LOG_LOGIC ("Sending MP_FASTCLOSE");
-  TcpHeader header;
-  Ptr<TcpOptionMpTcpFastClose> opt = Create<TcpOptionMpTcpFastClose>();
 
-  opt->SetPeerKey( GetPeerKey() );
-  sf->SendEmptyPacket(TcpHeader::RST);
-  TimeWait();
+  if (m_mptcpVersion == 0)
+    {
+      // RFC 6824: the peer answers the ACK with RSTs
+      Ptr<TcpOptionMpTcpFastClose> opt = CreateObject<TcpOptionMpTcpFastClose>();
+      opt->SetPeerKey( GetPeerKey() );
+      sf->m_pendingOptions.push_back(opt);
+      sf->SendEmptyPacket(TcpHeader::ACK);
+      TimeWait();
+      return;
+    }
+
+  // RFC 8684: a RST carrying the option on every subflow
+  SubflowList subflows(m_subflows[Established]);
+  subflows.insert(subflows.end(), m_subflows[Others].begin(), m_subflows[Others].end());
+  for (SubflowList::iterator it = subflows.begin(); it != subflows.end(); ++it)
+    {
+      Ptr<TcpOptionMpTcpFastClose> opt = CreateObject<TcpOptionMpTcpFastClose>();
+      opt->SetPeerKey( GetPeerKey() );
+      (*it)->m_pendingOptions.push_back(opt);
+      (*it)->Abort(true);
+    }
+  Abort();
+}
+
+void
+MpTcpSocketBase::PeerFastClose(Ptr<MpTcpSubflow> sf, bool replyRst)
+{
+  NS_LOG_FUNCTION(this << sf << replyRst);
+
+  SubflowList subflows(m_subflows[Established]);
+  subflows.insert(subflows.end(), m_subflows[Others].begin(), m_subflows[Others].end());
+  for (SubflowList::iterator it = subflows.begin(); it != subflows.end(); ++it)
+    {
+      (*it)->Abort(*it != sf || replyRst);
+    }
+  Abort();
+  NotifyErrorClose();
+}
+
+void
+MpTcpSocketBase::Abort()
+{
+  NS_LOG_FUNCTION(this);
+  NS_LOG_INFO (TcpStateName[m_state] << " -> CLOSED");
+  CancelAllTimers();
+  // the endpoint belonged to the master, which released it
+  m_endPoint = nullptr;
+  m_endPoint6 = nullptr;
+  if (m_tcp && m_mptcpLocalKey != 0)
+    {
+      m_tcp->RemoveMpTcpToken(m_mptcpLocalToken, this);
+    }
+  m_closeNotified = true;
+  m_state = CLOSED;
 }
 
 void
@@ -769,17 +1632,19 @@ only permissible to combine these signals on one subflow if there is
 no data outstanding on other subflows.
 */
 void
-MpTcpSocketBase::PeerClose( SequenceNumber32 dsn, Ptr<MpTcpSubflow> sf)
+MpTcpSocketBase::PeerClose( SequenceNumber64 dsn, Ptr<MpTcpSubflow> sf)
 {
   NS_LOG_LOGIC("Datafin with seq=" << dsn);
-  if( dsn < m_rxBuffer->NextRxSequence() || m_rxBuffer->MaxRxSequence() < dsn)
+  SequenceNumber64 nextRx = RxDsn(m_rxBuffer->NextRxSequence());
+  SequenceNumber64 maxRx = RxDsn(m_rxBuffer->MaxRxSequence());
+  if( dsn < nextRx || maxRx < dsn)
   {
-    NS_LOG_INFO("dsn " << dsn << " out of expected range [ " << m_rxBuffer->NextRxSequence()  << " - " << m_rxBuffer->MaxRxSequence() << " ]" );
+    NS_LOG_INFO("dsn " << dsn << " out of expected range [ " << nextRx  << " - " << maxRx << " ]" );
     return ;
   }
   // For any case, remember the FIN position in rx buffer first
   //! +1 because the datafin doesn't count as payload
-  m_rxBuffer->SetFinSequence(dsn);
+  m_rxBuffer->SetFinSequence(SEQ64TO32(dsn));
   NS_LOG_LOGIC ("Accepted MPTCP FIN at seq " << dsn);
 
   // Return if FIN is out of sequence, otherwise move to CLOSE_WAIT state by DoPeerClose
@@ -818,6 +1683,7 @@ void
 MpTcpSocketBase::NewAck(SequenceNumber32 const& dsn, bool resetRTO)
 {
   NS_LOG_FUNCTION(this << " new dataack=[" <<  dsn << "]");
+  m_txSentAhead.DiscardUpTo(TxDsn(dsn));
   TcpSocketBase::NewAck(dsn, resetRTO);
 }
 
@@ -867,30 +1733,14 @@ MpTcpSocketBase::SendPendingData(bool withAck)
   {
     if (!m_multipleSubflows)
      {
-       //selecting path manager
-       if (m_pathManager == MpTcpSocketBase::Default)
+       // set first: the path manager may send data on the subflows it opens
+       m_multipleSubflows = true;
+       if (!m_pathManagerImpl)
          {
-           //Default path mananger
+           m_pathManagerImpl = CreatePathManager();
          }
-       else if (m_pathManager == MpTcpSocketBase::FullMesh)
-          {
-            //fullmesh path manager
-            Ptr<MpTcpFullMesh> m_fullMesh = Create<MpTcpFullMesh>();
-            m_fullMesh->CreateMesh(this);
-          }
-       else if(m_pathManager == MpTcpSocketBase::nDiffPorts)
-          {
-            //ndiffports path manager
-            Ptr<MpTcpNdiffPorts> m_ndiffPorts = Create<MpTcpNdiffPorts>();
-            uint16_t localport = m_endPoint->GetLocalPort();
-            uint16_t remoteport = m_endPoint->GetPeerPort ();
-            m_ndiffPorts->CreateSubflows(this, localport, remoteport);
-          }
-       else
-          {
-            NS_LOG_WARN(" Wrong selection of Path Manger");
-          }
-       m_multipleSubflows = true;
+       ConnectInterfaceTraces();
+       m_pathManagerImpl->OnFullyEstablished(this);
      }
   }  
   //  MappingList mappings;
@@ -901,46 +1751,85 @@ MpTcpSocketBase::SendPendingData(bool withAck)
   //start/size
   uint32_t nbMappingsDispatched = 0; // mimic nbPackets in TcpSocketBase::SendPendingData
 
+  // Reinjected data has priority over new data
+  nbMappingsDispatched += SendReinjectedData();
+
+  // A DATA_ACK may have brought m_nextTxSequence up to a range sent ahead
+  SkipSentAhead();
+
   /* Generate DSS mappings
-   * This could go into a specific function
-   * MappingVector mappings;
+   * The scheduler decides on a snapshot of the subflows, we ask again
+   * as long as the decisions make the connection progress.
    */
-  SequenceNumber64 dsnHead;
-  SequenceNumber32 ssn;
-  int subflowArrayId;
-  uint16_t length;
-
-  while(m_scheduler->GenerateMapping(subflowArrayId, dsnHead, length))
+  SequenceNumber32 progress;
+  uint64_t progressAhead;
+  do
   {
-    Ptr<MpTcpSubflow> subflow = GetSubflow(subflowArrayId);
-
-    // For now we limit the mapping to a per packet basis
-    bool ok = subflow->AddLooseMapping(dsnHead, length);
-    NS_ASSERT(ok);
-    // see next #if 0 to see how it should be
-    SequenceNumber32 dsnTail = SEQ64TO32(dsnHead) + length;
-    Ptr<Packet> p = m_txBuffer->CopyFromSequence(length, SEQ64TO32(dsnHead));
-    NS_ASSERT(p->GetSize() <= length);
-    int ret = subflow->Send(p, 0);
-    // Flush to update cwnd and stuff
-    NS_LOG_DEBUG("Send result=" << ret);
-
-    /* Ideally we should be able to send data out of order so that it arrives in order at the
-     * receiver but to do that we need SACK support (IMO). Once SACK is implemented it should
-     * be reasonably easy to add
-     */
-    NS_ASSERT(dsnHead == SEQ32TO64 (m_tcb->m_nextTxSequence));
-    SequenceNumber32 nextTxSeq = m_tcb->m_nextTxSequence;
-    if (dsnHead <=  SEQ32TO64(nextTxSeq)
-          && (dsnTail) >= nextTxSeq )
+    progress = m_tcb->m_nextTxSequence;
+    progressAhead = m_txSentAhead.GetBytes();
+    FillSchedulerState(m_schedulerState);
+    if (m_schedulerState.pending == 0 || m_schedulerState.subflows.empty())
       {
-        m_tcb-> m_nextTxSequence = dsnTail;
+        break;
       }
-      m_tcb->m_highTxMark = std::max( m_tcb->m_highTxMark.Get(), dsnTail);
-      NS_LOG_LOGIC("m_nextTxSequence=" << m_tcb->m_nextTxSequence << " m_highTxMark=" << m_tcb->m_highTxMark);
+    m_schedulerDecisions.clear();
+    m_scheduler->Schedule(m_schedulerState, m_schedulerDecisions);
+
+    for (MpTcpAssignmentList::const_iterator it = m_schedulerDecisions.begin(); it != m_schedulerDecisions.end(); ++it)
+    {
+      NS_ASSERT_MSG(it->subflowId < GetNActiveSubflows(), "Scheduler chose an unknown subflow");
+      Ptr<MpTcpSubflow> subflow = GetSubflow(it->subflowId);
+      SequenceNumber64 dsnHead = it->dsn;
+
+      // A mapping may span several segments: the whole range is handed to the
+      // subflow at once, which cuts it into segments itself
+      uint32_t length = std::min<uint32_t>(it->length, subflow->GetTxAvailable());
+      if (length == 0)
+        {
+          NS_LOG_DEBUG("Tx buffer of subflow " << subflow << " is full");
+          continue;
+        }
+      // Copies of data already sent are allowed (redundant schedulers) as well as holes
+      NS_ASSERT(dsnHead >= m_txHeadDsn);
+      length = std::min(length, m_txBuffer->SizeFromSequence(SEQ64TO32(dsnHead)));
+      // The subflow only buffers a placeholder, see GetTxData
+      Ptr<Packet> p = Create<Packet>(length);
+      bool ok = subflow->AddLooseMapping(dsnHead, length);
+      NS_ASSERT(ok);
+      SequenceNumber64 dsnTail = dsnHead + length;
+      int ret = subflow->Send(p, 0);
+      // Flush to update cwnd and stuff
+      NS_LOG_DEBUG("Send result=" << ret);
+      m_stats->NotifyScheduled(subflow, dsnHead, length, false);
+
+      /* Data may be sent out of order so that it arrives in order at the receiver,
+       * whose reassembly queue accepts any DSN. Ranges beyond m_nextTxSequence are
+       * remembered and skipped when m_nextTxSequence reaches them.
+       */
+      SequenceNumber64 nextTxSeq = TxDsn(m_tcb->m_nextTxSequence);
+      if (dsnHead <= nextTxSeq && dsnTail >= nextTxSeq)
+        {
+          m_tcb-> m_nextTxSequence = SEQ64TO32(dsnTail);
+          SkipSentAhead();
+        }
+      else if (dsnHead > nextTxSeq)
+        {
+          m_txSentAhead.Add(dsnHead, dsnTail);
+        }
+        m_tcb->m_highTxMark = std::max( m_tcb->m_highTxMark.Get(), SEQ64TO32(dsnTail));
+        NS_LOG_LOGIC("m_nextTxSequence=" << m_tcb->m_nextTxSequence << " m_highTxMark=" << m_tcb->m_highTxMark);
+        nbMappingsDispatched++;
+    }
   }
+  while (m_tcb->m_nextTxSequence != progress || m_txSentAhead.GetBytes() != progressAhead);
 
   uint32_t remainingData = m_txBuffer->SizeFromSequence(m_tcb->m_nextTxSequence );
+  // New data is held back by the connection level window
+  if (m_opportunisticReinjection && remainingData > 0
+      && AvailableWindow() < m_tcb->m_segmentSize)
+    {
+      OpportunisticReinjection();
+    }
   if (m_closeOnEmpty && (remainingData == 0))
     {
       TcpHeader header;
@@ -949,6 +1838,14 @@ MpTcpSocketBase::SendPendingData(bool withAck)
   return nbMappingsDispatched > 0;
 }
 
+void
+MpTcpSocketBase::SkipSentAhead()
+{
+  SequenceNumber64 next = m_txSentAhead.SkipCovered(TxDsn(m_tcb->m_nextTxSequence));
+  m_txSentAhead.DiscardUpTo(next);
+  m_tcb->m_nextTxSequence = SEQ64TO32(next);
+}
+
 void
 MpTcpSocketBase::OnSubflowDupAck(Ptr<MpTcpSubflow> sf)
 {
@@ -958,16 +1855,21 @@ MpTcpSocketBase::OnSubflowDupAck(Ptr<MpTcpSubflow> sf)
 /**
 Retransmit timeout
 
-This function should be very interesting because one may
-adopt different strategies here, like reinjecting on other subflows etc...
-Maybe allow for a callback to be set here.
+The oldest unacknowledged data is reinjected on the fastest subflow available
+instead of rewinding m_nextTxSequence: the subflow which carried it first is
+still in charge of its own retransmissions.
 */
 void
 MpTcpSocketBase::Retransmit()
 {
   NS_LOG_LOGIC(this);
-  m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Start from highest Ack
   m_dupAckCount = 0;
+  SequenceNumber64 highTxMark = TxDsn(m_tcb->m_highTxMark);
+  if (m_txHeadDsn < highTxMark)
+    {
+      uint32_t length = std::min<uint64_t>(highTxMark - m_txHeadDsn, m_tcb->m_segmentSize);
+      ReinjectRange(m_txHeadDsn, length);
+    }
   DoRetransmit(); // Retransmit the packet
 }
 
@@ -990,7 +1892,8 @@ MpTcpSocketBase::DoRetransmit()
     }
 
   // Retransmit non-data packet: Only if in FIN_WAIT_1 or CLOSING state
-  if (m_txBuffer->Size() == 0)
+  // (m_txBuffer may still hold data acked at the data level, see ReleaseTxData)
+  if (TxDsn(m_txBuffer->TailSequence()) <= m_txHeadDsn)
     {
       if (m_state == FIN_WAIT_1 || m_state == CLOSING)
         {
@@ -1000,10 +1903,178 @@ MpTcpSocketBase::DoRetransmit()
         }
       return;
     }
-  // Retransmit a data packet: Call SendDataPacket
-  NS_LOG_LOGIC ("TcpSocketBase " << this << " retxing seq " << m_txBuffer->HeadSequence ());
-  DumpRxBuffers(0);
-  NS_FATAL_ERROR("TODO later, but for the tests only, it should not be necesssary ?! Check for anything suspicious");
+  // Retransmit data: send the reinjection queue
+  NS_LOG_LOGIC ("MpTcpSocketBase " << this << " reinjecting from dsn " << m_txHeadDsn);
+  uint32_t nbMappings = SendReinjectedData();
+  if (nbMappings == 0)
+    {
+      NS_LOG_DEBUG("No subflow window available, reinjection delayed");
+    }
+}
+
+void
+MpTcpSocketBase::ReinjectRange(SequenceNumber64 dsnHead, uint32_t length)
+{
+  NS_LOG_FUNCTION(this << dsnHead << length);
+  SequenceNumber64 dsnTail = dsnHead + length;
+  for (std::list<MpTcpMapping>::const_iterator it = m_reinjectQueue.begin(); it != m_reinjectQueue.end(); it++)
+  {
+    if (it->IsDSNInRange(dsnHead) && it->IsDSNInRange(dsnTail - 1))
+    {
+      NS_LOG_LOGIC("Range already queued");
+      return;
+    }
+  }
+  // mappings lengths are 16 bits
+  while (dsnHead < dsnTail)
+  {
+    MpTcpMapping range;
+    range.SetHeadDSN(dsnHead);
+    range.SetMappingSize(std::min<uint64_t>(dsnTail - dsnHead, 0xffff));
+    m_reinjectQueue.push_back(range);
+    dsnHead += range.GetLength();
+  }
+}
+
+uint32_t
+MpTcpSocketBase::SendReinjectedData()
+{
+  NS_LOG_FUNCTION(this);
+  uint32_t nbMappings = 0;
+
+  while (!m_reinjectQueue.empty())
+  {
+    MpTcpMapping& range = m_reinjectQueue.front();
+    SequenceNumber64 head = std::max(range.HeadDSN(), m_txHeadDsn);
+    SequenceNumber64 tail = range.TailDSN() + 1;
+    if (tail <= head)
+    {
+      NS_LOG_LOGIC("Reinjection " << range << " data acked in the meantime");
+      m_reinjectQueue.pop_front();
+      continue;
+    }
+
+    Ptr<MpTcpSubflow> sf = GetFastestSubflowForDSN(head);
+    if (!sf)
+    {
+      break;
+    }
+    uint32_t length = std::min<uint64_t>(tail - head, sf->AvailableWindow());
+    if (length > sf->GetTxAvailable())
+    {
+      NS_LOG_DEBUG("No room in the Tx buffer of subflow " << sf);
+      break;
+    }
+    length = std::min(length, m_txBuffer->SizeFromSequence(SEQ64TO32(head)));
+    Ptr<Packet> p = Create<Packet>(length);
+    NS_LOG_DEBUG("Reinjecting [" << head << ", +" << length << "] on subflow " << sf);
+    bool ok = sf->AddLooseMapping(head, length);
+    NS_ASSERT(ok);
+    sf->Send(p, 0);
+    m_stats->NotifyScheduled(sf, head, length, true);
+    nbMappings++;
+
+    if (head + length >= tail)
+    {
+      m_reinjectQueue.pop_front();
+    }
+    else
+    {
+      range.SetHeadDSN(head + length);
+      range.SetMappingSize(tail - (head + length));
+    }
+  }
+  return nbMappings;
+}
+
+bool
+MpTcpSocketBase::OpportunisticReinjection()
+{
+  NS_LOG_FUNCTION(this);
+  SequenceNumber64 head = m_txHeadDsn;
+  if (head >= TxDsn(m_tcb->m_highTxMark))
+  {
+    return false;
+  }
+  Ptr<MpTcpSubflow> lagging = GetSubflowHoldingDSN(head);
+  if (!lagging)
+  {
+    // lost or waiting in the peer subflow buffers, nothing we can help with
+    return false;
+  }
+  Ptr<MpTcpSubflow> target = GetFastestSubflowForDSN(head);
+  if (!target)
+  {
+    return false;
+  }
+  if (target->m_rtt->GetEstimate() < lagging->m_rtt->GetEstimate())
+  {
+    PenalizeSubflow(lagging);
+  }
+  MpTcpMapping mapping;
+  lagging->GetUnackedMappingForDSN(head, mapping);
+  NS_LOG_DEBUG("Subflow " << lagging << " blocks the connection with " << mapping);
+  // only the segment blocking the connection, the next ones get their turn
+  // if the window stays blocked
+  ReinjectRange(head, std::min<uint64_t>(mapping.TailDSN() + 1 - head, m_tcb->m_segmentSize));
+  return SendReinjectedData() > 0;
+}
+
+void
+MpTcpSocketBase::PenalizeSubflow(Ptr<MpTcpSubflow> sf)
+{
+  NS_LOG_FUNCTION(this << sf);
+  if (!m_penalization
+      || sf->m_tcb->m_congState != TcpSocketState::CA_OPEN
+      || Simulator::Now() < sf->m_lastPenalization + sf->m_rtt->GetEstimate())
+  {
+    return;
+  }
+  uint32_t priorCwnd = sf->m_tcb->m_cWnd;
+  sf->m_tcb->m_cWnd = std::max(priorCwnd / 2, sf->m_tcb->m_segmentSize);
+  // If in slow start, do not reduce the ssthresh
+  if (priorCwnd >= sf->m_tcb->m_ssThresh)
+  {
+    sf->m_tcb->m_ssThresh = std::max(sf->m_tcb->m_ssThresh.Get() / 2, 2 * sf->m_tcb->m_segmentSize);
+  }
+  sf->m_lastPenalization = Simulator::Now();
+  NS_LOG_DEBUG("Penalized subflow " << sf << ": cwnd " << priorCwnd << " -> " << sf->m_tcb->m_cWnd);
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocketBase::GetSubflowHoldingDSN(SequenceNumber64 dsn) const
+{
+  NS_LOG_FUNCTION(this << dsn);
+  MpTcpMapping mapping;
+  for (SubflowList::const_iterator it = m_subflows[Established].begin(); it != m_subflows[Established].end(); it++)
+  {
+    if ((*it)->GetUnackedMappingForDSN(dsn, mapping))
+    {
+      return *it;
+    }
+  }
+  return 0;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocketBase::GetFastestSubflowForDSN(SequenceNumber64 dsn) const
+{
+  NS_LOG_FUNCTION(this << dsn);
+  Ptr<MpTcpSubflow> fastest = 0;
+  MpTcpMapping mapping;
+  for (SubflowList::const_iterator it = m_subflows[Established].begin(); it != m_subflows[Established].end(); it++)
+  {
+    Ptr<MpTcpSubflow> sf = *it;
+    if (!sf->IsHealthy() || sf->AvailableWindow() == 0 || sf->GetUnackedMappingForDSN(dsn, mapping))
+    {
+      continue;
+    }
+    if (!fastest || sf->m_rtt->GetEstimate() < fastest->m_rtt->GetEstimate())
+    {
+      fastest = sf;
+    }
+  }
+  return fastest;
 }
 
 void
@@ -1014,11 +2085,39 @@ MpTcpSocketBase::SendFin()
   subflow->SendEmptyPacket(TcpHeader::ACK);
 }
 
+/* Subflows handle their own losses, the meta timer only fires when the
+   oldest DSN was not acknowledged at the data level for a whole RTO */
 void
 MpTcpSocketBase::ReTxTimeout()
 {
   NS_LOG_FUNCTION(this);
-  return TcpSocketBase::ReTxTimeout();
+  if (m_state == CLOSED || m_state == TIME_WAIT)
+    {
+      return;
+    }
+  if (m_state == SYN_SENT || TxDsn(m_txBuffer->TailSequence()) <= m_txHeadDsn)
+    {
+      DoRetransmit();
+      return;
+    }
+  if (m_txHeadDsn >= TxDsn(m_tcb->m_highTxMark))
+    {
+      NS_LOG_DEBUG ("Nothing outstanding at the data level");
+      return;
+    }
+  if (m_dataRetrCount == 0)
+    {
+      NS_LOG_INFO ("No more data retries available. Dropping connection");
+      NotifyErrorClose ();
+      return;
+    }
+  --m_dataRetrCount;
+
+  // RFC 6298, clause 2.5, double the timer
+  m_rto = Min (m_rto + m_rto, Time::FromDouble (60,  Time::S));
+  Retransmit();
+  m_retxEvent = Simulator::Schedule (m_rto, &MpTcpSocketBase::ReTxTimeout, this);
+  m_retxIsTimeout = true;
 }
 
 // advertise addresses
@@ -1026,63 +2125,168 @@ void
 MpTcpSocketBase::AdvertiseAddresses()
 {
   NS_LOG_INFO("AdvertiseAvailableAddresses-> ");
-  Ptr<Node> node = TcpSocketBase::GetNode ();
-  Ptr<Packet> p = Create<Packet> ();
-  TcpHeader header;
   SequenceNumber32 s = m_tcb->m_nextTxSequence;
   uint8_t flags = TcpHeader::ACK;
-  uint8_t j = 100;
 
-  if (flags & TcpHeader::FIN)
-    {
-      flags |= TcpHeader::ACK;
-    }
-  else if (m_state == FIN_WAIT_1 || m_state == LAST_ACK || m_state == CLOSING)
+  if (m_state == FIN_WAIT_1 || m_state == LAST_ACK || m_state == CLOSING)
     {
       ++s;
     }
-  AddSocketTags (p);
-  header.SetFlags (flags);
-  header.SetSequenceNumber (s);
-  header.SetAckNumber (m_rxBuffer->NextRxSequence ());
-  header.SetSourcePort(m_endPoint->GetLocalPort ());
-  header.SetDestinationPort(m_endPoint->GetPeerPort ());
-  // Object from L3 to access to routing protocol, Interfaces and NetDevices and so on.
-  Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
-  for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+
+  std::vector<Address> addresses;
+  GetUsableLocalAddresses(addresses);
+
+  // An IPv6 ADD_ADDR takes 22 of the 40 bytes of option space, addresses
+  // that do not fit are sent in further ACKs
+  std::vector<TcpHeader> headers;
+  for (std::vector<Address>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
      {
-       Ptr<Ipv4Interface> interface = ipv4->GetInterface(i);
-       Ipv4InterfaceAddress interfaceAddr = interface->GetAddress(0);
-       if (interfaceAddr.GetLocal() == Ipv4Address::GetLoopback())
-         continue;
-       Address address = InetSocketAddress(interfaceAddr.GetLocal(), m_endPoint->GetLocalPort ());
+       Address address;
+       if (Ipv4Address::IsMatchingType(*it))
+         {
+           address = InetSocketAddress(Ipv4Address::ConvertFrom(*it), GetLocalPort ());
+         }
+       else
+         {
+           address = Inet6SocketAddress(Ipv6Address::ConvertFrom(*it), GetLocalPort ());
+         }
        Ptr<TcpOptionMpTcpAddAddress> addaddr =  CreateObject<TcpOptionMpTcpAddAddress>();
-       uint8_t addrId = j;
-       std::cout<<" advertising "<<interfaceAddr.GetLocal()<<" "<<m_endPoint->GetLocalPort ()<<std::endl;
+       uint8_t addrId = GetLocalAddressId(*it);
+       NS_LOG_INFO("Advertising " << *it << " " << GetLocalPort ());
        addaddr->SetAddress (address, addrId);
+       if (headers.empty() || !headers.back().AppendOption( addaddr ))
+         {
+           TcpHeader header;
+           header.SetFlags (flags);
+           header.SetSequenceNumber (s);
+           header.SetAckNumber (m_rxBuffer->NextRxSequence ());
+           header.SetSourcePort(GetLocalPort ());
+           header.SetDestinationPort(GetPeerPort ());
+           if (!header.AppendOption( addaddr ))
+             {
+               NS_LOG_WARN("ADD_ADDR does not fit in an empty header");
+               continue;
+             }
+           headers.push_back(header);
+         }
        NS_LOG_INFO("Appended option" << addaddr);
-       header.AppendOption( addaddr );
-       j = j + 10 ;
     }
-  m_tcp->SendPacket (p, header, m_endPoint->GetLocalAddress (),
-                         m_endPoint->GetPeerAddress (), m_boundnetdevice);
+  for (std::vector<TcpHeader>::const_iterator it = headers.begin(); it != headers.end(); ++it)
+    {
+      Ptr<Packet> p = Create<Packet> ();
+      AddSocketTags (p);
+      m_tcp->SendPacket (p, *it, GetLocalIp (), GetPeerIp (), m_boundnetdevice);
+    }
 }
 
-// add local addresses to the container
 void
-MpTcpSocketBase::AddLocalAddresses()
+MpTcpSocketBase::GetUsableLocalAddresses(std::vector<Address>& addresses) const
 {
   NS_LOG_FUNCTION(this);
   Ptr<Node> node = TcpSocketBase::GetNode ();
   Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
-  for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+  for (uint32_t i = 0; ipv4 && i < ipv4->GetNInterfaces(); i++)
     {
       Ptr<Ipv4Interface> interface = ipv4->GetInterface(i);
+      if (interface->GetNAddresses() == 0)
+        continue;
       Ipv4InterfaceAddress interfaceAddr = interface->GetAddress(0);
       if (interfaceAddr.GetLocal() == Ipv4Address::GetLoopback())
         continue;
-      NS_LOG_INFO(" Adding local addresses "<<interfaceAddr.GetLocal()<<" "<<m_endPoint->GetLocalPort ());
-      LocalAddressInfo.push_back(std::make_pair(interfaceAddr.GetLocal(), m_endPoint->GetLocalPort ()));
+      addresses.push_back(interfaceAddr.GetLocal());
+    }
+  Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol>();
+  for (uint32_t i = 0; ipv6 && i < ipv6->GetNInterfaces(); i++)
+    {
+      Ptr<Ipv6Interface> interface = ipv6->GetInterface(i);
+      for (uint32_t k = 0; k < interface->GetNAddresses(); k++)
+        {
+          // link-local addresses cannot be reached from another link
+          Ipv6InterfaceAddress interfaceAddr = interface->GetAddress(k);
+          if (interfaceAddr.GetScope() != Ipv6InterfaceAddress::GLOBAL)
+            continue;
+          addresses.push_back(interfaceAddr.GetAddress());
+        }
+    }
+}
+
+// add local addresses to the container
+void
+MpTcpSocketBase::AddLocalAddresses()
+{
+  NS_LOG_FUNCTION(this);
+  std::vector<Address> addresses;
+  GetUsableLocalAddresses(addresses);
+  LocalAddressInfo.clear();
+  for (std::vector<Address>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+    {
+      NS_LOG_INFO(" Adding local addresses "<< *it <<" "<<GetLocalPort ());
+      LocalAddressInfo.push_back(std::make_pair(*it, GetLocalPort ()));
+    }
+}
+
+void
+MpTcpSocketBase::AddRemoteAddress(const Address& address, uint16_t port, uint8_t id)
+{
+  NS_LOG_FUNCTION(this << address << port << (int)id);
+  NS_ASSERT(Ipv4Address::IsMatchingType(address) || Ipv6Address::IsMatchingType(address));
+  m_remoteAddressIds[id] = address;
+  for (std::vector<AddressInfo>::const_iterator it = RemoteAddressInfo.begin(); it != RemoteAddressInfo.end(); ++it)
+    {
+      if (it->first == address && it->second == port)
+        {
+          NS_LOG_LOGIC("Address already known");
+          return;
+        }
+    }
+  RemoteAddressInfo.push_back(std::make_pair(address, port));
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnRemoteAddressAdded(this, address, port, id);
+    }
+}
+
+bool
+MpTcpSocketBase::GetRemoteAddress(uint8_t id, Address& address) const
+{
+  std::map<uint8_t, Address>::const_iterator it = m_remoteAddressIds.find(id);
+  if (it == m_remoteAddressIds.end())
+    {
+      return false;
+    }
+  address = it->second;
+  return true;
+}
+
+void
+MpTcpSocketBase::RemoveRemoteAddress(uint8_t id)
+{
+  NS_LOG_FUNCTION(this << (int)id);
+  Address address;
+  if (!GetRemoteAddress(id, address))
+    {
+      NS_LOG_WARN("REMOVE_ADDR for unknown id " << (int)id);
+      return;
+    }
+  m_remoteAddressIds.erase(id);
+  for (std::vector<AddressInfo>::iterator it = RemoteAddressInfo.begin(); it != RemoteAddressInfo.end(); )
+    {
+      if (it->first == address)
+        {
+          it = RemoteAddressInfo.erase(it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnRemoteAddressRemoved(this, address);
+    }
+  if (!m_onAddrDeletion.IsNull())
+    {
+      m_onAddrDeletion(id);
     }
 }
 
@@ -1147,6 +2351,7 @@ MpTcpSocketBase::OnSubflowEstablished(Ptr<MpTcpSubflow> subflow)
   {
     NS_LOG_LOGIC("Master subflow created, copying its endpoint");
     m_endPoint = subflow->m_endPoint;
+    m_endPoint6 = subflow->m_endPoint6;
     SetTcp(subflow->m_tcp);
     SetNode(subflow->GetNode());
 
@@ -1159,10 +2364,22 @@ MpTcpSocketBase::OnSubflowEstablished(Ptr<MpTcpSubflow> subflow)
     {
       NS_FATAL_ERROR("Unhandled case where subflow got established while meta in " << TcpStateName[m_state] );
     }
-    InetSocketAddress addr(subflow->m_endPoint->GetPeerAddress(), subflow->m_endPoint->GetPeerPort());
+    Address addr;
+    if (subflow->m_endPoint)
+      {
+        addr = InetSocketAddress(subflow->m_endPoint->GetPeerAddress(), subflow->m_endPoint->GetPeerPort());
+      }
+    else
+      {
+        addr = Inet6SocketAddress(subflow->m_endPoint6->GetPeerAddress(), subflow->m_endPoint6->GetPeerPort());
+      }
     NotifyNewConnectionCreated(this, addr);
   }
   ComputeTotalCWND();
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowEstablished(this, subflow);
+    }
 }
 
 void
@@ -1187,6 +2404,10 @@ MpTcpSocketBase::OnSubflowEstablishment(Ptr<MpTcpSubflow> subflow)
 
     Simulator::ScheduleNow(&MpTcpSocketBase::ConnectionSucceeded, this);
   }
+  if (m_pathManagerImpl)
+    {
+      m_pathManagerImpl->OnSubflowEstablished(this, subflow);
+    }
 }
 
 void
@@ -1256,12 +2477,21 @@ MpTcpSocketBase::OnSubflowRetransmit(Ptr<MpTcpSubflow> sf)
   NS_LOG_INFO("Subflow retransmit. Nothing done by meta");
 }
 
-// if bytes may not really be in flight but rather in subflows buffer
+// Bytes may not really be in flight but rather in subflows buffer
 uint32_t
 MpTcpSocketBase::BytesInFlight() const
 {
   NS_LOG_FUNCTION(this);
-  return TcpSocketBase::BytesInFlight();
+  // m_txBuffer never marks data as sent, subflows transmit it
+  return UnAckDataCount();
+}
+
+uint32_t
+MpTcpSocketBase::UnAckDataCount() const
+{
+  NS_LOG_FUNCTION(this);
+  // the head of m_txBuffer may be held back by the subflows, see ReleaseTxData
+  return static_cast<uint32_t>(TxDsn(m_tcb->m_highTxMark) - m_txHeadDsn);
 }
 
 /* This function is added to access m_nextTxSequence in
@@ -1278,6 +2508,29 @@ MpTcpSocketBase::AdvertisedWindowSize(bool scale) const
   return TcpSocketBase::AdvertisedWindowSize();
 }
 
+uint32_t
+MpTcpSocketBase::GetRxWindow() const
+{
+  NS_LOG_FUNCTION (this);
+  // Same as TcpSocketBase::AdvertisedWindowSize
+  if (m_rxBuffer->GotFin ())
+    {
+      return m_advWnd;
+    }
+  return static_cast<uint32_t>(m_rxBuffer->MaxRxSequence () - m_rxBuffer->NextRxSequence ());
+}
+
+Time
+MpTcpSocketBase::GetRcvBufAutoTuningRtt() const
+{
+  Time rtt;
+  for (SubflowList::const_iterator it = m_subflows[Established].begin(); it != m_subflows[Established].end(); ++it)
+    {
+      rtt = Max(rtt, (*it)->GetRcvRtt());
+    }
+  return rtt;
+}
+
 uint32_t
 MpTcpSocketBase::Window() const
 {
@@ -1333,32 +2586,41 @@ MpTcpSocketBase::CloseAllSubflows()
 
 void
 MpTcpSocketBase::ReceivedAck(
-  SequenceNumber32 dack
+  SequenceNumber64 dack
   , Ptr<MpTcpSubflow> sf
   , bool count_dupacks
   )
 {
   NS_LOG_FUNCTION("Received DACK " << dack << "from subflow" << sf << "(Enable dupacks:" << count_dupacks << " )");
 
-  if (dack < m_txBuffer->HeadSequence ())
+  if (dack < m_txHeadDsn)
     { // Case 1: Old ACK, ignored.
       NS_LOG_LOGIC ("Old ack Ignored " << dack  );
     }
-  else if (dack  == m_txBuffer->HeadSequence ())
+  else if (dack  == m_txHeadDsn)
     { // Case 2: Potentially a duplicated ACK
-      if (dack  < m_tcb->m_nextTxSequence && count_dupacks)
+      if (dack  < TxDsn(m_tcb->m_nextTxSequence) && count_dupacks)
         {
         /* dupackcount shall only be increased if there is only a DSS option ! */
         }
       // otherwise, the ACK is precisely equal to the nextTxSequence
-      NS_ASSERT( dack  <= m_tcb->m_nextTxSequence);
+      NS_ASSERT( dack  <= TxDsn(m_tcb->m_nextTxSequence));
     }
-  else if (dack  > m_txBuffer->HeadSequence ())
+  else
     { // Case 3: New ACK, reset m_dupAckCount and update m_txBuffer
       NS_LOG_LOGIC ("New DataAck [" << dack  << "]");
-      m_txBuffer->DiscardUpTo( dack );
+      m_txHeadDsn = dack;
+      for (int i = 0; i < Maximum; i++)
+        {
+          for (SubflowList::const_iterator it = m_subflows[i].begin(); it != m_subflows[i].end(); ++it)
+            {
+              Ptr<MpTcpSubflow> sf = *it;
+              sf->m_TxMappings.DiscardMappingsUpTo(dack, sf->m_txBuffer->HeadSequence());
+            }
+        }
+      ReleaseTxData();
       bool resetRTO = true;
-      NewAck( dack, resetRTO );
+      NewAck( SEQ64TO32(dack), resetRTO );
       m_dupAckCount = 0;
     }
 }
@@ -1522,7 +2784,20 @@ Ptr<Packet>
 MpTcpSocketBase::Recv(uint32_t maxSize, uint32_t flags)
 {
   NS_LOG_FUNCTION(this);
-  return TcpSocketBase::Recv(maxSize,flags);
+  Ptr<Packet> p = TcpSocketBase::Recv(maxSize,flags);
+  // Reading made room: subflows may hold data they could not hand over so far
+  if (PullSubflowData() > 0 && !p)
+    {
+      p = TcpSocketBase::Recv(maxSize,flags);
+    }
+  m_stats->NotifyRxBuffer(m_rxBuffer->Size() + m_rxReassembly.Size(), !m_rxReassembly.IsEmpty());
+  return p;
+}
+
+Ptr<MpTcpStats>
+MpTcpSocketBase::GetStats() const
+{
+  return m_stats;
 }
 
 uint32_t
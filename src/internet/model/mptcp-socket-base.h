@@ -23,8 +23,11 @@
 #ifndef MPTCP_SOCKET_BASE_H
 #define MPTCP_SOCKET_BASE_H
 
+#include <list>
+#include <map>
 #include "ns3/callback.h"
 #include "ns3/mptcp-mapping.h"
+#include "ns3/mptcp-reassembly-queue.h"
 #include "ns3/tcp-socket.h"
 #include "ns3/tcp-socket-base.h"
 #include "ns3/inet-socket-address.h"
@@ -34,12 +37,18 @@
 
 namespace ns3 {
 
+class Ipv4;
+class Ipv6;
+class Ipv4L3Protocol;
+class Ipv6L3Protocol;
 class Ipv4EndPoint;
 class Ipv6EndPoint;
 class Node;
 class Packet;
 class TcpL4Protocol;
 class MpTcpSubflow;
+class MpTcpStats;
+class MpTcpPathManager;
 class TcpOptionMpTcpDSS;
 class TcpOptionMpTcpJoin;
 class OutputStreamWrapper;
@@ -127,6 +136,23 @@ protected:
 public:
 
   virtual void SetPathManager(PathManagerMode); 
+
+  /**
+   * \brief Replaces the path manager selected by PathManagerMode
+   * \param pathManager will be notified of the connection events once fully established
+   */
+  void SetPathManager(Ptr<MpTcpPathManager> pathManager);
+
+  /**
+   * \return The path manager of the connection, 0 until it is fully established
+   */
+  Ptr<MpTcpPathManager> GetPathManager() const;
+
+  /**
+   * \return True if the backup subflows are currently used as regular ones
+   */
+  bool BackupsPromoted() const;
+
   /**
    * Create a subflow for ndiffports path manager
    * Initiate a single new subflow between given IP addresses
@@ -169,11 +195,39 @@ public:
   void NotifySubflowConnected(Ptr<MpTcpSubflow> sf);
 
   /**
-   * Called when a subflow TCP state is updated.
-   * It detects such events by tracing its subflow m_state.
+   * Called when a subflow congestion window is updated.
+   * It detects such events by tracing its subflow m_cWnd and refreshes
+   * the aggregates used by the coupled congestion controls.
    *
+   * \param context
+   * \param sf Subflow whose window changed
+   * \param oldCwnd previous congestion window
+   * \param newCwnd new congestion window
+   */
+  virtual void OnSubflowNewCwnd(std::string context, Ptr<MpTcpSubflow> sf, uint32_t oldCwnd, uint32_t newCwnd);
+
+  /**
+   * \name Coupled congestion control aggregates
+   * Cached over all the subflows of the connection and refreshed on every
+   * subflow window change, see MpTcpCongestionOps.
+   * Rates are expressed in bytes per second.
+   * \{
    */
-  virtual void  OnSubflowNewCwnd(std::string context, uint32_t oldCwnd, uint32_t newCwnd);
+  uint64_t GetCoupledTotalCwnd() const;                 //!< sum_i cwnd_i
+  double GetCoupledSumRate() const;                     //!< sum_i cwnd_i / rtt_i
+  double GetCoupledMaxRate() const;                     //!< max_i cwnd_i / rtt_i
+  double GetCoupledMaxCwndOverRtt2() const;             //!< max_i cwnd_i / rtt_i^2
+  uint32_t GetCoupledNSubflows() const;                 //!< number of coupled subflows
+  Ptr<MpTcpSubflow> GetCoupledMaxCwndSubflow() const;   //!< argmax_i cwnd_i
+  Ptr<MpTcpSubflow> GetCoupledBestSubflow() const;      //!< argmax_i l_i^2 / rtt_i (OLIA)
+
+  /**
+   * \brief Updates the number of bytes acked between losses of a subflow (l_i in OLIA)
+   * \param sf subflow
+   * \param bytes length of the inter-loss interval
+   */
+  void UpdateCoupledLossInterval(Ptr<MpTcpSubflow> sf, uint64_t bytes);
+  /** \} */
 
   /**
    * Initiates a new subflow with MP_JOIN
@@ -203,6 +257,7 @@ public:
 
   // Window Management
   virtual uint32_t BytesInFlight (void) const;  // Return total bytes in flight of a subflow
+  virtual uint32_t UnAckDataCount (void) const; // Counted from the last DATA_ACK
 
   /* 
    * This function is added to access m_nextTxSequence in 
@@ -219,6 +274,11 @@ public:
    */
   virtual uint32_t ComputeTotalCWND();
   virtual uint16_t AdvertisedWindowSize (bool scale = true) const;
+
+  /**
+   * \return Connection level receive window, before scaling, advertised by every subflow
+   */
+  uint32_t GetRxWindow() const;
   virtual uint32_t AvailableWindow (void) const;
   virtual void CloseAndNotify(void);
 
@@ -231,11 +291,18 @@ public:
    * \param finalDsn
    * OnDataFin
    */
-  virtual void PeerClose( SequenceNumber32 fin_seq, Ptr<MpTcpSubflow> sf); 
+  virtual void PeerClose( SequenceNumber64 fin_seq, Ptr<MpTcpSubflow> sf);
 
   /* equivalent to TCP Rst */
   virtual void SendFastClose(Ptr<MpTcpSubflow> sf);
 
+  /**
+   * \brief The peer closed the connection with an MP_FASTCLOSE
+   * \param sf Subflow on which the option was received
+   * \param replyRst The option came on an ACK (\RFC{6824}), hence sf has to be reset too
+   */
+  virtual void PeerFastClose(Ptr<MpTcpSubflow> sf, bool replyRst);
+
   /**
    * \return return true if connected
    */
@@ -284,6 +351,35 @@ public:
    * \return an established subflow
    */
   virtual Ptr<MpTcpSubflow> GetSubflow(uint8_t) const;
+
+  /**
+   * \return Connection level statistics
+   */
+  Ptr<MpTcpStats> GetStats() const;
+
+  /**
+   * \return Out of order data received on the subflows
+   */
+  const MpTcpReassemblyQueue& GetReassemblyQueue() const;
+
+  /**
+   * \brief DSN of a position of the Tx buffer
+   *
+   * The meta buffers are shared with TCP and work modulo 2^32, the 64 bits
+   * DSN is recovered from the DSN of the buffer head.
+   *
+   * \param seq position in m_txBuffer, e.g. m_nextTxSequence
+   * \return the 64 bits DSN
+   */
+  SequenceNumber64 TxDsn(const SequenceNumber32& seq) const;
+
+  /**
+   * \brief DSN of a position of the Rx buffer, or of a DSN received on 4 bytes
+   * \param seq lower 32 bits of the DSN
+   * \return the 64 bits DSN closest to the next expected DSN
+   */
+  SequenceNumber64 RxDsn(const SequenceNumber32& seq) const;
+
   virtual void ClosingOnEmpty(TcpHeader& header);
 
   /**
@@ -333,8 +429,8 @@ public:
   uint32_t GetPeerToken() const;
 
   /**
-  * \brief For now it looks there is no way to know that an ip interface went up so we will assume until
-  * \brief further notice that IPs of the client don't change.
+  * \brief Local interfaces going up or down are reported to the path manager,
+  * \brief these callbacks only concern the addresses of the peer.
   * \param -1st callback called on receiving an ADD_ADDR
   * -param 2nd callback called on receiving REM_ADDR
   */
@@ -363,15 +459,60 @@ public:
 protected:
   friend class Tcp;
   friend class MpTcpSubflow;
+  friend class MpTcpPathManager;
   /**
    * \brief Expects InetXSocketAddress
    */
   virtual bool NotifyJoinRequest (const Address &from, const Address & toAddress);
   /**
-   * \brief Expects Ipv4 (6 not supported yet)
+   * \brief Expects an Ipv4Address or an Ipv6Address
    */
   bool OwnIP(const Address& address) const;
 
+  /**
+   * \return Local address of the master subflow, as an Ipv4Address or an Ipv6Address
+   */
+  Address GetLocalIp() const;
+
+  /**
+   * \return Remote address of the master subflow, as an Ipv4Address or an Ipv6Address
+   */
+  Address GetPeerIp() const;
+
+  /**
+   * \return Local port of the master subflow
+   */
+  uint16_t GetLocalPort() const;
+
+  /**
+   * \return Remote port of the master subflow
+   */
+  uint16_t GetPeerPort() const;
+
+  /**
+   * \brief Addresses usable by new subflows
+   *
+   * The first IPv4 address of each interface and the global IPv6 addresses,
+   * loopback and link-local addresses excluded.
+   *
+   * \param addresses Filled with Ipv4Address and Ipv6Address
+   */
+  void GetUsableLocalAddresses(std::vector<Address>& addresses) const;
+
+  /**
+   * \brief Allocates the endpoint of a subflow initiated by this host and sends its SYN
+   *
+   * Both addresses must be of the same family.
+   *
+   * \param localAddress Ipv4Address or Ipv6Address to bind to
+   * \param localPort local port
+   * \param remoteAddress Ipv4Address or Ipv6Address to connect to
+   * \param remotePort remote port
+   * \return false if no endpoint could be allocated
+   */
+  bool InitiateSubflow(const Address& localAddress, uint16_t localPort,
+                       const Address& remoteAddress, uint16_t remotePort);
+
   /**
    * Should be called after having sent a dataFIN
    * Should send a RST on all subflows in state Other
@@ -395,11 +536,29 @@ protected:
    */
   virtual void OnSubflowRecv (Ptr<MpTcpSubflow> sf);
 
+  /**
+   * \brief Moves the data received by a subflow to the reassembly queue, then
+   * what is in order to the receive buffer
+   * \return Number of bytes extracted from the subflow
+   */
+  uint32_t ExtractSubflowData(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Extracts the data the subflows still hold, e.g. after the application read
+   * \return Number of bytes extracted
+   */
+  uint32_t PullSubflowData();
+
   /*
    * \brief close all subflows
    */
   virtual void TimeWait (void);
 
+  /**
+   * \brief Moves to CLOSED without any exchange, once the subflows are reset
+   */
+  void Abort (void);
+
   /**
    * \brief Called when a subflow that initiated the connection
    * \brief gets established
@@ -420,6 +579,108 @@ protected:
   void NotifyRemoteAddAddr(Address address);
   void NotifyRemoteRemAddr(uint8_t addrId);
 
+  /**
+   * \name Path management
+   * Events forwarded to the path manager
+   * \{
+   */
+
+  /**
+   * \brief Gets the path manager matching m_pathManager
+   *
+   * Path managers are stateless: the connections of a node share one instance
+   * per mode (see TcpL4Protocol::GetMpTcpPathManager).
+   */
+  virtual Ptr<MpTcpPathManager> CreatePathManager() const;
+
+  /**
+   * \brief Called by a subflow when its retransmission timer expired
+   */
+  virtual void OnSubflowTimeout(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Called by a suspected or failed subflow when it gets new acknowledgments
+   */
+  virtual void OnSubflowRecovered(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Called when a subflow received an ICMP destination unreachable
+   */
+  virtual void OnSubflowUnreachable(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Connected to the "InterfaceUp"/"InterfaceDown" trace sources of the node
+   * \param ipv4 L3 protocol of the node
+   * \param interface index of the interface
+   */
+  void OnInterfaceUp(Ptr<Ipv4> ipv4, uint32_t interface);
+  void OnInterfaceDown(Ptr<Ipv4> ipv4, uint32_t interface);
+  void OnInterfaceUp6(Ptr<Ipv6> ipv6, uint32_t interface);
+  void OnInterfaceDown6(Ptr<Ipv6> ipv6, uint32_t interface);
+
+  /**
+   * \brief Connects the interface trace sources of the node to the path manager
+   */
+  void ConnectInterfaceTraces();
+
+  /**
+   * \brief Queues for reinjection the data a subflow holds and that was not
+   * acknowledged at the data level yet
+   * \param sf subflow whose path failed
+   */
+  virtual void ReinjectSubflowData(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Data delivered at the connection level is measured over the RTT of
+   * the slowest subflow, so that the buffer covers the sum of the
+   * bandwidth-delay products of the subflows (RFC 6824 section 3.3.5)
+   */
+  virtual Time GetRcvBufAutoTuningRtt() const;
+
+  /**
+   * \brief Reads the data a subflow is about to transmit
+   *
+   * Subflows do not keep a copy of the data they are handed, only placeholders of
+   * the same size, and read the bytes from m_txBuffer when they (re)transmit them.
+   * \param dsn DSN of the first byte
+   * \param length number of bytes
+   * \return the data, sharing the payload of m_txBuffer
+   */
+  Ptr<Packet> GetTxData(const SequenceNumber64& dsn, uint32_t length) const;
+
+  /**
+   * \brief Frees the head of m_txBuffer
+   *
+   * Data is kept as long as it is not acknowledged both at the connection level
+   * and by every subflow it was mapped on, since a subflow may still retransmit it.
+   */
+  void ReleaseTxData();
+
+  /**
+   * \return True if a subflow (in any state) links these two addresses
+   */
+  bool HasSubflow(const Address& localAddress, const Address& remoteAddress) const;
+
+  /**
+   * \return The id advertised with a local address, allocated on first use.
+   * Id 0 is left to the address of the initial subflow.
+   */
+  uint8_t GetLocalAddressId(const Address& address);
+
+  /**
+   * \brief Called when the peer sent a REMOVE_ADDR
+   * \param id address id the peer advertised in ADD_ADDR
+   */
+  void RemoveRemoteAddress(uint8_t id);
+
+  /**
+   * \param id address id advertised by the peer
+   * \param address Set to the matching address
+   * \return False if the id is unknown
+   */
+  bool GetRemoteAddress(uint8_t id, Address& address) const;
+  /** \} */
+
   /**
    * /brief note Setting a remote key has the sideeffect of enabling MPTCP on the socket
    */
@@ -442,15 +703,73 @@ protected:
    * \return true if it send mappings
    */
   virtual uint32_t SendPendingData(bool withAck = false);
+
+  /**
+   * \brief Moves m_nextTxSequence past the range sent ahead it may have reached
+   */
+  void SkipSentAhead();
+
   virtual void ReTxTimeout (void);
   virtual void Retransmit();
   // MPTCP specfic version
   virtual void ReceivedAck (
-    SequenceNumber32 dack
+    SequenceNumber64 dack
   , Ptr<MpTcpSubflow> sf
   , bool count_dupacks
   );
 
+  /**
+   * \name Reinjection
+   * Data already sent on a subflow can be sent again on another one, either
+   * because the meta retransmission timer expired or because a slow subflow
+   * holds the oldest unacknowledged DSN while the peer receive window is
+   * exhausted (as mptcp_rcv_buf_optimization in the linux kernel).
+   * Reinjected data is sent before new data.
+   * \{
+   */
+
+  /**
+   * \brief Queues a DSN range to be sent again
+   * \param dsnHead first byte of the range
+   * \param length size of the range
+   */
+  virtual void ReinjectRange(SequenceNumber64 dsnHead, uint32_t length);
+
+  /**
+   * \brief Sends as much of the reinjection queue as the subflows windows allow
+   * \return Number of mappings sent
+   */
+  virtual uint32_t SendReinjectedData();
+
+  /**
+   * \brief Reinjects the oldest unacknowledged data on a faster subflow when
+   * the connection is blocked by the peer receive window.
+   * The lagging subflow gets penalized.
+   * \return true if some data was reinjected
+   */
+  virtual bool OpportunisticReinjection();
+
+  /**
+   * \brief Halves the window of a subflow holding back the connection,
+   * at most once per RTT of that subflow
+   * \param sf the lagging subflow
+   */
+  virtual void PenalizeSubflow(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \param dsn
+   * \return The established subflow responsible for the delivery of dsn, 0 if none
+   */
+  Ptr<MpTcpSubflow> GetSubflowHoldingDSN(SequenceNumber64 dsn) const;
+
+  /**
+   * \param dsn data to send
+   * \return Established subflow with the lowest RTT that has some window
+   * available and does not carry dsn yet, 0 if none
+   */
+  Ptr<MpTcpSubflow> GetFastestSubflowForDSN(SequenceNumber64 dsn) const;
+  /** \} */
+
   /**
    * \brief Part of the logic was implemented but this is non-working.
    * \return Always false
@@ -468,13 +787,20 @@ protected:
   virtual void NewAck(SequenceNumber32 const& dataLevelSeq, bool resetRTO);
 
   virtual void OnTimeWaitTimeOut();
-  std::vector< std::pair<const Ipv4Address, uint16_t > > RemoteAddressInfo;  //!< Ipv4/v6 address and its port
-  std::vector< std::pair<const Ipv4Address, uint16_t > > LocalAddressInfo;  //!< Ipv4/v6 address and its port
+  /**
+   * \brief Adds an address advertised by the peer, unless already known
+   * \param address Ipv4Address or Ipv6Address
+   * \param port advertised port
+   * \param id address id chosen by the peer
+   */
+  void AddRemoteAddress(const Address& address, uint16_t port, uint8_t id);
+
+  typedef std::pair<Address, uint16_t> AddressInfo; //!< Ipv4Address or Ipv6Address and its port
+  std::vector<AddressInfo> RemoteAddressInfo;  //!< Ipv4/v6 address and its port
+  std::vector<AddressInfo> LocalAddressInfo;  //!< Ipv4/v6 address and its port
 
 protected:
   friend class TcpL4Protocol;
-  friend class MpTcpSchedulerRoundRobin;
-  friend class MpTcpSchedulerFastestRTT;
   friend class MpTcpNdiffPorts;
   /**
    * \brief called by TcpL4protocol when receiving an MP_JOIN taht does not fit
@@ -489,6 +815,31 @@ protected:
     Ptr<const TcpOptionMpTcpJoin> join
     );
 
+  /**
+   * \brief IPv6 counterpart of NewSubflowRequest
+   */
+  virtual Ipv6EndPoint*
+  NewSubflowRequest6(
+    Ptr<Packet> p,
+    const TcpHeader & header,
+    const Address & fromAddress,
+    const Address & toAddress,
+    Ptr<const TcpOptionMpTcpJoin> join
+    );
+
+  /**
+   * \brief Checks an MP_JOIN request and forks the subflow accepting it
+   * \return the new subflow or 0 if the request was refused
+   */
+  Ptr<MpTcpSubflow>
+  AcceptSubflowRequest(
+    Ptr<Packet> p,
+    const TcpHeader & header,
+    const Address & fromAddress,
+    const Address & toAddress,
+    Ptr<const TcpOptionMpTcpJoin> join
+    );
+
   /**
    * \brief should accept a stream
    */
@@ -498,14 +849,57 @@ protected:
   Callback<bool, Ptr<Socket>, Address, uint8_t > m_onRemoteAddAddr;  //!< return true to create a subflow
   Callback<void, uint8_t > m_onAddrDeletion;    // return true to create a subflow
 protected:
+  /**
+   * \brief Takes a scheduler, recycled from a closed connection of the node if possible
+   */
   virtual void CreateScheduler(TypeId schedulerTypeId);
 
+  /**
+   * \brief Takes the snapshot of the connection given to the scheduler
+   * \param state filled with the current state of the meta and of the established subflows
+   */
+  virtual void FillSchedulerState(MpTcpSchedulerState& state) const;
+
+  /**
+   * \brief Creates the congestion control of a subflow.
+   * Coupled algorithms (inheriting MpTcpCongestionOps) get linked to this meta
+   * while others run uncoupled on a fork of the meta algorithm.
+   */
+  virtual Ptr<TcpCongestionOps> CreateSubflowCongestionControl(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Refreshes the cached values of a subflow and the aggregates in O(1),
+   * except when the subflow holding one of the maxima decreases.
+   */
+  void UpdateCoupledAggregates(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Removes the contribution of a closed subflow
+   */
+  void RemoveCoupledAggregates(Ptr<MpTcpSubflow> sf);
+
+  /**
+   * \brief Recomputes the maxima by iterating over the coupled subflows
+   */
+  void RecomputeCoupledMaxima();
+
   /**
    * \brief the scheduler is so closely
    */
   Ptr<MpTcpScheduler> m_scheduler;  //!<
+  MpTcpSchedulerState m_schedulerState;      //!< Reused snapshot, avoids allocations
+  MpTcpAssignmentList m_schedulerDecisions;  //!< Reused list of decisions
+  Ptr<MpTcpStats> m_stats;                   //!< Connection level statistics
+  MpTcpReassemblyQueue m_rxReassembly;       //!< Data received beyond the next expected DSN
+  MpTcpRangeSet m_txSentAhead;               //!< Ranges sent beyond m_nextTxSequence
   uint32_t m_peerToken;
   PathManagerMode m_pathManager {FullMesh};
+  Ptr<MpTcpPathManager> m_pathManagerImpl;   //!< Reacts to the connection events
+  bool m_backupsPromoted {false};            //!< True if the backup subflows are in use
+  Ptr<Ipv4L3Protocol> m_interfaceTraces;     //!< Set once connected to its interface traces
+  Ptr<Ipv6L3Protocol> m_interfaceTraces6;    //!< Set once connected to its interface traces
+  std::map<uint8_t, Address> m_remoteAddressIds;  //!< Addresses advertised by the peer
+  std::map<Address, uint8_t> m_localAddressIds;   //!< Ids of the advertised local addresses
 
 private:
   uint64_t m_peerKey; //!< Store remote host token
@@ -533,6 +927,28 @@ private:
   //!
   TypeId m_subflowTypeId;
   TypeId m_schedulerTypeId;
+  TypeId m_congestionTypeId;    //!< Congestion control of the subflows
+
+  bool m_opportunisticReinjection;  //!< Reinject data blocking the peer receive window
+  bool m_penalization;              //!< Halve the window of the subflows blocking the connection
+  bool m_dss64Bits;                 //!< Send the DSN and DATA_ACK on 8 bytes
+  bool m_subflowPacing;             //!< Pace each subflow at a rate derived from its cwnd and srtt
+  bool m_superSegments;             //!< Paced subflows send a burst of segments per pacing quantum
+  SequenceNumber64 m_txHeadDsn;     //!< Last DATA_ACK, m_txBuffer may start earlier (see ReleaseTxData)
+  std::list<MpTcpMapping> m_reinjectQueue;  //!< DSN ranges waiting to be reinjected (SSN unused)
+
+  // Coupled congestion control aggregates
+  uint32_t m_ccNSubflows;       //!< Number of subflows accounted in the aggregates
+  uint64_t m_ccTotalCwnd;       //!< Sum of the subflow windows
+  double   m_ccSumRate;         //!< Sum of cwnd/rtt
+  double   m_ccMaxRate;         //!< Max of cwnd/rtt
+  double   m_ccMaxCwndRtt2;     //!< Max of cwnd/rtt^2
+  uint32_t m_ccMaxCwnd;         //!< Max of cwnd
+  double   m_ccMaxQuality;      //!< Max of l^2/rtt
+  Ptr<MpTcpSubflow> m_ccMaxRateSubflow;     //!< argmax of cwnd/rtt
+  Ptr<MpTcpSubflow> m_ccMaxCwndRtt2Subflow; //!< argmax of cwnd/rtt^2
+  Ptr<MpTcpSubflow> m_ccMaxCwndSubflow;     //!< argmax of cwnd
+  Ptr<MpTcpSubflow> m_ccBestSubflow;        //!< argmax of l^2/rtt
 };
 
 }   //namespace ns3
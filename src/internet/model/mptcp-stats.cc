@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author:  Matthieu Coudron <matthieu.coudron@lip6.fr>
+ *          Morteza Kheirkhah <m.kheirkhah@sussex.ac.uk>
+ */
+#include "ns3/mptcp-stats.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpStats");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpStats);
+
+TypeId
+MpTcpStats::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpStats")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpStats> ()
+    .AddTraceSource ("ScheduledBytes",
+                     "Bytes handed to the subflows",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_scheduledBytes),
+                     "ns3::MpTcpStats::Uint64TracedValueCallback")
+    .AddTraceSource ("Reinjections",
+                     "Number of reinjections",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_reinjections),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("ReinjectedBytes",
+                     "Bytes sent again on another subflow",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_reinjectedBytes),
+                     "ns3::MpTcpStats::Uint64TracedValueCallback")
+    .AddTraceSource ("OutOfOrderArrivals",
+                     "Number of ranges received beyond the next expected DSN",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_outOfOrderArrivals),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("DuplicateBytes",
+                     "Bytes received more than once",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_duplicateBytes),
+                     "ns3::MpTcpStats::Uint64TracedValueCallback")
+    .AddTraceSource ("RxBufferOccupancy",
+                     "Bytes in the meta receive buffer",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_rxBufferOccupancy),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("HolBlockingTime",
+                     "Time spent with out-of-order data waiting for a missing DSN, "
+                     "updated at the end of each blocking period",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_holBlockingTime),
+                     "ns3::TracedValueCallback::Time")
+    .AddTraceSource ("Scheduled",
+                     "A DSN range was handed to a subflow",
+                     MakeTraceSourceAccessor (&MpTcpStats::m_scheduledTrace),
+                     "ns3::MpTcpStats::ScheduledTracedCallback")
+  ;
+  return tid;
+}
+
+MpTcpStats::MpTcpStats ()
+  : m_scheduledBytes (0),
+    m_reinjections (0),
+    m_reinjectedBytes (0),
+    m_outOfOrderArrivals (0),
+    m_duplicateBytes (0),
+    m_rxBufferOccupancy (0),
+    m_holBlockingTime (Time (0)),
+    m_blocked (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpStats::~MpTcpStats ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpTcpStats::NotifyScheduled (Ptr<MpTcpSubflow> subflow, SequenceNumber64 dsn, uint32_t length, bool reinjection)
+{
+  NS_LOG_FUNCTION (this << subflow << dsn << length << reinjection);
+  uint32_t i = 0;
+  while (i < m_subflows.size () && m_subflows[i] != PeekPointer (subflow))
+    {
+      i++;
+    }
+  if (i == m_subflows.size ())
+    {
+      m_subflows.push_back (PeekPointer (subflow));
+      m_subflowBytes.push_back (0);
+    }
+  m_subflowBytes[i] += length;
+  m_scheduledBytes += length;
+  if (reinjection)
+    {
+      m_reinjections++;
+      m_reinjectedBytes += length;
+    }
+  m_scheduledTrace (subflow, dsn, length);
+}
+
+void
+MpTcpStats::NotifyReceived (SequenceNumber64 dsn, uint32_t length, SequenceNumber64 expected, bool duplicate)
+{
+  NS_LOG_FUNCTION (this << dsn << length << expected << duplicate);
+  if (duplicate)
+    {
+      m_duplicateBytes += length;
+    }
+  else if (dsn > expected)
+    {
+      m_outOfOrderArrivals++;
+    }
+}
+
+void
+MpTcpStats::NotifyRxBuffer (uint32_t size, bool blocked)
+{
+  NS_LOG_FUNCTION (this << size << blocked);
+  m_rxBufferOccupancy = size;
+  if (blocked && !m_blocked)
+    {
+      m_blockedSince = Simulator::Now ();
+    }
+  else if (!blocked && m_blocked)
+    {
+      m_holBlockingTime = m_holBlockingTime.Get () + (Simulator::Now () - m_blockedSince);
+    }
+  m_blocked = blocked;
+}
+
+uint32_t
+MpTcpStats::GetNSubflows (void) const
+{
+  return m_subflows.size ();
+}
+
+uint64_t
+MpTcpStats::GetSubflowScheduledBytes (uint32_t i) const
+{
+  NS_ASSERT (i < m_subflowBytes.size ());
+  return m_subflowBytes[i];
+}
+
+uint64_t
+MpTcpStats::GetScheduledBytes (void) const
+{
+  return m_scheduledBytes;
+}
+
+uint32_t
+MpTcpStats::GetReinjections (void) const
+{
+  return m_reinjections;
+}
+
+uint64_t
+MpTcpStats::GetReinjectedBytes (void) const
+{
+  return m_reinjectedBytes;
+}
+
+uint32_t
+MpTcpStats::GetOutOfOrderArrivals (void) const
+{
+  return m_outOfOrderArrivals;
+}
+
+uint64_t
+MpTcpStats::GetDuplicateBytes (void) const
+{
+  return m_duplicateBytes;
+}
+
+uint32_t
+MpTcpStats::GetRxBufferOccupancy (void) const
+{
+  return m_rxBufferOccupancy;
+}
+
+Time
+MpTcpStats::GetHolBlockingTime (void) const
+{
+  if (m_blocked)
+    {
+      return m_holBlockingTime.Get () + (Simulator::Now () - m_blockedSince);
+    }
+  return m_holBlockingTime;
+}
+
+} // namespace ns3
@@ -35,13 +35,18 @@
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-end-point.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/inet6-socket-address.h"
 #include "ns3/node.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-option-mptcp.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/trace-helper.h"
 #include <algorithm>
-#include <openssl/sha.h>
+#include <cstring>
+#include "ns3/mptcp-crypto.h"
+#include "ns3/icmpv4.h"
+#include "ns3/icmpv6-header.h"
 
 namespace ns3 {
 
@@ -68,6 +73,10 @@ MpTcpSubflow::GetTypeId(void)
       .SetParent<TcpSocketBase>()
       .SetGroupName ("Internet")
       .AddConstructor<MpTcpSubflow>()
+      .AddTraceSource ("Health",
+                       "Health of the path of the subflow",
+                       MakeTraceSourceAccessor (&MpTcpSubflow::m_health),
+                       "ns3::MpTcpSubflow::HealthTracedValueCallback")
     ;
   return tid;
 }
@@ -75,13 +84,13 @@ MpTcpSubflow::GetTypeId(void)
 //! wrapper function
 static inline
 MpTcpMapping
-GetMapping(const Ptr<const TcpOptionMpTcpDSS> dss)
+GetMapping(const MpTcpDss& dss)
 {
   MpTcpMapping mapping;
   uint64_t dsn;
   uint32_t ssn;
   uint16_t length;
-  dss->GetMapping (dsn, ssn, length);
+  dss.GetMapping (dsn, ssn, length);
   mapping.SetHeadDSN( SequenceNumber64(dsn));
   mapping.SetMappingSize(length);
   mapping.MapToSSN( SequenceNumber32(ssn));
@@ -143,14 +152,26 @@ MpTcpSubflow::Close(void)
 MpTcpSubflow::MpTcpSubflow(const TcpSocketBase& sock)
   : TcpSocketBase(sock),
     m_dssFlags(0),
-    m_masterSocket(true)
+    m_masterSocket(true),
+    m_backupSubflow(false),
+    m_health(Active),
+    m_ccRegistered(false),
+    m_ccCwnd(0),
+    m_ccRtt(0),
+    m_ccRate(0),
+    m_ccCwndRtt2(0),
+    m_ccLossInterval(0),
+    m_ccQuality(0),
+    m_lastPenalization(Time::Min()),
+    m_ratePacing(false),
+    m_superSegments(false)
 {
   NS_LOG_FUNCTION (this << &sock);
   NS_LOG_LOGIC ("Copying from TcpSocketBase/check2. endPoint=" << sock.m_endPoint);
   // We need to update the endpoint callbnacks so that packets come to this socket
   // instead of the abstract meta
   // this is necessary for the client socket
-  NS_LOG_UNCOND("Cb=" << m_sendCb.IsNull () << " endPoint=" << m_endPoint);
+  NS_LOG_LOGIC("Cb=" << m_sendCb.IsNull () << " endPoint=" << m_endPoint);
   m_endPoint = (sock.m_endPoint);
   m_endPoint6 = (sock.m_endPoint6);
   SetupCallback();
@@ -161,7 +182,21 @@ MpTcpSubflow::MpTcpSubflow(const MpTcpSubflow& sock)
   : TcpSocketBase(sock),
     m_dssFlags(0),
     m_masterSocket(sock.m_masterSocket),
-    m_localNonce(sock.m_localNonce)
+    m_backupSubflow(sock.m_backupSubflow),
+    m_health(Active),
+    m_localNonce(sock.m_localNonce),
+    m_peerNonce(sock.m_peerNonce),
+    m_joinHmacPending(false),
+    m_ccRegistered(false),
+    m_ccCwnd(0),
+    m_ccRtt(0),
+    m_ccRate(0),
+    m_ccCwndRtt2(0),
+    m_ccLossInterval(0),
+    m_ccQuality(0),
+    m_lastPenalization(Time::Min()),
+    m_ratePacing(false),
+    m_superSegments(false)
 {
   NS_LOG_FUNCTION (this << &sock);
   NS_LOG_LOGIC ("Invoked the copy constructor/check2");
@@ -172,7 +207,20 @@ MpTcpSubflow::MpTcpSubflow()
     m_metaSocket(0),
     m_masterSocket(false),
     m_backupSubflow(false),
-    m_localNonce(0)
+    m_health(Active),
+    m_localNonce(0),
+    m_peerNonce(0),
+    m_joinHmacPending(false),
+    m_ccRegistered(false),
+    m_ccCwnd(0),
+    m_ccRtt(0),
+    m_ccRate(0),
+    m_ccCwndRtt2(0),
+    m_ccLossInterval(0),
+    m_ccQuality(0),
+    m_lastPenalization(Time::Min()),
+    m_ratePacing(false),
+    m_superSegments(false)
 {
   NS_LOG_FUNCTION(this);
 }
@@ -212,6 +260,18 @@ MpTcpSubflow::SendEmptyPacket(uint8_t flags)
   TcpSocketBase::SendEmptyPacket(flags);
 }
 
+double
+MpTcpSubflow::GetCoupledRtt() const
+{
+  return m_ccRtt;
+}
+
+double
+MpTcpSubflow::GetCoupledRate() const
+{
+  return m_ccRate;
+}
+
 bool
 MpTcpSubflow::AddLooseMapping(SequenceNumber64 dsnHead, uint16_t length)
 {
@@ -238,6 +298,17 @@ MpTcpSubflow::FirstUnmappedSSN()
   return ssn;
 }
 
+bool
+MpTcpSubflow::GetUnackedMappingForDSN(SequenceNumber64 dsn, MpTcpMapping& mapping) const
+{
+  NS_LOG_FUNCTION(this << dsn);
+  if(!m_TxMappings.GetMappingForDSN(dsn, mapping))
+    {
+      return false;
+    }
+  return mapping.TailSSN() >= m_txBuffer->HeadSequence();
+}
+
 void
 MpTcpSubflow::GetMappedButMissingData(
                 std::set< MpTcpMapping >& missing
@@ -252,26 +323,7 @@ void
 MpTcpSubflow::SendPacket(TcpHeader header, Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << header <<  p);
-  Ptr<const TcpOptionMpTcpJoin> join;   
-  if (p->GetSize() && !IsInfiniteMappingEnabled() && !GetTcpOption(header, join))
-    {
-      //... we must decide to send a mapping or not
-      // For now we always append the mapping but we could have mappings spanning over several packets.
-      // and thus not add the mapping for several packets
-      ///============================
-
-      SequenceNumber32 ssnHead = header.GetSequenceNumber();
-      MpTcpMapping mapping;
-
-      bool result = m_TxMappings.GetMappingForSSN(ssnHead, mapping);
-      if (!result)
-        {
-          m_TxMappings.Dump();
-          NS_FATAL_ERROR("Could not find mapping associated to ssn");
-        }
-      NS_ASSERT_MSG(mapping.TailSSN() >= ssnHead +p->GetSize() -1, "mapping should cover the whole packet" );
-      AppendDSSMapping(mapping);
-   }
+  // The DSS mapping, if any, was chosen by SendDataPacket
   // we append hte ack everytime
   TcpSocketBase::SendPacket(header, p);
   m_dssFlags = 0; // reset for next packet
@@ -288,11 +340,34 @@ MpTcpSubflow::SendDataPacket(SequenceNumber32 ssnHead, uint32_t maxSize, bool wi
       m_TxMappings.Dump();
       NS_FATAL_ERROR("Could not find mapping associated to ssn");
     }
-  AppendDSSMapping(mapping);
+  // A mapping spanning several segments is only advertised with its first
+  // segment. Retransmissions carry it too since the peer may have missed it.
+  if (!IsInfiniteMappingEnabled()
+      && (ssnHead == mapping.HeadSSN() || ssnHead < m_tcb->m_highTxMark))
+    {
+      AppendDSSMapping(mapping);
+    }
   // Here we set the maxsize to the size of the mapping
   return TcpSocketBase::SendDataPacket(ssnHead, std::min( (int)maxSize,mapping.TailSSN()-ssnHead+1), withAck);
 }
 
+Ptr<Packet>
+MpTcpSubflow::GetPayload(Ptr<Packet> p, SequenceNumber32 ssnHead)
+{
+  NS_LOG_FUNCTION(this << p << ssnHead);
+  if (p->GetSize() == 0)
+    {
+      return p;
+    }
+  MpTcpMapping mapping;
+  bool ok = m_TxMappings.GetMappingForSSN(ssnHead, mapping);
+  NS_ASSERT_MSG(ok, "No mapping for SSN " << ssnHead);
+  // SendDataPacket does not let a segment span several mappings
+  NS_ASSERT(ssnHead + p->GetSize() <= mapping.TailSSN() + 1);
+  SequenceNumber64 dsn = mapping.HeadDSN() + (ssnHead - mapping.HeadSSN());
+  return GetMeta()->GetTxData(dsn, p->GetSize());
+}
+
 bool
 MpTcpSubflow::IsInfiniteMappingEnabled() const
 {
@@ -374,32 +449,33 @@ void
 MpTcpSubflow::AddMpTcpOptionDSS(TcpHeader& header)
 {
   NS_LOG_FUNCTION(this);
-  Ptr<TcpOptionMpTcpDSS> dss = Create<TcpOptionMpTcpDSS>();
-  const bool sendDataFin = m_dssFlags &  TcpOptionMpTcpDSS::DataFin;
-  const bool sendDataAck = m_dssFlags & TcpOptionMpTcpDSS::DataAckPresent;
+  MpTcpDss dss;
+  const bool sendDataFin = m_dssFlags &  MpTcpDss::DataFin;
+  const bool sendDataAck = m_dssFlags & MpTcpDss::DataAckPresent;
 
   if(sendDataAck)
   {
-    uint32_t dack = GetMeta()->GetRxBuffer()->NextRxSequence().GetValue();
-    dss->SetDataAck( dack );
+    SequenceNumber64 dack = GetMeta()->RxDsn(GetMeta()->GetRxBuffer()->NextRxSequence());
+    dss.SetDataAck( dack.GetValue(), !GetMeta()->m_dss64Bits );
   }
 
   // If no mapping set but datafin set , we have to create the mapping from scratch
   if (sendDataFin)
    {
      m_dssMapping.MapToSSN(SequenceNumber32(0));
-     m_dssMapping.SetHeadDSN(SEQ32TO64(GetMeta()->m_txBuffer->TailSequence() ));
+     m_dssMapping.SetHeadDSN(GetMeta()->TxDsn(GetMeta()->m_txBuffer->TailSequence() ));
      m_dssMapping.SetMappingSize(1);
-     m_dssFlags |= TcpOptionMpTcpDSS::DSNMappingPresent;
+     m_dssFlags |= MpTcpDss::DSNMappingPresent;
    }
 
   // if there is a mapping to send
-  if(m_dssFlags & TcpOptionMpTcpDSS::DSNMappingPresent)
+  if(m_dssFlags & MpTcpDss::DSNMappingPresent)
   {
-    dss->SetMapping(m_dssMapping.HeadDSN().GetValue(), m_dssMapping.HeadSSN().GetValue(),
+    dss.SetMapping(m_dssMapping.HeadDSN().GetValue(), m_dssMapping.HeadSSN().GetValue(),
                            m_dssMapping.GetLength(), sendDataFin);
+    dss.TruncateDSS(!GetMeta()->m_dss64Bits);
    }
-  header.AppendOption(dss);
+  header.SetMpTcpDss(dss);
 }
 
 void
@@ -408,7 +484,11 @@ MpTcpSubflow::AddMpTcpOptions (TcpHeader& header)
   NS_LOG_FUNCTION(this);
 
   Ptr<const TcpOptionMpTcpJoin> join;
-  if ((header.GetFlags () & TcpHeader::SYN))
+  if ((header.GetFlags () & TcpHeader::RST))
+    {
+      // only MP_TCPRST or MP_FASTCLOSE, from the pending options
+    }
+  else if ((header.GetFlags () & TcpHeader::SYN))
     {
       AddOptionMpTcp3WHS(header);
     }
@@ -418,13 +498,36 @@ MpTcpSubflow::AddMpTcpOptions (TcpHeader& header)
     {
       AddOptionMpTcp3WHS(header);
     }
+  else if(m_joinHmacPending)
+    {
+      AddOptionMpTcp3WHS(header);
+      m_joinHmacPending = false;
+    }
   /// Constructs DSS if necessary
   /////////////////////////////////////////
 
+  Ptr<const TcpOptionMpTcpCapable> mpc;
+  if (GetTcpOption(header, mpc) && mpc->HasDataLength())
+    {
+      // the mapping is implicit
+      m_dssFlags &= ~TcpOptionMpTcpDSS::DSNMappingPresent;
+    }
+
   if (m_dssFlags && !GetTcpOption(header, join) )
     {
       AddMpTcpOptionDSS(header);
     }
+
+  // what does not fit waits for the next segment
+  if (!(header.GetFlags () & TcpHeader::SYN))
+    {
+      std::vector<Ptr<TcpOption> >::iterator it = m_pendingOptions.begin();
+      while (it != m_pendingOptions.end() && header.AppendOption(*it))
+        {
+          NS_LOG_INFO("Appended option " << *it);
+          it = m_pendingOptions.erase(it);
+        }
+    }
 }
 
 void
@@ -467,6 +570,7 @@ MpTcpSubflow::CompleteFork(Ptr<Packet> p, const TcpHeader& h, const Address& fro
       NS_LOG_LOGIC("Setting meta endpoint to " << m_endPoint
                    << " (old endpoint=" << GetMeta()->m_endPoint << " )");
       GetMeta()->m_endPoint = m_endPoint;
+      GetMeta()->m_endPoint6 = m_endPoint6;
     }
    NS_LOG_LOGIC("Setting subflow endpoint to " << m_endPoint); 
 }
@@ -492,6 +596,30 @@ MpTcpSubflow::ForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port,
   TcpSocketBase::ForwardUp(packet, header, port, incomingInterface);
 }
 
+void
+MpTcpSubflow::ForwardIcmp (Ipv4Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo)
+{
+  NS_LOG_FUNCTION(this << icmpSource << (int)icmpType << (int)icmpCode);
+  TcpSocketBase::ForwardIcmp(icmpSource, icmpTtl, icmpType, icmpCode, icmpInfo);
+  // the path MTU is not the path being broken
+  if (icmpType == Icmpv4Header::ICMPV4_DEST_UNREACH
+      && icmpCode != Icmpv4DestinationUnreachable::ICMPV4_FRAG_NEEDED)
+    {
+      GetMeta()->OnSubflowUnreachable(this);
+    }
+}
+
+void
+MpTcpSubflow::ForwardIcmp6 (Ipv6Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo)
+{
+  NS_LOG_FUNCTION(this << icmpSource << (int)icmpType << (int)icmpCode);
+  TcpSocketBase::ForwardIcmp6(icmpSource, icmpTtl, icmpType, icmpCode, icmpInfo);
+  if (icmpType == Icmpv6Header::ICMPV6_ERROR_DESTINATION_UNREACHABLE)
+    {
+      GetMeta()->OnSubflowUnreachable(this);
+    }
+}
+
 /* Apparently this function is never called for now */
 void
 MpTcpSubflow::ConnectionSucceeded(void)
@@ -519,7 +647,28 @@ MpTcpSubflow::ProcessOptionMpTcpCapable(const Ptr<const TcpOptionMpTcpMain> opti
   // Expect an MP_CAPABLE option
   Ptr<const TcpOptionMpTcpCapable> mpcRcvd = DynamicCast<const TcpOptionMpTcpCapable>(option);
   NS_ASSERT_MSG(mpcRcvd, "There must be a MP_CAPABLE option");
-  GetMeta()->SetPeerKey( mpcRcvd->GetSenderKey() );
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+
+  // a version 1 SYN carries no key
+  if (mpcRcvd->HasSenderKey())
+    {
+      meta->SetPeerKey( mpcRcvd->GetSenderKey() );
+    }
+
+  // Options are processed before the payload is queued, so the first data
+  // byte of the connection is the next one expected by both sockets
+  if (mpcRcvd->HasDataLength() && !meta->FullyEstablished())
+    {
+      MpTcpMapping m;
+      m.SetHeadDSN(meta->RxDsn(meta->m_rxBuffer->NextRxSequence()));
+      m.MapToSSN(m_rxBuffer->NextRxSequence());
+      m.SetMappingSize(mpcRcvd->GetDataLength());
+      if (!m_RxMappings.AddMapping(m))
+        {
+          NS_LOG_WARN("Could not insert implicit mapping " << m);
+        }
+      meta->BecomeFullyEstablished();
+    }
   return 0;
 }
 
@@ -530,20 +679,210 @@ MpTcpSubflow::ProcessOptionMpTcpJoin(const Ptr<const TcpOptionMpTcpMain> option)
 
   Ptr<const TcpOptionMpTcpJoin> join = DynamicCast<const TcpOptionMpTcpJoin>(option);
   NS_ASSERT_MSG( join, "There must be an MP_JOIN option in the SYN Packet" );
-  NS_ASSERT_MSG( join && join->GetMode() == TcpOptionMpTcpJoin::SynAck, "the MPTCP join option received is not of the expected 1 out of 3 MP_JOIN types." );
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+
+  switch(join->GetMode())
+    {
+      case TcpOptionMpTcpJoin::Syn:
+        // token and nonce were consumed by the meta when accepting the subflow
+        break;
+      case TcpOptionMpTcpJoin::SynAck:
+        {
+          m_peerNonce = join->GetNonce();
+          uint64_t expected = GenerateTruncatedJoinHmac(meta->GetMpTcpCryptoAlg(), meta->GetPeerKey(), meta->GetLocalKey(),
+                                                        m_peerNonce, m_localNonce);
+          if (join->GetTruncatedHmac() != expected)
+            {
+              NS_LOG_WARN("Wrong HMAC in MP_JOIN SYN/ACK");
+              RejectJoin();
+              return 1;
+            }
+          // the third ACK must carry our full HMAC
+          m_joinHmacPending = true;
+        }
+        break;
+      case TcpOptionMpTcpJoin::Ack:
+        {
+          uint8_t expected[MPTCP_HMAC_SIZE];
+          GenerateJoinHmac(meta->GetMpTcpCryptoAlg(), meta->GetPeerKey(), meta->GetLocalKey(),
+                           m_peerNonce, m_localNonce, expected);
+          if (memcmp(join->GetHmac(), expected, MPTCP_HMAC_SIZE) != 0)
+            {
+              NS_LOG_WARN("Wrong HMAC in MP_JOIN ACK");
+              RejectJoin();
+              return 1;
+            }
+        }
+        break;
+      default:
+        NS_FATAL_ERROR("Unknown MP_JOIN mode");
+    }
   return 0;
 }
 
+void
+MpTcpSubflow::RejectJoin()
+{
+  NS_LOG_FUNCTION(this);
+  if (GetMeta()->m_mptcpVersion >= 1)
+    {
+      Ptr<TcpOptionMpTcpReset> reset = CreateObject<TcpOptionMpTcpReset>();
+      reset->SetReason(TcpOptionMpTcpReset::MpTcpSpecific);
+      m_pendingOptions.push_back(reset);
+    }
+  Abort(true);
+}
+
+void
+MpTcpSubflow::Abort(bool sendRst)
+{
+  NS_LOG_FUNCTION(this << sendRst);
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+
+  if (m_state == CLOSED)
+    {
+      return;
+    }
+  if (sendRst)
+    {
+      SendEmptyPacket(TcpHeader::RST);
+    }
+  CancelAllTimers();
+  m_state = CLOSED;
+  DeallocateEndPoint();
+  meta->MoveSubflow(this, MpTcpSocketBase::Closing);
+  meta->OnSubflowClosed(this, false);
+}
+
+void
+MpTcpSubflow::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
+                           const Address &toAddress)
+{
+  TcpHeader tcpHeader;
+  packet->PeekHeader (tcpHeader);
+  if (tcpHeader.GetFlags () & TcpHeader::RST)
+    {
+      Ptr<const TcpOptionMpTcpReset> reset;
+      if (GetTcpOption(tcpHeader, reset))
+        {
+          ProcessOptionMpTcpReset(reset);
+        }
+    }
+  // RFC 6824 sends it on an ACK, RFC 8684 on a RST
+  Ptr<const TcpOptionMpTcpFastClose> fastClose;
+  if (GetTcpOption(tcpHeader, fastClose) && ProcessOptionMpTcpFastClose(fastClose, tcpHeader.GetFlags () & TcpHeader::RST) != 0)
+    {
+      // the connection is gone
+      return;
+    }
+  TcpSocketBase::DoForwardUp(packet, fromAddress, toAddress);
+}
+
 //This functions process MP_ADD_ADDR mptcp options
 int
 MpTcpSubflow::ProcessOptionMpTcpAddAddress(const Ptr<const TcpOptionMpTcpAddAddress> addaddr) 
 {
   NS_LOG_FUNCTION (this << addaddr << " MP_ADD_ADDR ");
-  InetSocketAddress  address= InetSocketAddress::ConvertFrom (addaddr->GetAddress ());
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+  if (addaddr->GetVersion () >= 1)
+    {
+      if (addaddr->IsEcho ())
+        {
+          NS_LOG_LOGIC("Peer received our advertisement of address id " << (int)addaddr->GetAddressId ());
+          return 0;
+        }
+      uint64_t expected = addaddr->ComputeTruncatedHmac(meta->GetMpTcpCryptoAlg(), meta->GetPeerKey(), meta->GetLocalKey());
+      if (addaddr->GetTruncatedHmac () != expected)
+        {
+          NS_LOG_WARN("Wrong HMAC in ADD_ADDR, ignored");
+          return 0;
+        }
+      Ptr<TcpOptionMpTcpAddAddress> echo = CreateObject<TcpOptionMpTcpAddAddress>();
+      if (addaddr->GetAddressVersion () == 4)
+        {
+          echo->SetAddress(addaddr->GetAddress (), addaddr->GetAddressId ());
+        }
+      else
+        {
+          echo->SetAddress(addaddr->GetAddress6 (), addaddr->GetAddressId ());
+        }
+      echo->SetEcho(true);
+      m_pendingOptions.push_back(echo);
+    }
+  if (addaddr->GetAddressVersion () == 4)
+    {
+      InetSocketAddress address = addaddr->GetAddress ();
+      meta->AddRemoteAddress(address.GetIpv4 (), address.GetPort (), addaddr->GetAddressId ());
+    }
+  else
+    {
+      Inet6SocketAddress address = addaddr->GetAddress6 ();
+      meta->AddRemoteAddress(address.GetIpv6 (), address.GetPort (), addaddr->GetAddressId ());
+    }
+  return 0;
+}
+
+int
+MpTcpSubflow::ProcessOptionMpTcpPriority(const Ptr<const TcpOptionMpTcpChangePriority> prio)
+{
+  NS_LOG_FUNCTION (this << prio);
+  bool backup = prio->GetFlags () & TcpOptionMpTcpChangePriority::Backup;
+  if (!prio->EmbeddedAddressId ())
+    {
+      SetBackup(backup);
+      return 0;
+    }
+  Address address;
+  if (!GetMeta()->GetRemoteAddress(prio->GetAddressId (), address))
+    {
+      NS_LOG_WARN("MP_PRIO for unknown address id " << (int)prio->GetAddressId ());
+      return 0;
+    }
+  const MpTcpSocketBase::SubflowList& subflows = GetMeta()->m_subflows[MpTcpSocketBase::Established];
+  for (MpTcpSocketBase::SubflowList::const_iterator it = subflows.begin(); it != subflows.end(); ++it)
+    {
+      if ((*it)->GetPeerIp() == address)
+        {
+          (*it)->SetBackup(backup);
+        }
+    }
+  return 0;
+}
+
+int
+MpTcpSubflow::ProcessOptionMpTcpRemoveAddress(const Ptr<const TcpOptionMpTcpRemoveAddress> remaddr)
+{
+  NS_LOG_FUNCTION (this << remaddr);
+  std::vector<uint8_t> ids;
+  remaddr->GetAddresses(ids);
+  for (std::vector<uint8_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+      GetMeta()->RemoveRemoteAddress(*it);
+    }
+  return 0;
+}
 
-  Ipv4Address destinationIp = address.GetIpv4 ();
-  uint16_t    destinationPort = address.GetPort ();  
-  GetMeta()->RemoteAddressInfo.push_back(std::make_pair(destinationIp, destinationPort));
+int
+MpTcpSubflow::ProcessOptionMpTcpFastClose(const Ptr<const TcpOptionMpTcpFastClose> fastClose, bool onRst)
+{
+  NS_LOG_FUNCTION (this << fastClose << onRst);
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+  if (fastClose->GetPeerKey () != meta->GetLocalKey ())
+    {
+      NS_LOG_WARN("MP_FASTCLOSE with a wrong key, ignored");
+      return 0;
+    }
+  // Received on an ACK, the peer waits for our RST
+  meta->PeerFastClose(this, !onRst);
+  return 1;
+}
+
+int
+MpTcpSubflow::ProcessOptionMpTcpReset(const Ptr<const TcpOptionMpTcpReset> reset)
+{
+  NS_LOG_FUNCTION (this << reset);
+  NS_LOG_INFO("Subflow reset by the peer, reason " << (int)reset->GetReason ()
+              << ((reset->GetFlags () & TcpOptionMpTcpReset::Transient) ? " (transient)" : ""));
   return 0;
 }
 
@@ -564,7 +903,7 @@ MpTcpSubflow::ProcessOptionMpTcp (const Ptr<const TcpOption> option)
               Ptr<const TcpOptionMpTcpDSS> dss = DynamicCast<const TcpOptionMpTcpDSS>(option);
               NS_ASSERT(dss);
               // Update later on
-              ProcessOptionMpTcpDSSEstablished(dss);
+              ProcessOptionMpTcpDSSEstablished(*dss);
             }
             break;
        case TcpOptionMpTcpMain::MP_ADD_ADDR: 
@@ -574,7 +913,24 @@ MpTcpSubflow::ProcessOptionMpTcp (const Ptr<const TcpOption> option)
               ProcessOptionMpTcpAddAddress(addaddr);   
             }
             break;   
+       case TcpOptionMpTcpMain::MP_PRIO:
+            {
+              Ptr<const TcpOptionMpTcpChangePriority> prio = DynamicCast<const TcpOptionMpTcpChangePriority>(option);
+              NS_ASSERT(prio);
+              ProcessOptionMpTcpPriority(prio);
+            }
+            break;
+       case TcpOptionMpTcpMain::MP_REMOVE_ADDR:
+            {
+              Ptr<const TcpOptionMpTcpRemoveAddress> remaddr = DynamicCast<const TcpOptionMpTcpRemoveAddress>(option);
+              NS_ASSERT(remaddr);
+              ProcessOptionMpTcpRemoveAddress(remaddr);
+            }
+            break;
        case TcpOptionMpTcpMain::MP_FASTCLOSE:
+       case TcpOptionMpTcpMain::MP_TCPRST:
+            // see DoForwardUp
+            break;
        case TcpOptionMpTcpMain::MP_FAIL:
        default:
             NS_FATAL_ERROR("Unsupported yet");
@@ -592,15 +948,25 @@ MpTcpSubflow::AddOptionMpTcp3WHS(TcpHeader& hdr) const
     {
      //! Use an MP_CAPABLE option
      Ptr<TcpOptionMpTcpCapable> mpc =  CreateObject<TcpOptionMpTcpCapable>();
+     mpc->SetVersion( GetMeta()->m_mptcpVersion );
      switch(hdr.GetFlags())
      {
        case TcpHeader::SYN:
+         if (GetMeta()->m_mptcpVersion == 0)
+           {
+             mpc->SetSenderKey( GetMeta()->GetLocalKey() );
+           }
+         break;
        case (TcpHeader::SYN | TcpHeader::ACK):
          mpc->SetSenderKey( GetMeta()->GetLocalKey() );
          break;
        case TcpHeader::ACK:
          mpc->SetSenderKey( GetMeta()->GetLocalKey() );
          mpc->SetPeerKey( GetMeta()->GetPeerKey() );
+         if (SendsDataInCapable())
+           {
+             mpc->SetDataLength( m_dssMapping.GetLength() );
+           }
          break;
        default:
          NS_FATAL_ERROR("Should never happen");
@@ -618,13 +984,15 @@ MpTcpSubflow::AddOptionMpTcp3WHS(TcpHeader& hdr) const
          {
            join->SetMode(TcpOptionMpTcpJoin::Syn);
            join->SetPeerToken(GetMeta()->GetPeerToken());
-           join->SetNonce(0);
+           join->SetNonce(m_localNonce);
          }
          break;
        case TcpHeader::ACK:
          {
-           uint8_t hmac[20];
+           uint8_t hmac[MPTCP_HMAC_SIZE];
 
+           GenerateJoinHmac(GetMeta()->GetMpTcpCryptoAlg(), GetMeta()->GetLocalKey(), GetMeta()->GetPeerKey(),
+                            m_localNonce, m_peerNonce, hmac);
            join->SetMode(TcpOptionMpTcpJoin::Ack);
            join->SetHmac( hmac );
          }
@@ -635,8 +1003,9 @@ MpTcpSubflow::AddOptionMpTcp3WHS(TcpHeader& hdr) const
            static uint8_t id = 0;
            NS_LOG_WARN("IDs are incremental, there is no real logic behind it yet");
            join->SetAddressId( id++ );
-           join->SetTruncatedHmac(424242); // who cares 
-           join->SetNonce(4242); //! truly random :)
+           join->SetTruncatedHmac(GenerateTruncatedJoinHmac(GetMeta()->GetMpTcpCryptoAlg(), GetMeta()->GetLocalKey(),
+                                                            GetMeta()->GetPeerKey(), m_localNonce, m_peerNonce));
+           join->SetNonce(m_localNonce);
          }
          break;
        default:
@@ -648,6 +1017,20 @@ MpTcpSubflow::AddOptionMpTcp3WHS(TcpHeader& hdr) const
   }
 }
 
+bool
+MpTcpSubflow::SendsDataInCapable() const
+{
+  Ptr<MpTcpSocketBase> meta = GetMeta();
+  // Until the peer acknowledges data with a DSS, the head of the meta send
+  // buffer is the first byte of the connection
+  return IsMaster()
+      && meta->m_mptcpVersion >= 1
+      && !meta->FullyEstablished()
+      && (m_dssFlags & TcpOptionMpTcpDSS::DSNMappingPresent)
+      && !(m_dssFlags & TcpOptionMpTcpDSS::DataFin)
+      && m_dssMapping.HeadDSN() == meta->TxDsn(meta->m_txBuffer->HeadSequence());
+}
+
 // This function to pass peer token to tcpsocketbase
 uint32_t
 MpTcpSubflow::PeerToken()
@@ -699,6 +1082,100 @@ MpTcpSubflow::BackupSubflow() const
   return m_backupSubflow;
 }
 
+void
+MpTcpSubflow::SetBackup(bool backup)
+{
+  NS_LOG_FUNCTION(this << backup);
+  m_backupSubflow = backup;
+}
+
+void
+MpTcpSubflow::SendMpPriority(bool backup)
+{
+  NS_LOG_FUNCTION(this << backup);
+  Ptr<TcpOptionMpTcpChangePriority> prio = CreateObject<TcpOptionMpTcpChangePriority>();
+  prio->SetFlags(backup ? TcpOptionMpTcpChangePriority::Backup : 0);
+  m_pendingOptions.push_back(prio);
+  SendEmptyPacket(TcpHeader::ACK);
+}
+
+MpTcpSubflow::HealthState
+MpTcpSubflow::GetHealth() const
+{
+  return m_health;
+}
+
+void
+MpTcpSubflow::SetHealth(HealthState health)
+{
+  NS_LOG_FUNCTION(this << health);
+  if (health == Recovered)
+    {
+      m_healthMark = m_tcb->m_highTxMark;
+    }
+  m_health = health;
+}
+
+bool
+MpTcpSubflow::IsHealthy() const
+{
+  return m_health == Active || m_health == Recovered;
+}
+
+bool
+MpTcpSubflow::IsPathFailed() const
+{
+  return m_health == Failed;
+}
+
+void
+MpTcpSubflow::SetPathFailed(bool failed)
+{
+  NS_LOG_FUNCTION(this << failed);
+  if (failed)
+    {
+      SetHealth(Failed);
+    }
+  else if (m_health != Active)
+    {
+      SetHealth(Recovered);
+    }
+}
+
+uint32_t
+MpTcpSubflow::GetConsecutiveTimeouts() const
+{
+  return m_dataRetries - m_dataRetrCount;
+}
+
+Address
+MpTcpSubflow::GetLocalIp() const
+{
+  if (m_endPoint)
+    {
+      return m_endPoint->GetLocalAddress();
+    }
+  if (m_endPoint6)
+    {
+      return m_endPoint6->GetLocalAddress();
+    }
+  return Address();
+}
+
+Address
+MpTcpSubflow::GetPeerIp() const
+{
+  if (m_endPoint)
+    {
+      return m_endPoint->GetPeerAddress();
+    }
+  if (m_endPoint6)
+    {
+      return m_endPoint6->GetPeerAddress();
+    }
+  return Address();
+}
+
 /* should be able to advertise several in one packet if enough space
    It is possible
    http://tools.ietf.org/html/rfc6824#section-3.4.1
@@ -718,14 +1195,44 @@ MpTcpSubflow::BackupSubflow() const
    attempt on a previously advertised address/port combination can
    therefore refresh ADD_ADDR information by sending the option again. */
 void
-MpTcpSubflow::AdvertiseAddress(Ipv4Address addr, uint16_t port)
+MpTcpSubflow::AdvertiseAddress(const Address& address, uint16_t port)
 {
-  NS_LOG_FUNCTION("Started advertising address");
+  NS_LOG_FUNCTION(this << address << port);
+  Ptr<TcpOptionMpTcpAddAddress> addaddr = CreateObject<TcpOptionMpTcpAddAddress>();
+  uint8_t addrId = GetMeta()->GetLocalAddressId(address);
+  if (Ipv4Address::IsMatchingType(address))
+    {
+      addaddr->SetAddress(InetSocketAddress(Ipv4Address::ConvertFrom(address), port), addrId);
+    }
+  else
+    {
+      addaddr->SetAddress(Inet6SocketAddress(Ipv6Address::ConvertFrom(address), port), addrId);
+    }
+  if (GetMeta()->m_mptcpVersion >= 1)
+    {
+      Ptr<MpTcpSocketBase> meta = GetMeta();
+      addaddr->SetTruncatedHmac(addaddr->ComputeTruncatedHmac(meta->GetMpTcpCryptoAlg(),
+                                                              meta->GetLocalKey(), meta->GetPeerKey()));
+    }
+  m_pendingOptions.push_back(addaddr);
+  SendEmptyPacket(TcpHeader::ACK);
 }
 
 bool
-MpTcpSubflow::StopAdvertisingAddress(Ipv4Address address)
+MpTcpSubflow::StopAdvertisingAddress(const Address& address)
 {
+  NS_LOG_FUNCTION(this << address);
+  std::map<Address, uint8_t>& ids = GetMeta()->m_localAddressIds;
+  std::map<Address, uint8_t>::iterator it = ids.find(address);
+  if (it == ids.end())
+    {
+      return false;
+    }
+  Ptr<TcpOptionMpTcpRemoveAddress> remaddr = CreateObject<TcpOptionMpTcpRemoveAddress>();
+  remaddr->AddAddressId(it->second);
+  ids.erase(it);
+  m_pendingOptions.push_back(remaddr);
+  SendEmptyPacket(TcpHeader::ACK);
   return true;
 }
 
@@ -733,7 +1240,12 @@ void
 MpTcpSubflow::ReTxTimeout()
 {
   NS_LOG_LOGIC("MpTcpSubflow ReTxTimeout expired !");
+  uint32_t retries = m_dataRetrCount;
   TcpSocketBase::ReTxTimeout();
+  if (m_dataRetrCount < retries)
+    {
+      GetMeta()->OnSubflowTimeout(this);
+    }
 }
 
 bool
@@ -753,6 +1265,51 @@ MpTcpSubflow::GetTxAvailable() const
   return TcpSocketBase::GetTxAvailable();
 }
 
+void
+MpTcpSubflow::SetPacing(bool superSegments)
+{
+  NS_LOG_FUNCTION(this << superSegments);
+  m_tcb->m_pacing = true;
+  m_ratePacing = true;
+  m_superSegments = superSegments;
+  UpdatePacingRate();
+}
+
+void
+MpTcpSubflow::UpdatePacingRate(void)
+{
+  if (!m_ratePacing)
+    {
+      return;
+    }
+  Time srtt = m_rtt ? m_rtt->GetEstimate() : Time(0);
+  if (srtt.IsZero())
+    {
+      // no sample yet: the initial window leaves at once
+      m_tcb->m_currentPacingRate = m_tcb->m_maxPacingRate;
+      return;
+    }
+  double factor = (m_tcb->m_cWnd < m_tcb->m_ssThresh) ? 2.0 : 1.2;
+  uint64_t bps = static_cast<uint64_t>(factor * m_tcb->m_cWnd.Get() * 8 / srtt.GetSeconds());
+  m_tcb->m_currentPacingRate = DataRate(std::min(bps, m_tcb->m_maxPacingRate.GetBitRate()));
+  NS_LOG_LOGIC("Pacing rate " << m_tcb->m_currentPacingRate << " for cwnd=" << m_tcb->m_cWnd << " srtt=" << srtt);
+}
+
+uint32_t
+MpTcpSubflow::GetPacingQuantum(void) const
+{
+  if (!m_superSegments)
+    {
+      return 0;
+    }
+  uint32_t segmentSize = m_tcb->m_segmentSize;
+  // 1 ms worth of data
+  uint64_t bytes = m_tcb->m_currentPacingRate.GetBitRate() / 8000;
+  uint64_t segments = std::max<uint64_t>(bytes / segmentSize, 2);
+  segments = std::min<uint64_t>(segments, std::max<uint32_t>(65535 / segmentSize, 2));
+  return segments * segmentSize;
+}
+
 /* Receipt of new packet, put into Rx buffer
    SlowStart and fast recovery remains untouched in MPTCP.
    The reaction should be different depending on if we handle NR-SACK or not */
@@ -761,6 +1318,20 @@ MpTcpSubflow::NewAck(SequenceNumber32 const& ack, bool resetRTO)
 {
   NS_LOG_FUNCTION (this << resetRTO << ack);
   TcpSocketBase::NewAck(ack, resetRTO);
+  UpdatePacingRate();
+  // mappings both acked at subflow and connection level will never be sent again
+  m_TxMappings.DiscardMappingsUpTo(GetMeta()->m_txHeadDsn, ack);
+  GetMeta()->ReleaseTxData();
+  if (m_health == PotentiallyFailed || m_health == Failed)
+    {
+      GetMeta()->OnSubflowRecovered(this);
+    }
+  else if (m_health == Recovered && ack > m_healthMark)
+    {
+      SetHealth(Active);
+    }
+  // window opened: data waiting in the meta (first of all reinjections) can go
+  GetMeta()->SendPendingData(true);
 }
 
 /* this is private */
@@ -784,19 +1355,21 @@ MpTcpSubflow::ExtractAtMostOneMapping(uint32_t maxSize, bool only_full_mapping,
   SequenceNumber32 headSSN = m_rxBuffer->HeadSequence();
   if(!m_RxMappings.GetMappingForSSN(headSSN, mapping))
    {
-      m_RxMappings.Dump();
-      NS_FATAL_ERROR("Could not associate a mapping to ssn [" << headSSN << "]. Should be impossible");
+      NS_LOG_LOGIC("No mapping received yet for ssn [" << headSSN << "]");
+      return p;
    }
-  headDSN = mapping.HeadDSN();
+  // Part of the mapping may have been extracted already
+  mapping.TranslateSSNToDSN(headSSN, headDSN);
+  uint32_t mappingLeft = mapping.TailSSN() - headSSN + 1;
 
   if(only_full_mapping) {
 
-    if(mapping.GetLength() > maxSize)
+    if(mappingLeft > maxSize)
     {
       NS_LOG_DEBUG("Not enough space available to extract the full mapping");
       return p;
     }
-    if(m_rxBuffer->Available() < mapping.GetLength())
+    if(m_rxBuffer->Available() < mappingLeft)
     {
       NS_LOG_DEBUG("Mapping not fully received yet");
       return p;
@@ -804,7 +1377,7 @@ MpTcpSubflow::ExtractAtMostOneMapping(uint32_t maxSize, bool only_full_mapping,
   }
 
   // Extract at most one mapping
-  maxSize = std::min(maxSize, (uint32_t)mapping.GetLength());
+  maxSize = std::min(maxSize, mappingLeft);
   NS_LOG_DEBUG("Extracting at most " << maxSize << " bytes ");
   p = m_rxBuffer->Extract( maxSize );
   SequenceNumber32 extractedTail = headSSN + p->GetSize() - 1;
@@ -818,6 +1391,8 @@ MpTcpSubflow::ExtractAtMostOneMapping(uint32_t maxSize, bool only_full_mapping,
   else
   {
     m_RxMappings.DiscardMapping(mapping);
+    // also drops the mappings of retransmissions already extracted
+    m_RxMappings.DiscardMappingsUpTo(mapping.TailDSN() + 1, mapping.TailSSN() + 1);
   }
   return p;
 }
@@ -851,13 +1426,11 @@ MpTcpSubflow::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
   MpTcpMapping mapping;
   bool sendAck = false;
 
-  // OutOfRange
-  // If cannot find an adequate mapping, then it should [check RFC]
+  // The mapping is advertised only with the first segment it covers: if that
+  // one got lost, the data is buffered until its retransmission brings the mapping
   if(!m_RxMappings.GetMappingForSSN(tcpHeader.GetSequenceNumber(), mapping) )
    {
-     m_RxMappings.Dump();
-     NS_FATAL_ERROR("Could not find mapping associated ");
-     return;
+     NS_LOG_LOGIC("No mapping yet for ssn " << tcpHeader.GetSequenceNumber());
    }
   // Put into Rx buffer
   SequenceNumber32 expectedSSN = m_rxBuffer->NextRxSequence();
@@ -870,6 +1443,8 @@ MpTcpSubflow::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
       SendEmptyPacket(TcpHeader::ACK);
       return;
     }
+  // the meta tunes its buffer over the RTT of its subflows
+  UpdateRcvRtt(tcpHeader);
 
   // Size() = Get the actual buffer occupancy
   if (m_rxBuffer->Size() > m_rxBuffer->Available() /* Out of order packets exist in buffer */
@@ -943,7 +1518,27 @@ uint16_t
 MpTcpSubflow::AdvertisedWindowSize(bool scale) const
 {
   NS_LOG_DEBUG(this<<scale);
-  return GetMeta()->AdvertisedWindowSize();
+  uint32_t w = GetMeta()->GetRxWindow();
+  if (w != m_advWnd)
+    {
+      const_cast<MpTcpSubflow*>(this)->m_advWnd = w;
+    }
+  if (scale)
+    {
+      w >>= m_rcvWindShift;
+    }
+  return static_cast<uint16_t>(std::min<uint32_t>(w, m_maxWinSize));
+}
+
+uint8_t
+MpTcpSubflow::CalculateWScale() const
+{
+  NS_LOG_FUNCTION(this);
+  if (!m_metaSocket)
+    {
+      return TcpSocketBase::CalculateWScale();
+    }
+  return m_metaSocket->CalculateWScale();
 }
 
 void
@@ -966,9 +1561,15 @@ MpTcpSubflow::ClosingOnEmpty(TcpHeader& header)
 }
 
 int
-MpTcpSubflow::ProcessOptionMpTcpDSSEstablished(const Ptr<const TcpOptionMpTcpDSS> dss)
+MpTcpSubflow::ProcessOptionMpTcpDss(const MpTcpDss& dss)
+{
+  return ProcessOptionMpTcpDSSEstablished(dss);
+}
+
+int
+MpTcpSubflow::ProcessOptionMpTcpDSSEstablished(const MpTcpDss& dss)
 {
-  NS_LOG_FUNCTION (this << dss << " from subflow ");
+  NS_LOG_FUNCTION (this << " from subflow ");
 
   if(!GetMeta()->FullyEstablished() )
   {
@@ -977,29 +1578,50 @@ MpTcpSubflow::ProcessOptionMpTcpDSSEstablished(const Ptr<const TcpOptionMpTcpDSS
   }
 
   //! datafin case handled at the start of the function
-  if( (dss->GetFlags() & TcpOptionMpTcpDSS::DSNMappingPresent) && !dss->DataFinMappingOnly() )
+  if( (dss.GetFlags() & MpTcpDss::DSNMappingPresent) && !dss.DataFinMappingOnly() )
   {
     MpTcpMapping m;
     //Get mapping n'est utilisé qu'une fois, copier le code ici
     m = GetMapping(dss);
+    if (!(dss.GetFlags() & MpTcpDss::DSNOfEightBytes))
+    {
+      // only the lower 32 bits were sent
+      m.SetHeadDSN(GetMeta()->RxDsn(SEQ64TO32(m.HeadDSN())));
+    }
     // Add peer mapping
     bool ok = m_RxMappings.AddMapping( m );
-    if(!ok)
+    MpTcpMapping known;
+    if(!ok && m_RxMappings.GetMappingForSSN(m.HeadSSN(), known) && known == m)
+      {
+        // mappings are advertised again with retransmissions
+        NS_LOG_LOGIC("Mapping already known " << m);
+      }
+    else if(!ok)
       {
         NS_LOG_WARN("Could not insert mapping: already received ?");
         NS_LOG_UNCOND("Dumping Rx mappings...");
         m_RxMappings.Dump();
       }
   }
-  if ( dss->GetFlags() & TcpOptionMpTcpDSS::DataFin)
+  if ( dss.GetFlags() & MpTcpDss::DataFin)
   {
-    NS_LOG_LOGIC("DFIN detected " << dss->GetDataFinDSN());
-    GetMeta()->PeerClose( SequenceNumber32(dss->GetDataFinDSN()), this);
+    NS_LOG_LOGIC("DFIN detected " << dss.GetDataFinDSN());
+    SequenceNumber64 dfin(dss.GetDataFinDSN());
+    if (!(dss.GetFlags() & MpTcpDss::DSNOfEightBytes))
+    {
+      dfin = GetMeta()->RxDsn(SEQ64TO32(dfin));
+    }
+    GetMeta()->PeerClose(dfin, this);
   }
 
-  if( dss->GetFlags() & TcpOptionMpTcpDSS::DataAckPresent)
+  if( dss.GetFlags() & MpTcpDss::DataAckPresent)
   {
-    GetMeta()->ReceivedAck( SequenceNumber32(dss->GetDataAck()), this, false);
+    SequenceNumber64 dack(dss.GetDataAck());
+    if (!(dss.GetFlags() & MpTcpDss::DataAckOf8Bytes))
+    {
+      dack = GetMeta()->TxDsn(SEQ64TO32(dack));
+    }
+    GetMeta()->ReceivedAck(dack, this, false);
   }
   return 0;
 }
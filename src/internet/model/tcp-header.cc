@@ -44,7 +44,8 @@ TcpHeader::TcpHeader ()
     m_urgentPointer (0),
     m_calcChecksum (false),
     m_goodChecksum (true),
-    m_optionsLen (0)
+    m_optionsLen (0),
+    m_hasMpTcpDss (false)
 {
 }
 
@@ -310,6 +311,12 @@ TcpHeader::Print (std::ostream &os)  const
       (*op)->Print (os);
       os << ")";
     }
+  if (m_hasMpTcpDss)
+    {
+      os << " ns3::TcpOptionMpTcpDSS(";
+      m_mptcpDss.Print (os);
+      os << ")";
+    }
 }
 
 uint32_t
@@ -342,6 +349,12 @@ TcpHeader::Serialize (Buffer::Iterator start)  const
       (*op)->Serialize (i);
       i.Next ((*op)->GetSerializedSize ());
     }
+  if (m_hasMpTcpDss)
+    {
+      optionLen += m_mptcpDss.GetSerializedSize ();
+      m_mptcpDss.Serialize (i);
+      i.Next (m_mptcpDss.GetSerializedSize ());
+    }
 
   // padding to word alignment; add ENDs and/or pad values (they are the same)
   while (optionLen % 4)
@@ -381,6 +394,7 @@ TcpHeader::Deserialize (Buffer::Iterator start)
 
   // Deserialize options if they exist
   m_options.clear ();
+  m_hasMpTcpDss = false;
   uint32_t optionLen = (m_length - 5) * 4;
   if (optionLen > m_maxOptionsLen)
     {
@@ -398,6 +412,21 @@ TcpHeader::Deserialize (Buffer::Iterator start)
           i.ReadU16(); // skip TCP kind & length
           uint8_t subtype = i.ReadU8() >> 4;  // read MPTCP subtype
           i.Prev(3); // revert the iterator back to where it should be
+          if (subtype == TcpOptionMpTcpMain::MP_DSS && !m_hasMpTcpDss)
+            {
+              // read in place, no option object
+              optionSize = m_mptcpDss.Deserialize (i);
+              if (optionSize != m_mptcpDss.GetSerializedSize () || optionSize > optionLen)
+                {
+                  NS_LOG_ERROR ("DSS option did not deserialize correctly");
+                  break;
+                }
+              m_hasMpTcpDss = true;
+              optionLen -= optionSize;
+              i.Next (optionSize);
+              m_optionsLen += optionSize;
+              continue;
+            }
           op = TcpOptionMpTcpMain::CreateMpTcpOption(subtype);
         }
       else if (TcpOption::IsKindKnown (kind))
@@ -466,6 +495,10 @@ TcpHeader::CalculateHeaderLength () const
     {
       len += (*i)->GetSerializedSize ();
     }
+  if (m_hasMpTcpDss)
+    {
+      len += m_mptcpDss.GetSerializedSize ();
+    }
   // Option list may not include padding; need to pad up to word boundary
   if (len % 4)
     {
@@ -500,6 +533,33 @@ TcpHeader::AppendOption (Ptr<const TcpOption> option)
   return false;
 }
 
+bool
+TcpHeader::SetMpTcpDss (const MpTcpDss& dss)
+{
+  uint32_t optionsLen = m_optionsLen + dss.GetSerializedSize ();
+  if (m_hasMpTcpDss)
+    {
+      optionsLen -= m_mptcpDss.GetSerializedSize ();
+    }
+  if (optionsLen > m_maxOptionsLen)
+    {
+      return false;
+    }
+  m_mptcpDss = dss;
+  m_hasMpTcpDss = true;
+  m_optionsLen = optionsLen;
+
+  uint32_t totalLen = 20 + 3 + m_optionsLen;
+  m_length = totalLen >> 2;
+  return true;
+}
+
+const MpTcpDss*
+TcpHeader::GetMpTcpDss () const
+{
+  return m_hasMpTcpDss ? &m_mptcpDss : 0;
+}
+
 const TcpHeader::TcpOptionList&
 TcpHeader::GetOptionList () const
 {
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "ns3/header.h"
 #include "ns3/tcp-option.h"
+#include "ns3/mptcp-dss.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-socket-factory.h"
 #include "ns3/ipv4-address.h"
@@ -226,6 +227,27 @@ public:
    */
   bool AppendOption (Ptr<const TcpOption> option);
 
+  /**
+   * \brief Sets the MPTCP Data Sequence Signal of the segment
+   *
+   * The DSS is carried by every MPTCP segment, it is stored in the header
+   * itself instead of the option list so that no TcpOption object is
+   * allocated for it. A previous DSS is replaced.
+   *
+   * \param dss content of the option
+   * \return true if the option fits in the option space, false otherwise
+   */
+  bool SetMpTcpDss (const MpTcpDss& dss);
+
+  /**
+   * \brief Get the MPTCP Data Sequence Signal of the segment
+   *
+   * Received DSS options are stored there rather than in the option list.
+   *
+   * \return the DSS, or 0 if the segment carries none
+   */
+  const MpTcpDss* GetMpTcpDss (void) const;
+
   /**
    * \brief Initialize the TCP checksum.
    *
@@ -358,6 +380,8 @@ private:
   static const uint8_t m_maxOptionsLen = 40;         //!< Maximum options length
   TcpOptionList m_options;     //!< TcpOption present in the header
   uint8_t m_optionsLen;        //!< Tcp options length.
+  MpTcpDss m_mptcpDss;         //!< MPTCP DSS, kept out of m_options
+  bool m_hasMpTcpDss;          //!< Whether m_mptcpDss is part of the header
 };
 
 /**
@@ -370,8 +394,7 @@ template<class T>
 bool
 GetTcpOption (const TcpHeader& header, Ptr<const T>& ret)
 {
-  TcpHeader::TcpOptionList l;
-  header.GetOptions (l);
+  const TcpHeader::TcpOptionList& l = header.GetOptionList ();
   for (TcpHeader::TcpOptionList::const_iterator it = l.begin (); it != l.end (); ++it)
     {
 //      std::cout << "comparing " << ((*it)->GetInstanceTypeId ().GetName())
@@ -43,6 +43,8 @@
 #include "tcp-socket-base.h"
 #include "mptcp-socket-base.h"
 #include "mptcp-subflow.h"
+#include "mptcp-path-manager.h"
+#include "mptcp-scheduler.h"
 #include "tcp-option-mptcp.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-recovery-ops.h"
@@ -164,6 +166,9 @@ TcpL4Protocol::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_sockets.clear ();
+  m_mptcpTokens.clear ();
+  m_mptcpPathManagers.clear ();
+  m_mptcpSchedulers.clear ();
 
   if (m_endPoints != 0)
     {
@@ -238,15 +243,19 @@ TcpL4Protocol::CreateSocket (Ptr<TcpCongestionOps> algo, TypeId socketTypeId)
   NS_LOG_FUNCTION_NOARGS ();
   ObjectFactory rttFactory;
   ObjectFactory socketFactory;
+  ObjectFactory recoveryAlgorithmFactory;
   rttFactory.SetTypeId (m_rttTypeId);
   socketFactory.SetTypeId(socketTypeId);
+  recoveryAlgorithmFactory.SetTypeId (m_recoveryTypeId);
 
   Ptr<RttEstimator>  rtt = rttFactory.Create<RttEstimator> ();
   Ptr<TcpSocketBase> socket = socketFactory.Create<TcpSocketBase> ();
+  Ptr<TcpRecoveryOps> recovery = recoveryAlgorithmFactory.Create<TcpRecoveryOps> ();
   socket->SetNode (m_node);
   socket->SetTcp (this);
   socket->SetRtt (rtt);
   socket->SetCongestionControlAlgorithm (algo);
+  socket->SetRecoveryAlgorithm (recovery);
   m_sockets.push_back (socket);
   return socket;
 }
@@ -466,29 +475,77 @@ TcpL4Protocol::NoEndPointsFound (const TcpHeader &incomingHeader,
 Ptr<TcpSocket>
 TcpL4Protocol::LookupMpTcpToken (uint32_t token)
 {
-  //! We should find the token
-  /* We go through all the metas to find one with the correct token */
-  for(std::vector<Ptr<TcpSocketBase> >::iterator it = m_sockets.begin(), last(m_sockets.end());
-      it != last;
-      it++
-     )
-    {
-      Ptr<TcpSocketBase> sock = *it;
-      Ptr<MpTcpSocketBase> meta = DynamicCast<MpTcpSocketBase>( sock );
-      Address addr;
-      (*it)->GetSockName(addr);
-      if (!meta)
-        {
-          NS_LOG_DEBUG("Conversion failed: " << sock << " is not an mptcp socket");
-          continue;
-        }
-      if (meta->GetLocalToken() == token)
-        {
-          NS_LOG_DEBUG("Found match " << &meta);
-          return meta;
-        }
+  NS_LOG_FUNCTION (this << token);
+  std::unordered_map<uint32_t, TcpSocketBase*>::const_iterator it = m_mptcpTokens.find (token);
+  if (it == m_mptcpTokens.end ())
+    {
+      return 0;
+    }
+  NS_LOG_DEBUG ("Found match " << it->second);
+  return it->second;
+}
+
+bool
+TcpL4Protocol::AddMpTcpToken (uint32_t token, TcpSocketBase* socket)
+{
+  NS_LOG_FUNCTION (this << token << socket);
+  return m_mptcpTokens.insert (std::make_pair (token, socket)).second;
+}
+
+bool
+TcpL4Protocol::RemoveMpTcpToken (uint32_t token, TcpSocketBase* socket)
+{
+  NS_LOG_FUNCTION (this << token << socket);
+  std::unordered_map<uint32_t, TcpSocketBase*>::iterator it = m_mptcpTokens.find (token);
+  if (it == m_mptcpTokens.end () || it->second != socket)
+    {
+      return false;
+    }
+  m_mptcpTokens.erase (it);
+  return true;
+}
+
+Ptr<MpTcpPathManager>
+TcpL4Protocol::GetMpTcpPathManager (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid);
+  Ptr<MpTcpPathManager> &pathManager = m_mptcpPathManagers[tid];
+  if (!pathManager)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (tid);
+      pathManager = factory.Create<MpTcpPathManager> ();
     }
-    return 0;
+  return pathManager;
+}
+
+Ptr<MpTcpScheduler>
+TcpL4Protocol::AllocateMpTcpScheduler (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid);
+  std::vector<Ptr<MpTcpScheduler> > &recycled = m_mptcpSchedulers[tid];
+  if (recycled.empty ())
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (tid);
+      return factory.Create<MpTcpScheduler> ();
+    }
+  Ptr<MpTcpScheduler> scheduler = recycled.back ();
+  recycled.pop_back ();
+  scheduler->Reset ();
+  return scheduler;
+}
+
+void
+TcpL4Protocol::RecycleMpTcpScheduler (Ptr<MpTcpScheduler> scheduler)
+{
+  NS_LOG_FUNCTION (this << scheduler);
+  // the sockets still alive once the stack got disposed are destroyed one by one
+  if (m_node == 0)
+    {
+      return;
+    }
+  m_mptcpSchedulers[scheduler->GetInstanceTypeId ()].push_back (scheduler);
 }
 
 enum IpL4Protocol::RxStatus
@@ -622,6 +679,35 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
                           incomingTcpHeader.GetDestinationPort (),
                           incomingIpHeader.GetSourceAddress (),
                           incomingTcpHeader.GetSourcePort (), interface);
+
+  if (endPoints.empty ())
+    {
+      NS_LOG_LOGIC ("No Ipv6 endpoints matched on TcpL4Protocol, "
+                    "checking if packet is a MP_JOIN request");
+
+      Ptr<const TcpOptionMpTcpJoin> join;
+      if ((incomingTcpHeader.GetFlags () & TcpHeader::SYN)
+          && GetTcpOption (incomingTcpHeader, join)
+          && join->GetMode () == TcpOptionMpTcpJoin::Syn)
+        {
+          Ptr<MpTcpSocketBase> meta = DynamicCast<MpTcpSocketBase> (LookupMpTcpToken (join->GetPeerToken ()));
+          if (meta)
+            {
+              NS_LOG_LOGIC ("Found meta " << meta << " matching MP_JOIN token=" << join->GetPeerToken ());
+              Ipv6EndPoint *endP = meta->NewSubflowRequest6 (
+                  packet,
+                  incomingTcpHeader,
+                  Inet6SocketAddress (incomingIpHeader.GetSourceAddress (), incomingTcpHeader.GetSourcePort ()),
+                  Inet6SocketAddress (incomingIpHeader.GetDestinationAddress (), incomingTcpHeader.GetDestinationPort ()),
+                  join);
+              if (endP)
+                {
+                  endPoints.push_back (endP);
+                }
+            }
+        }
+    }
+
   if (endPoints.empty ())
     {
       NS_LOG_LOGIC ("TcpL4Protocol " << this << " received a packet but"
@@ -801,15 +887,15 @@ TcpL4Protocol::SendPacket (Ptr<Packet> pkt, const TcpHeader &outgoing,
 void
 TcpL4Protocol::DumpSockets () const
 {
-  NS_LOG_UNCOND ("== Dumping sockets ==");
+  NS_LOG_DEBUG ("== Dumping sockets ==");
   for(std::vector<Ptr<TcpSocketBase> >::const_iterator it = m_sockets.begin(), last(m_sockets.end());
      it != last;
      it++
     )
     {
-      Ptr<TcpSocket> sock = *it;
+      NS_LOG_DEBUG ("- socket " << *it);
     }
-    NS_LOG_UNCOND ("== end of dump ==");
+  NS_LOG_DEBUG ("== end of dump ==");
 }
 
 bool
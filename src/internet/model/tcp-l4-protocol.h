@@ -22,6 +22,8 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <map>
+#include <unordered_map>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -43,6 +45,8 @@ class TcpSocketBase;
 class Ipv4EndPoint;
 class Ipv6EndPoint;
 class MpTcpSubflow;
+class MpTcpPathManager;
+class MpTcpScheduler;
 class NetDevice;
 class TcpCongestionOps;
 
@@ -214,10 +218,57 @@ public:
   /**
    * \brief finds if peer have valid token
    * \token the key exchanged during 3WHS
+   * \return the socket owning the token (the meta once the connection is upgraded), 0 otherwise
    */
   Ptr<TcpSocket>
   LookupMpTcpToken (uint32_t token);
 
+  /**
+   * \brief Register the local token of a socket so that MP_JOINs can find it
+   *
+   * The table does not hold a reference, the socket must remove its token before
+   * being destroyed.
+   * \param token the token (hash of the local key)
+   * \param socket the socket which generated the key
+   * \return false if the token is already in use
+   */
+  bool AddMpTcpToken (uint32_t token, TcpSocketBase* socket);
+
+  /**
+   * \brief Unregister a token
+   * \param token the token to remove
+   * \param socket the socket which registered it, the token is kept if it belongs to another socket
+   * \return true if the token has been removed
+   */
+  bool RemoveMpTcpToken (uint32_t token, TcpSocketBase* socket);
+
+  /**
+   * \brief Get the path manager shared by the MPTCP connections of the node
+   *
+   * Path managers keep no per connection state, hence a single instance per
+   * TypeId is created, with the attribute defaults of the time of the first
+   * request.
+   * \param tid TypeId of a MpTcpPathManager
+   * \return the path manager
+   */
+  Ptr<MpTcpPathManager> GetMpTcpPathManager (TypeId tid);
+
+  /**
+   * \brief Get a scheduler for a new MPTCP connection
+   *
+   * The schedulers of the closed connections are reused once Reset, a new
+   * one is only created when none of this TypeId is left.
+   * \param tid TypeId of a MpTcpScheduler
+   * \return the scheduler
+   */
+  Ptr<MpTcpScheduler> AllocateMpTcpScheduler (TypeId tid);
+
+  /**
+   * \brief Give back the scheduler of a closed MPTCP connection
+   * \param scheduler the scheduler, it must not be used afterwards
+   */
+  void RecycleMpTcpScheduler (Ptr<MpTcpScheduler> scheduler);
+
   /**
    * \brief Send a packet via TCP (IP-agnostic)
    *
@@ -334,6 +385,9 @@ private:
   TypeId m_congestionTypeId;       //!< The socket TypeId
   TypeId m_recoveryTypeId;         //!< The recovery TypeId
   std::vector<Ptr<TcpSocketBase> > m_sockets;      //!< list of sockets
+  std::unordered_map<uint32_t, TcpSocketBase*> m_mptcpTokens; //!< MPTCP local tokens in use, not refcounted
+  std::map<TypeId, Ptr<MpTcpPathManager> > m_mptcpPathManagers;          //!< Path managers shared by the connections
+  std::map<TypeId, std::vector<Ptr<MpTcpScheduler> > > m_mptcpSchedulers; //!< Schedulers of the closed connections
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
 
@@ -19,14 +19,11 @@
  *          Matthieu Coudron <matthieu.coudron@lip6.fr>
  */
 
+#include <algorithm>
+#include <cstring>
 #include "tcp-option-mptcp.h"
 #include "ns3/log.h"
 
-static inline
-uint64_t TRUNC_TO_32(uint64_t seq) {
-  return static_cast<uint32_t>(seq);
-}
-
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpCapable);
@@ -37,6 +34,7 @@ NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpChangePriority );
 NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpDSS);
 NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpFail);
 NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpFastClose);
+NS_OBJECT_ENSURE_REGISTERED (TcpOptionMpTcpReset);
 
 /**
 \note This is a global MPTCP option logger
@@ -85,9 +83,9 @@ TcpOptionMpTcpMain::Print (std::ostream &os) const
 }
 
 std::string
-TcpOptionMpTcpMain::SubTypeToString (const uint8_t& flags, const std::string& delimiter)
+TcpOptionMpTcpMain::SubTypeToString (const uint16_t& flags, const std::string& delimiter)
 {
-  static const char* flagNames[8] = {
+  static const char* flagNames[9] = {
     "CAPABLE",
     "JOIN",
     "DSS",
@@ -95,12 +93,13 @@ TcpOptionMpTcpMain::SubTypeToString (const uint8_t& flags, const std::string& de
     "REM_ADDR",
     "CHANGE_PRIORITY",
     "MP_FAIL",
-    "MP_FASTCLOSE"
+    "MP_FASTCLOSE",
+    "MP_TCPRST"
   };
 
   std::string flagsDescription = "";
 
-  for (int i = 0; i < 8; ++i)
+  for (int i = 0; i < 9; ++i)
     {
       if ( flags & (1 << i) )
         {
@@ -137,6 +136,8 @@ TcpOptionMpTcpMain::CreateMpTcpOption (const uint8_t& subtype)
       return CreateObject<TcpOptionMpTcpRemoveAddress>();
     case MP_ADD_ADDR:
       return CreateObject<TcpOptionMpTcpAddAddress>();
+    case MP_TCPRST:
+      return CreateObject<TcpOptionMpTcpReset>();
     default:
       break;
     }
@@ -173,7 +174,8 @@ TcpOptionMpTcpCapable::TcpOptionMpTcpCapable ()
     m_flags ( HMAC_SHA1 ),
     m_senderKey (0),
     m_remoteKey (0),
-    m_length (12)
+    m_dataLength (0),
+    m_length (4)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -202,13 +204,15 @@ TcpOptionMpTcpCapable::GetInstanceTypeId (void) const
 bool
 TcpOptionMpTcpCapable::operator== (const TcpOptionMpTcpCapable& opt) const
 {
-  return (GetPeerKey () == opt.GetPeerKey () && GetSenderKey () == opt.GetSenderKey () );
+  return (GetPeerKey () == opt.GetPeerKey () && GetSenderKey () == opt.GetSenderKey ()
+          && GetVersion () == opt.GetVersion () && GetDataLength () == opt.GetDataLength ());
 }
 
 void
 TcpOptionMpTcpCapable::SetSenderKey (const uint64_t& senderKey)
 {
   NS_LOG_FUNCTION (this);
+  m_length = std::max<uint32_t> (m_length, 12);
   m_senderKey = senderKey;
 }
 
@@ -216,20 +220,69 @@ void
 TcpOptionMpTcpCapable::SetPeerKey (const uint64_t& remoteKey)
 {
   NS_LOG_FUNCTION (this);
-  m_length = 20;
+  m_length = std::max<uint32_t> (m_length, 20);
   m_remoteKey = remoteKey;
 }
 
+void
+TcpOptionMpTcpCapable::SetDataLength (uint16_t length)
+{
+  NS_LOG_FUNCTION (this << length);
+  NS_ASSERT_MSG (m_version >= 1, "Only version 1 carries data in MP_CAPABLE");
+  NS_ASSERT_MSG (HasReceiverKey (), "Data is carried by the third ACK only");
+  m_length = 22;
+  m_dataLength = length;
+}
+
+bool
+TcpOptionMpTcpCapable::HasDataLength (void) const
+{
+  return m_length >= 22;
+}
+
+uint16_t
+TcpOptionMpTcpCapable::GetDataLength (void) const
+{
+  return m_dataLength;
+}
+
+void
+TcpOptionMpTcpCapable::SetVersion (uint8_t version)
+{
+  NS_ASSERT (version <= 1);
+  m_version = version;
+}
+
+uint8_t
+TcpOptionMpTcpCapable::GetFlags (void) const
+{
+  return m_flags;
+}
+
+void
+TcpOptionMpTcpCapable::SetFlags (uint8_t flags)
+{
+  m_flags = flags;
+}
+
 void
 TcpOptionMpTcpCapable::Print (std::ostream &os) const
 {
   os << "MP_CAPABLE:"
-     << " flags=" << (int)m_flags << "]"
-     << " Sender's Key :[" << GetSenderKey () << "]";
+     << " version=" << (int)m_version
+     << " flags=" << (int)m_flags << "]";
+  if ( HasSenderKey () )
+    {
+      os << " Sender's Key :[" << GetSenderKey () << "]";
+    }
   if ( HasReceiverKey () )
     {
       os << " Peer's Key [" << GetPeerKey () << "]";
     }
+  if ( HasDataLength () )
+    {
+      os << " Data-Level Length [" << GetDataLength () << "]";
+    }
 
 }
 
@@ -246,29 +299,50 @@ TcpOptionMpTcpCapable::Serialize (Buffer::Iterator i) const
 
   i.WriteU8 ( (GetSubType () << 4) + (0x0f & GetVersion ()) ); // Kind
   i.WriteU8 ( m_flags ); //
-  i.WriteHtonU64 ( GetSenderKey () );
+  if ( HasSenderKey () )
+    {
+      i.WriteHtonU64 ( GetSenderKey () );
+    }
   if ( HasReceiverKey () )
     {
       i.WriteHtonU64 ( GetPeerKey () );
     }
+  if ( HasDataLength () )
+    {
+      i.WriteHtonU16 ( GetDataLength () );
+    }
 }
 
 uint32_t
 TcpOptionMpTcpCapable::Deserialize (Buffer::Iterator i)
 {
   uint32_t length = TcpOptionMpTcpMain::DeserializeRef (i);
-  NS_ASSERT ( length == 12 || length == 20 );
+  NS_ASSERT ( length == 4 || length == 12 || length == 20 || length == 22 || length == 24 );
 
   uint8_t subtype_and_version = i.ReadU8 ();
   NS_ASSERT ( subtype_and_version >> 4 == GetSubType () );
+  m_version = subtype_and_version & 0x0f;
   m_flags = i.ReadU8 ();
 
-  SetSenderKey ( i.ReadNtohU64 () );
-
-  if (length == 20)
+  if (length >= 12)
+    {
+      SetSenderKey ( i.ReadNtohU64 () );
+    }
+  if (length >= 20)
     {
       SetPeerKey ( i.ReadNtohU64 () );
     }
+  if (length >= 22)
+    {
+      m_dataLength = i.ReadNtohU16 ();
+      m_length = 22;
+    }
+  if (length == 24)
+    {
+      // DSS checksums are not modeled
+      i.ReadNtohU16 ();
+      m_length = 24;
+    }
   return length;
 }
 
@@ -281,7 +355,7 @@ TcpOptionMpTcpCapable::GetSerializedSize (void) const
 uint8_t
 TcpOptionMpTcpCapable::GetVersion (void) const
 {
-  return 0;
+  return m_version;
 }
 
 uint64_t
@@ -299,7 +373,13 @@ TcpOptionMpTcpCapable::GetPeerKey (void) const
 bool
 TcpOptionMpTcpCapable::HasReceiverKey (void) const
 {
-  return GetSerializedSize () == 20;
+  return GetSerializedSize () >= 20;
+}
+
+bool
+TcpOptionMpTcpCapable::HasSenderKey (void) const
+{
+  return GetSerializedSize () >= 12;
 }
 
 /////////////////////////////////////////////////////////
@@ -436,7 +516,7 @@ uint32_t
 TcpOptionMpTcpJoin::GetNonce () const
 {
   NS_ASSERT_MSG (m_mode & (Syn | SynAck), "Nonce only available in Syn and SynAck modes");
-  return m_buffer[0];
+  return (m_mode == Syn) ? m_buffer[1] : m_buffer[2];
 }
 
 void
@@ -487,11 +567,8 @@ TcpOptionMpTcpJoin::Serialize (Buffer::Iterator i) const
       i.WriteHtonU32 ( GetNonce () );
       break;
     case Ack:
-      // +=4 cos' amount of bytes we write
-      for (int j = 0; j < m_mode / 4 - 1; j++)
-        {
-          i.WriteHtonU32 ( m_buffer[j]);
-        }
+      // the HMAC is kept as a byte string
+      i.Write ( (const uint8_t*)m_buffer, 20);
       break;
     default:
       NS_FATAL_ERROR("Unhandled case");
@@ -502,7 +579,7 @@ const uint8_t*
 TcpOptionMpTcpJoin::GetHmac () const
 {
   NS_ASSERT_MSG (m_mode == Ack, "Only available in Ack mode");
-  return 0;
+  return (const uint8_t*)m_buffer;
 }
 
 uint32_t
@@ -539,7 +616,8 @@ TcpOptionMpTcpJoin::Deserialize (Buffer::Iterator i)
 void
 TcpOptionMpTcpJoin::SetHmac (uint8_t hmac[20])
 {
-  NS_LOG_ERROR ("Not implemented");
+  NS_ASSERT_MSG (m_mode == Ack, "Only available in Ack mode");
+  std::memcpy (m_buffer, hmac, 20);
 }
 
 uint32_t
@@ -573,13 +651,14 @@ TcpOptionMpTcpJoin::GetTruncatedHmac () const
 //// MP_DSS
 TcpOptionMpTcpDSS::TcpOptionMpTcpDSS ()
   : TcpOptionMpTcp (),
-    m_hasChecksum (false),
-    m_checksum (0),
-    m_flags (0),
-    m_dataAck (0),
-    m_dsn (0),
-    m_ssn (0),
-    m_dataLevelLength (0)
+    MpTcpDss ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpOptionMpTcpDSS::TcpOptionMpTcpDSS (const MpTcpDss& dss)
+  : TcpOptionMpTcp (),
+    MpTcpDss (dss)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -605,291 +684,28 @@ TcpOptionMpTcpDSS::GetInstanceTypeId (void) const
   return TcpOptionMpTcpDSS::GetTypeId ();
 }
 
-void
-TcpOptionMpTcpDSS::TruncateDSS(bool truncate)
-{
-  NS_ASSERT_MSG(m_flags & DSNMappingPresent, "Call it only after setting the mapping");
-
-  if (truncate)
-    { 
-      m_flags &=  ~(0xff & DSNOfEightBytes);
-    }
-  else
-   {
-     m_flags |= DSNOfEightBytes;
-   }
-}
-
-void
-TcpOptionMpTcpDSS::SetMapping (uint64_t headDsn, uint32_t headSsn, uint16_t length, bool enable_dfin)
-{
-  NS_ASSERT_MSG ( !(m_flags & DataFin), "For now you can't set mapping after enabling datafin");
-  m_dsn = headDsn;
-  m_ssn = headSsn;
-  // += in case there is a datafin
-  m_dataLevelLength = length;
-  m_flags |= DSNMappingPresent;
-
-  if(enable_dfin)
-  {
-    m_flags |= DataFin;
-  }
-}
-
-void
-TcpOptionMpTcpDSS::GetMapping (uint64_t& dsn, uint32_t& ssn, uint16_t& length) const
-{
-  NS_ASSERT ( (m_flags & DSNMappingPresent) && !IsInfiniteMapping () );
-  ssn = m_ssn;
-  dsn = m_dsn;
-  length = m_dataLevelLength;
-  if (GetFlags () & DataFin)
-    {
-      length--;
-    }
-}
-
 uint32_t
 TcpOptionMpTcpDSS::GetSerializedSize (void) const
 {
-  uint32_t len = GetSizeFromFlags (m_flags) + ((m_hasChecksum) ? 2 : 0);
-  return len;
-}
-
-uint64_t
-TcpOptionMpTcpDSS::GetDataAck (void) const
-{
-  NS_ASSERT_MSG ( m_flags & DataAckPresent, "Can't request DataAck value when DataAck flag was not set. Check for its presence first" );
-  return m_dataAck;
-}
-
-void
-TcpOptionMpTcpDSS::SetChecksum (const uint16_t& checksum)
-{
-  m_hasChecksum = checksum;
-}
-
-uint16_t
-TcpOptionMpTcpDSS::GetChecksum (void) const
-{
-  NS_ASSERT (m_hasChecksum);
-  return m_checksum;
+  return MpTcpDss::GetSerializedSize ();
 }
 
 void
 TcpOptionMpTcpDSS::Print (std::ostream& os) const
 {
-  os << " MP_DSS: ";
-  if (GetFlags () & DataAckPresent)
-    {
-      os << "Acknowledges [" << GetDataAck () << "] ";
-      if (GetFlags () & DataAckOf8Bytes)
-        {
-          os << "(8bytes DACK)";
-        }
-    }
-
-  if (GetFlags () & DSNMappingPresent)
-    {
-
-      if (IsInfiniteMapping ())
-        {
-          os << " Infinite Mapping";
-        }
-      else if (GetFlags () & DataFin)
-        {
-          os << "Has datafin for seq [" << GetDataFinDSN () << "]";
-        }
-      os << " DSN:" << m_dsn << " length=" << m_dataLevelLength;
-      if (GetFlags () & DSNOfEightBytes)
-        {
-          os << "(8bytes mapping)";
-        }
-    }
+  MpTcpDss::Print (os);
 }
 
 void
 TcpOptionMpTcpDSS::Serialize (Buffer::Iterator i) const
 {
-  TcpOptionMpTcp::SerializeRef (i);
-  i.WriteU8 ( GetSubType () << 4);
-  i.WriteU8 ( m_flags );
-
-  if ( m_flags & DataAckPresent)
-    {
-      if ( m_flags & DataAckOf8Bytes)
-        {
-          i.WriteHtonU64 ( m_dataAck );
-        }
-      else
-        {
-          i.WriteHtonU32 ( static_cast<uint32_t>(m_dataAck) );
-        }
-    }
-
-  if (m_flags & DSNMappingPresent)
-    {
-
-      if ( m_flags & DSNOfEightBytes)
-        {
-          i.WriteHtonU64 ( m_dsn );
-        }
-      else
-        {
-          i.WriteHtonU32 ( m_dsn );
-        }
-
-      // Write relative SSN
-      i.WriteHtonU32 ( m_ssn );
-      i.WriteHtonU16 ( m_dataLevelLength );
-    }
-  if (m_hasChecksum)
-    {
-      i.WriteHtonU16 ( m_checksum );
-    }
-}
-
-uint32_t
-TcpOptionMpTcpDSS::GetSizeFromFlags (uint16_t flags)
-{
-  uint32_t length = 4;
-
-  if ( flags & DataAckPresent)
-    {
-      length += 4;
-      if ( flags & DataAckOf8Bytes)
-        {
-          length += 4;
-        }
-    }
-  if ( flags & DSNMappingPresent)
-    {
-      length += 10; /* data length (2) + ssn (4) + DSN min size (4) */
-      if ( flags & DSNOfEightBytes)
-        {
-          length += 4;
-        }
-    }
-  return length;
+  MpTcpDss::Serialize (i);
 }
 
 uint32_t
 TcpOptionMpTcpDSS::Deserialize (Buffer::Iterator i)
 {
-  uint32_t length =  TcpOptionMpTcpMain::DeserializeRef (i);
-  uint8_t subtype_and_reserved = i.ReadU8 ();
-
-  NS_ASSERT ( (subtype_and_reserved >> 4) == GetSubType ()  );
-  m_flags = i.ReadU8 ();
-  uint32_t shouldBeLength = GetSizeFromFlags (m_flags);
-  NS_ASSERT (shouldBeLength == length || shouldBeLength + 2 == length);
-
-  if (shouldBeLength + 2 == length)
-    {
-      m_hasChecksum = true;
-    }
-  if ( m_flags & DataAckPresent)
-    {
-      if ( m_flags & DataAckOf8Bytes)
-        {
-          m_dataAck = i.ReadNtohU64 ();
-        }
-      else
-        {
-          m_dataAck = i.ReadNtohU32 ();
-        }
-    }
-  // Read mapping
-  if (m_flags & DSNMappingPresent)
-    {
-
-      if ( m_flags & DSNOfEightBytes)
-        {
-          m_dsn = i.ReadNtohU64 ();
-        }
-      else
-        {
-          m_dsn = i.ReadNtohU32 ();
-        }
-      m_ssn = i.ReadNtohU32 ();
-      m_dataLevelLength = i.ReadNtohU16 ();
-    }
-
-  if (m_hasChecksum)
-    {
-      m_checksum = i.ReadNtohU16 ( );
-    }
-
-  return length;
-}
-
-uint8_t
-TcpOptionMpTcpDSS::GetFlags (void) const
-{
-  return m_flags;
-}
-
-/*
-Note that when the DATA_FIN is not attached to a TCP segment
-containing data, the Data Sequence Signal MUST have a subflow
-sequence number of 0, a Data-Level Length of 1, and the data sequence
-number that corresponds with the DATA_FIN itself
-*/
-bool
-TcpOptionMpTcpDSS::DataFinMappingOnly () const
-{
-  return (m_flags & DataFin) && m_dataLevelLength == 1 && m_ssn == 0;
-}
-
-bool
-TcpOptionMpTcpDSS::IsInfiniteMapping () const
-{
-  // The checksum, in such a case, will also be set to zero
-  return (GetFlags () & DSNMappingPresent) && m_dataLevelLength == 0;
-}
-
-uint64_t
-TcpOptionMpTcpDSS::GetDataFinDSN () const
-{
-  NS_ASSERT ( GetFlags () & DataFin);
-
-  if (DataFinMappingOnly ())
-    {
-      return m_dsn;
-    }
-  else
-    {
-      return m_dsn + m_dataLevelLength;
-    }
-}
-
-void
-TcpOptionMpTcpDSS::SetDataAck (const uint64_t& dack, const bool& send_as_32bits)
-{
-  NS_LOG_LOGIC (this << dack);
-
-  m_dataAck = dack;
-  m_flags |= DataAckPresent;
-
-  if (send_as_32bits)
-    {
-      m_dataAck = TRUNC_TO_32 (m_dataAck);
-    }
-  else
-    {
-      m_flags |= DataAckOf8Bytes;
-    }
-}
-
-bool
-TcpOptionMpTcpDSS::operator== (const TcpOptionMpTcpDSS& opt) const
-{
-  bool ret = m_flags == opt.m_flags;
-  ret &= opt.m_checksum == m_checksum;
-  ret &= opt.m_dsn == m_dsn;
-  ret &= opt.m_ssn == m_ssn;
-  ret &= opt.m_dataAck == m_dataAck;
-  return ( ret );
+  return MpTcpDss::Deserialize (i);
 }
 
 ///////////////////////////////////////:
@@ -898,7 +714,10 @@ TcpOptionMpTcpDSS::operator== (const TcpOptionMpTcpDSS& opt) const
 TcpOptionMpTcpAddAddress::TcpOptionMpTcpAddAddress ()
   : TcpOptionMpTcp (),
     m_addressVersion (0),
-    m_addrId (0)
+    m_addrId (0),
+    m_version (0),
+    m_echo (false),
+    m_hmac (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -950,7 +769,8 @@ TcpOptionMpTcpAddAddress::SetAddress (const Address& _address, uint8_t addrId)
 void
 TcpOptionMpTcpAddAddress::Print (std::ostream &os) const
 {
-  os << "ADD_ADDR: address id=" << GetAddressId ()
+  os << "ADD_ADDR: address id=" << (int)GetAddressId ()
+     << (m_echo ? " echo" : "")
      << " associated to IP:port [";
   if (m_addressVersion == 4)
     {
@@ -959,7 +779,8 @@ TcpOptionMpTcpAddAddress::Print (std::ostream &os) const
     }
   else
     {
-      os << m_address6;
+      os << m_address6 << ":";
+      os << m_port;
     }
   os << "]";
 }
@@ -984,6 +805,64 @@ TcpOptionMpTcpAddAddress::GetAddressId () const
   return m_addrId;
 }
 
+uint8_t
+TcpOptionMpTcpAddAddress::GetVersion (void) const
+{
+  return m_version;
+}
+
+void
+TcpOptionMpTcpAddAddress::SetEcho (bool echo)
+{
+  m_version = 1;
+  m_echo = echo;
+}
+
+bool
+TcpOptionMpTcpAddAddress::IsEcho (void) const
+{
+  return m_echo;
+}
+
+void
+TcpOptionMpTcpAddAddress::SetTruncatedHmac (uint64_t hmac)
+{
+  m_version = 1;
+  m_echo = false;
+  m_hmac = hmac;
+}
+
+uint64_t
+TcpOptionMpTcpAddAddress::GetTruncatedHmac (void) const
+{
+  return m_hmac;
+}
+
+uint64_t
+TcpOptionMpTcpAddAddress::ComputeTruncatedHmac (mptcp_crypto_alg_t alg, uint64_t senderKey,
+                                                uint64_t receiverKey) const
+{
+  NS_ASSERT_MSG (m_addressVersion == 4 || m_addressVersion == 6, "Set an IP before computing the HMAC");
+  // Address ID + Address + Port
+  uint8_t msg[1 + 16 + 2];
+  uint32_t size = 0;
+
+  msg[size++] = m_addrId;
+  if (m_addressVersion == 4)
+    {
+      m_address.Serialize (msg + size);
+      size += 4;
+    }
+  else
+    {
+      m_address6.GetBytes (msg + size);
+      size += 16;
+    }
+  msg[size++] = m_port >> 8;
+  msg[size++] = m_port & 0xff;
+  return GenerateAddAddressHmac (alg, senderKey, receiverKey, msg, size);
+}
+
 void
 TcpOptionMpTcpAddAddress::Serialize (Buffer::Iterator i) const
 {
@@ -991,7 +870,14 @@ TcpOptionMpTcpAddAddress::Serialize (Buffer::Iterator i) const
 
   NS_ASSERT_MSG (m_addressVersion == 4 || m_addressVersion == 6, "Set an IP before serializing");
 
-  i.WriteU8 ( (GetSubType () << 4) + (uint8_t) m_addressVersion );
+  if (m_version == 0)
+    {
+      i.WriteU8 ( (GetSubType () << 4) + (uint8_t) m_addressVersion );
+    }
+  else
+    {
+      i.WriteU8 ( (GetSubType () << 4) + (m_echo ? 1 : 0) );
+    }
   i.WriteU8 ( GetAddressId () );
 
   if (m_addressVersion == 4)
@@ -1011,30 +897,69 @@ TcpOptionMpTcpAddAddress::Serialize (Buffer::Iterator i) const
     }
 
   i.WriteHtonU16 (m_port);
+  if (m_version == 1 && !m_echo)
+    {
+      i.WriteHtonU64 (m_hmac);
+    }
 }
 
 uint32_t
 TcpOptionMpTcpAddAddress::Deserialize (Buffer::Iterator i)
 {
   uint32_t length =  TcpOptionMpTcpMain::DeserializeRef (i);
-  NS_ASSERT ( length == 10 || length == 22 );
 
   uint8_t subtype_and_ipversion = i.ReadU8 ();
   NS_ASSERT ( subtype_and_ipversion >> 4 == GetSubType ()  );
 
-  m_addressVersion = subtype_and_ipversion  & 0x0f;
-  NS_ASSERT_MSG (m_addressVersion == 4 || m_addressVersion == 6, "Unsupported address version");
+  uint8_t nibble = subtype_and_ipversion  & 0x0f;
+  uint32_t remaining = length - 4;
+  if (nibble == 4 || nibble == 6)
+    {
+      // RFC 6824
+      NS_ASSERT ( length == 10 || length == 22 );
+      m_version = 0;
+      m_echo = false;
+      m_addressVersion = nibble;
+    }
+  else
+    {
+      // RFC 8684: the IP version depends on the length
+      m_version = 1;
+      m_echo = nibble & 1;
+      if (!m_echo)
+        {
+          NS_ASSERT (remaining > 8);
+          remaining -= 8;
+        }
+      NS_ASSERT_MSG (remaining == 4 || remaining == 6 || remaining == 16 || remaining == 18,
+                     "Wrong ADD_ADDR length " << length);
+      m_addressVersion = (remaining < 16) ? 4 : 6;
+    }
 
   m_addrId =  i.ReadU8 ();
 
+  m_port = 0;
   if ( m_addressVersion == 4)
     {
       m_address.Set ( i.ReadNtohU32 () );
-      m_port = i.ReadNtohU16 () ; 
+      if (remaining == 6)
+        {
+          m_port = i.ReadNtohU16 () ;
+        }
     }
   else
     {
-      NS_FATAL_ERROR ("IPv6 not supported yet");
+      uint8_t buf[16];
+      i.Read (buf, 16);
+      m_address6.Set (buf);
+      if (remaining == 18)
+        {
+          m_port = i.ReadNtohU16 ();
+        }
+    }
+  if (m_version == 1 && !m_echo)
+    {
+      m_hmac = i.ReadNtohU64 ();
     }
   return length;
 }
@@ -1048,12 +973,13 @@ TcpOptionMpTcpAddAddress::GetAddressVersion (void) const
 uint32_t
 TcpOptionMpTcpAddAddress::GetSerializedSize (void) const
 {
+  uint32_t hmacSize = (m_version == 1 && !m_echo) ? 8 : 0;
   if ( GetAddressVersion () == 4)
     {
-      return 10;
+      return 10 + hmacSize;
     }
   NS_ASSERT_MSG ( GetAddressVersion ()  == 6,"Wrong IP version. Maybe you didn't set an address to the MPTCP ADD_ADDR option ?");
-  return 22;
+  return 22 + hmacSize;
 }
 
 bool
@@ -1062,6 +988,9 @@ TcpOptionMpTcpAddAddress::operator== (const TcpOptionMpTcpAddAddress& opt) const
   return (GetAddressId () == opt.GetAddressId ()
           && m_address == opt.m_address
           && m_address6 == opt.m_address6
+          && m_version == opt.m_version
+          && m_echo == opt.m_echo
+          && m_hmac == opt.m_hmac
           );
 }
 
@@ -1096,7 +1025,7 @@ TcpOptionMpTcpRemoveAddress::GetInstanceTypeId (void) const
 }
 
 void
-TcpOptionMpTcpRemoveAddress::GetAddresses (std::vector<uint8_t>& addresses)
+TcpOptionMpTcpRemoveAddress::GetAddresses (std::vector<uint8_t>& addresses) const
 {
   addresses = m_addressesId;
 }
@@ -1160,7 +1089,7 @@ TcpOptionMpTcpRemoveAddress::Print (std::ostream &os) const
     it++
     )
     {
-      os << *it << "/";
+      os << static_cast<int> (*it) << "/";
     }
 }
 
@@ -1211,7 +1140,7 @@ TcpOptionMpTcpChangePriority::Print (std::ostream &os) const
 
   if ( EmbeddedAddressId () )
     {
-      os << m_addrId;
+      os << static_cast<int> (m_addrId);
     }
   else
     {
@@ -1304,6 +1233,22 @@ TcpOptionMpTcpChangePriority::operator== (const TcpOptionMpTcpChangePriority& op
 ///////////////////////////////////////////////////
 //// MP_FASTCLOSE to totally stop a flow of data
 ////
+TypeId
+TcpOptionMpTcpFastClose::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpOptionMpTcpFastClose")
+    .SetParent<TcpOptionMpTcpMain> ()
+    .AddConstructor<TcpOptionMpTcpFastClose> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpOptionMpTcpFastClose::GetInstanceTypeId (void) const
+{
+  return TcpOptionMpTcpFastClose::GetTypeId ();
+}
+
 TcpOptionMpTcpFastClose::TcpOptionMpTcpFastClose ()
   : TcpOptionMpTcp (),
     m_peerKey (0)
@@ -1348,6 +1293,7 @@ TcpOptionMpTcpFastClose::Serialize (Buffer::Iterator i) const
   TcpOptionMpTcp::SerializeRef (i);
 
   i.WriteU8 ( (GetSubType () << 4) + (uint8_t)0 );
+  i.WriteU8 ( 0 ); // reserved
   i.WriteHtonU64 ( GetPeerKey () );
 }
 
@@ -1359,6 +1305,7 @@ TcpOptionMpTcpFastClose::Deserialize (Buffer::Iterator i)
   NS_ASSERT ( length == GetSerializedSize() );
   uint8_t subtype_and_flags = i.ReadU8 ();
   NS_ASSERT ( subtype_and_flags >> 4 == GetSubType ()  );
+  i.ReadU8 (); // reserved
 
   SetPeerKey ( i.ReadNtohU64 () );
   return GetSerializedSize();
@@ -1373,6 +1320,22 @@ TcpOptionMpTcpFastClose::GetSerializedSize (void) const
 ///////////////////////////////////////////////////
 //// MP_FAIL to totally stop a flow of data
 ////
+TypeId
+TcpOptionMpTcpFail::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpOptionMpTcpFail")
+    .SetParent<TcpOptionMpTcpMain> ()
+    .AddConstructor<TcpOptionMpTcpFail> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpOptionMpTcpFail::GetInstanceTypeId (void) const
+{
+  return TcpOptionMpTcpFail::GetTypeId ();
+}
+
 TcpOptionMpTcpFail::TcpOptionMpTcpFail ()
   : TcpOptionMpTcp (),
     m_dsn (0)
@@ -1416,6 +1379,7 @@ TcpOptionMpTcpFail::Serialize (Buffer::Iterator i) const
   TcpOptionMpTcp::SerializeRef (i);
 
   i.WriteU8 ( (GetSubType () << 4) + (uint8_t)0 );
+  i.WriteU8 ( 0 ); // reserved
   i.WriteHtonU64 ( GetDSN () );
 }
 
@@ -1427,6 +1391,7 @@ TcpOptionMpTcpFail::Deserialize (Buffer::Iterator i)
 
   uint8_t subtype_and_flags = i.ReadU8 ();
   NS_ASSERT ( subtype_and_flags >> 4 == GetSubType ()  );
+  i.ReadU8 (); // reserved
   SetDSN ( i.ReadNtohU64 () );
 
   return 12;
@@ -1438,4 +1403,103 @@ TcpOptionMpTcpFail::GetSerializedSize (void) const
   return 12;
 }
 
+///////////////////////////////////////////////////
+//// MP_TCPRST to explain why a subflow is reset
+////
+TypeId
+TcpOptionMpTcpReset::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpOptionMpTcpReset")
+    .SetParent<TcpOptionMpTcpMain> ()
+    .AddConstructor<TcpOptionMpTcpReset> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpOptionMpTcpReset::GetInstanceTypeId (void) const
+{
+  return TcpOptionMpTcpReset::GetTypeId ();
+}
+
+TcpOptionMpTcpReset::TcpOptionMpTcpReset ()
+  : TcpOptionMpTcp (),
+    m_flags (0),
+    m_reason (Unspecified)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpOptionMpTcpReset::~TcpOptionMpTcpReset (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TcpOptionMpTcpReset::SetFlags (uint8_t flags)
+{
+  NS_ASSERT_MSG (flags < 16, "Flags are encoded on 4 bits");
+  m_flags = flags;
+}
+
+uint8_t
+TcpOptionMpTcpReset::GetFlags (void) const
+{
+  return m_flags;
+}
+
+void
+TcpOptionMpTcpReset::SetReason (uint8_t reason)
+{
+  m_reason = reason;
+}
+
+uint8_t
+TcpOptionMpTcpReset::GetReason (void) const
+{
+  return m_reason;
+}
+
+void
+TcpOptionMpTcpReset::Print (std::ostream &os) const
+{
+  os << "MP_TCPRST: reason=" << (int)GetReason ()
+     << ((GetFlags () & Transient) ? " transient" : "");
+}
+
+bool
+TcpOptionMpTcpReset::operator== (const TcpOptionMpTcpReset& opt) const
+{
+  return (GetFlags () == opt.GetFlags () && GetReason () == opt.GetReason ());
+}
+
+void
+TcpOptionMpTcpReset::Serialize (Buffer::Iterator i) const
+{
+  TcpOptionMpTcp::SerializeRef (i);
+
+  i.WriteU8 ( (GetSubType () << 4) + (0x0f & GetFlags ()) );
+  i.WriteU8 ( GetReason () );
+}
+
+uint32_t
+TcpOptionMpTcpReset::Deserialize (Buffer::Iterator i)
+{
+  uint32_t length = TcpOptionMpTcpMain::DeserializeRef (i);
+  NS_ASSERT ( length == 4 );
+
+  uint8_t subtype_and_flags = i.ReadU8 ();
+  NS_ASSERT ( subtype_and_flags >> 4 == GetSubType ()  );
+  SetFlags ( subtype_and_flags & 0x0f );
+  SetReason ( i.ReadU8 () );
+
+  return 4;
+}
+
+uint32_t
+TcpOptionMpTcpReset::GetSerializedSize (void) const
+{
+  return 4;
+}
+
 } // namespace ns3
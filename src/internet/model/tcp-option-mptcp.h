@@ -48,6 +48,10 @@ namespace ns3 {
  *
  * MPTCP signaling messages are all encoded under the same TCP option number 30.
  * MPTCP then uses a subtype
+ *
+ * Both version 0 (\RFC{6824}) and version 1 (\RFC{8684}) encodings are
+ * supported: the version negotiated in MP_CAPABLE decides which one is sent,
+ * the parsers accept both.
  */
 class TcpOptionMpTcpMain : public TcpOption
 {
@@ -64,7 +68,8 @@ public:
     MP_REMOVE_ADDR,
     MP_PRIO,
     MP_FAIL,
-    MP_FASTCLOSE
+    MP_FASTCLOSE,
+    MP_TCPRST       //!< \RFC{8684} only
   };
 
   TcpOptionMpTcpMain (void);
@@ -79,7 +84,7 @@ public:
    * \return Human readable string of subtypes
    */
   static std::string
-  SubTypeToString (const uint8_t& flags, const std::string& delimiter);
+  SubTypeToString (const uint16_t& flags, const std::string& delimiter);
 
   /**
    * \brief Calls CreateObject with the template parameter with the class matching the given subtype
@@ -173,6 +178,20 @@ ACK + MP_CAPABLE      ->
 
 Here is the format as defined in \RFC{6824}, flags C to H refer to the crypto algorithm.
 Only sha1 is defined and supported in the standard (same for ns3).
+
+\RFC{8684} (version 1) drops the key from the SYN (length 4), the H bit selects
+HMAC-SHA256 and the third ACK may carry the first data segment, in which case
+the option ends with the Data-Level Length of the payload (length 22):
+\verbatim
+Host A (client)                         Host B (server)
+MP_CAPABLE            ->
+[flags]
+                    <-                MP_CAPABLE
+                                      [B's key, flags]
+ACK + MP_CAPABLE (+ data) ->
+[A's key, B's key, flags, (data-level length)]
+\endverbatim
+
 \verbatim
 
  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
@@ -186,7 +205,9 @@ Only sha1 is defined and supported in the standard (same for ns3).
 |                  Option Receiver's Key (64 bits)              |
 |                     (if option Length == 20)                  |
 |                                                               |
-+---------------------------------------------------------------+
++-------------------------------+-------------------------------+
+|  Data-Level Length (16 bits)  |  Checksum (16 bits, optional) |
++-------------------------------+-------------------------------+
 \endverbatim
  */
 class TcpOptionMpTcpCapable : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_CAPABLE>
@@ -198,14 +219,39 @@ public:
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
 
+  /**
+   * Flags of the MP_CAPABLE option
+   */
+  enum Flags
+  {
+    HmacAlgorithm     = 0x01, /**< H bit: HMAC-SHA1 in version 0, HMAC-SHA256 in version 1 */
+    NoJoinToSource    = 0x20, /**< C bit (\RFC{8684}): do not open subflows towards the source address */
+    Extensibility     = 0x40, /**< B bit */
+    ChecksumRequired  = 0x80  /**< A bit */
+  };
+
   bool operator== (const TcpOptionMpTcpCapable&) const;
 
   /**
-   * \brief Only version 0 is standardized so far
-   * \return 0
+   * \return MPTCP version proposed (SYN) or selected (SYN/ACK, ACK)
    */
   virtual uint8_t GetVersion (void) const;
 
+  /**
+   * \param version 0 for \RFC{6824}, 1 for \RFC{8684}
+   */
+  virtual void SetVersion (uint8_t version);
+
+  /**
+   * \return Flags A to H
+   */
+  virtual uint8_t GetFlags (void) const;
+
+  /**
+   * \param flags Flags A to H
+   */
+  virtual void SetFlags (uint8_t flags);
+
   /**
    * \note MPTCP Checksums are not used in ns3
    * \return True if checksum is required
@@ -232,6 +278,30 @@ public:
    */
   virtual bool HasReceiverKey (void) const;
 
+  /**
+   * \brief A version 1 SYN carries no key
+   * \return True if sender key available
+   */
+  virtual bool HasSenderKey (void) const;
+
+  /**
+   * \brief Version 1 only: the option covers the payload of the segment
+   *
+   * The payload is mapped to the first byte of the data stream, hence no DSS is needed.
+   * \param length Data-Level Length, i.e., number of bytes of the payload
+   */
+  virtual void SetDataLength (uint16_t length);
+
+  /**
+   * \return True if the option maps the payload of the segment
+   */
+  virtual bool HasDataLength (void) const;
+
+  /**
+   * \return Data-Level Length
+   */
+  virtual uint16_t GetDataLength (void) const;
+
   /**
    * \return Sender's key
    */
@@ -254,6 +324,7 @@ protected:
   uint8_t m_flags;      /**< 8 bits bitfield (unused in the standard for now) */
   uint64_t m_senderKey; /**< Sender key */
   uint64_t m_remoteKey; /**< Peer key */
+  uint16_t m_dataLength; /**< Data-Level Length (version 1) */
   uint32_t m_length;    /**< Stores the length of the option */
 
 private:
@@ -410,7 +481,7 @@ public:
   /**
    * \brief Returns hmac generated by the peer.
    * \warning Available in Ack mode only
-   * \return null for now (not implemented)
+   * \return the 160 bits HMAC carried by the third ACK
    */
   virtual const uint8_t* GetHmac (void) const;
 
@@ -418,7 +489,6 @@ public:
    * \brief Available only in Ack mode. Sets Hmac computed from the nonce, tokens previously exchanged
    * \warning Available in Ack mode only
    * \param hmac
-   * \todo not implemented
    */
   virtual void SetHmac (uint8_t hmac[20]);
 
@@ -514,122 +584,27 @@ private:
 
 \endverbatim
 */
-class TcpOptionMpTcpDSS : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_DSS>
+class TcpOptionMpTcpDSS : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_DSS>,
+                          public MpTcpDss
 {
 
 public:
-  /**
-   * \brief Each value represents the offset of a flag in LSB order
-   * \see TcpOptionMpTcpDSS
-   */
-  enum FLAG
-  {
-    DataAckPresent  = 1,       //!< matches the "A" in previous packet format
-    DataAckOf8Bytes = 2,       //!< a
-    DSNMappingPresent = 4,     //!< M bit
-    DSNOfEightBytes   = 8,     //!< m bit
-    DataFin           = 16,    //!< F . set to indicate end of communication
-    CheckSumPresent   = 32     //!< Not computed for now
-
-  };
-
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
 
   TcpOptionMpTcpDSS (void);
-  virtual ~TcpOptionMpTcpDSS (void);
-
-  /**
-   * \brief Upon detecting an error, an MPTCP connection can fallback to legacy TCP.
-   * \return False (not implemented)
-   */
-  virtual bool IsInfiniteMapping () const;
-
-  /**
-   * \brief when DataFin is set, the data level length is increased by one.
-   * \return True if the mapping present is just because of the datafin
-   */
-  virtual bool DataFinMappingOnly () const;
-
-  virtual void TruncateDSS(bool truncate);
-
-  /**
-   * \brief This returns a copy
-   * \warning Asserts if flags
-   * \
-   */
-  virtual void GetMapping (uint64_t& dsn, uint32_t& ssn, uint16_t& length) const;
-
-  /**
-   * \brief
-   * \param trunc_to_32bits Set to true to send a 32bit DSN
-   * \warn Mapping can be set only once, otherwise it will crash ns3
-   */
-  virtual void SetMapping (uint64_t headDsn, uint32_t headSsn, uint16_t length, bool enable_dfin);
-
-  /**
-   * \brief A DSS length depends on what content it embeds. This is defined by the flags.
-   * \return All flags
-   */
-  virtual uint8_t GetFlags (void) const;
-
-  virtual bool operator== (const TcpOptionMpTcpDSS&) const;
-
   /**
-   * \brief Set seq nb of acked data at MPTP level
-   * \param dack Sequence number of the dataack
-   * \param send_as_32bits Decides if the DACK should be sent as a 32 bits number
+   * \brief Wraps the content of an inline DSS
+   * \param dss content of the option
    */
-  virtual void SetDataAck (const uint64_t& dack, const bool& send_as_32bits = true);
-
-  /**
-   * \brief Get data ack value
-   * \warning  check the flags to know if the returned value is a 32 or 64 bits DSN
-   */
-  virtual uint64_t GetDataAck (void) const;
-
-  /**
-   * \brief Unimplemented
-   */
-  virtual void SetChecksum (const uint16_t&);
-
-  /**
-   * \brief Unimplemented
-   */
-  virtual uint16_t GetChecksum (void) const;
-
-  /**
-  * \return If DFIN is set, returns its associated DSN
-  *
-  * \warning check the flags to know if it returns a 32 or 64 bits DSN
-  */
-  virtual uint64_t GetDataFinDSN () const;
+  TcpOptionMpTcpDSS (const MpTcpDss& dss);
+  virtual ~TcpOptionMpTcpDSS (void);
 
   virtual void Print (std::ostream &os) const;
   virtual void Serialize (Buffer::Iterator ) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
   virtual uint32_t GetSerializedSize (void) const;
 
-  /**
-  * \brief the DSS option size can change a lot
-  * The DSS size depends if it embeds a DataAck, a mapping, in 32 bits
-  *  or in 64 bits. This can compute the size depending on the flags
-  * \param flags flags of the DSS option
-  */
-  static uint32_t GetSizeFromFlags (uint16_t flags);
-
-protected:
-
-  bool m_hasChecksum;   //!< true if checksums enabled
-  uint16_t m_checksum;  //!< valeu of the checksum
-  uint8_t m_flags;  //!< bitfield
-
-  // In fact for now we use only 32 LSB
-  uint64_t m_dataAck;           /**< Can be On 32 bits dependings on the flags **/
-  uint64_t m_dsn;               /**< Data Sequence Number (Can be On 32 bits dependings on the flags) */
-  uint32_t m_ssn;               /**< Subflow Sequence Number, always 32bits */
-  uint16_t m_dataLevelLength;   /**< Length of the mapping and/or +1 if DFIN */
-
 private:
   //! Defined and unimplemented to avoid misuse
   TcpOptionMpTcpDSS (const TcpOptionMpTcpDSS&);
@@ -651,6 +626,11 @@ private:
  * \note Though the port is optional in the RFC, ns3 implementation always include it, even if
  * it's 0 for the sake of simplicity.
  *
+ * In version 1 (\RFC{8684}) the IP version is deduced from the length and the
+ * nibble carries the E flag instead. The option is authenticated by the rightmost
+ * 64 bits of HMAC(Key=(Key-A+Key-B), Msg=(Address ID+Address+Port)) where A is
+ * the sender. The receiver echoes the option (E set, without HMAC) to acknowledge it.
+ *
  * Add Address (ADD_ADDR) option:
 \verbatim
                      1                   2                   3
@@ -662,6 +642,21 @@ private:
 +-------------------------------+-------------------------------+
 |   Port (2 octets, optional)   |
 +-------------------------------+
+\endverbatim
+
+Version 1:
+\verbatim
++---------------+---------------+-------+-------+---------------+
+|     Kind      |     Length    |Subtype|(rsv)|E|  Address ID   |
++---------------+---------------+-------+-------+---------------+
+|          Address (IPv4 - 4 octets / IPv6 - 16 octets)         |
++-------------------------------+-------------------------------+
+|   Port (2 octets, optional)   |                               |
++-------------------------------+                               |
+|                Truncated HMAC (8 octets, if E=0)              |
+|                               +-------------------------------+
+|                               |
++-------------------------------+
 \endverbatim
  */
 class TcpOptionMpTcpAddAddress : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_ADD_ADDR>
@@ -686,7 +681,6 @@ public:
   virtual bool operator== (const TcpOptionMpTcpAddAddress&) const;
 
   /**
-   * \note Only IPv4 is supported so far
    * \return IP version (i.e., 4 or 6)
    */
   virtual uint8_t GetAddressVersion (void) const;
@@ -708,6 +702,42 @@ public:
    */
   virtual uint8_t GetAddressId (void) const;
 
+  /**
+   * \return 0 for the \RFC{6824} encoding, 1 for the \RFC{8684} one
+   */
+  virtual uint8_t GetVersion (void) const;
+
+  /**
+   * \brief Version 1: the option acknowledges an ADD_ADDR of the peer
+   * \param echo True to send an echo, that carries no HMAC
+   */
+  virtual void SetEcho (bool echo);
+
+  /**
+   * \return True if the option is an echo
+   */
+  virtual bool IsEcho (void) const;
+
+  /**
+   * \brief Switches the option to the version 1 encoding
+   * \param hmac rightmost 64 bits of the HMAC
+   */
+  virtual void SetTruncatedHmac (uint64_t hmac);
+
+  /**
+   * \return The truncated HMAC carried by a version 1 option
+   */
+  virtual uint64_t GetTruncatedHmac (void) const;
+
+  /**
+   * \brief Computes the HMAC authenticating the advertised address
+   * \param alg The hmac algorithm
+   * \param senderKey Key of the host advertising the address
+   * \param receiverKey Key of the remote host
+   * \return rightmost 64 bits of the HMAC
+   */
+  uint64_t ComputeTruncatedHmac (mptcp_crypto_alg_t alg, uint64_t senderKey, uint64_t receiverKey) const;
+
   //! Inherited
   virtual void Print (std::ostream &os) const;
   virtual void Serialize (Buffer::Iterator start) const;
@@ -717,9 +747,12 @@ public:
 protected:
   uint8_t m_addressVersion; /**< IPversion (4 or 6) */
   uint8_t m_addrId;
+  uint8_t m_version;  //!< MPTCP version of the encoding
+  bool m_echo;        //!< E flag (version 1)
+  uint64_t m_hmac;    //!< Truncated HMAC (version 1)
   uint16_t m_port; /**< Optional value */ // changed from uint8_t to uint16_t
   Ipv4Address m_address;  /**< Advertised IPv4 address */
-  Ipv6Address m_address6; //!< unused
+  Ipv6Address m_address6; //!< Advertised IPv6 address
 
 private:
   //! Defined and unimplemented to avoid misuse
@@ -761,7 +794,7 @@ public:
    * As we do not know in advance the number of records, we pass a vector
    * \param Returns the addresses into a vector. Empty it before use.
    */
-  void GetAddresses (std::vector<uint8_t>& addresses);
+  void GetAddresses (std::vector<uint8_t>& addresses) const;
 
   /**
    * Append an association id to remove from peer memory
@@ -796,7 +829,6 @@ private:
  * This option is unidirectional, i.e, an emitter may ask not to receive data
  * on a subflow while transmitting on it.
  *
- * \warn This option is not taken into account by ns3 yet.
  * MP_PRIO option:
 \verbatim
                      1                   2                   3
@@ -817,7 +849,7 @@ public:
    */
   enum Flags
   {
-    Backup = 0 /**< Set this flag if you prefer not to receive data on path addressId*/
+    Backup = 1 /**< B bit (LSB), set it if you prefer not to receive data on path addressId*/
   };
 
   static TypeId GetTypeId (void);
@@ -887,7 +919,7 @@ private:
  *
  * For example, if the operating system is running out of resources, MPTCP could send an
  * MP_FASTCLOSE.
- * This should not be very useful in ns3 scenarii.
+ * In version 1 (\RFC{8684}), it is sent along with a RST on every subflow.
  *
  * MP_FASTCLOSE option:
 \verbatim
@@ -903,10 +935,13 @@ private:
 
 \endverbatim
 **/
-class TcpOptionMpTcpFastClose : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_PRIO>
+class TcpOptionMpTcpFastClose : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_FASTCLOSE>
 {
 
 public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
   TcpOptionMpTcpFastClose (void);
   virtual ~TcpOptionMpTcpFastClose (void);
   virtual bool operator== (const TcpOptionMpTcpFastClose&) const;
@@ -964,6 +999,9 @@ class TcpOptionMpTcpFail : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_FAIL>
 {
 
 public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
   TcpOptionMpTcpFail (void);
   virtual ~TcpOptionMpTcpFail (void);
 
@@ -994,6 +1032,90 @@ private:
   uint64_t m_dsn; /**< Last acked dsn */
 };
 
+/**
+ * \brief MP_TCPRST tells the peer why a subflow is reset (\RFC{8684} only)
+ *
+ * It is sent along with the TCP RST. The T flag tells whether the error is
+ * transient, i.e., whether the peer may try to reestablish the subflow.
+ *
+ * MP_TCPRST option:
+\verbatim
+                     1                   2                   3
+ 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
++---------------+---------------+-------+-----------------------+
+|     Kind      |    Length     |Subtype|U|V|W|T|    Reason     |
++---------------+---------------+-------+-----------------------+
+\endverbatim
+*/
+class TcpOptionMpTcpReset : public TcpOptionMpTcp<TcpOptionMpTcpMain::MP_TCPRST>
+{
+
+public:
+  /**
+   * Flags of the option
+   */
+  enum Flags
+  {
+    Transient = 1 /**< T bit, the subflow may be reestablished */
+  };
+
+  /**
+   * Reason codes
+   */
+  enum Reason
+  {
+    Unspecified = 0,          /**< Unspecified error */
+    MpTcpSpecific,            /**< MPTCP-specific error, e.g., authentication failure */
+    LackOfResources,          /**< Lack of resources */
+    AdministrativelyProhibited, /**< Administratively prohibited */
+    TooMuchOutstandingData,   /**< Too much outstanding data */
+    UnacceptablePerformance,  /**< Unacceptable performance */
+    MiddleboxInterference     /**< Middlebox interference */
+  };
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  TcpOptionMpTcpReset (void);
+  virtual ~TcpOptionMpTcpReset (void);
+
+  virtual bool operator== (const TcpOptionMpTcpReset& ) const;
+
+  /**
+   * \param flags U, V, W, T flags
+   */
+  virtual void SetFlags (uint8_t flags);
+
+  /**
+   * \return U, V, W, T flags
+   */
+  virtual uint8_t GetFlags (void) const;
+
+  /**
+   * \param reason Why the subflow is reset
+   */
+  virtual void SetReason (uint8_t reason);
+
+  /**
+   * \return Why the subflow is reset
+   */
+  virtual uint8_t GetReason (void) const;
+
+  //! Inherited
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual uint32_t GetSerializedSize (void) const;
+
+private:
+  //! Defined and unimplemented to avoid misuse
+  TcpOptionMpTcpReset (const TcpOptionMpTcpReset&);
+  TcpOptionMpTcpReset& operator= (const TcpOptionMpTcpReset&);
+
+  uint8_t m_flags;  //!< On 4 bits
+  uint8_t m_reason; //!< Reason code
+};
+
 /**
  * \brief Like GetMpTcpOption but if does not find the option then it creates one
  *       and append it to the the header
@@ -262,8 +262,13 @@ TcpRxBuffer::Add (Ptr<Packet> p,  SequenceNumber32 const& _headSeq)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. Packets ending before the one
+  // starting at or before headSeq can not overlap
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -296,7 +301,10 @@ TcpRxBuffer::Add (Ptr<Packet> p,  SequenceNumber32 const& _headSeq)
     {
       uint32_t start = headSeq - _headSeq;
       uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
+      if (length != pktSize)
+        { // Only copy when the packet has to be trimmed
+          p = p->CreateFragment (start, length);
+        }
       NS_ASSERT (length == p->GetSize ());
     }
   // Insert packet into buffer
@@ -305,7 +313,7 @@ TcpRxBuffer::Add (Ptr<Packet> p,  SequenceNumber32 const& _headSeq)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  for (BufIterator i = m_data.lower_bound (m_nextRxSeq); i != m_data.end (); ++i)
     {
       if (i->first < m_nextRxSeq)
         {
@@ -98,6 +98,11 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&TcpSocketBase::m_mptcpEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("MpTcpVersion",
+                   "Highest MPTCP version proposed: 0 for RFC 6824, 1 for RFC 8684",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_mptcpVersion),
+                   MakeUintegerChecker<uint8_t> (0, 1))
     .AddAttribute ("IcmpCallback", "Callback invoked whenever an icmp error is received on this socket.",
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback),
@@ -114,6 +119,16 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("RcvBufAutoTuning",
+                   "Grow the receive buffer according to the data delivered per RTT",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_rcvBufAutoTuning),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RcvBufMax",
+                   "Maximum size of an auto-tuned receive buffer (bytes)",
+                   UintegerValue (6291456),
+                   MakeUintegerAccessor (&TcpSocketBase::m_rcvBufMax),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("Timestamp", "Enable or disable Timestamp option",
                    BooleanValue (false),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
@@ -329,7 +344,16 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_rWnd (sock.m_rWnd),
     m_highRxMark (sock.m_highRxMark),
     m_highRxAckMark (sock.m_highRxAckMark),
+    m_rcvBufAutoTuning (sock.m_rcvBufAutoTuning),
+    m_rcvBufMax (sock.m_rcvBufMax),
+    m_rcvRttSeq (sock.m_rcvRttSeq),
+    m_rcvRttTime (sock.m_rcvRttTime),
+    m_rcvRtt (sock.m_rcvRtt),
+    m_rcvSpaceSeq (sock.m_rcvSpaceSeq),
+    m_rcvSpaceTime (sock.m_rcvSpaceTime),
+    m_rcvSpace (sock.m_rcvSpace),
     m_mptcpEnabled (sock.m_mptcpEnabled),
+    m_mptcpVersion (sock.m_mptcpVersion),
     m_mptcpLocalKey(sock.m_mptcpLocalKey),
     m_mptcpLocalToken(sock.m_mptcpLocalToken),
     m_mptcpPeerToken(sock.m_mptcpPeerToken),
@@ -422,6 +446,76 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   NS_ASSERT (ok == true);
 }
 
+/**
+ * \brief Size of the blocks of TcpSocketBase::operator new
+ * \return the size of the largest of a meta and a subflow
+ */
+static size_t
+GetSocketBlockSize (void)
+{
+  return std::max (sizeof (MpTcpSocketBase), sizeof (MpTcpSubflow));
+}
+
+/**
+ * \brief Blocks released by TcpSocketBase::operator delete
+ *
+ * Each thread has its own list, so that threads running parts of a
+ * simulation never share blocks. The list frees its blocks when the
+ * thread exits.
+ */
+class FreeSocketBlocks : public std::vector<void*>
+{
+public:
+  ~FreeSocketBlocks ();
+};
+
+//! Free blocks of the thread
+static thread_local FreeSocketBlocks g_freeSocketBlocks;
+//! The free blocks of the thread are gone, sockets outliving them are freed directly
+static thread_local bool g_freeSocketBlocksDestroyed = false;
+
+FreeSocketBlocks::~FreeSocketBlocks ()
+{
+  for (iterator i = begin (); i != end (); ++i)
+    {
+      ::operator delete (*i);
+    }
+  g_freeSocketBlocksDestroyed = true;
+}
+
+//! Free blocks kept at most, beyond this the memory is given back to the system
+static const uint32_t MAX_FREE_SOCKET_BLOCKS = 1024;
+
+void*
+TcpSocketBase::operator new (size_t size)
+{
+  if (size > GetSocketBlockSize ())
+    {
+      return ::operator new (size);
+    }
+  if (g_freeSocketBlocksDestroyed || g_freeSocketBlocks.empty ())
+    {
+      return ::operator new (GetSocketBlockSize ());
+    }
+  void *ptr = g_freeSocketBlocks.back ();
+  g_freeSocketBlocks.pop_back ();
+  return ptr;
+}
+
+void
+TcpSocketBase::operator delete (void* ptr, size_t size)
+{
+  // metas built by UpgradeToMeta fit their block, larger sockets never got one
+  if (size > GetSocketBlockSize ()
+      || g_freeSocketBlocksDestroyed
+      || g_freeSocketBlocks.size () >= MAX_FREE_SOCKET_BLOCKS)
+    {
+      ::operator delete (ptr);
+      return;
+    }
+  g_freeSocketBlocks.push_back (ptr);
+}
+
 TcpSocketBase::~TcpSocketBase (void)
 {
   NS_LOG_FUNCTION (this);
@@ -447,6 +541,11 @@ TcpSocketBase::~TcpSocketBase (void)
       m_tcp->DeAllocate (m_endPoint6);
       NS_ASSERT (m_endPoint6 == nullptr);
     }
+  if (m_tcp != nullptr && m_mptcpLocalKey != 0)
+    {
+      // only removed if this socket registered it, forks copy the key
+      m_tcp->RemoveMpTcpToken (m_mptcpLocalToken, this);
+    }
   m_tcp = 0;
   CancelAllTimers ();
 }
@@ -1739,8 +1838,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     }
 
   // RFC 6675 Section 5: 2nd, 3rd paragraph and point (A), (B) implementation
-  // are inside the function ProcessAck
-  ProcessAck (ackNumber, scoreboardUpdated, oldHeadSequence);
+  // are inside the function ProcessAck. RFC 5681: a segment carrying data
+  // does not acknowledge anything new and is not a duplicate ACK either
+  if (packet->GetSize () == 0 || ackNumber != oldHeadSequence || scoreboardUpdated)
+    {
+      ProcessAck (ackNumber, scoreboardUpdated, oldHeadSequence);
+    }
 
   // If there is any data piggybacked, store it into m_rxBuffer
   if (packet->GetSize () > 0)
@@ -2098,7 +2201,7 @@ TcpSocketBase::UpgradeToMeta()
   this->CancelAllTimers();
 
   // I don't want the destructor to be called in that moment
-  MpTcpSocketBase* meta = new (this) MpTcpSocketBase(*master);
+  MpTcpSocketBase* meta = ::new (this) MpTcpSocketBase(*master);
   meta->SetTcp(master->m_tcp);
   meta->SetNode(master->GetNode());
   // we add it to tcp so that it can be freed and used for token lookup
@@ -2116,8 +2219,7 @@ TcpSocketBase::ProcessTcpOptions(const TcpHeader& header)
 {
   NS_LOG_FUNCTION (this << header);
 
-  TcpHeader::TcpOptionList options;
-  header.GetOptions (options);
+  const TcpHeader::TcpOptionList& options = header.GetOptionList ();
   for(TcpHeader::TcpOptionList::const_iterator it(options.begin()); it != options.end(); ++it)
   {
     Ptr<const TcpOption> option = *it;
@@ -2132,7 +2234,7 @@ TcpSocketBase::ProcessTcpOptions(const TcpHeader& header)
         case TcpOption::MPTCP:
           //! this will interrupt option processing but this function will be scheduled again
           //! thus some options may be processed twice, it should not trigger errors
-          if (ProcessOptionMpTcp(option) != 0)
+          if (m_mptcpEnabled && ProcessOptionMpTcp(option) != 0)
             {
               return 1;
             }
@@ -2153,6 +2255,11 @@ TcpSocketBase::ProcessTcpOptions(const TcpHeader& header)
           break;
       }
   }
+  const MpTcpDss* dss = header.GetMpTcpDss ();
+  if (dss && m_mptcpEnabled)
+    {
+      return ProcessOptionMpTcpDss (*dss);
+    }
   return 0;
 }
 
@@ -2207,6 +2314,11 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
     { // Handshake completed
       if(ProcessTcpOptions(tcpHeader) == 1)
       {
+        // the options closed the socket, e.g. a subflow rejecting an MP_JOIN
+        if (m_state != SYN_SENT)
+          {
+            return;
+          }
         // upgrade to mptcp socket
         Ptr<MpTcpSubflow> master = UpgradeToMeta();
         Simulator::ScheduleNow( &MpTcpSubflow::ProcessSynSent, master, packet, tcpHeader);
@@ -2312,7 +2424,10 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       // Always respond to first data packet to speed up the connection.
       // Remove to get the behaviour of old NS-3 code.
       m_delAckCount = m_delAckMaxCount;
-      ProcessTcpOptions(tcpHeader);
+      if (ProcessTcpOptions(tcpHeader) == 1)
+        {
+          return;
+        }
       NotifyNewConnectionCreated (this, fromAddress);
       ReceivedAck (packet, tcpHeader);
       // As this connection is established, the socket is available to send data now
@@ -2775,6 +2890,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
       m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxIsTimeout = false;
     }
 }
 
@@ -3023,6 +3139,12 @@ TcpSocketBase::AddSocketTags (const Ptr<Packet> &p) const
       p->ReplacePacketTag (priorityTag);
     }
 }
+Ptr<Packet>
+TcpSocketBase::GetPayload (Ptr<Packet> p, SequenceNumber32 seq)
+{
+  return p;
+}
+
 /* Extract at most maxSize bytes from the TxBuffer at sequence seq, add the
     TCP header, and send to TcpL4Protocol */
 uint32_t
@@ -3036,7 +3158,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       isRetransmission = true;
     }
 
-  Ptr<Packet> p = m_txBuffer->CopyFromSequence (maxSize, seq);
+  Ptr<Packet> p = GetPayload (m_txBuffer->CopyFromSequence (maxSize, seq), seq);
   uint32_t sz = p->GetSize (); // Size of packet
   uint8_t flags = withAck ? TcpHeader::ACK : 0;
   uint32_t remainingData = m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (sz));
@@ -3046,9 +3168,14 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_INFO ("Pacing is enabled");
       if (m_pacingTimer.IsExpired ())
         {
-          NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_currentPacingRate);
-          NS_LOG_DEBUG ("Timer is in expired state, activate it " << m_tcb->m_currentPacingRate.CalculateBytesTxTime (sz));
-          m_pacingTimer.Schedule (m_tcb->m_currentPacingRate.CalculateBytesTxTime (sz));
+          m_pacingBurst += sz;
+          if (m_pacingBurst >= GetPacingQuantum ())
+            {
+              NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_currentPacingRate);
+              NS_LOG_DEBUG ("Timer is in expired state, activate it " << m_tcb->m_currentPacingRate.CalculateBytesTxTime (m_pacingBurst));
+              m_pacingTimer.Schedule (m_tcb->m_currentPacingRate.CalculateBytesTxTime (m_pacingBurst));
+              m_pacingBurst = 0;
+            }
         }
       else
         {
@@ -3126,6 +3253,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
       m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxIsTimeout = true;
     }
 
   m_txTrace (p, header, this);
@@ -3335,17 +3463,7 @@ TcpSocketBase::SendPendingData (bool withAck)
                         " sent seq " << m_tcb->m_nextTxSequence <<
                         " size " << sz);
           ++nPacketsSent;
-          if (m_tcb->m_pacing)
-            {
-              NS_LOG_INFO ("Pacing is enabled");
-              if (m_pacingTimer.IsExpired ())
-                {
-                  NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_currentPacingRate);
-                  NS_LOG_DEBUG ("Timer is in expired state, activate it " << m_tcb->m_currentPacingRate.CalculateBytesTxTime (sz));
-                  m_pacingTimer.Schedule (m_tcb->m_currentPacingRate.CalculateBytesTxTime (sz));
-                  break;
-                }
-            }
+          // With pacing, SendDataPacket armed the timer once the quantum was sent
         }
 
       // (C.4) The estimate of the amount of data outstanding in the
@@ -3449,6 +3567,106 @@ TcpSocketBase::AdvertisedWindowSize (bool scale) const
   return static_cast<uint16_t> (w);
 }
 
+void
+TcpSocketBase::UpdateRcvRtt (const TcpHeader& tcpHeader)
+{
+  NS_LOG_FUNCTION (this << tcpHeader);
+  if (m_timestampEnabled && tcpHeader.HasOption (TcpOption::TS))
+    {
+      Ptr<const TcpOptionTS> ts;
+      ts = DynamicCast<const TcpOptionTS> (tcpHeader.GetOption (TcpOption::TS));
+      if (ts->GetEcho () != 0)
+        {
+          // moving average with gain 1/8, as for the sender side SRTT
+          Time sample = TcpOptionTS::ElapsedTimeFromTsValue (ts->GetEcho ());
+          m_rcvRtt = m_rcvRtt.IsZero () ? sample : (m_rcvRtt * 7 + sample) / 8;
+          return;
+        }
+    }
+
+  SequenceNumber32 next = m_rxBuffer->NextRxSequence ();
+  if (m_rcvRttTime.IsZero ())
+    {
+      m_rcvRttSeq = m_rxBuffer->MaxRxSequence ();
+      m_rcvRttTime = Simulator::Now ();
+      return;
+    }
+  if (next < m_rcvRttSeq)
+    {
+      return;
+    }
+  // The peer may not fill the window in a RTT, so the sample is an upper bound
+  Time sample = Simulator::Now () - m_rcvRttTime;
+  if (m_rcvRtt.IsZero () || sample < m_rcvRtt)
+    {
+      m_rcvRtt = sample;
+      NS_LOG_LOGIC ("Receiver side RTT estimation " << m_rcvRtt.As (Time::MS));
+    }
+  m_rcvRttSeq = m_rxBuffer->MaxRxSequence ();
+  m_rcvRttTime = Simulator::Now ();
+}
+
+Time
+TcpSocketBase::GetRcvRtt (void) const
+{
+  if (m_rtt && !m_rtt->GetEstimate ().IsZero ())
+    {
+      return m_rtt->GetEstimate ();
+    }
+  return m_rcvRtt;
+}
+
+Time
+TcpSocketBase::GetRcvBufAutoTuningRtt (void) const
+{
+  return GetRcvRtt ();
+}
+
+void
+TcpSocketBase::AutoTuneRcvBuf (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_rcvBufAutoTuning)
+    {
+      return;
+    }
+  SequenceNumber32 next = m_rxBuffer->NextRxSequence ();
+  if (m_rcvSpace == 0)
+    {
+      // Initial window of the peer, as in tcp_init_buffer_space
+      m_rcvSpace = std::min (10 * m_tcb->m_segmentSize, m_rxBuffer->MaxBufferSize ());
+      m_rcvSpaceSeq = next;
+      m_rcvSpaceTime = Simulator::Now ();
+      return;
+    }
+  Time rtt = GetRcvBufAutoTuningRtt ();
+  if (rtt.IsZero () || Simulator::Now () - m_rcvSpaceTime < rtt)
+    {
+      return;
+    }
+
+  uint32_t delivered = next - m_rcvSpaceSeq;
+  if (delivered > m_rcvSpace)
+    {
+      // Twice the data delivered in the last RTT since the sender may be in
+      // slow start, plus as much again as the delivery rate grew
+      uint64_t rcvWin = 2 * static_cast<uint64_t> (delivered) + 16 * m_tcb->m_segmentSize;
+      rcvWin += 2 * rcvWin * (delivered - m_rcvSpace) / m_rcvSpace;
+      uint32_t size = static_cast<uint32_t> (std::min<uint64_t> (rcvWin, m_rcvBufMax));
+      if (size > m_rxBuffer->MaxBufferSize ())
+        {
+          NS_LOG_INFO ("Rx buffer auto-tuned from " << m_rxBuffer->MaxBufferSize () <<
+                       " to " << size << " bytes (" << delivered << " bytes in " <<
+                       rtt.As (Time::MS) << ")");
+          // The window is advertised by the next ACK, sent right after the delivery
+          m_rxBuffer->SetMaxBufferSize (size);
+        }
+      m_rcvSpace = delivered;
+    }
+  m_rcvSpaceSeq = next;
+  m_rcvSpaceTime = Simulator::Now ();
+}
+
 // Receipt of new packet, put into Rx buffer
 void
 TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
@@ -3473,9 +3691,11 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
         }
       return;
     }
+  UpdateRcvRtt (tcpHeader);
   // Notify app to receive if necessary
   if (expectedSeq < m_rxBuffer->NextRxSequence ())
     { // NextRxSeq advanced, we have something to send to the app
+      AutoTuneRcvBuf ();
       if (!m_shutdownRecv)
         {
           NotifyDataRecv ();
@@ -3606,17 +3826,25 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
 
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
-      NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
 
-      NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
-                    Simulator::Now ().GetSeconds () << " to expire at time " <<
-                    (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      NS_LOG_LOGIC (this << " Move ReTxTimeout event which was set to expire at " <<
+                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds () <<
+                    " to expire at time " << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
+      if (m_retxEvent.IsRunning () && m_retxIsTimeout)
+        {
+          // every new ACK pushes the timer back: move it rather than leave
+          // a cancelled event in the event list
+          m_retxEvent = Simulator::Reschedule (m_retxEvent, m_rto);
+        }
+      else
+        {
+          m_retxEvent.Cancel ();
+          m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+          m_retxIsTimeout = true;
+        }
     }
 
   // Note the highest ACK and tell app to send more
@@ -3759,6 +3987,7 @@ TcpSocketBase::ReTxTimeout ()
   m_tcb->m_congState = TcpSocketState::CA_LOSS;
 
   m_pacingTimer.Cancel ();
+  m_pacingBurst = 0;
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
                 m_tcb->m_ssThresh << ", restart from seqnum " <<
@@ -4098,12 +4327,25 @@ TcpSocketBase::GenerateUniqueMpTcpKey()
   uint64_t localKey, idsn;
   uint32_t localToken;
 
+  if (m_mptcpLocalKey != 0)
+    {
+      m_tcp->RemoveMpTcpToken(m_mptcpLocalToken, this);
+    }
+
+  if (m_mptcpKeyRng == 0)
+    {
+      // the stream follows the RngSeed and RngRun of the simulation
+      m_mptcpKeyRng = CreateObject<UniformRandomVariable> ();
+    }
+
+  // as in mptcp_set_key_sk, draw keys until the token is not used by another connection
   do
   {
-    localKey = (rand() % 1000 + 1);
-    GenerateTokenForKey( HMAC_SHA1, localKey, localToken, idsn );
+    localKey = (static_cast<uint64_t>(m_mptcpKeyRng->GetInteger (0, 0xffffffff)) << 32)
+      | m_mptcpKeyRng->GetInteger (0, 0xffffffff);
+    GenerateTokenForKey( GetMpTcpCryptoAlg(), localKey, localToken, idsn );
   }
-  while(m_tcp->LookupMpTcpToken(localToken));
+  while(localKey == 0 || !m_tcp->AddMpTcpToken(localToken, this));
 
   m_mptcpLocalToken = localToken;
   m_mptcpLocalKey = localKey;
@@ -4111,6 +4353,12 @@ TcpSocketBase::GenerateUniqueMpTcpKey()
   return localKey;
 }
 
+mptcp_crypto_alg_t
+TcpSocketBase::GetMpTcpCryptoAlg() const
+{
+  return (m_mptcpVersion >= 1) ? HMAC_SHA256 : HMAC_SHA1;
+}
+
 void
 TcpSocketBase::AddMpTcpOptions (TcpHeader& header)
 {
@@ -4125,7 +4373,12 @@ TcpSocketBase::AddMpTcpOptions (TcpHeader& header)
     {
       // Append the MPTCP capable option
       Ptr<TcpOptionMpTcpCapable> mpc = CreateObject<TcpOptionMpTcpCapable>();
-      mpc->SetSenderKey(m_mptcpLocalKey);
+      mpc->SetVersion(m_mptcpVersion);
+      // since RFC 8684 the key is only disclosed once the version is agreed on
+      if (m_mptcpVersion == 0)
+        {
+          mpc->SetSenderKey(m_mptcpLocalKey);
+        }
       header.AppendOption(mpc);
     }
   else if(m_state == ESTABLISHED && (header.GetFlags () == TcpHeader::SYN)) 
@@ -4144,7 +4397,10 @@ void
 TcpSocketBase::AddOptions (TcpHeader& header)
 {
   NS_LOG_FUNCTION (this << header);
-  AddMpTcpOptions(header);
+  if (m_mptcpEnabled)
+    {
+      AddMpTcpOptions(header);
+    }
 
   if (m_timestampEnabled)
     {
@@ -4152,6 +4408,13 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     }
 }
 
+int
+TcpSocketBase::ProcessOptionMpTcpDss (const MpTcpDss& dss)
+{
+  NS_LOG_WARN("Invalid option MP_DSS");
+  return 0;
+}
+
 int
 TcpSocketBase::ProcessOptionMpTcp ( const Ptr<const TcpOption> option)
 {
@@ -4162,6 +4425,19 @@ TcpSocketBase::ProcessOptionMpTcp ( const Ptr<const TcpOption> option)
      NS_LOG_WARN("Invalid option " << option);
      return 0;
    }
+  // both ends settle on the lowest version proposed
+  uint8_t version = std::min(m_mptcpVersion, mpc->GetVersion());
+  if (version != m_mptcpVersion)
+    {
+      NS_LOG_LOGIC("Peer proposes MPTCP version " << (int)mpc->GetVersion() << ", falling back");
+      m_mptcpVersion = version;
+      // the token depends on the hash algorithm. The key was not disclosed yet
+      // as a lower version can only be proposed in response to a version 1 SYN
+      if (m_mptcpLocalKey != 0)
+        {
+          GenerateUniqueMpTcpKey();
+        }
+    }
   return 1;
 }
 
@@ -4191,6 +4467,11 @@ TcpSocketBase::CalculateWScale () const
 {
   NS_LOG_FUNCTION (this);
   uint32_t maxSpace = m_rxBuffer->MaxBufferSize ();
+  if (m_rcvBufAutoTuning)
+    {
+      // The scale can not change once negotiated
+      maxSpace = std::max (maxSpace, m_rcvBufMax);
+    }
   uint8_t scale = 0;
 
   while (maxSpace > m_maxWinSize)
@@ -4522,6 +4803,12 @@ TcpSocketBase::NotifyPacingPerformed (void)
   SendPendingData (m_connected);
 }
 
+uint32_t
+TcpSocketBase::GetPacingQuantum (void) const
+{
+  return 0;
+}
+
 void
 TcpSocketBase::SetEcn (EcnMode_t ecnMode)
 {
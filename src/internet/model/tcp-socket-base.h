@@ -30,10 +30,12 @@
 #include "ns3/timer.h"
 #include "ns3/sequence-number.h"
 #include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/node.h"
 #include "ns3/tcp-socket-state.h"
 #include "ns3/ipv4-end-point.h"
 #include "tcp-tx-buffer.h"
+#include "mptcp-crypto.h"
 
 namespace ns3 {
 
@@ -46,6 +48,7 @@ class TcpHeader;
 class MpTcpSubflow;
 class MpTcpSocketBase;
 class TcpOptionMpTcpMain;
+class MpTcpDss;
 class TcpCongestionOps;
 class TcpRecoveryOps;
 class RttEstimator;
@@ -251,6 +254,25 @@ public:
   TcpSocketBase (const TcpSocketBase& sock);
   virtual ~TcpSocketBase (void);
 
+  /**
+   * \brief Allocates enough memory for UpgradeToMeta to build an
+   * MpTcpSocketBase in place of the socket
+   *
+   * Sockets, metas and subflows share blocks of a single size, the blocks of
+   * the destroyed ones are kept for the next sockets so that connection
+   * churn does not go through the system allocator.
+   * \param size size of the object
+   * \return the allocated memory
+   */
+  static void* operator new (size_t size);
+
+  /**
+   * \brief Releases memory from TcpSocketBase::operator new
+   * \param ptr the memory
+   * \param size size of the dynamic type of the object
+   */
+  static void operator delete (void* ptr, size_t size);
+
   // Set associated Node, TcpL4Protocol, RttEstimator to this socket
 
   /**
@@ -712,7 +734,7 @@ protected:
    * \param icmpCode the ICMP Code
    * \param icmpInfo the ICMP Info
    */
-  void ForwardIcmp (Ipv4Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
+  virtual void ForwardIcmp (Ipv4Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
 
   /**
    * \brief Called by the L3 protocol when it received an ICMPv6 packet to pass on to TCP.
@@ -723,7 +745,7 @@ protected:
    * \param icmpCode the ICMP Code
    * \param icmpInfo the ICMP Info
    */
-  void ForwardIcmp6 (Ipv6Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
+  virtual void ForwardIcmp6 (Ipv6Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);
 
   /**
    * \brief Send as much pending data as possible according to the Tx window.
@@ -746,6 +768,19 @@ protected:
    */
   virtual uint32_t SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool withAck);
 
+  /**
+   * \brief Provide the payload of a segment about to be sent
+   *
+   * By default the payload is the packet extracted from the TxBuffer. MPTCP
+   * subflows only buffer placeholders and read the bytes from the send buffer
+   * of their connection instead.
+   *
+   * \param p the packet extracted from the TxBuffer
+   * \param seq the sequence number of its first byte
+   * \returns the packet to send, of the same size as p
+   */
+  virtual Ptr<Packet> GetPayload (Ptr<Packet> p, SequenceNumber32 seq);
+
   /**
    * \brief Send a empty packet that carries a flag, e.g., ACK
    *
@@ -952,6 +987,40 @@ protected:
    */
   virtual bool UpdateWindowSize (const TcpHeader& header);
 
+  /**
+   * \brief Receiver side RTT estimation
+   *
+   * This is the only estimation available to a socket which does not send
+   * data. With timestamps, each data segment echoing one of our timestamps
+   * gives a sample; otherwise we measure the time it takes to receive a
+   * window worth of data, as Linux does in tcp_rcv_rtt_measure.
+   * Called on each received data segment.
+   *
+   * \param tcpHeader header of the data segment
+   */
+  void UpdateRcvRtt (const TcpHeader& tcpHeader);
+
+  /**
+   * \return The RTT estimated from our own data if any, the receiver side
+   * estimation otherwise (zero if there is none yet)
+   */
+  Time GetRcvRtt (void) const;
+
+  /**
+   * \return The RTT over which the delivered data is measured by AutoTuneRcvBuf
+   */
+  virtual Time GetRcvBufAutoTuningRtt (void) const;
+
+  /**
+   * \brief Receive buffer auto-tuning (dynamic right sizing)
+   *
+   * Once per RTT, the Rx buffer grows to twice the data delivered in order
+   * during the last RTT (plus its growth), up to RcvBufMax, so that the
+   * advertised window never limits the sender. The buffer never shrinks.
+   * Called each time in order data is delivered.
+   */
+  virtual void AutoTuneRcvBuf (void);
+
   // Manage data tx/rx
 
   /**
@@ -1085,12 +1154,25 @@ protected:
    */
   virtual int ProcessOptionMpTcp(const Ptr<const TcpOption> option);
 
+  /**
+   * \brief Processes the DSS that TcpHeader stores outside its option list.
+   * Only subflows make use of it, this baseclass ignores it.
+   * \param dss the received DSS
+   */
+  virtual int ProcessOptionMpTcpDss(const MpTcpDss& dss);
+
   /**
    * \brief Generate a unique key for this host
    * \see mptcp_set_key_sk
    */
   virtual uint64_t GenerateUniqueMpTcpKey() ;
 
+  /**
+   * \brief Algorithm used for tokens and HMACs, depends on the negotiated version
+   * \return HMAC_SHA256 for \RFC{8684} (version 1), HMAC_SHA1 otherwise
+   */
+  mptcp_crypto_alg_t GetMpTcpCryptoAlg() const;
+
   /**
    * \brief Read TCP options before Ack processing
    *
@@ -1138,11 +1220,12 @@ protected:
   /**
    * \brief Calculate window scale value based on receive buffer space
    *
-   * Calculate our factor from the rxBuffer max size
+   * Calculate our factor from the rxBuffer max size, or from the size the
+   * buffer may be auto-tuned to.
    *
    * \returns the Window Scale factor
    */
-  uint8_t CalculateWScale () const;
+  virtual uint8_t CalculateWScale () const;
 
   /**
    * \brief Read the SACK PERMITTED option
@@ -1214,6 +1297,14 @@ protected:
    */
   void NotifyPacingPerformed (void);
 
+  /**
+   * \brief Bytes that may leave back to back before the pacing timer is armed
+   *
+   * The timer then waits for the transmission time of the whole burst.
+   * \return 0, i.e., every segment is paced
+   */
+  virtual uint32_t GetPacingQuantum (void) const;
+
   /**
    * \brief Add Tags for the Socket
    * \param p Packet
@@ -1229,6 +1320,7 @@ protected:
 
   // Counters and events
   EventId           m_retxEvent     {}; //!< Retransmission event
+  bool              m_retxIsTimeout {false}; //!< The retransmission event calls ReTxTimeout
   EventId           m_lastAckEvent  {}; //!< Last ACK timeout event
   EventId           m_delAckEvent   {}; //!< Delayed ACK timeout event
   EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
@@ -1292,10 +1384,22 @@ protected:
   TracedValue<SequenceNumber32> m_highRxMark {0};  //!< Highest seqno received
   TracedValue<SequenceNumber32> m_highRxAckMark {0}; //!< Highest ack received
 
+  // Receive buffer auto-tuning
+  bool             m_rcvBufAutoTuning {false};         //!< Grow the Rx buffer with the delivery rate
+  uint32_t         m_rcvBufMax        {0};             //!< Ceiling of the auto-tuned Rx buffer
+  SequenceNumber32 m_rcvRttSeq        {0};             //!< Reception of this seq ends the receiver RTT sample
+  Time             m_rcvRttTime       {Seconds (0.0)}; //!< Start of the receiver RTT sample (zero if none)
+  Time             m_rcvRtt           {Seconds (0.0)}; //!< Receiver side RTT estimation
+  SequenceNumber32 m_rcvSpaceSeq      {0};             //!< Rx next sequence at the start of the measure
+  Time             m_rcvSpaceTime     {Seconds (0.0)}; //!< Start of the measure
+  uint32_t         m_rcvSpace         {0};             //!< Data delivered during a RTT (zero if not measured yet)
+
   // MPTCP variables
   bool        m_mptcpEnabled   {true};         //!< Window Scale option enabled
+  uint8_t     m_mptcpVersion   {1};        //!< MPTCP version (0: RFC 6824, 1: RFC 8684), negotiated down
   uint64_t    m_mptcpLocalKey  {0};        //!< MPTCP key
   uint32_t    m_mptcpLocalToken{0};      //!< Hash of the key
+  Ptr<UniformRandomVariable> m_mptcpKeyRng; //!< Draws the MPTCP keys, created on first use
   uint32_t    m_mptcpPeerToken {0};      //!< Hash of the key
 
   // Options
@@ -1330,6 +1434,7 @@ protected:
 
   // Pacing related variable
   Timer m_pacingTimer {Timer::REMOVE_ON_DESTROY}; //!< Pacing Event
+  uint32_t m_pacingBurst {0};                     //!< Bytes sent since the pacing timer was last armed
 
   // Parameters related to Explicit Congestion Notification
   EcnMode_t                     m_ecnMode    {EcnMode_t::NoEcn};      //!< Socket ECN capability
@@ -275,6 +275,65 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
   return toRet;
 }
 
+Ptr<Packet>
+TcpTxBuffer::PeekFromSequence (uint32_t numBytes, const SequenceNumber32& seq) const
+{
+  NS_LOG_FUNCTION (this << numBytes << seq);
+
+  NS_ABORT_MSG_IF (m_firstByteSeq > seq,
+                   "Requested a sequence number which is not in the buffer anymore");
+
+  Ptr<Packet> p = Create<Packet> ();
+  uint32_t s = std::min (numBytes, SizeFromSequence (seq));
+  if (s == 0)
+    {
+      return p;
+    }
+
+  SequenceNumber32 end = seq + s;
+  SequenceNumber32 appStart = m_firstByteSeq + m_sentSize;
+  if (seq < appStart)
+    {
+      PeekFromList (m_sentList, m_firstByteSeq, seq, std::min (end, appStart), p);
+    }
+  if (end > appStart)
+    {
+      PeekFromList (m_appList, appStart, std::max (seq, appStart), end, p);
+    }
+
+  NS_ASSERT (p->GetSize () == s);
+  return p;
+}
+
+void
+TcpTxBuffer::PeekFromList (const PacketList &list, const SequenceNumber32 &startingSeq,
+                           const SequenceNumber32 &begin, const SequenceNumber32 &end,
+                           Ptr<Packet> out) const
+{
+  NS_LOG_FUNCTION (this << startingSeq << begin << end);
+  SequenceNumber32 itemStart = startingSeq;
+
+  for (PacketList::const_iterator it = list.begin (); it != list.end () && itemStart < end; ++it)
+    {
+      Ptr<Packet> item = (*it)->m_packet;
+      SequenceNumber32 itemEnd = itemStart + item->GetSize ();
+      if (itemEnd > begin)
+        {
+          SequenceNumber32 from = std::max (itemStart, begin);
+          SequenceNumber32 to = std::min (itemEnd, end);
+          if (from == itemStart && to == itemEnd)
+            {
+              out->AddAtEnd (item);
+            }
+          else
+            {
+              out->AddAtEnd (item->CreateFragment (from - itemStart, to - from));
+            }
+        }
+      itemStart = itemEnd;
+    }
+}
+
 TcpTxItem*
 TcpTxBuffer::GetNewSegment (uint32_t numBytes)
 {
@@ -1340,12 +1399,17 @@ void
 TcpTxBuffer::AddRenoSack (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_sentList.size () > 1);
 
   m_renoSack = true;
 
-  // We can _never_ SACK the head, so start from the second segment sent
-  auto it = ++m_sentList.begin ();
+  // We can _never_ SACK the head, so start from the second segment sent.
+  // After a retransmission timeout, the head may be the only segment sent
+  // while dupacks for the previous flight keep arriving
+  auto it = m_sentList.begin ();
+  if (it != m_sentList.end ())
+    {
+      ++it;
+    }
 
   // Find the "highest sacked" point, that is SND.UNA + m_sackedOut
   while (it != m_sentList.end () && (*it)->m_sacked)
@@ -278,6 +278,20 @@ public:
    */
   Ptr<Packet> CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
 
+  /**
+   * \brief Read the data in the range [seq, seq+numBytes) without marking it as sent
+   *
+   * Unlike CopyFromSequence, neither the lists nor the scoreboard are touched:
+   * the items are left as they are and the returned packet refers to their
+   * payload. Meant for a buffer whose data is transmitted by other sockets,
+   * e.g. the send buffer of an MPTCP connection.
+   *
+   * \param numBytes number of bytes to read
+   * \param seq start sequence number to read
+   * \returns a packet (empty if seq is at the tail of the buffer)
+   */
+  Ptr<Packet> PeekFromSequence (uint32_t numBytes, const SequenceNumber32& seq) const;
+
   /**
    * \brief Set the head sequence of the buffer
    *
@@ -562,6 +576,22 @@ private:
                                 uint32_t numBytes, const SequenceNumber32 &requestedSeq,
                                 bool *listEdited = nullptr) const;
 
+  /**
+   * \brief Append to a packet the part of a list within [begin, end)
+   *
+   * Items entirely within the range are appended as they are, only the
+   * items at its edges get fragmented.
+   *
+   * \param list List to read from
+   * \param startingSeq Starting sequence of the list
+   * \param begin First sequence to read
+   * \param end Sequence following the last one to read
+   * \param out Packet to append the data to
+   */
+  void PeekFromList (const PacketList &list, const SequenceNumber32 &startingSeq,
+                     const SequenceNumber32 &begin, const SequenceNumber32 &end,
+                     Ptr<Packet> out) const;
+
   /**
    * \brief Merge two TcpTxItem
    *
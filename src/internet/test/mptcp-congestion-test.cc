@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/mptcp-congestion-lia.h"
+#include "ns3/mptcp-congestion-balia.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow whose window can be set from the test
+ */
+class MpTcpCongestionTestSubflow : public MpTcpSubflow
+{
+public:
+  /**
+   * \brief Set the subflow window and RTT estimate
+   * \param cWnd Congestion window.
+   * \param rtt Smoothed RTT.
+   */
+  void Set (uint32_t cWnd, Time rtt)
+  {
+    m_tcb->m_cWnd = cWnd;
+    Ptr<RttEstimator> estimator = CreateObject<RttMeanDeviation> ();
+    estimator->Measurement (rtt);
+    SetRtt (estimator);
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta exposing the coupled aggregates bookkeeping
+ */
+class MpTcpCongestionTestMeta : public MpTcpSocketBase
+{
+public:
+  /**
+   * \brief Register a subflow and account for its window
+   * \param sf The subflow
+   */
+  void Add (Ptr<MpTcpSubflow> sf)
+  {
+    m_subflows[Established].push_back (sf);
+    UpdateCoupledAggregates (sf);
+  }
+  /**
+   * \brief Refresh the aggregates after the subflow changed
+   * \param sf The subflow
+   */
+  void Update (Ptr<MpTcpSubflow> sf)
+  {
+    UpdateCoupledAggregates (sf);
+  }
+  /**
+   * \brief Forget a subflow
+   * \param sf The subflow
+   */
+  void Remove (Ptr<MpTcpSubflow> sf)
+  {
+    RemoveCoupledAggregates (sf);
+    m_subflows[Established].erase (std::find (m_subflows[Established].begin (),
+                                              m_subflows[Established].end (), sf));
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the aggregates cached by the meta stay consistent
+ */
+class MpTcpCoupledAggregatesTest : public TestCase
+{
+public:
+  MpTcpCoupledAggregatesTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpCoupledAggregatesTest::MpTcpCoupledAggregatesTest ()
+  : TestCase ("Coupled aggregates on add, update and removal of subflows")
+{
+}
+
+void
+MpTcpCoupledAggregatesTest::DoRun (void)
+{
+  Ptr<MpTcpCongestionTestMeta> meta = CreateObject<MpTcpCongestionTestMeta> ();
+  Ptr<MpTcpCongestionTestSubflow> sf1 = CreateObject<MpTcpCongestionTestSubflow> ();
+  Ptr<MpTcpCongestionTestSubflow> sf2 = CreateObject<MpTcpCongestionTestSubflow> ();
+
+  sf1->Set (10000, Seconds (0.1));
+  sf2->Set (20000, Seconds (0.2));
+  meta->Add (sf1);
+  meta->Add (sf2);
+
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledNSubflows (), 2, "Wrong number of subflows");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledTotalCwnd (), 30000, "Wrong total window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (meta->GetCoupledSumRate (), 200000, 1e-6, "Wrong sum of rates");
+  NS_TEST_ASSERT_MSG_EQ_TOL (meta->GetCoupledMaxCwndOverRtt2 (), 1e6, 1e-3, "Wrong max cwnd/rtt^2");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledMaxCwndSubflow (), sf2, "Wrong largest window");
+
+  // Subflow holding the max decreases: maxima must be recomputed
+  sf1->Set (2000, Seconds (0.1));
+  meta->Update (sf1);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledTotalCwnd (), 22000, "Wrong total window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (meta->GetCoupledSumRate (), 120000, 1e-6, "Wrong sum of rates");
+  NS_TEST_ASSERT_MSG_EQ_TOL (meta->GetCoupledMaxCwndOverRtt2 (), 5e5, 1e-3, "Wrong max cwnd/rtt^2");
+
+  meta->Remove (sf2);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledNSubflows (), 1, "Wrong number of subflows");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledTotalCwnd (), 2000, "Wrong total window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (meta->GetCoupledMaxCwndOverRtt2 (), 2e5, 1e-3, "Wrong max cwnd/rtt^2");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetCoupledMaxCwndSubflow (), sf1, "Wrong largest window");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the LIA increase and the BALIA decrease
+ */
+class MpTcpCoupledWindowTest : public TestCase
+{
+public:
+  MpTcpCoupledWindowTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpCoupledWindowTest::MpTcpCoupledWindowTest ()
+  : TestCase ("LIA increase and BALIA decrease")
+{
+}
+
+void
+MpTcpCoupledWindowTest::DoRun (void)
+{
+  Ptr<MpTcpCongestionTestMeta> meta = CreateObject<MpTcpCongestionTestMeta> ();
+  Ptr<MpTcpCongestionTestSubflow> sf1 = CreateObject<MpTcpCongestionTestSubflow> ();
+  Ptr<MpTcpCongestionTestSubflow> sf2 = CreateObject<MpTcpCongestionTestSubflow> ();
+  sf1->Set (10000, Seconds (0.1));
+  sf2->Set (20000, Seconds (0.2));
+  meta->Add (sf1);
+  meta->Add (sf2);
+
+  Ptr<TcpSocketState> state = CreateObject<TcpSocketState> ();
+  state->m_cWnd = 10000;
+  state->m_segmentSize = 1000;
+  state->m_ssThresh = 1000;
+
+  // max(w/rtt^2) * mss^2 / (sum w/rtt)^2 = 1e6 * 1e6 / 4e10 = 25 bytes per ACK,
+  // smaller than the uncoupled mss^2 / w = 100 bytes
+  Ptr<MpTcpCongestionLia> lia = CreateObject<MpTcpCongestionLia> ();
+  lia->SetMeta (meta, sf1);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      lia->IncreaseWindow (state, 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ (state->m_cWnd.Get (), 10250, "Wrong LIA increase");
+
+  // Not attached: plain NewReno
+  Ptr<MpTcpCongestionLia> uncoupled = CreateObject<MpTcpCongestionLia> ();
+  state->m_cWnd = 10000;
+  uncoupled->IncreaseWindow (state, 1);
+  NS_TEST_ASSERT_MSG_EQ (state->m_cWnd.Get (), 10100, "Wrong uncoupled increase");
+
+  // Same RTT, sf2 twice as fast: alpha(sf1) = 2 (capped to 1.5), alpha(sf2) = 1
+  sf2->Set (20000, Seconds (0.1));
+  meta->Update (sf2);
+  Ptr<MpTcpCongestionBalia> balia1 = CreateObject<MpTcpCongestionBalia> ();
+  Ptr<MpTcpCongestionBalia> balia2 = CreateObject<MpTcpCongestionBalia> ();
+  balia1->SetMeta (meta, sf1);
+  balia2->SetMeta (meta, sf2);
+  NS_TEST_ASSERT_MSG_EQ (balia1->GetSsThresh (state, 10000), 2500, "Wrong BALIA decrease");
+  NS_TEST_ASSERT_MSG_EQ (balia2->GetSsThresh (state, 20000), 10000, "Wrong BALIA decrease");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the coupled algorithm does not keep its subflow and meta alive
+ */
+class MpTcpCoupledLifetimeTest : public TestCase
+{
+public:
+  MpTcpCoupledLifetimeTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpCoupledLifetimeTest::MpTcpCoupledLifetimeTest ()
+  : TestCase ("Coupled algorithm does not reference its subflow and meta")
+{
+}
+
+void
+MpTcpCoupledLifetimeTest::DoRun (void)
+{
+  Ptr<MpTcpCongestionTestMeta> meta = CreateObject<MpTcpCongestionTestMeta> ();
+  Ptr<MpTcpCongestionTestSubflow> sf = CreateObject<MpTcpCongestionTestSubflow> ();
+  uint32_t metaReferences = meta->GetReferenceCount ();
+  uint32_t subflowReferences = sf->GetReferenceCount ();
+
+  // the subflow owns its algorithm, which would otherwise make a cycle
+  Ptr<MpTcpCongestionLia> lia = CreateObject<MpTcpCongestionLia> ();
+  lia->SetMeta (meta, sf);
+  sf->SetCongestionControlAlgorithm (lia);
+  lia = 0;
+  NS_TEST_ASSERT_MSG_EQ (meta->GetReferenceCount (), metaReferences, "Meta referenced by the algorithm");
+  NS_TEST_ASSERT_MSG_EQ (sf->GetReferenceCount (), subflowReferences, "Subflow referenced by the algorithm");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP coupled congestion control TestSuite
+ */
+class MpTcpCongestionTestSuite : public TestSuite
+{
+public:
+  MpTcpCongestionTestSuite () : TestSuite ("mptcp-congestion", UNIT)
+  {
+    AddTestCase (new MpTcpCoupledAggregatesTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpCoupledWindowTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpCoupledLifetimeTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpCongestionTestSuite g_mptcpCongestionTestSuite; //!< Static variable for test initialization
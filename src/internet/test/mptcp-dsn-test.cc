@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/mptcp-mapping.h"
+#include "ns3/mptcp-reassembly-queue.h"
+#include "ns3/tcp-option-mptcp.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/tcp-header.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpDsnTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Expansion of 32 bits DSNs around a 64 bits reference
+ */
+class MpTcpDsnExpandTest : public TestCase
+{
+public:
+  MpTcpDsnExpandTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpDsnExpandTest::MpTcpDsnExpandTest ()
+  : TestCase ("DSN expansion")
+{
+}
+
+void
+MpTcpDsnExpandTest::DoRun (void)
+{
+  const uint64_t wrap = 1ULL << 32;
+  SequenceNumber64 ref (wrap - 100);
+
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (0xFFFFFF00, ref), SequenceNumber64 (wrap - 256), "Behind the reference");
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (50, ref), SequenceNumber64 (wrap + 50), "Ahead, across the wrap");
+
+  ref = SequenceNumber64 (3 * wrap + 10);
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (10, ref), ref, "Same value");
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (0xFFFFFFF0, ref), SequenceNumber64 (3 * wrap - 16), "Behind, across the wrap");
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (0x7FFFFFFF, ref), SequenceNumber64 (3 * wrap + 0x7FFFFFFF),
+                         "Half the space ahead");
+
+  ref = SequenceNumber64 (0);
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (1000, ref), SequenceNumber64 (1000), "Start of the space");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief DSS round trips with 4 and 8 bytes DSN and DATA_ACK
+ */
+class MpTcpDssEncodingTest : public TestCase
+{
+public:
+  /**
+   * \param dsn64 Send the mapping with an 8 bytes DSN
+   * \param dack64 Send an 8 bytes DATA_ACK
+   */
+  MpTcpDssEncodingTest (bool dsn64, bool dack64);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_dsn64;   //!< 8 bytes mapping
+  bool m_dack64;  //!< 8 bytes DATA_ACK
+};
+
+MpTcpDssEncodingTest::MpTcpDssEncodingTest (bool dsn64, bool dack64)
+  : TestCase ("DSS encoding, 8 bytes DSN=" + std::string (dsn64 ? "yes" : "no")
+              + " 8 bytes DATA_ACK=" + std::string (dack64 ? "yes" : "no")),
+    m_dsn64 (dsn64),
+    m_dack64 (dack64)
+{
+}
+
+void
+MpTcpDssEncodingTest::DoRun (void)
+{
+  const uint64_t dsn = (5ULL << 32) + 1234;
+  const uint64_t dack = (7ULL << 32) + 42;
+
+  Ptr<TcpOptionMpTcpDSS> dss = CreateObject<TcpOptionMpTcpDSS> ();
+  dss->SetDataAck (dack, !m_dack64);
+  dss->SetMapping (dsn, 1, 1000, false);
+  dss->TruncateDSS (!m_dsn64);
+
+  uint32_t expected = 4 + (m_dack64 ? 8 : 4) + 10 + (m_dsn64 ? 4 : 0);
+  NS_TEST_ASSERT_MSG_EQ (dss->GetSerializedSize (), expected, "Size follows the flags");
+
+  Buffer buffer;
+  buffer.AddAtStart (dss->GetSerializedSize ());
+  dss->Serialize (buffer.Begin ());
+
+  Ptr<TcpOptionMpTcpDSS> read = CreateObject<TcpOptionMpTcpDSS> ();
+  NS_TEST_ASSERT_MSG_EQ (read->Deserialize (buffer.Begin ()), expected, "Whole option read");
+  NS_TEST_ASSERT_MSG_EQ (read->GetFlags (), dss->GetFlags (), "Same flags");
+  NS_TEST_ASSERT_MSG_EQ (bool (read->GetFlags () & TcpOptionMpTcpDSS::DSNOfEightBytes), m_dsn64, "m bit");
+  NS_TEST_ASSERT_MSG_EQ (bool (read->GetFlags () & TcpOptionMpTcpDSS::DataAckOf8Bytes), m_dack64, "a bit");
+
+  uint64_t readDsn;
+  uint32_t readSsn;
+  uint16_t readLength;
+  read->GetMapping (readDsn, readSsn, readLength);
+  uint64_t expectedDsn = m_dsn64 ? dsn : (dsn & 0xFFFFFFFF);
+  uint64_t expectedDack = m_dack64 ? dack : (dack & 0xFFFFFFFF);
+  NS_TEST_ASSERT_MSG_EQ (readDsn, expectedDsn, "Mapping DSN");
+  NS_TEST_ASSERT_MSG_EQ (readSsn, 1, "Mapping SSN");
+  NS_TEST_ASSERT_MSG_EQ (readLength, 1000, "Mapping length");
+  NS_TEST_ASSERT_MSG_EQ (read->GetDataAck (), expectedDack, "DATA_ACK");
+
+  // A receiver expands the truncated values against its own 64 bits state
+  SequenceNumber64 expanded = m_dsn64 ? SequenceNumber64 (readDsn)
+    : ExpandDsn (static_cast<uint32_t> (readDsn), SequenceNumber64 (dsn - 5000));
+  NS_TEST_ASSERT_MSG_EQ (expanded, SequenceNumber64 (dsn), "Receiver recovers the full DSN");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief DSS stored inline in TcpHeader, next to listed options
+ */
+class MpTcpDssHeaderTest : public TestCase
+{
+public:
+  MpTcpDssHeaderTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpDssHeaderTest::MpTcpDssHeaderTest ()
+  : TestCase ("DSS inline in the TCP header")
+{
+}
+
+void
+MpTcpDssHeaderTest::DoRun (void)
+{
+  MpTcpDss dss;
+  dss.SetDataAck (4000);
+  dss.SetMapping (3000, 1, 1400, false);
+  dss.TruncateDSS (true);
+
+  TcpHeader header;
+  header.AppendOption (CreateObject<TcpOptionTS> ());
+  NS_TEST_ASSERT_MSG_EQ (header.SetMpTcpDss (dss), true, "DSS fits");
+  NS_TEST_ASSERT_MSG_EQ (header.GetOptionList ().size (), 1, "DSS kept out of the option list");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (header.GetOptionLength ()), 10 + 18, "Option space used");
+  NS_TEST_ASSERT_MSG_EQ (header.GetSerializedSize (), 20 + 28, "Header length");
+
+  MpTcpDss dack;
+  dack.SetDataAck (5000);
+  NS_TEST_ASSERT_MSG_EQ (header.SetMpTcpDss (dack), true, "DSS replaced");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (header.GetOptionLength ()), 10 + 8, "Space of the replaced DSS freed");
+  NS_TEST_ASSERT_MSG_EQ (header.SetMpTcpDss (dss), true, "DSS replaced again");
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  TcpHeader read;
+  packet->RemoveHeader (read);
+  NS_TEST_ASSERT_MSG_NE (read.GetMpTcpDss (), 0, "DSS parsed inline");
+  NS_TEST_ASSERT_MSG_EQ ((*read.GetMpTcpDss () == dss), true, "Same DSS");
+  NS_TEST_ASSERT_MSG_EQ (read.GetOptionList ().size (), 1, "Timestamp parsed in the list");
+  NS_TEST_ASSERT_MSG_EQ (read.HasOption (TcpOption::TS), true, "Timestamp parsed in the list");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (read.GetOptionLength ()), 10 + 18, "Option space read");
+
+  // a DSS built as an option object has the same encoding
+  Ptr<TcpOptionMpTcpDSS> option = CreateObject<TcpOptionMpTcpDSS> (dss);
+  TcpHeader listed;
+  listed.AppendOption (option);
+  packet = Create<Packet> ();
+  packet->AddHeader (listed);
+  packet->RemoveHeader (read);
+  NS_TEST_ASSERT_MSG_NE (read.GetMpTcpDss (), 0, "Listed DSS parsed inline");
+  NS_TEST_ASSERT_MSG_EQ ((*read.GetMpTcpDss () == dss), true, "Same DSS");
+  NS_TEST_ASSERT_MSG_EQ (read.HasOption (TcpOption::MPTCP), false, "No DSS object");
+
+  TcpHeader empty;
+  packet = Create<Packet> ();
+  packet->AddHeader (empty);
+  packet->RemoveHeader (read);
+  NS_TEST_ASSERT_MSG_EQ (read.GetMpTcpDss (), 0, "No DSS left from the previous segment");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Reassembly of data spanning the 2^32 boundary of the DSN space
+ */
+class MpTcpDsnWrapReassemblyTest : public TestCase
+{
+public:
+  MpTcpDsnWrapReassemblyTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpDsnWrapReassemblyTest::MpTcpDsnWrapReassemblyTest ()
+  : TestCase ("Reassembly across 2^32")
+{
+}
+
+void
+MpTcpDsnWrapReassemblyTest::DoRun (void)
+{
+  const uint64_t wrap = 1ULL << 32;
+  SequenceNumber64 head (wrap - 1000);
+  SequenceNumber64 maxDsn (wrap + 100000);
+
+  MpTcpReassemblyQueue queue;
+  queue.DiscardUpTo (head);
+
+  // second half first, it starts past the wrap
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (Create<Packet> (1000), SequenceNumber64 (wrap), maxDsn), 1000, "Out of order");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsHeadAvailable (), false, "Hole before the wrap");
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (Create<Packet> (1000), head, maxDsn), 1000, "Fills the hole");
+
+  SequenceNumber64 dsn;
+  uint32_t total = 0;
+  Ptr<Packet> p;
+  while ((p = queue.Extract (dsn)))
+    {
+      NS_TEST_ASSERT_MSG_EQ (dsn, head + total, "In order");
+      total += p->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (total, 2000, "Everything extracted");
+  NS_TEST_ASSERT_MSG_EQ (queue.GetNextDsn (), SequenceNumber64 (wrap + 1000), "Next DSN past the wrap");
+  NS_TEST_ASSERT_MSG_EQ (ExpandDsn (static_cast<uint32_t> (wrap + 1000), queue.GetNextDsn ()),
+                         queue.GetNextDsn (), "Low bits map back to the same DSN");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP 64 bits data sequence numbers TestSuite
+ */
+class MpTcpDsnTestSuite : public TestSuite
+{
+public:
+  MpTcpDsnTestSuite () : TestSuite ("mptcp-dsn", UNIT)
+  {
+    AddTestCase (new MpTcpDsnExpandTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpDssEncodingTest (false, false), TestCase::QUICK);
+    AddTestCase (new MpTcpDssEncodingTest (true, false), TestCase::QUICK);
+    AddTestCase (new MpTcpDssEncodingTest (false, true), TestCase::QUICK);
+    AddTestCase (new MpTcpDssEncodingTest (true, true), TestCase::QUICK);
+    AddTestCase (new MpTcpDssHeaderTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpDsnWrapReassemblyTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpDsnTestSuite g_mptcpDsnTestSuite; //!< Static variable for test initialization
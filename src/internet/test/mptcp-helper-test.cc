@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/type-id.h"
+#include "ns3/mptcp-helper.h"
+#include "ns3/mptcp-socket-base.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpHelperTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Bulk transfer between two hosts connected by two paths, MPTCP being
+ * installed by the helper
+ */
+class MpTcpHelperTransferTest : public TestCase
+{
+public:
+  /**
+   * \param scheduler TypeId name of the scheduler
+   * \param pathManager path manager
+   * \param multipath whether additional subflows are expected
+   */
+  MpTcpHelperTransferTest (std::string scheduler, MpTcpSocketBase::PathManagerMode pathManager, bool multipath);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Fills the send buffer of the client
+   * \param socket the client socket
+   * \param available room in the send buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Reads what the server received
+   * \param socket the server socket
+   */
+  void ReceiveData (Ptr<Socket> socket);
+
+  std::string m_scheduler;                        //!< Scheduler under test
+  MpTcpSocketBase::PathManagerMode m_pathManager; //!< Path manager under test
+  bool m_multipath;                               //!< Whether additional subflows are expected
+  uint32_t m_total;                               //!< Bytes to transfer
+  uint32_t m_sent;                                //!< Bytes accepted by the client socket
+  uint32_t m_received;                            //!< Bytes read by the server
+};
+
+MpTcpHelperTransferTest::MpTcpHelperTransferTest (std::string scheduler,
+                                                  MpTcpSocketBase::PathManagerMode pathManager,
+                                                  bool multipath)
+  : TestCase ("Transfer with " + scheduler + (multipath ? " on several subflows" : " on the master subflow")),
+    m_scheduler (scheduler),
+    m_pathManager (pathManager),
+    m_multipath (multipath),
+    m_total (300000),
+    m_sent (0),
+    m_received (0)
+{
+}
+
+void
+MpTcpHelperTransferTest::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < m_total && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (m_total - m_sent, socket->GetTxAvailable ()), 1000u);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          return;
+        }
+      m_sent += sent;
+    }
+}
+
+void
+MpTcpHelperTransferTest::ReceiveData (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received += packet->GetSize ();
+    }
+}
+
+void
+MpTcpHelperTransferTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  MpTcpHelper mptcp;
+  mptcp.SetScheduler (m_scheduler);
+  mptcp.SetPathManager (m_pathManager);
+  mptcp.SetCongestionControl ("ns3::MpTcpCongestionOlia");
+  mptcp.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5 + 10 * i)));
+      NetDeviceContainer devices;
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+          device->SetAddress (Mac48Address::Allocate ());
+          device->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+          device->SetChannel (channel);
+          nodes.Get (j)->AddDevice (device);
+          devices.Add (device);
+        }
+      address.Assign (devices);
+      address.NewNetwork ();
+    }
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 80));
+  server->Listen ();
+  server->SetRecvCallback (MakeCallback (&MpTcpHelperTransferTest::ReceiveData, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  client->Bind ();
+  client->SetSendCallback (MakeCallback (&MpTcpHelperTransferTest::SendData, this));
+  client->Connect (InetSocketAddress (Ipv4Address ("10.1.1.2"), 80));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  // both sockets upgraded themselves in place
+  Ptr<MpTcpSocketBase> meta = MpTcpHelper::GetMeta (client);
+  NS_TEST_ASSERT_MSG_NE (meta, 0, "The client socket should have been upgraded to a meta socket");
+  NS_TEST_ASSERT_MSG_NE (MpTcpHelper::GetMeta (server), 0, "The server socket should have been upgraded to a meta socket");
+  TypeIdValue scheduler;
+  meta->GetAttribute ("Scheduler", scheduler);
+  NS_TEST_EXPECT_MSG_EQ (scheduler.Get ().GetName (), m_scheduler, "The meta should use the scheduler of the helper");
+  TypeIdValue congestion;
+  meta->GetAttribute ("CongestionControl", congestion);
+  NS_TEST_EXPECT_MSG_EQ (congestion.Get ().GetName (), "ns3::MpTcpCongestionOlia", "The meta should use the congestion control of the helper");
+  if (m_multipath)
+    {
+      NS_TEST_EXPECT_MSG_GT (meta->GetNActiveSubflows (), 1, "Both paths should carry a subflow");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (meta->GetNActiveSubflows (), 1, "Only the master subflow should be opened");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_received, m_total, "Every byte should be delivered");
+
+  Simulator::Destroy ();
+}
+
+void
+MpTcpHelperTransferTest::DoTeardown (void)
+{
+  // the helper works through attribute defaults
+  Config::Reset ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP helper TestSuite
+ */
+class MpTcpHelperTestSuite : public TestSuite
+{
+public:
+  MpTcpHelperTestSuite ()
+    : TestSuite ("mptcp-helper", UNIT)
+  {
+    AddTestCase (new MpTcpHelperTransferTest ("ns3::MpTcpSchedulerRoundRobin", MpTcpSocketBase::FullMesh, true), TestCase::QUICK);
+    AddTestCase (new MpTcpHelperTransferTest ("ns3::MpTcpSchedulerFastestRTT", MpTcpSocketBase::FullMesh, true), TestCase::QUICK);
+    AddTestCase (new MpTcpHelperTransferTest ("ns3::MpTcpSchedulerRoundRobin", MpTcpSocketBase::Default, false), TestCase::QUICK);
+  }
+};
+
+static MpTcpHelperTestSuite g_mptcpHelperTestSuite; //!< Static variable for test initialization
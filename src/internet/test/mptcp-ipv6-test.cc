@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/buffer.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/tcp-option-mptcp.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpIpv6TestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta exposing its address bookkeeping
+ */
+class MpTcpIpv6TestMeta : public MpTcpSocketBase
+{
+public:
+  using MpTcpSocketBase::GetUsableLocalAddresses;
+  using MpTcpSocketBase::OwnIP;
+  using MpTcpSocketBase::AddRemoteAddress;
+  using MpTcpSocketBase::RemoteAddressInfo;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief ADD_ADDR round trip with an IPv6 address
+ */
+class MpTcpAddAddressIpv6Test : public TestCase
+{
+public:
+  MpTcpAddAddressIpv6Test ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpAddAddressIpv6Test::MpTcpAddAddressIpv6Test ()
+  : TestCase ("ADD_ADDR with an IPv6 address")
+{
+}
+
+void
+MpTcpAddAddressIpv6Test::DoRun (void)
+{
+  Ipv6Address ip ("2001:db8::42");
+  Ptr<TcpOptionMpTcpAddAddress> addaddr = CreateObject<TcpOptionMpTcpAddAddress> ();
+  addaddr->SetAddress (Inet6SocketAddress (ip, 4242), 7);
+  NS_TEST_ASSERT_MSG_EQ (addaddr->GetSerializedSize (), 22, "IPv6 ADD_ADDR size");
+
+  Buffer buffer;
+  buffer.AddAtStart (addaddr->GetSerializedSize ());
+  addaddr->Serialize (buffer.Begin ());
+
+  Ptr<TcpOptionMpTcpAddAddress> read = CreateObject<TcpOptionMpTcpAddAddress> ();
+  NS_TEST_ASSERT_MSG_EQ (read->Deserialize (buffer.Begin ()), 22, "Whole option read");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (read->GetAddressVersion ()), 6, "IP version");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (read->GetAddressId ()), 7, "Address id");
+  NS_TEST_ASSERT_MSG_EQ (read->GetAddress6 ().GetIpv6 (), ip, "Address");
+  NS_TEST_ASSERT_MSG_EQ (read->GetAddress6 ().GetPort (), 4242, "Port");
+  NS_TEST_ASSERT_MSG_EQ ((*read == *addaddr), true, "Same option");
+
+  // two of them do not fit in the TCP option space
+  TcpHeader header;
+  NS_TEST_ASSERT_MSG_EQ (header.AppendOption (addaddr), true, "First ADD_ADDR");
+  NS_TEST_ASSERT_MSG_EQ (header.AppendOption (read), false, "Second ADD_ADDR");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Addresses of a dual stack node usable by new subflows
+ */
+class MpTcpDualStackAddressesTest : public TestCase
+{
+public:
+  MpTcpDualStackAddressesTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpDualStackAddressesTest::MpTcpDualStackAddressesTest ()
+  : TestCase ("Dual stack local and remote addresses")
+{
+}
+
+void
+MpTcpDualStackAddressesTest::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NetDeviceContainer devices;
+  for (int i = 0; i < 2; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      devices.Add (device);
+    }
+  InternetStackHelper stack;
+  stack.Install (node);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (NetDeviceContainer (devices.Get (0)));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (NetDeviceContainer (devices.Get (1)));
+
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  ipv6.Assign (NetDeviceContainer (devices.Get (0)));
+  ipv6.SetBase (Ipv6Address ("2001:2::"), Ipv6Prefix (64));
+  ipv6.Assign (NetDeviceContainer (devices.Get (1)));
+
+  Ptr<MpTcpIpv6TestMeta> meta = CreateObject<MpTcpIpv6TestMeta> ();
+  meta->SetNode (node);
+
+  std::vector<Address> addresses;
+  meta->GetUsableLocalAddresses (addresses);
+  uint32_t v4 = 0;
+  uint32_t v6 = 0;
+  for (std::vector<Address>::const_iterator it = addresses.begin (); it != addresses.end (); ++it)
+    {
+      if (Ipv4Address::IsMatchingType (*it))
+        {
+          ++v4;
+          NS_TEST_EXPECT_MSG_NE (Ipv4Address::ConvertFrom (*it), Ipv4Address::GetLoopback (), "No loopback");
+        }
+      else
+        {
+          ++v6;
+          NS_TEST_EXPECT_MSG_EQ (Ipv6Address::ConvertFrom (*it).IsLinkLocal (), false, "No link-local");
+          NS_TEST_EXPECT_MSG_EQ (Ipv6Address::ConvertFrom (*it).IsLocalhost (), false, "No loopback");
+        }
+      NS_TEST_EXPECT_MSG_EQ (meta->OwnIP (*it), true, "Usable addresses belong to the node");
+    }
+  NS_TEST_ASSERT_MSG_EQ (v4, 2, "One IPv4 address per interface");
+  NS_TEST_ASSERT_MSG_EQ (v6, 2, "One global IPv6 address per interface");
+
+  NS_TEST_ASSERT_MSG_EQ (meta->OwnIP (Ipv4Address ("10.1.3.1")), false, "Foreign IPv4 address");
+  NS_TEST_ASSERT_MSG_EQ (meta->OwnIP (Ipv6Address ("2001:3::1")), false, "Foreign IPv6 address");
+
+  meta->AddRemoteAddress (Ipv4Address ("10.2.1.1"), 80, 1);
+  meta->AddRemoteAddress (Ipv6Address ("2001:4::1"), 80, 2);
+  meta->AddRemoteAddress (Ipv6Address ("2001:4::1"), 80, 2);
+  NS_TEST_ASSERT_MSG_EQ (meta->RemoteAddressInfo.size (), 2, "Duplicated ADD_ADDR ignored");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP over IPv6 TestSuite
+ */
+class MpTcpIpv6TestSuite : public TestSuite
+{
+public:
+  MpTcpIpv6TestSuite () : TestSuite ("mptcp-ipv6", UNIT)
+  {
+    AddTestCase (new MpTcpAddAddressIpv6Test (), TestCase::QUICK);
+    AddTestCase (new MpTcpDualStackAddressesTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpIpv6TestSuite g_mptcpIpv6TestSuite; //!< Static variable for test initialization
@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/mptcp-mapping.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpMappingTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow receiving data covered by a given mapping
+ */
+class MpTcpMappingTestSubflow : public MpTcpSubflow
+{
+public:
+  /**
+   * \brief Register a mapping received from the peer
+   * \param mapping the mapping
+   */
+  void Map (const MpTcpMapping& mapping)
+  {
+    m_RxMappings.AddMapping (mapping);
+  }
+  /**
+   * \brief Put in order data into the receive buffer
+   * \param ssn sequence number of the first byte
+   * \param size amount of data
+   */
+  void Receive (SequenceNumber32 ssn, uint32_t size)
+  {
+    if (m_rxBuffer->Size () == 0 && m_rxBuffer->NextRxSequence () == SequenceNumber32 (0))
+      {
+        m_rxBuffer->SetNextRxSequence (ssn);
+      }
+    m_rxBuffer->Add (Create<Packet> (size), ssn);
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the extraction of a mapping spanning several segments
+ */
+class MpTcpMultiSegmentMappingTest : public TestCase
+{
+public:
+  MpTcpMultiSegmentMappingTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpMultiSegmentMappingTest::MpTcpMultiSegmentMappingTest ()
+  : TestCase ("Extraction of a mapping spanning several segments")
+{
+}
+
+void
+MpTcpMultiSegmentMappingTest::DoRun (void)
+{
+  Ptr<MpTcpMappingTestSubflow> sf = CreateObject<MpTcpMappingTestSubflow> ();
+  MpTcpMapping mapping;
+  mapping.SetHeadDSN (SequenceNumber64 (5000));
+  mapping.MapToSSN (SequenceNumber32 (1));
+  mapping.SetMappingSize (3000);
+
+  SequenceNumber64 dsn;
+  sf->Receive (SequenceNumber32 (1), 1000);
+  Ptr<Packet> p = sf->ExtractAtMostOneMapping (1000, false, dsn);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 0, "Data can't be extracted before its mapping is known");
+
+  sf->Map (mapping);
+  sf->Receive (SequenceNumber32 (1001), 1000);
+  sf->Receive (SequenceNumber32 (2001), 1000);
+
+  p = sf->ExtractAtMostOneMapping (2000, true, dsn);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 0, "The whole mapping does not fit");
+
+  p = sf->ExtractAtMostOneMapping (1000, false, dsn);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1000, "Partial extraction");
+  NS_TEST_ASSERT_MSG_EQ (dsn, SequenceNumber64 (5000), "Wrong DSN");
+
+  p = sf->ExtractAtMostOneMapping (1500, false, dsn);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1500, "Partial extraction");
+  NS_TEST_ASSERT_MSG_EQ (dsn, SequenceNumber64 (6000), "DSN must follow the extracted data");
+
+  p = sf->ExtractAtMostOneMapping (5000, false, dsn);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 500, "Can't extract beyond the end of the mapping");
+  NS_TEST_ASSERT_MSG_EQ (dsn, SequenceNumber64 (7500), "Wrong DSN");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the lookups and removals of the mapping container
+ */
+class MpTcpMappingContainerTest : public TestCase
+{
+public:
+  MpTcpMappingContainerTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Register a mapping
+   * \param container the container
+   * \param dsn head DSN
+   * \param ssn head SSN
+   * \param length length of the mapping
+   * \return the result of AddMapping
+   */
+  bool Add (MpTcpMappingContainer& container, uint64_t dsn, uint32_t ssn, uint16_t length);
+};
+
+MpTcpMappingContainerTest::MpTcpMappingContainerTest ()
+  : TestCase ("Lookups and removals in the mapping container")
+{
+}
+
+bool
+MpTcpMappingContainerTest::Add (MpTcpMappingContainer& container, uint64_t dsn, uint32_t ssn, uint16_t length)
+{
+  MpTcpMapping mapping;
+  mapping.SetHeadDSN (SequenceNumber64 (dsn));
+  mapping.MapToSSN (SequenceNumber32 (ssn));
+  mapping.SetMappingSize (length);
+  return container.AddMapping (mapping);
+}
+
+void
+MpTcpMappingContainerTest::DoRun (void)
+{
+  MpTcpMappingContainer container;
+  MpTcpMapping m;
+
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (1), m), false, "Empty container");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (1), m), false, "Empty container");
+
+  // 100 mappings of 100 bytes, enough to wrap and grow the ring
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Add (container, 10000 + 100 * i, 1 + 100 * i, 100), true, "Could not add mapping");
+    }
+  NS_TEST_ASSERT_MSG_EQ (Add (container, 50000, 150, 10), false, "SSN overlap must be rejected");
+  NS_TEST_ASSERT_MSG_EQ (container.GetSize (), 100, "Wrong size");
+
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (0), m), false, "SSN below every mapping");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (4250), m), true, "SSN lookup");
+  NS_TEST_ASSERT_MSG_EQ (m.HeadSSN (), SequenceNumber32 (4201), "Wrong mapping");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (14250), m), true, "DSN lookup");
+  NS_TEST_ASSERT_MSG_EQ (m.HeadSSN (), SequenceNumber32 (4201), "Wrong mapping");
+
+  // a reinjection maps DSN 10050 again, the latest mapping wins
+  NS_TEST_ASSERT_MSG_EQ (Add (container, 10000, 10001, 100), true, "Could not add reinjected mapping");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (10050), m), true, "DSN lookup");
+  NS_TEST_ASSERT_MSG_EQ (m.HeadSSN (), SequenceNumber32 (10001), "The mapping with the highest SSN is expected");
+
+  // a hole filled afterwards
+  NS_TEST_ASSERT_MSG_EQ (Add (container, 30000, 20001, 100), true, "Could not add mapping");
+  NS_TEST_ASSERT_MSG_EQ (Add (container, 20000, 15001, 100), true, "Could not add mapping");
+  SequenceNumber32 ssn;
+  NS_TEST_ASSERT_MSG_EQ (container.FirstUnmappedSSN (ssn), true, "Non empty container");
+  NS_TEST_ASSERT_MSG_EQ (ssn, SequenceNumber32 (20101), "Wrong first unmapped SSN");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (15050), m), true, "SSN lookup");
+  NS_TEST_ASSERT_MSG_EQ (m.HeadDSN (), SequenceNumber64 (20000), "Wrong mapping");
+
+  // cumulative ack up to SSN 5001, DSN 15000
+  NS_TEST_ASSERT_MSG_EQ (container.DiscardMappingsUpTo (SequenceNumber64 (15000), SequenceNumber32 (5001)), 50,
+                         "Wrong number of discarded mappings");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (4250), m), false, "Mapping was discarded");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (14250), m), false, "Mapping was discarded");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (10050), m), true, "Reinjection is still there");
+  NS_TEST_ASSERT_MSG_EQ (m.HeadSSN (), SequenceNumber32 (10001), "Wrong mapping");
+
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForSSN (SequenceNumber32 (10001), m), true, "SSN lookup");
+  NS_TEST_ASSERT_MSG_EQ (container.DiscardMapping (m), true, "Could not discard mapping");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (10050), m), false, "Mapping was discarded");
+
+  std::set<MpTcpMapping> mappings;
+  container.GetMappingsStartingFromSSN (SequenceNumber32 (9950), mappings);
+  NS_TEST_ASSERT_MSG_EQ (mappings.size (), 2, "Wrong number of mappings");
+
+  NS_TEST_ASSERT_MSG_EQ (container.DiscardMappingsUpTo (SequenceNumber64 (100000), SequenceNumber32 (30000)), 52,
+                         "Wrong number of discarded mappings");
+  NS_TEST_ASSERT_MSG_EQ (container.IsEmpty (), true, "Container should be empty");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (30050), m), false, "Empty container");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP mapping TestSuite
+ */
+class MpTcpMappingTestSuite : public TestSuite
+{
+public:
+  MpTcpMappingTestSuite () : TestSuite ("mptcp-mapping", UNIT)
+  {
+    AddTestCase (new MpTcpMultiSegmentMappingTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpMappingContainerTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpMappingTestSuite g_mptcpMappingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/mptcp-helper.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpPacingTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow with a settable window and RTT estimation
+ */
+class MpTcpPacingTestSubflow : public MpTcpSubflow
+{
+public:
+  /**
+   * \param cwnd congestion window
+   * \param ssThresh slow start threshold
+   * \param rtt smoothed RTT
+   */
+  void SetState (uint32_t cwnd, uint32_t ssThresh, Time rtt)
+  {
+    m_tcb->m_cWnd = cwnd;
+    m_tcb->m_ssThresh = ssThresh;
+    Ptr<RttEstimator> estimator = CreateObject<RttMeanDeviation> ();
+    estimator->Measurement (rtt);
+    SetRtt (estimator);
+    UpdatePacingRate ();
+  }
+  /**
+   * \return The current pacing rate
+   */
+  DataRate GetPacingRate (void) const
+  {
+    return m_tcb->m_currentPacingRate;
+  }
+  /**
+   * \param rate ceiling of the pacing rate
+   */
+  void SetMaxPacingRate (DataRate rate)
+  {
+    m_tcb->m_maxPacingRate = rate;
+  }
+  using MpTcpSubflow::GetPacingQuantum;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Pacing rate and quantum derived from cwnd and srtt
+ */
+class MpTcpPacingRateTest : public TestCase
+{
+public:
+  MpTcpPacingRateTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpPacingRateTest::MpTcpPacingRateTest ()
+  : TestCase ("Pacing rate follows cwnd and srtt")
+{
+}
+
+void
+MpTcpPacingRateTest::DoRun (void)
+{
+  Ptr<MpTcpPacingTestSubflow> sf = CreateObject<MpTcpPacingTestSubflow> ();
+  sf->SetAttribute ("SegmentSize", UintegerValue (1000));
+  sf->SetPacing (false);
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingQuantum (), 0, "Every segment is paced");
+
+  // 100 KB per 100 ms is 8 Mbps
+  sf->SetState (100000, 1000000, MilliSeconds (100));
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingRate (), DataRate ("16Mbps"), "Twice cwnd/srtt in slow start");
+  sf->SetState (100000, 50000, MilliSeconds (100));
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingRate (), DataRate ("9.6Mbps"), "1.2 times cwnd/srtt in congestion avoidance");
+
+  sf->SetPacing (true);
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingQuantum (), 2000, "At least 2 segments");
+  sf->SetState (1000000, 50000, MilliSeconds (10));
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingRate (), DataRate ("960Mbps"), "Fast subflow");
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingQuantum (), 65000, "At most 64 KB");
+  sf->SetMaxPacingRate (DataRate ("400Mbps"));
+  sf->SetState (100000, 50000, MilliSeconds (1));
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingRate (), DataRate ("400Mbps"), "Capped by MaxPacingRate");
+  NS_TEST_ASSERT_MSG_EQ (sf->GetPacingQuantum (), 50000, "1 ms at the pacing rate");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Bulk transfer over two paced subflows
+ */
+class MpTcpPacingTransferTest : public TestCase
+{
+public:
+  /**
+   * \param superSegments send bursts of segments per pacing quantum
+   */
+  MpTcpPacingTransferTest (bool superSegments);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Fills the send buffer of the client
+   * \param socket the client socket
+   * \param available room in the send buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Reads what the server received
+   * \param socket the server socket
+   */
+  void ReceiveData (Ptr<Socket> socket);
+  /**
+   * \brief Runs the transfer
+   * \param pacing enable subflow pacing
+   * \return The number of events simulated
+   */
+  uint64_t Transfer (bool pacing);
+
+  bool m_superSegments; //!< Send bursts of segments
+  uint32_t m_total;     //!< Bytes to transfer
+  uint32_t m_sent;      //!< Bytes accepted by the client socket
+  uint32_t m_received;  //!< Bytes read by the server
+  Ptr<Socket> m_client; //!< Client socket
+};
+
+MpTcpPacingTransferTest::MpTcpPacingTransferTest (bool superSegments)
+  : TestCase (superSegments ? "Transfer with paced super segments" : "Transfer with paced segments"),
+    m_superSegments (superSegments),
+    m_total (500000),
+    m_sent (0),
+    m_received (0)
+{
+}
+
+void
+MpTcpPacingTransferTest::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < m_total && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (m_total - m_sent, socket->GetTxAvailable ()), 1000u);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          return;
+        }
+      m_sent += sent;
+    }
+}
+
+void
+MpTcpPacingTransferTest::ReceiveData (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received += packet->GetSize ();
+    }
+}
+
+uint64_t
+MpTcpPacingTransferTest::Transfer (bool pacing)
+{
+  m_sent = 0;
+  m_received = 0;
+  Config::SetDefault ("ns3::MpTcpSocketBase::SubflowPacing", BooleanValue (pacing));
+  Config::SetDefault ("ns3::MpTcpSocketBase::SuperSegments", BooleanValue (m_superSegments));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  MpTcpHelper mptcp;
+  mptcp.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5 + 10 * i)));
+      NetDeviceContainer devices;
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+          device->SetAddress (Mac48Address::Allocate ());
+          device->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+          device->SetChannel (channel);
+          nodes.Get (j)->AddDevice (device);
+          devices.Add (device);
+        }
+      address.Assign (devices);
+      address.NewNetwork ();
+    }
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 80));
+  server->Listen ();
+  server->SetRecvCallback (MakeCallback (&MpTcpPacingTransferTest::ReceiveData, this));
+
+  m_client = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  m_client->Bind ();
+  m_client->SetSendCallback (MakeCallback (&MpTcpPacingTransferTest::SendData, this));
+  m_client->Connect (InetSocketAddress (Ipv4Address ("10.1.1.2"), 80));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+  return events;
+}
+
+void
+MpTcpPacingTransferTest::DoRun (void)
+{
+  uint64_t unpaced = Transfer (false);
+  NS_TEST_ASSERT_MSG_EQ (m_received, m_total, "Every byte should be delivered without pacing");
+  Simulator::Destroy ();
+
+  uint64_t paced = Transfer (true);
+  NS_TEST_ASSERT_MSG_EQ (m_received, m_total, "Every byte should be delivered with pacing");
+  Ptr<MpTcpSocketBase> meta = MpTcpHelper::GetMeta (m_client);
+  NS_TEST_ASSERT_MSG_NE (meta, 0, "The client socket should have been upgraded to a meta socket");
+  NS_TEST_ASSERT_MSG_GT (meta->GetNActiveSubflows (), 1, "Both paths should carry a subflow");
+  if (m_superSegments)
+    {
+      // one pacing event per burst instead of one per segment
+      NS_TEST_EXPECT_MSG_LT (paced, unpaced + m_total / 1000, "Bursts should save pacing events");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_GT (paced, unpaced, "Every segment should cost a pacing event");
+    }
+  m_client = 0;
+  Simulator::Destroy ();
+}
+
+void
+MpTcpPacingTransferTest::DoTeardown (void)
+{
+  Config::Reset ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow pacing TestSuite
+ */
+class MpTcpPacingTestSuite : public TestSuite
+{
+public:
+  MpTcpPacingTestSuite ()
+    : TestSuite ("mptcp-pacing", UNIT)
+  {
+    AddTestCase (new MpTcpPacingRateTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpPacingTransferTest (false), TestCase::QUICK);
+    AddTestCase (new MpTcpPacingTransferTest (true), TestCase::QUICK);
+  }
+};
+
+static MpTcpPacingTestSuite g_mptcpPacingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,479 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/buffer.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/icmpv4.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/mptcp-path-manager.h"
+#include "ns3/tcp-option-mptcp.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpPathManagerTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow bound to fixed addresses that records the MP_PRIO it sends
+ */
+class MpTcpPathManagerTestSubflow : public MpTcpSubflow
+{
+public:
+  MpTcpPathManagerTestSubflow ()
+    : m_nPrio (0),
+      m_lastBackup (false)
+  {
+  }
+  /**
+   * \brief Set the window, RTT and addresses of the subflow
+   * \param local local address
+   * \param peer peer address
+   * \param rtt Smoothed RTT.
+   */
+  void Set (Ipv4Address local, Ipv4Address peer, Time rtt)
+  {
+    m_tcb->m_segmentSize = 1000;
+    m_tcb->m_cWnd = 10000;
+    m_tcb->m_ssThresh = 65535;
+    m_rWnd = 65535;
+    Ptr<RttEstimator> estimator = CreateObject<RttMeanDeviation> ();
+    estimator->Measurement (rtt);
+    SetRtt (estimator);
+    m_endPoint = new Ipv4EndPoint (local, 4000);
+    m_endPoint->SetPeer (peer, 80);
+  }
+  /**
+   * \brief Release the endpoint, no L4 protocol would do it
+   */
+  void Unbind (void)
+  {
+    delete m_endPoint;
+    m_endPoint = 0;
+  }
+  /**
+   * \brief Map a DSN range on the subflow
+   * \param dsn head DSN
+   * \param length length of the mapping
+   */
+  void Map (uint64_t dsn, uint16_t length)
+  {
+    AddLooseMapping (SequenceNumber64 (dsn), length);
+  }
+  /**
+   * \brief Builds the options the segment would carry instead of sending it
+   * \param flags TCP flags
+   */
+  virtual void SendEmptyPacket (uint8_t flags)
+  {
+    TcpHeader header;
+    header.SetFlags (flags);
+    AddMpTcpOptions (header);
+    Ptr<const TcpOptionMpTcpChangePriority> prio;
+    if (GetTcpOption (header, prio))
+      {
+        ++m_nPrio;
+        m_lastBackup = prio->GetFlags () & TcpOptionMpTcpChangePriority::Backup;
+      }
+  }
+
+  uint32_t m_nPrio;     //!< Number of MP_PRIO sent
+  bool m_lastBackup;    //!< B flag of the last MP_PRIO sent
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta exposing its subflows and scheduling helpers
+ */
+class MpTcpPathManagerTestMeta : public MpTcpSocketBase
+{
+public:
+  /**
+   * \brief Register an established subflow
+   * \param sf The subflow
+   */
+  void Add (Ptr<MpTcpSubflow> sf)
+  {
+    m_subflows[Established].push_back (sf);
+  }
+  /**
+   * \brief Pretend the connection got established
+   */
+  void SetEstablished (void)
+  {
+    m_state = ESTABLISHED;
+  }
+  using MpTcpSocketBase::FillSchedulerState;
+  using MpTcpSocketBase::GetFastestSubflowForDSN;
+  using MpTcpSocketBase::ConnectInterfaceTraces;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Path manager recording the local addresses events
+ */
+class MpTcpRecordingPathManager : public MpTcpPathManager
+{
+public:
+  virtual void OnLocalAddressUp (Ptr<MpTcpSocketBase> meta, const Address& address)
+  {
+    m_up.push_back (address);
+  }
+  virtual void OnLocalAddressDown (Ptr<MpTcpSocketBase> meta, const Address& address)
+  {
+    m_down.push_back (address);
+  }
+
+  std::vector<Address> m_up;    //!< Addresses reported up
+  std::vector<Address> m_down;  //!< Addresses reported down
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MP_PRIO carries the B flag in the least significant bit
+ */
+class MpTcpPriorityOptionTest : public TestCase
+{
+public:
+  MpTcpPriorityOptionTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpPriorityOptionTest::MpTcpPriorityOptionTest ()
+  : TestCase ("MP_PRIO serialization")
+{
+}
+
+void
+MpTcpPriorityOptionTest::DoRun (void)
+{
+  Ptr<TcpOptionMpTcpChangePriority> prio = CreateObject<TcpOptionMpTcpChangePriority> ();
+  prio->SetFlags (TcpOptionMpTcpChangePriority::Backup);
+  NS_TEST_ASSERT_MSG_EQ (prio->GetSerializedSize (), 3, "MP_PRIO without address id");
+
+  Buffer buffer;
+  buffer.AddAtStart (prio->GetSerializedSize ());
+  prio->Serialize (buffer.Begin ());
+  Buffer::Iterator i = buffer.Begin ();
+  i.Next (2);
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (i.ReadU8 ()),
+                         static_cast<uint32_t> ((TcpOptionMpTcpMain::MP_PRIO << 4) | 1), "B flag is the LSB");
+
+  Ptr<TcpOptionMpTcpChangePriority> read = CreateObject<TcpOptionMpTcpChangePriority> ();
+  read->Deserialize (buffer.Begin ());
+  NS_TEST_ASSERT_MSG_EQ ((read->GetFlags () & TcpOptionMpTcpChangePriority::Backup), true, "Backup");
+  NS_TEST_ASSERT_MSG_EQ (read->EmbeddedAddressId (), false, "No address id");
+
+  prio->SetFlags (0);
+  prio->SetAddressId (3);
+  Buffer buffer2;
+  buffer2.AddAtStart (prio->GetSerializedSize ());
+  prio->Serialize (buffer2.Begin ());
+  read = CreateObject<TcpOptionMpTcpChangePriority> ();
+  NS_TEST_ASSERT_MSG_EQ (read->Deserialize (buffer2.Begin ()), 4, "MP_PRIO with address id");
+  NS_TEST_ASSERT_MSG_EQ ((read->GetFlags () & TcpOptionMpTcpChangePriority::Backup), false, "Regular");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (read->GetAddressId ()), 3, "Address id");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Failover of a regular subflow to a backup one and back
+ */
+class MpTcpBackupFailoverTest : public TestCase
+{
+public:
+  MpTcpBackupFailoverTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpBackupFailoverTest::MpTcpBackupFailoverTest ()
+  : TestCase ("Promotion of the backup subflows when the regular path fails")
+{
+}
+
+void
+MpTcpBackupFailoverTest::DoRun (void)
+{
+  Ptr<MpTcpPathManagerTestMeta> meta = CreateObject<MpTcpPathManagerTestMeta> ();
+  Ptr<MpTcpPathManagerTestSubflow> regular = CreateObject<MpTcpPathManagerTestSubflow> ();
+  Ptr<MpTcpPathManagerTestSubflow> backup = CreateObject<MpTcpPathManagerTestSubflow> ();
+  regular->Set (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.2.1.1"), MilliSeconds (10));
+  backup->Set (Ipv4Address ("10.1.2.1"), Ipv4Address ("10.2.1.1"), MilliSeconds (100));
+  backup->SetBackup (true);
+  regular->SetMeta (meta);
+  backup->SetMeta (meta);
+  meta->Add (regular);
+  meta->Add (backup);
+
+  Ptr<MpTcpPathManager> pm = CreateObject<MpTcpPathManager> ();
+  pm->SetAttribute ("TimeoutThreshold", UintegerValue (2));
+  meta->SetPathManager (pm);
+
+  regular->Map (1000, 500);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetFastestSubflowForDSN (SequenceNumber64 (5000)), regular, "Fastest subflow");
+
+  pm->OnSubflowTimeout (meta, regular, 1);
+  NS_TEST_ASSERT_MSG_EQ (regular->IsPathFailed (), false, "A single RTO is tolerated");
+  NS_TEST_ASSERT_MSG_EQ (meta->BackupsPromoted (), false, "Regular path still in use");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_nPrio, 0, "No MP_PRIO");
+
+  pm->OnSubflowTimeout (meta, regular, 2);
+  NS_TEST_ASSERT_MSG_EQ (regular->IsPathFailed (), true, "Path failed");
+  NS_TEST_ASSERT_MSG_EQ (meta->BackupsPromoted (), true, "Backup promoted");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_nPrio, 1, "MP_PRIO sent on the backup subflow");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_lastBackup, false, "Peer asked to use the backup subflow");
+  NS_TEST_ASSERT_MSG_EQ (regular->m_nPrio, 0, "Nothing sent on the failed path");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetFastestSubflowForDSN (SequenceNumber64 (5000)), backup,
+                         "Failed subflow skipped");
+
+  MpTcpSchedulerState state;
+  meta->FillSchedulerState (state);
+  NS_TEST_ASSERT_MSG_EQ (state.subflows.size (), 2, "Both subflows in the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (state.subflows[0].available, 0, "No data for the failed subflow");
+  NS_TEST_ASSERT_MSG_EQ (state.subflows[0].backup, true, "Failed subflow seen as backup");
+
+  pm->OnSubflowTimeout (meta, regular, 3);
+  NS_TEST_ASSERT_MSG_EQ (backup->m_nPrio, 1, "MP_PRIO only on transitions");
+
+  pm->OnSubflowRecovered (meta, regular);
+  NS_TEST_ASSERT_MSG_EQ (regular->IsPathFailed (), false, "Path recovered");
+  NS_TEST_ASSERT_MSG_EQ (meta->BackupsPromoted (), false, "Backup demoted");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_nPrio, 2, "Second MP_PRIO");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_lastBackup, true, "Backup again");
+
+  // the interface of the regular subflow goes down then up again
+  pm->OnLocalAddressDown (meta, Ipv4Address ("10.1.1.1"));
+  NS_TEST_ASSERT_MSG_EQ (regular->IsPathFailed (), true, "Interface down");
+  NS_TEST_ASSERT_MSG_EQ (backup->IsPathFailed (), false, "Other interface still up");
+  NS_TEST_ASSERT_MSG_EQ (meta->BackupsPromoted (), true, "Backup promoted");
+  pm->OnLocalAddressUp (meta, Ipv4Address ("10.1.1.1"));
+  NS_TEST_ASSERT_MSG_EQ (regular->IsPathFailed (), false, "Interface up");
+  NS_TEST_ASSERT_MSG_EQ (meta->BackupsPromoted (), false, "Backup demoted");
+  NS_TEST_ASSERT_MSG_EQ (backup->m_nPrio, 4, "One MP_PRIO per transition");
+
+  regular->Unbind ();
+  backup->Unbind ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Transitions of the subflow health state machine
+ */
+class MpTcpSubflowHealthTest : public TestCase
+{
+public:
+  MpTcpSubflowHealthTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Records the health transitions
+   * \param oldValue previous state
+   * \param newValue new state
+   */
+  void HealthChanged (MpTcpSubflow::HealthState oldValue, MpTcpSubflow::HealthState newValue);
+
+  std::vector<MpTcpSubflow::HealthState> m_states; //!< States entered
+};
+
+MpTcpSubflowHealthTest::MpTcpSubflowHealthTest ()
+  : TestCase ("Subflow health from RTOs, ICMP and acknowledgments")
+{
+}
+
+void
+MpTcpSubflowHealthTest::HealthChanged (MpTcpSubflow::HealthState oldValue, MpTcpSubflow::HealthState newValue)
+{
+  m_states.push_back (newValue);
+}
+
+void
+MpTcpSubflowHealthTest::DoRun (void)
+{
+  Ptr<MpTcpPathManagerTestMeta> meta = CreateObject<MpTcpPathManagerTestMeta> ();
+  Ptr<MpTcpPathManagerTestSubflow> fast = CreateObject<MpTcpPathManagerTestSubflow> ();
+  Ptr<MpTcpPathManagerTestSubflow> slow = CreateObject<MpTcpPathManagerTestSubflow> ();
+  fast->Set (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.2.1.1"), MilliSeconds (10));
+  slow->Set (Ipv4Address ("10.1.2.1"), Ipv4Address ("10.2.1.1"), MilliSeconds (50));
+  fast->SetMeta (meta);
+  slow->SetMeta (meta);
+  meta->Add (fast);
+  meta->Add (slow);
+  fast->TraceConnectWithoutContext ("Health", MakeCallback (&MpTcpSubflowHealthTest::HealthChanged, this));
+
+  Ptr<MpTcpPathManager> pm = CreateObject<MpTcpPathManager> ();
+  pm->SetAttribute ("TimeoutThreshold", UintegerValue (3));
+  meta->SetPathManager (pm);
+
+  fast->Map (1000, 500);
+  pm->OnSubflowTimeout (meta, fast, 1);
+  NS_TEST_ASSERT_MSG_EQ (fast->GetHealth (), MpTcpSubflow::PotentiallyFailed, "Suspected on the first RTO");
+  NS_TEST_ASSERT_MSG_EQ (fast->IsPathFailed (), false, "Not failed yet");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetFastestSubflowForDSN (SequenceNumber64 (5000)), slow,
+                         "Suspected subflow skipped by reinjections");
+  MpTcpSchedulerState state;
+  meta->FillSchedulerState (state);
+  NS_TEST_ASSERT_MSG_EQ (state.subflows[0].backup, true, "Suspected subflow only used if nothing else is left");
+  NS_TEST_ASSERT_MSG_NE (state.subflows[0].available, 0, "Suspected subflow still usable");
+
+  pm->OnSubflowTimeout (meta, fast, 2);
+  NS_TEST_ASSERT_MSG_EQ (fast->GetHealth (), MpTcpSubflow::PotentiallyFailed, "Below the threshold");
+  pm->OnSubflowRecovered (meta, fast);
+  NS_TEST_ASSERT_MSG_EQ (fast->GetHealth (), MpTcpSubflow::Recovered, "Acknowledged again");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetFastestSubflowForDSN (SequenceNumber64 (5000)), fast, "Used again");
+
+  pm->OnSubflowTimeout (meta, fast, 1);
+  NS_TEST_ASSERT_MSG_EQ (fast->GetHealth (), MpTcpSubflow::Failed, "No second chance while recovering");
+  meta->FillSchedulerState (state);
+  NS_TEST_ASSERT_MSG_EQ (state.subflows[0].available, 0, "Nothing for a failed subflow");
+
+  pm->OnSubflowRecovered (meta, fast);
+  NS_TEST_ASSERT_MSG_EQ (fast->GetHealth (), MpTcpSubflow::Recovered, "Failed subflow recovered");
+
+  // the fragmentation needed message is about the MTU, not the path
+  slow->ForwardIcmp (Ipv4Address ("10.2.1.1"), 64, Icmpv4Header::ICMPV4_DEST_UNREACH,
+                     Icmpv4DestinationUnreachable::ICMPV4_FRAG_NEEDED, 0);
+  NS_TEST_ASSERT_MSG_EQ (slow->GetHealth (), MpTcpSubflow::Active, "MTU problem");
+  slow->ForwardIcmp (Ipv4Address ("10.2.1.1"), 64, Icmpv4Header::ICMPV4_DEST_UNREACH,
+                     Icmpv4DestinationUnreachable::ICMPV4_HOST_UNREACHABLE, 0);
+  NS_TEST_ASSERT_MSG_EQ (slow->GetHealth (), MpTcpSubflow::Failed, "Host unreachable");
+
+  NS_TEST_ASSERT_MSG_EQ (m_states.size (), 4, "Transitions of the fast subflow");
+  NS_TEST_ASSERT_MSG_EQ (m_states[0], MpTcpSubflow::PotentiallyFailed, "First transition");
+  NS_TEST_ASSERT_MSG_EQ (m_states[3], MpTcpSubflow::Recovered, "Last transition");
+
+  fast->Unbind ();
+  slow->Unbind ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Interfaces going down or up are reported to the path manager
+ */
+class MpTcpInterfaceEventsTest : public TestCase
+{
+public:
+  MpTcpInterfaceEventsTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpInterfaceEventsTest::MpTcpInterfaceEventsTest ()
+  : TestCase ("Interface up and down events")
+{
+}
+
+void
+MpTcpInterfaceEventsTest::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NetDeviceContainer devices;
+  for (int i = 0; i < 2; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      devices.Add (device);
+    }
+  InternetStackHelper stack;
+  stack.Install (node);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (NetDeviceContainer (devices.Get (0)));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (NetDeviceContainer (devices.Get (1)));
+
+  Ptr<MpTcpPathManagerTestMeta> meta = CreateObject<MpTcpPathManagerTestMeta> ();
+  Ptr<MpTcpRecordingPathManager> pm = CreateObject<MpTcpRecordingPathManager> ();
+  meta->SetNode (node);
+  meta->SetPathManager (pm);
+  meta->SetEstablished ();
+  meta->ConnectInterfaceTraces ();
+
+  Ptr<Ipv4L3Protocol> l3 = node->GetObject<Ipv4L3Protocol> ();
+  uint32_t interface = l3->GetInterfaceForDevice (devices.Get (1));
+  l3->SetDown (interface);
+  NS_TEST_ASSERT_MSG_EQ (pm->m_down.size (), 1, "One address down");
+  NS_TEST_ASSERT_MSG_EQ (Ipv4Address::ConvertFrom (pm->m_down[0]), Ipv4Address ("10.1.2.1"), "Address down");
+  NS_TEST_ASSERT_MSG_EQ (pm->m_up.size (), 0, "No address up");
+
+  l3->SetUp (interface);
+  NS_TEST_ASSERT_MSG_EQ (pm->m_up.size (), 1, "One address up");
+  NS_TEST_ASSERT_MSG_EQ (Ipv4Address::ConvertFrom (pm->m_up[0]), Ipv4Address ("10.1.2.1"), "Address up");
+
+  meta = 0;
+  // no callback left on the destroyed meta
+  l3->SetDown (interface);
+  NS_TEST_ASSERT_MSG_EQ (pm->m_down.size (), 1, "Meta disconnected");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP path manager TestSuite
+ */
+class MpTcpPathManagerTestSuite : public TestSuite
+{
+public:
+  MpTcpPathManagerTestSuite () : TestSuite ("mptcp-path-manager", UNIT)
+  {
+    AddTestCase (new MpTcpPriorityOptionTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpBackupFailoverTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpSubflowHealthTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpInterfaceEventsTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpPathManagerTestSuite g_mptcpPathManagerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpRcvBufAutoTuningTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket exposing the receiver side RTT estimation
+ */
+class TcpRcvRttTestSocket : public TcpSocketBase
+{
+public:
+  /**
+   * \brief Receive data in order, immediately read by the application
+   * \param bytes amount of data
+   * \param echo timestamp echoed by the segment, no timestamp option if 0
+   */
+  void Receive (uint32_t bytes, uint32_t echo)
+  {
+    TcpHeader header;
+    header.SetSequenceNumber (m_rxBuffer->NextRxSequence ());
+    if (echo != 0)
+      {
+        Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS> ();
+        ts->SetEcho (echo);
+        header.AppendOption (ts);
+      }
+    m_rxBuffer->Add (Create<Packet> (bytes), header);
+    UpdateRcvRtt (header);
+    m_rxBuffer->Extract (bytes);
+  }
+  using TcpSocketBase::GetRcvRtt;
+  using TcpSocketBase::CalculateWScale;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow with a fixed RTT estimation
+ */
+class MpTcpRcvBufTestSubflow : public MpTcpSubflow
+{
+public:
+  /**
+   * \param rtt smoothed RTT of the subflow
+   */
+  void SetRttEstimate (Time rtt)
+  {
+    Ptr<RttEstimator> estimator = CreateObject<RttMeanDeviation> ();
+    estimator->Measurement (rtt);
+    SetRtt (estimator);
+  }
+  /**
+   * \brief Sets the scale factor as if the subflow had sent its SYN
+   */
+  void NegotiateScale (void)
+  {
+    m_rcvWindShift = CalculateWScale ();
+  }
+  using MpTcpSubflow::CalculateWScale;
+  using MpTcpSubflow::AdvertisedWindowSize;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta receiving data in order from its subflows
+ */
+class MpTcpRcvBufTestMeta : public MpTcpSocketBase
+{
+public:
+  /**
+   * \brief Register an established subflow
+   * \param sf The subflow
+   */
+  void Add (Ptr<MpTcpSubflow> sf)
+  {
+    m_subflows[Established].push_back (sf);
+  }
+  /**
+   * \brief Deliver data in order, immediately read by the application
+   * \param bytes amount of data
+   */
+  void Deliver (uint32_t bytes)
+  {
+    m_rxBuffer->Add (Create<Packet> (bytes), m_rxBuffer->NextRxSequence ());
+    m_rxBuffer->Extract (bytes);
+    AutoTuneRcvBuf ();
+  }
+  using MpTcpSocketBase::CalculateWScale;
+  using MpTcpSocketBase::GetRcvBufAutoTuningRtt;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Receiver side RTT estimation, with and without timestamps
+ */
+class TcpRcvRttTest : public TestCase
+{
+public:
+  TcpRcvRttTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Remembers the timestamp sent at this time
+   */
+  void SaveTimestamp (void);
+
+  Ptr<TcpRcvRttTestSocket> m_socket; //!< Receiver
+  uint32_t m_ts;                     //!< Timestamp the peer will echo
+};
+
+TcpRcvRttTest::TcpRcvRttTest ()
+  : TestCase ("Receiver side RTT estimation"),
+    m_ts (0)
+{
+}
+
+void
+TcpRcvRttTest::SaveTimestamp (void)
+{
+  m_ts = TcpOptionTS::NowToTsValue ();
+}
+
+void
+TcpRcvRttTest::DoRun (void)
+{
+  m_socket = CreateObject<TcpRcvRttTestSocket> ();
+  m_socket->GetRxBuffer ()->SetMaxBufferSize (10000);
+
+  // a window worth of data takes 100 ms
+  Simulator::Schedule (MilliSeconds (100), &TcpRcvRttTestSocket::Receive, m_socket, 1000, 0);
+  Simulator::Schedule (MilliSeconds (150), &TcpRcvRttTestSocket::Receive, m_socket, 5000, 0);
+  Simulator::Schedule (MilliSeconds (200), &TcpRcvRttTestSocket::Receive, m_socket, 5000, 0);
+  Simulator::Stop (MilliSeconds (250));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_socket->GetRcvRtt (), MilliSeconds (100), "Window based sample");
+
+  // a faster window lowers the estimation
+  Simulator::Schedule (MilliSeconds (20), &TcpRcvRttTestSocket::Receive, m_socket, 10000, 0);
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_socket->GetRcvRtt (), MilliSeconds (70), "Minimum of the samples");
+
+  m_socket->SetAttribute ("Timestamp", BooleanValue (true));
+  Simulator::Schedule (MilliSeconds (10), &TcpRcvRttTest::SaveTimestamp, this);
+  Simulator::Stop (MilliSeconds (70));
+  Simulator::Run ();
+  m_socket->Receive (1000, m_ts);
+  NS_TEST_ASSERT_MSG_EQ (m_socket->GetRcvRtt (), MicroSeconds ((7 * 70000 + 60000) / 8),
+                         "Timestamp sample averaged");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief The meta buffer follows the data delivered over the RTT of the slowest subflow
+ */
+class MpTcpRcvBufAutoTuningTest : public TestCase
+{
+public:
+  MpTcpRcvBufAutoTuningTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the size of the meta Rx buffer
+   * \param expected expected size
+   * \param msg message printed on failure
+   */
+  void CheckSize (uint32_t expected, std::string msg);
+
+  Ptr<MpTcpRcvBufTestMeta> m_meta; //!< Receiver
+};
+
+MpTcpRcvBufAutoTuningTest::MpTcpRcvBufAutoTuningTest ()
+  : TestCase ("Meta receive buffer auto-tuning")
+{
+}
+
+void
+MpTcpRcvBufAutoTuningTest::CheckSize (uint32_t expected, std::string msg)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetRxBuffer ()->MaxBufferSize (), expected, msg);
+}
+
+void
+MpTcpRcvBufAutoTuningTest::DoRun (void)
+{
+  m_meta = CreateObject<MpTcpRcvBufTestMeta> ();
+  m_meta->SetAttribute ("RcvBufAutoTuning", BooleanValue (true));
+  m_meta->SetAttribute ("RcvBufMax", UintegerValue (4000000));
+  m_meta->SetAttribute ("SegmentSize", UintegerValue (1000));
+  m_meta->GetRxBuffer ()->SetMaxBufferSize (131072);
+
+  Ptr<MpTcpRcvBufTestSubflow> fast = CreateObject<MpTcpRcvBufTestSubflow> ();
+  Ptr<MpTcpRcvBufTestSubflow> slow = CreateObject<MpTcpRcvBufTestSubflow> ();
+  fast->SetRttEstimate (MilliSeconds (10));
+  slow->SetRttEstimate (MilliSeconds (50));
+  fast->SetMeta (m_meta);
+  slow->SetMeta (m_meta);
+  m_meta->Add (fast);
+  m_meta->Add (slow);
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetRcvBufAutoTuningRtt (), MilliSeconds (50), "RTT of the slowest subflow");
+
+  // the scale covers the ceiling, and the subflows use the one of the meta
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (m_meta->CalculateWScale ()), 6, "Scale of the ceiling");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (fast->CalculateWScale ()), 6, "Scale of the meta");
+
+  // starts the measure, then 20 ms are less than the RTT
+  Simulator::Schedule (MilliSeconds (1000), &MpTcpRcvBufTestMeta::Deliver, m_meta, 1000);
+  Simulator::Schedule (MilliSeconds (1020), &MpTcpRcvBufTestMeta::Deliver, m_meta, 40000);
+  Simulator::Schedule (MilliSeconds (1021), &MpTcpRcvBufAutoTuningTest::CheckSize, this,
+                       131072, "Not measured over a RTT yet");
+  // 50000 bytes in a RTT, i.e. 5 times the initial window
+  Simulator::Schedule (MilliSeconds (1050), &MpTcpRcvBufTestMeta::Deliver, m_meta, 10000);
+  Simulator::Schedule (MilliSeconds (1051), &MpTcpRcvBufAutoTuningTest::CheckSize, this,
+                       1044000, "Grown");
+  // steady rate
+  Simulator::Schedule (MilliSeconds (1100), &MpTcpRcvBufTestMeta::Deliver, m_meta, 50000);
+  Simulator::Schedule (MilliSeconds (1101), &MpTcpRcvBufAutoTuningTest::CheckSize, this,
+                       1044000, "Kept at steady rate");
+  Simulator::Schedule (MilliSeconds (1150), &MpTcpRcvBufTestMeta::Deliver, m_meta, 500000);
+  Simulator::Schedule (MilliSeconds (1151), &MpTcpRcvBufAutoTuningTest::CheckSize, this,
+                       4000000, "Capped");
+  Simulator::Run ();
+
+  fast->NegotiateScale ();
+  NS_TEST_ASSERT_MSG_EQ (fast->AdvertisedWindowSize (), (4000000 >> 6), "Meta window scaled");
+  NS_TEST_ASSERT_MSG_EQ (fast->AdvertisedWindowSize (false), 65535, "Unscaled window truncated");
+
+  // without auto-tuning nothing changes
+  Ptr<MpTcpRcvBufTestMeta> fixed = CreateObject<MpTcpRcvBufTestMeta> ();
+  fixed->GetRxBuffer ()->SetMaxBufferSize (131072);
+  fixed->Add (slow);
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (fixed->CalculateWScale ()), 2, "Scale of the buffer");
+  fixed->Deliver (1000);
+  Simulator::Schedule (MilliSeconds (100), &MpTcpRcvBufTestMeta::Deliver, fixed, 100000);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (fixed->GetRxBuffer ()->MaxBufferSize (), 131072, "Static buffer");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Receive buffer auto-tuning TestSuite
+ */
+class MpTcpRcvBufAutoTuningTestSuite : public TestSuite
+{
+public:
+  MpTcpRcvBufAutoTuningTestSuite () : TestSuite ("mptcp-rcvbuf-autotuning", UNIT)
+  {
+    AddTestCase (new TcpRcvRttTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpRcvBufAutoTuningTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpRcvBufAutoTuningTestSuite g_mptcpRcvBufAutoTuningTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/mptcp-range-set.h"
+#include "ns3/mptcp-reassembly-queue.h"
+#include "ns3/mptcp-scheduler-fastest-rtt.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpReassemblyTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Merging, gaps and discarding of DSN ranges
+ */
+class MpTcpRangeSetTest : public TestCase
+{
+public:
+  MpTcpRangeSetTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpRangeSetTest::MpTcpRangeSetTest ()
+  : TestCase ("DSN range set")
+{
+}
+
+void
+MpTcpRangeSetTest::DoRun (void)
+{
+  MpTcpRangeSet ranges;
+  NS_TEST_ASSERT_MSG_EQ (ranges.Add (SequenceNumber64 (100), SequenceNumber64 (200)), 100, "New range");
+  NS_TEST_ASSERT_MSG_EQ (ranges.Add (SequenceNumber64 (300), SequenceNumber64 (400)), 100, "New range");
+  NS_TEST_ASSERT_MSG_EQ (ranges.GetSize (), 2, "Disjoint ranges");
+  NS_TEST_ASSERT_MSG_EQ (ranges.Add (SequenceNumber64 (150), SequenceNumber64 (250)), 50, "Overlap");
+  NS_TEST_ASSERT_MSG_EQ (ranges.GetSize (), 2, "Merged with the first range");
+
+  std::vector<MpTcpDsnRange> gaps;
+  ranges.GetGaps (SequenceNumber64 (50), SequenceNumber64 (500), gaps);
+  NS_TEST_ASSERT_MSG_EQ (gaps.size (), 3, "Holes around and between the ranges");
+  NS_TEST_EXPECT_MSG_EQ (gaps[0].first, SequenceNumber64 (50), "First hole");
+  NS_TEST_EXPECT_MSG_EQ (gaps[0].second, SequenceNumber64 (100), "First hole");
+  NS_TEST_EXPECT_MSG_EQ (gaps[1].first, SequenceNumber64 (250), "Second hole");
+  NS_TEST_EXPECT_MSG_EQ (gaps[1].second, SequenceNumber64 (300), "Second hole");
+  NS_TEST_EXPECT_MSG_EQ (gaps[2].first, SequenceNumber64 (400), "Last hole");
+  NS_TEST_EXPECT_MSG_EQ (gaps[2].second, SequenceNumber64 (500), "Last hole");
+
+  // Filling the hole exactly merges everything
+  NS_TEST_ASSERT_MSG_EQ (ranges.Add (SequenceNumber64 (250), SequenceNumber64 (300)), 50, "Hole filled");
+  NS_TEST_ASSERT_MSG_EQ (ranges.GetSize (), 1, "Adjacent ranges are merged");
+  NS_TEST_ASSERT_MSG_EQ (ranges.GetBytes (), 300, "Bytes covered");
+  NS_TEST_ASSERT_MSG_EQ (ranges.Add (SequenceNumber64 (120), SequenceNumber64 (180)), 0, "Duplicate");
+  NS_TEST_EXPECT_MSG_EQ (ranges.SkipCovered (SequenceNumber64 (120)), SequenceNumber64 (400), "Skip");
+  NS_TEST_EXPECT_MSG_EQ (ranges.SkipCovered (SequenceNumber64 (400)), SequenceNumber64 (400), "Tail excluded");
+
+  ranges.DiscardUpTo (SequenceNumber64 (350));
+  NS_TEST_EXPECT_MSG_EQ (ranges.Begin ()->first, SequenceNumber64 (350), "Range cut");
+  NS_TEST_EXPECT_MSG_EQ (ranges.GetBytes (), 50, "Bytes covered after discard");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Out of order insertions in the meta reassembly queue
+ */
+class MpTcpReassemblyQueueTest : public TestCase
+{
+public:
+  MpTcpReassemblyQueueTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpReassemblyQueueTest::MpTcpReassemblyQueueTest ()
+  : TestCase ("Reassembly of data received on several subflows")
+{
+}
+
+void
+MpTcpReassemblyQueueTest::DoRun (void)
+{
+  MpTcpReassemblyQueue queue;
+  SequenceNumber64 window (100000);
+  SequenceNumber64 dsn;
+  queue.DiscardUpTo (SequenceNumber64 (1000));
+
+  // Data from the fast subflow arrives before the head, sent on the slow one
+  Ptr<Packet> fast = Create<Packet> (500);
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (fast, SequenceNumber64 (1500), window), 500, "Stored out of order");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsHeadAvailable (), false, "Head missing");
+  NS_TEST_ASSERT_MSG_EQ (queue.Extract (dsn), 0, "Nothing in order");
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (Create<Packet> (300), SequenceNumber64 (1600), window), 0, "Duplicate");
+
+  // Partial overlap: only the new part is fragmented
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (Create<Packet> (400), SequenceNumber64 (1800), window), 200, "Tail is new");
+  NS_TEST_ASSERT_MSG_EQ (queue.GetRanges ().GetSize (), 1, "Ranges merged");
+  NS_TEST_ASSERT_MSG_EQ (queue.Size (), 700, "Occupancy");
+
+  Ptr<Packet> slow = Create<Packet> (500);
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (slow, SequenceNumber64 (1000), window), 500, "Head filled");
+  Ptr<Packet> p = queue.Extract (dsn);
+  NS_TEST_EXPECT_MSG_EQ (dsn, SequenceNumber64 (1000), "Head first");
+  NS_TEST_EXPECT_MSG_EQ (p, slow, "Packets that do not overlap are not copied");
+  p = queue.Extract (dsn);
+  NS_TEST_EXPECT_MSG_EQ (dsn, SequenceNumber64 (1500), "Then the fast subflow data");
+  NS_TEST_EXPECT_MSG_EQ (p, fast, "Packets that do not overlap are not copied");
+  p = queue.Extract (dsn);
+  NS_TEST_EXPECT_MSG_EQ (dsn, SequenceNumber64 (2000), "Then the fragment");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 200, "Fragment size");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "Everything delivered");
+  NS_TEST_EXPECT_MSG_EQ (queue.GetNextDsn (), SequenceNumber64 (2200), "Next expected DSN");
+
+  // Data below the next DSN or beyond the window is dropped
+  NS_TEST_ASSERT_MSG_EQ (queue.Add (Create<Packet> (300), SequenceNumber64 (2000), SequenceNumber64 (2300)), 100,
+                         "Trimmed on both sides");
+  queue.DiscardUpTo (SequenceNumber64 (2250));
+  NS_TEST_EXPECT_MSG_EQ (queue.Size (), 50, "Discarded up to the new head");
+  p = queue.Extract (dsn);
+  NS_TEST_EXPECT_MSG_EQ (dsn, SequenceNumber64 (2250), "Remainder of the fragment");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ranges sent ahead of the next DSN are not scheduled again
+ */
+class MpTcpSentAheadTest : public TestCase
+{
+public:
+  MpTcpSentAheadTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpSentAheadTest::MpTcpSentAheadTest ()
+  : TestCase ("Scheduling around ranges sent ahead")
+{
+}
+
+void
+MpTcpSentAheadTest::DoRun (void)
+{
+  MpTcpSchedulerState state;
+  state.nextTxSequence = SequenceNumber64 (100);
+  state.pending = 5000;
+  state.window = 100000;
+  state.sendWindow = 100000;
+  state.inFlight = 0;
+  state.sentAhead.Add (SequenceNumber64 (1100), SequenceNumber64 (2100));
+
+  MpTcpSubflowState sf;
+  sf.id = 0;
+  sf.cwnd = 10000;
+  sf.ssThresh = 0xffffffff;
+  sf.inFlight = 0;
+  sf.available = 10000;
+  sf.segmentSize = 1000;
+  sf.srtt = MilliSeconds (10);
+  sf.rttVar = MilliSeconds (1);
+  sf.backup = false;
+  state.subflows.push_back (sf);
+
+  MpTcpAssignmentList decisions;
+  CreateObject<MpTcpSchedulerFastestRTT> ()->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 2, "The range sent ahead splits the new data");
+  NS_TEST_EXPECT_MSG_EQ (decisions[0].dsn, SequenceNumber64 (100), "Up to the range sent ahead");
+  NS_TEST_EXPECT_MSG_EQ (decisions[0].length, 1000, "Up to the range sent ahead");
+  NS_TEST_EXPECT_MSG_EQ (decisions[1].dsn, SequenceNumber64 (2100), "After the range sent ahead");
+  NS_TEST_EXPECT_MSG_EQ (decisions[1].length, 3000, "Rest of the data");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP reassembly TestSuite
+ */
+class MpTcpReassemblyTestSuite : public TestSuite
+{
+public:
+  MpTcpReassemblyTestSuite () : TestSuite ("mptcp-reassembly", UNIT)
+  {
+    AddTestCase (new MpTcpRangeSetTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpReassemblyQueueTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpSentAheadTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpReassemblyTestSuite g_mptcpReassemblyTestSuite; //!< Static variable for test initialization
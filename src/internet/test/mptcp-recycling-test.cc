@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/mptcp-helper.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-path-manager.h"
+#include "ns3/mptcp-fullmesh.h"
+#include "ns3/mptcp-scheduler-round-robin.h"
+#include "ns3/mptcp-scheduler-ecf.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpRecyclingTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Round robin scheduler exposing its position
+ */
+class MpTcpRecyclingTestScheduler : public MpTcpSchedulerRoundRobin
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::MpTcpRecyclingTestScheduler")
+      .SetParent<MpTcpSchedulerRoundRobin> ()
+      .SetGroupName ("Internet")
+      .AddConstructor<MpTcpRecyclingTestScheduler> ()
+    ;
+    return tid;
+  }
+  /**
+   * \return The last subflow the scheduler used
+   */
+  uint8_t GetLastUsed (void) const
+  {
+    return m_lastUsedFlowId;
+  }
+  /**
+   * \param id last subflow used
+   */
+  void SetLastUsed (uint8_t id)
+  {
+    m_lastUsedFlowId = id;
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Schedulers, path managers and socket memory are reused by the node
+ */
+class MpTcpRecyclingUnitTest : public TestCase
+{
+public:
+  MpTcpRecyclingUnitTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpRecyclingUnitTest::MpTcpRecyclingUnitTest ()
+  : TestCase ("Recycling of schedulers, path managers and sockets")
+{
+}
+
+void
+MpTcpRecyclingUnitTest::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  MpTcpHelper mptcp;
+  mptcp.Install (node);
+  Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol> ();
+
+  Ptr<MpTcpPathManager> pm = tcp->GetMpTcpPathManager (MpTcpFullMesh::GetTypeId ());
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<MpTcpFullMesh> (pm), 0, "Path manager of the requested type");
+  NS_TEST_ASSERT_MSG_EQ (tcp->GetMpTcpPathManager (MpTcpFullMesh::GetTypeId ()), pm, "One path manager per node");
+  NS_TEST_ASSERT_MSG_NE (tcp->GetMpTcpPathManager (MpTcpPathManager::GetTypeId ()), pm, "One path manager per type");
+
+  Ptr<MpTcpScheduler> scheduler = tcp->AllocateMpTcpScheduler (MpTcpRecyclingTestScheduler::GetTypeId ());
+  Ptr<MpTcpRecyclingTestScheduler> rr = DynamicCast<MpTcpRecyclingTestScheduler> (scheduler);
+  NS_TEST_ASSERT_MSG_NE (rr, 0, "Scheduler of the requested type");
+  NS_TEST_ASSERT_MSG_NE (tcp->AllocateMpTcpScheduler (MpTcpRecyclingTestScheduler::GetTypeId ()), scheduler,
+                         "Schedulers in use are not shared");
+  rr->SetLastUsed (1);
+  tcp->RecycleMpTcpScheduler (scheduler);
+  NS_TEST_ASSERT_MSG_NE (tcp->AllocateMpTcpScheduler (MpTcpSchedulerEcf::GetTypeId ()), scheduler,
+                         "Recycled per type");
+  NS_TEST_ASSERT_MSG_EQ (tcp->AllocateMpTcpScheduler (MpTcpRecyclingTestScheduler::GetTypeId ()), scheduler,
+                         "Scheduler of a closed connection reused");
+  NS_TEST_ASSERT_MSG_EQ (rr->GetLastUsed (), 0, "Recycled scheduler reset");
+
+  Ptr<TcpSocketBase> socket = CreateObject<TcpSocketBase> ();
+  TcpSocketBase *memory = PeekPointer (socket);
+  socket = 0;
+  Ptr<MpTcpSocketBase> meta = CreateObject<MpTcpSocketBase> ();
+  NS_TEST_ASSERT_MSG_EQ (PeekPointer (meta), memory, "Memory of the destroyed socket reused");
+  meta = 0;
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Successive connections between two hosts share their path manager
+ */
+class MpTcpRecyclingChurnTest : public TestCase
+{
+public:
+  MpTcpRecyclingChurnTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Opens a connection
+   * \param port port the server listens on
+   */
+  void Open (uint16_t port);
+  /**
+   * \brief Sends the data of a connection then closes it
+   * \param socket the client socket
+   * \param available room in the send buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Reads what the server received
+   * \param socket the server socket
+   */
+  void ReceiveData (Ptr<Socket> socket);
+
+  NodeContainer m_nodes;                //!< Client and server
+  uint32_t m_received;                  //!< Bytes read by the servers
+  std::vector<Ptr<Socket> > m_servers;  //!< Listening sockets
+  std::vector<Ptr<Socket> > m_clients;  //!< Client sockets
+};
+
+MpTcpRecyclingChurnTest::MpTcpRecyclingChurnTest ()
+  : TestCase ("Short connections share path managers"),
+    m_received (0)
+{
+}
+
+void
+MpTcpRecyclingChurnTest::Open (uint16_t port)
+{
+  Ptr<Socket> server = Socket::CreateSocket (m_nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  server->Listen ();
+  server->SetRecvCallback (MakeCallback (&MpTcpRecyclingChurnTest::ReceiveData, this));
+  m_servers.push_back (server);
+
+  Ptr<Socket> client = Socket::CreateSocket (m_nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  client->Bind ();
+  client->SetSendCallback (MakeCallback (&MpTcpRecyclingChurnTest::SendData, this));
+  client->Connect (InetSocketAddress (Ipv4Address ("10.1.1.2"), port));
+  m_clients.push_back (client);
+}
+
+void
+MpTcpRecyclingChurnTest::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  if (socket->GetTxAvailable () < 10000)
+    {
+      return;
+    }
+  socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+  socket->Send (Create<Packet> (10000));
+  socket->Close ();
+}
+
+void
+MpTcpRecyclingChurnTest::ReceiveData (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received += packet->GetSize ();
+    }
+}
+
+void
+MpTcpRecyclingChurnTest::DoRun (void)
+{
+  m_nodes.Create (2);
+  MpTcpHelper mptcp;
+  mptcp.SetPathManager (MpTcpSocketBase::FullMesh);
+  mptcp.Install (m_nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5 + 10 * i)));
+      NetDeviceContainer devices;
+      for (uint32_t j = 0; j < m_nodes.GetN (); j++)
+        {
+          Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+          device->SetAddress (Mac48Address::Allocate ());
+          device->SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
+          device->SetChannel (channel);
+          m_nodes.Get (j)->AddDevice (device);
+          devices.Add (device);
+        }
+      address.Assign (devices);
+      address.NewNetwork ();
+    }
+
+  for (uint16_t i = 0; i < 4; i++)
+    {
+      Simulator::Schedule (MilliSeconds (200 * i), &MpTcpRecyclingChurnTest::Open, this, 80 + i);
+    }
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 40000, "Every connection should deliver its data");
+  // the senders get their path manager once they send data
+  Ptr<MpTcpPathManager> shared = m_nodes.Get (0)->GetObject<TcpL4Protocol> ()->GetMpTcpPathManager (MpTcpFullMesh::GetTypeId ());
+  for (uint32_t i = 0; i < m_clients.size (); i++)
+    {
+      Ptr<MpTcpSocketBase> meta = MpTcpHelper::GetMeta (m_clients[i]);
+      NS_TEST_ASSERT_MSG_NE (meta, 0, "The client socket should have been upgraded to a meta socket");
+      NS_TEST_ASSERT_MSG_EQ (meta->GetPathManager (), shared, "Path manager shared by the connections of the node");
+    }
+
+  m_servers.clear ();
+  m_clients.clear ();
+  m_nodes = NodeContainer ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Recycling of the per connection MPTCP objects TestSuite
+ */
+class MpTcpRecyclingTestSuite : public TestSuite
+{
+public:
+  MpTcpRecyclingTestSuite ()
+    : TestSuite ("mptcp-recycling", UNIT)
+  {
+    AddTestCase (new MpTcpRecyclingUnitTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpRecyclingChurnTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpRecyclingTestSuite g_mptcpRecyclingTestSuite; //!< Static variable for test initialization
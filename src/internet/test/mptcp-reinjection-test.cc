@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/mptcp-mapping.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpReinjectionTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow whose state can be set from the test
+ */
+class MpTcpReinjectionTestSubflow : public MpTcpSubflow
+{
+public:
+  /**
+   * \brief Set the windows and RTT of the subflow
+   * \param cWnd Congestion window.
+   * \param ssThresh Slow start threshold.
+   * \param rtt Smoothed RTT.
+   */
+  void Set (uint32_t cWnd, uint32_t ssThresh, Time rtt)
+  {
+    m_tcb->m_segmentSize = 1000;
+    m_tcb->m_cWnd = cWnd;
+    m_tcb->m_ssThresh = ssThresh;
+    m_rWnd = 65535;
+    Ptr<RttEstimator> estimator = CreateObject<RttMeanDeviation> ();
+    estimator->Measurement (rtt);
+    SetRtt (estimator);
+  }
+  /**
+   * \brief Map a DSN range on the subflow
+   * \param dsn head DSN
+   * \param length length of the mapping
+   */
+  void Map (uint64_t dsn, uint16_t length)
+  {
+    AddLooseMapping (SequenceNumber64 (dsn), length);
+  }
+  /**
+   * \return congestion window
+   */
+  uint32_t GetCwnd (void) const
+  {
+    return m_tcb->m_cWnd;
+  }
+  /**
+   * \return slow start threshold
+   */
+  uint32_t GetSsThresh (void) const
+  {
+    return m_tcb->m_ssThresh;
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta exposing the reinjection helpers
+ */
+class MpTcpReinjectionTestMeta : public MpTcpSocketBase
+{
+public:
+  /**
+   * \brief Register an established subflow
+   * \param sf The subflow
+   */
+  void Add (Ptr<MpTcpSubflow> sf)
+  {
+    m_subflows[Established].push_back (sf);
+  }
+  using MpTcpSocketBase::GetSubflowHoldingDSN;
+  using MpTcpSocketBase::GetFastestSubflowForDSN;
+  using MpTcpSocketBase::PenalizeSubflow;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the lookup of a DSN among the mappings
+ */
+class MpTcpMappingDsnLookupTest : public TestCase
+{
+public:
+  MpTcpMappingDsnLookupTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpMappingDsnLookupTest::MpTcpMappingDsnLookupTest ()
+  : TestCase ("Lookup of reinjected DSN in a mapping container")
+{
+}
+
+void
+MpTcpMappingDsnLookupTest::DoRun (void)
+{
+  MpTcpMappingContainer container;
+  MpTcpMapping first, second, reinjected, found;
+
+  first.SetHeadDSN (SequenceNumber64 (1000));
+  first.MapToSSN (SequenceNumber32 (1));
+  first.SetMappingSize (500);
+  second.SetHeadDSN (SequenceNumber64 (2000));
+  second.MapToSSN (SequenceNumber32 (501));
+  second.SetMappingSize (500);
+  reinjected.SetHeadDSN (SequenceNumber64 (1200));
+  reinjected.MapToSSN (SequenceNumber32 (1001));
+  reinjected.SetMappingSize (100);
+
+  container.AddMapping (first);
+  container.AddMapping (second);
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (1600), found), false,
+                         "DSN not mapped");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (1250), found), true,
+                         "DSN mapped");
+  NS_TEST_ASSERT_MSG_EQ (found, first, "Wrong mapping");
+
+  container.AddMapping (reinjected);
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (1250), found), true,
+                         "DSN mapped");
+  NS_TEST_ASSERT_MSG_EQ (found, reinjected, "The latest mapping should be returned");
+  NS_TEST_ASSERT_MSG_EQ (container.GetMappingForDSN (SequenceNumber64 (1300), found), true,
+                         "DSN mapped");
+  NS_TEST_ASSERT_MSG_EQ (found, first, "Wrong mapping");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the choice of the subflows and the penalization of the lagging one
+ */
+class MpTcpPenalizationTest : public TestCase
+{
+public:
+  MpTcpPenalizationTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Penalize the slow subflow and check its windows
+   * \param cWnd expected congestion window
+   * \param ssThresh expected slow start threshold
+   */
+  void Penalize (uint32_t cWnd, uint32_t ssThresh);
+
+  Ptr<MpTcpReinjectionTestMeta> m_meta;       //!< Meta socket
+  Ptr<MpTcpReinjectionTestSubflow> m_slow;    //!< Subflow with the highest RTT
+  Ptr<MpTcpReinjectionTestSubflow> m_fast;    //!< Subflow with the lowest RTT
+};
+
+MpTcpPenalizationTest::MpTcpPenalizationTest ()
+  : TestCase ("Penalization of the subflow holding back the connection")
+{
+}
+
+void
+MpTcpPenalizationTest::Penalize (uint32_t cWnd, uint32_t ssThresh)
+{
+  m_meta->PenalizeSubflow (m_slow);
+  NS_TEST_ASSERT_MSG_EQ (m_slow->GetCwnd (), cWnd, "Wrong cwnd at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_ASSERT_MSG_EQ (m_slow->GetSsThresh (), ssThresh, "Wrong ssthresh at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+MpTcpPenalizationTest::DoRun (void)
+{
+  m_meta = CreateObject<MpTcpReinjectionTestMeta> ();
+  m_slow = CreateObject<MpTcpReinjectionTestSubflow> ();
+  m_fast = CreateObject<MpTcpReinjectionTestSubflow> ();
+  m_slow->Set (10000, 5000, Seconds (0.5));
+  m_fast->Set (10000, 5000, Seconds (0.01));
+  m_meta->Add (m_slow);
+  m_meta->Add (m_fast);
+
+  m_slow->Map (0, 1000);
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetSubflowHoldingDSN (SequenceNumber64 (500)), m_slow,
+                         "The slow subflow carries the head of the connection");
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetSubflowHoldingDSN (SequenceNumber64 (1500)), 0,
+                         "No subflow carries this DSN");
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetFastestSubflowForDSN (SequenceNumber64 (500)), m_fast,
+                         "Reinjection must go on the other subflow");
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetFastestSubflowForDSN (SequenceNumber64 (1500)), m_fast,
+                         "Fastest subflow");
+  m_fast->Map (0, 1000);
+  NS_TEST_ASSERT_MSG_EQ (m_meta->GetFastestSubflowForDSN (SequenceNumber64 (500)), 0,
+                         "Data already carried by all subflows");
+
+  // halved once per RTT of the slow subflow
+  Simulator::Schedule (Seconds (0), &MpTcpPenalizationTest::Penalize, this, 5000, 2500);
+  Simulator::Schedule (Seconds (0.2), &MpTcpPenalizationTest::Penalize, this, 5000, 2500);
+  Simulator::Schedule (Seconds (0.6), &MpTcpPenalizationTest::Penalize, this, 2500, 2000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP reinjection TestSuite
+ */
+class MpTcpReinjectionTestSuite : public TestSuite
+{
+public:
+  MpTcpReinjectionTestSuite () : TestSuite ("mptcp-reinjection", UNIT)
+  {
+    AddTestCase (new MpTcpMappingDsnLookupTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpPenalizationTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpReinjectionTestSuite g_mptcpReinjectionTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/mptcp-scheduler-round-robin.h"
+#include "ns3/mptcp-scheduler-fastest-rtt.h"
+#include "ns3/mptcp-scheduler-blest.h"
+#include "ns3/mptcp-scheduler-ecf.h"
+#include "ns3/mptcp-scheduler-redundant.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpSchedulerTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the decisions of the schedulers on given snapshots
+ */
+class MpTcpSchedulerDecisionTest : public TestCase
+{
+public:
+  MpTcpSchedulerDecisionTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Appends a subflow to the snapshot
+   * \param state the snapshot
+   * \param rttMs smoothed RTT in milliseconds
+   * \param cwnd congestion window
+   * \param available bytes the subflow can send right away
+   * \param backup backup flag
+   */
+  void AddSubflow (MpTcpSchedulerState& state, uint32_t rttMs, uint32_t cwnd, uint32_t available,
+                   bool backup = false);
+
+  /**
+   * \brief Checks an assignment
+   * \param a the assignment
+   * \param id expected subflow
+   * \param dsn expected head DSN
+   * \param length expected length
+   */
+  void Check (const MpTcpAssignment& a, uint8_t id, uint64_t dsn, uint16_t length);
+};
+
+MpTcpSchedulerDecisionTest::MpTcpSchedulerDecisionTest ()
+  : TestCase ("Decisions of the MPTCP schedulers")
+{
+}
+
+void
+MpTcpSchedulerDecisionTest::AddSubflow (MpTcpSchedulerState& state, uint32_t rttMs, uint32_t cwnd,
+                                        uint32_t available, bool backup)
+{
+  MpTcpSubflowState sf;
+  sf.id = state.subflows.size ();
+  sf.cwnd = cwnd;
+  sf.ssThresh = 0xffffffff;
+  sf.inFlight = cwnd - available;
+  sf.available = available;
+  sf.segmentSize = 1000;
+  sf.srtt = MilliSeconds (rttMs);
+  sf.rttVar = MilliSeconds (1);
+  sf.backup = backup;
+  state.subflows.push_back (sf);
+}
+
+void
+MpTcpSchedulerDecisionTest::Check (const MpTcpAssignment& a, uint8_t id, uint64_t dsn, uint16_t length)
+{
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) a.subflowId, (uint32_t) id, "Wrong subflow");
+  NS_TEST_EXPECT_MSG_EQ (a.dsn, SequenceNumber64 (dsn), "Wrong DSN");
+  NS_TEST_EXPECT_MSG_EQ (a.length, length, "Wrong length");
+}
+
+void
+MpTcpSchedulerDecisionTest::DoRun (void)
+{
+  MpTcpSchedulerState state;
+  state.nextTxSequence = SequenceNumber64 (100);
+  state.pending = 6000;
+  state.window = 100000;
+  state.sendWindow = 100000;
+  state.inFlight = 0;
+  AddSubflow (state, 100, 10000, 5000);
+  AddSubflow (state, 10, 10000, 3000);
+
+  MpTcpAssignmentList decisions;
+  CreateObject<MpTcpSchedulerFastestRTT> ()->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 2, "Fastest subflow first, then the other one");
+  Check (decisions[0], 1, 100, 3000);
+  Check (decisions[1], 0, 3100, 3000);
+
+  decisions.clear ();
+  Ptr<MpTcpScheduler> rr = CreateObject<MpTcpSchedulerRoundRobin> ();
+  rr->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 2, "Both subflows are used");
+  Check (decisions[0], 1, 100, 3000);
+  Check (decisions[1], 0, 3100, 3000);
+
+  // the backup subflow is not used as long as another one is established
+  state.subflows[0].backup = true;
+  decisions.clear ();
+  rr->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 1, "Backup subflow must not be used");
+  Check (decisions[0], 1, 100, 3000);
+  state.subflows[0].backup = false;
+
+  // redundant: the same range on every subflow
+  decisions.clear ();
+  state.pending = 2000;
+  state.subflows[1].available = 1000;
+  CreateObject<MpTcpSchedulerRedundant> ()->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 2, "One copy per subflow");
+  Check (decisions[0], 0, 100, 2000);
+  Check (decisions[1], 1, 100, 1000);
+
+  // the fastest subflow is blocked by its window
+  state.subflows[1].available = 0;
+  state.pending = 5000;
+
+  // BLEST: the fast subflow would send about 145KB during one RTT of the slow one
+  decisions.clear ();
+  state.sendWindow = 20000;
+  CreateObject<MpTcpSchedulerBlest> ()->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 0, "Slow subflow would block the fast one");
+  decisions.clear ();
+  state.sendWindow = 1000000;
+  CreateObject<MpTcpSchedulerBlest> ()->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 1, "Large enough receive window, slow subflow used");
+  Check (decisions[0], 0, 100, 5000);
+
+  // ECF: little data left, waiting for the fast subflow completes earlier
+  decisions.clear ();
+  Ptr<MpTcpScheduler> ecf = CreateObject<MpTcpSchedulerEcf> ();
+  ecf->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 0, "Should wait for the fast subflow");
+  decisions.clear ();
+  state.pending = 1000000;
+  ecf->Schedule (state, decisions);
+  NS_TEST_ASSERT_MSG_EQ (decisions.size (), 1, "Lots of data, the slow subflow helps");
+  Check (decisions[0], 0, 100, 5000);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP scheduler TestSuite
+ */
+class MpTcpSchedulerTestSuite : public TestSuite
+{
+public:
+  MpTcpSchedulerTestSuite () : TestSuite ("mptcp-scheduler", UNIT)
+  {
+    AddTestCase (new MpTcpSchedulerDecisionTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpSchedulerTestSuite g_mptcpSchedulerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/mptcp-socket-base.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpSharedBufferTestSuite");
+
+/**
+ * \brief Builds a packet whose byte at offset i is the lower bits of start + i
+ * \param start offset of the first byte in the stream
+ * \param size size of the packet
+ * \return the packet
+ */
+static Ptr<Packet>
+MakePayload (uint32_t start, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      data[i] = static_cast<uint8_t> ((start + i) % 251);
+    }
+  return Create<Packet> (&data[0], size);
+}
+
+/**
+ * \brief Checks the payload of a packet built with MakePayload
+ * \param p packet to check
+ * \param start offset in the stream of the first byte expected
+ * \return true if every byte matches
+ */
+static bool
+IsPayload (Ptr<const Packet> p, uint32_t start)
+{
+  std::vector<uint8_t> data (p->GetSize ());
+  p->CopyData (&data[0], data.size ());
+  for (uint32_t i = 0; i < data.size (); ++i)
+    {
+      if (data[i] != static_cast<uint8_t> ((start + i) % 251))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Subflow exposing the hooks of the shared send buffer
+ */
+class MpTcpSharedBufferTestSubflow : public MpTcpSubflow
+{
+public:
+  MpTcpSharedBufferTestSubflow ()
+  {
+    SetRtt (CreateObject<RttMeanDeviation> ());
+  }
+  /**
+   * \brief Map a DSN range on the subflow
+   * \param dsn head DSN
+   * \param length length of the mapping
+   */
+  void Map (uint64_t dsn, uint16_t length)
+  {
+    AddLooseMapping (SequenceNumber64 (dsn), length);
+  }
+  using MpTcpSubflow::GetPayload;
+  using MpTcpSubflow::NewAck;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Meta whose data was all dispatched to its subflows
+ */
+class MpTcpSharedBufferTestMeta : public MpTcpSocketBase
+{
+public:
+  MpTcpSharedBufferTestMeta ()
+  {
+    SetRtt (CreateObject<RttMeanDeviation> ());
+  }
+  /**
+   * \brief Register a subflow
+   * \param sf The subflow
+   */
+  void Add (Ptr<MpTcpSubflow> sf)
+  {
+    m_subflows[Established].push_back (sf);
+  }
+  /**
+   * \brief Buffer data and mark it as dispatched
+   * \param size number of bytes
+   */
+  void Dispatch (uint32_t size)
+  {
+    m_txBuffer->Add (MakePayload (0, size));
+    m_tcb->m_nextTxSequence = m_txBuffer->TailSequence ();
+    m_tcb->m_highTxMark = m_txBuffer->TailSequence ();
+  }
+  using MpTcpSocketBase::ReceivedAck;
+  using MpTcpSocketBase::GetTxData;
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Reading the Tx buffer does not mark anything as sent
+ */
+class TcpTxBufferPeekTest : public TestCase
+{
+public:
+  TcpTxBufferPeekTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpTxBufferPeekTest::TcpTxBufferPeekTest ()
+  : TestCase ("Peek into the sent and unsent parts of the Tx buffer")
+{
+}
+
+void
+TcpTxBufferPeekTest::DoRun (void)
+{
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (0);
+  buffer->SetSegmentSize (500);
+  buffer->Add (MakePayload (0, 1000));
+  buffer->Add (MakePayload (1000, 1000));
+  buffer->CopyFromSequence (500, SequenceNumber32 (0));
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (), 500, "One segment sent");
+
+  // across the sent list, the unsent part of the first packet and the second packet
+  Ptr<Packet> p = buffer->PeekFromSequence (1400, SequenceNumber32 (300));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 1400, "Whole range read");
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 300), true, "Bytes in order");
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (), 500, "Nothing marked as sent");
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 2000, "Nothing discarded");
+
+  p = buffer->PeekFromSequence (1000, SequenceNumber32 (1500));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 500, "Read up to the tail");
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 1500), true, "Bytes in order");
+  NS_TEST_ASSERT_MSG_EQ (buffer->PeekFromSequence (100, SequenceNumber32 (2000))->GetSize (), 0,
+                         "Nothing beyond the tail");
+
+  // CopyFromSequence still hands out the same data
+  p = buffer->CopyFromSequence (500, SequenceNumber32 (500));
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 500), true, "Buffer unchanged");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Data is read from the meta by the subflows and freed once acked at both levels
+ */
+class MpTcpSharedBufferReleaseTest : public TestCase
+{
+public:
+  MpTcpSharedBufferReleaseTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpSharedBufferReleaseTest::MpTcpSharedBufferReleaseTest ()
+  : TestCase ("Meta send buffer shared with the subflows")
+{
+}
+
+void
+MpTcpSharedBufferReleaseTest::DoRun (void)
+{
+  Ptr<MpTcpSharedBufferTestMeta> meta = CreateObject<MpTcpSharedBufferTestMeta> ();
+  Ptr<MpTcpSharedBufferTestSubflow> a = CreateObject<MpTcpSharedBufferTestSubflow> ();
+  Ptr<MpTcpSharedBufferTestSubflow> b = CreateObject<MpTcpSharedBufferTestSubflow> ();
+  a->SetMeta (meta);
+  b->SetMeta (meta);
+  meta->Add (a);
+  meta->Add (b);
+  meta->Dispatch (2000);
+
+  // b carries [0, 1000) then a copy of [1000, 2000), which a carries too
+  a->Map (1000, 1000);
+  b->Map (0, 1000);
+  b->Map (1000, 1000);
+
+  Ptr<Packet> p = a->GetPayload (Create<Packet> (1000), SequenceNumber32 (0));
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 1000), true, "Mapping of a");
+  p = b->GetPayload (Create<Packet> (200), SequenceNumber32 (1100));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 200, "Size of the placeholder");
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 1100), true, "Middle of the second mapping of b");
+  NS_TEST_ASSERT_MSG_EQ (meta->UnAckDataCount (), 2000, "Nothing acked");
+
+  meta->ReceivedAck (SequenceNumber64 (2000), a, false);
+  NS_TEST_ASSERT_MSG_EQ (meta->UnAckDataCount (), 0, "All acked at the data level");
+  NS_TEST_ASSERT_MSG_EQ (meta->GetTxBuffer ()->Size (), 2000, "Held until the subflows ack");
+
+  b->NewAck (SequenceNumber32 (1000), false);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetTxBuffer ()->HeadSequence (), SequenceNumber32 (1000),
+                         "First mapping of b released");
+
+  a->NewAck (SequenceNumber32 (1000), false);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetTxBuffer ()->HeadSequence (), SequenceNumber32 (1000),
+                         "Copy still held by b");
+  p = meta->GetTxData (SequenceNumber64 (1500), 100);
+  NS_TEST_ASSERT_MSG_EQ (IsPayload (p, 1500), true, "b may still retransmit");
+
+  b->NewAck (SequenceNumber32 (2000), false);
+  NS_TEST_ASSERT_MSG_EQ (meta->GetTxBuffer ()->Size (), 0, "Everything released");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Minimal LowestDSN behavior of the mapping container
+ */
+class MpTcpLowestDsnTest : public TestCase
+{
+public:
+  MpTcpLowestDsnTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpLowestDsnTest::MpTcpLowestDsnTest ()
+  : TestCase ("Lowest DSN of mappings out of DSN order")
+{
+}
+
+void
+MpTcpLowestDsnTest::DoRun (void)
+{
+  MpTcpMappingContainer container;
+  SequenceNumber64 dsn;
+  NS_TEST_ASSERT_MSG_EQ (container.LowestDSN (dsn), false, "Empty");
+
+  MpTcpMapping m;
+  m.MapToSSN (SequenceNumber32 (0));
+  m.SetHeadDSN (SequenceNumber64 (5000));
+  m.SetMappingSize (100);
+  container.AddMapping (m);
+  m.MapToSSN (SequenceNumber32 (100));
+  m.SetHeadDSN (SequenceNumber64 (1000));
+  container.AddMapping (m);
+  NS_TEST_ASSERT_MSG_EQ (container.LowestDSN (dsn), true, "Not empty");
+  NS_TEST_ASSERT_MSG_EQ (dsn, SequenceNumber64 (1000), "Reinjected mapping");
+
+  container.DiscardMapping (m);
+  container.LowestDSN (dsn);
+  NS_TEST_ASSERT_MSG_EQ (dsn, SequenceNumber64 (5000), "Stale entry skipped");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP shared send buffer TestSuite
+ */
+class MpTcpSharedBufferTestSuite : public TestSuite
+{
+public:
+  MpTcpSharedBufferTestSuite () : TestSuite ("mptcp-shared-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferPeekTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpLowestDsnTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpSharedBufferReleaseTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpSharedBufferTestSuite g_mptcpSharedBufferTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/mptcp-stats.h"
+#include "ns3/mptcp-stats-helper.h"
+#include "ns3/mptcp-subflow.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpStatsTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the MPTCP counters and their sampling
+ */
+class MpTcpStatsCountersTest : public TestCase
+{
+public:
+  MpTcpStatsCountersTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Head of line blocking starts
+   */
+  void Block (void);
+  /**
+   * \brief Head of line blocking ends
+   */
+  void Unblock (void);
+
+  Ptr<MpTcpStats> m_stats; //!< Statistics under test
+};
+
+MpTcpStatsCountersTest::MpTcpStatsCountersTest ()
+  : TestCase ("MPTCP statistics counters and samples")
+{
+}
+
+void
+MpTcpStatsCountersTest::Block (void)
+{
+  // DSN 2000 arrives while 1000 is expected
+  m_stats->NotifyReceived (SequenceNumber64 (2000), 1000, SequenceNumber64 (1000), false);
+  m_stats->NotifyRxBuffer (1000, true);
+}
+
+void
+MpTcpStatsCountersTest::Unblock (void)
+{
+  m_stats->NotifyReceived (SequenceNumber64 (1000), 1000, SequenceNumber64 (1000), false);
+  m_stats->NotifyReceived (SequenceNumber64 (1000), 500, SequenceNumber64 (3000), true);
+  m_stats->NotifyRxBuffer (2000, false);
+}
+
+void
+MpTcpStatsCountersTest::DoRun (void)
+{
+  m_stats = CreateObject<MpTcpStats> ();
+  Ptr<MpTcpSubflow> sf0 = CreateObject<MpTcpSubflow> ();
+  Ptr<MpTcpSubflow> sf1 = CreateObject<MpTcpSubflow> ();
+
+  m_stats->NotifyScheduled (sf0, SequenceNumber64 (1000), 1000, false);
+  m_stats->NotifyScheduled (sf1, SequenceNumber64 (2000), 1000, false);
+  m_stats->NotifyScheduled (sf1, SequenceNumber64 (1000), 400, true);
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetNSubflows (), 2, "Two subflows were used");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetSubflowScheduledBytes (0), 1000, "Wrong bytes for subflow 0");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetSubflowScheduledBytes (1), 1400, "Wrong bytes for subflow 1");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetScheduledBytes (), 2400, "Wrong total");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetReinjections (), 1, "Wrong number of reinjections");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetReinjectedBytes (), 400, "Wrong reinjected bytes");
+
+  Simulator::Schedule (Seconds (1), &MpTcpStatsCountersTest::Block, this);
+  Simulator::Schedule (Seconds (1.25), &MpTcpStatsCountersTest::Unblock, this);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetOutOfOrderArrivals (), 1, "One range arrived out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetDuplicateBytes (), 500, "Wrong duplicate bytes");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetRxBufferOccupancy (), 2000, "Wrong occupancy");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetHolBlockingTime (), MilliSeconds (250), "Wrong blocking time");
+
+  std::ostringstream csv;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (&csv);
+  MpTcpStatsHelper::WriteSample (m_stats, stream, MpTcpStatsHelper::CSV);
+  NS_TEST_ASSERT_MSG_EQ (csv.str (), "1.25,2000,0.25,1,1,400,500,2400,2,1000,1400\n", "Wrong CSV sample");
+
+  std::ostringstream binary;
+  stream = Create<OutputStreamWrapper> (&binary);
+  MpTcpStatsHelper::WriteSample (m_stats, stream, MpTcpStatsHelper::BINARY);
+  NS_TEST_ASSERT_MSG_EQ (binary.str ().size (), 2 * 8 + 4 * 4 + 3 * 8 + 2 * 8, "Wrong binary record size");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP statistics TestSuite
+ */
+class MpTcpStatsTestSuite : public TestSuite
+{
+public:
+  MpTcpStatsTestSuite () : TestSuite ("mptcp-stats", UNIT)
+  {
+    AddTestCase (new MpTcpStatsCountersTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpStatsTestSuite g_mptcpStatsTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <cstring>
+#include <set>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/mptcp-crypto.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpTokenTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket giving access to its MPTCP key generation
+ */
+class MpTcpTokenTestSocket : public TcpSocketBase
+{
+public:
+  /**
+   * \brief Generate a new key
+   * \return the token of the new key
+   */
+  uint32_t NewToken (void)
+  {
+    GenerateUniqueMpTcpKey ();
+    return m_mptcpLocalToken;
+  }
+  /**
+   * \brief Generate a new key
+   * \return the new key
+   */
+  uint64_t NewKey (void)
+  {
+    GenerateUniqueMpTcpKey ();
+    return m_mptcpLocalKey;
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that generated tokens are unique and can be looked up
+ */
+class MpTcpTokenTableTest : public TestCase
+{
+public:
+  MpTcpTokenTableTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpTokenTableTest::MpTcpTokenTableTest ()
+  : TestCase ("Unique MPTCP tokens and token lookups")
+{
+}
+
+void
+MpTcpTokenTableTest::DoRun (void)
+{
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+  std::vector<Ptr<MpTcpTokenTestSocket> > sockets;
+  std::vector<uint32_t> tokens;
+  std::set<uint32_t> uniqueTokens;
+
+  for (uint32_t i = 0; i < 2000; ++i)
+    {
+      Ptr<MpTcpTokenTestSocket> sock = CreateObject<MpTcpTokenTestSocket> ();
+      sock->SetTcp (tcp);
+      tokens.push_back (sock->NewToken ());
+      uniqueTokens.insert (tokens.back ());
+      sockets.push_back (sock);
+    }
+  NS_TEST_ASSERT_MSG_EQ (uniqueTokens.size (), sockets.size (), "Tokens must be unique");
+
+  for (uint32_t i = 0; i < sockets.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (tcp->LookupMpTcpToken (tokens[i]), sockets[i], "Token lookup failed");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (tcp->AddMpTcpToken (tokens[0], PeekPointer (sockets[1])), false,
+                         "Token collision not detected");
+  NS_TEST_ASSERT_MSG_EQ (tcp->RemoveMpTcpToken (tokens[0], PeekPointer (sockets[1])), false,
+                         "A socket may only remove its own token");
+
+  // a new key releases the previous token
+  uint32_t oldToken = tokens[0];
+  tokens[0] = sockets[0]->NewToken ();
+  NS_TEST_ASSERT_MSG_EQ (tcp->LookupMpTcpToken (tokens[0]), sockets[0], "Token lookup failed");
+  if (oldToken != tokens[0])
+    {
+      NS_TEST_ASSERT_MSG_EQ (tcp->LookupMpTcpToken (oldToken), 0, "Previous token should be released");
+    }
+
+  // the destruction of the socket releases its token
+  sockets[1] = 0;
+  NS_TEST_ASSERT_MSG_EQ (tcp->LookupMpTcpToken (tokens[1]), 0, "Token of a destroyed socket");
+
+  sockets.clear ();
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the generated keys use all of their 64 bits
+ */
+class MpTcpKeyWidthTest : public TestCase
+{
+public:
+  MpTcpKeyWidthTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpKeyWidthTest::MpTcpKeyWidthTest ()
+  : TestCase ("MPTCP keys span 64 bits")
+{
+}
+
+void
+MpTcpKeyWidthTest::DoRun (void)
+{
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+  Ptr<MpTcpTokenTestSocket> sock = CreateObject<MpTcpTokenTestSocket> ();
+  sock->SetTcp (tcp);
+
+  // every bit is set by some key and cleared by another, in all likelihood
+  uint64_t anySet = 0;
+  uint64_t anyCleared = 0;
+  for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint64_t key = sock->NewKey ();
+      anySet |= key;
+      anyCleared |= ~key;
+    }
+  NS_TEST_ASSERT_MSG_EQ (anySet, ~static_cast<uint64_t> (0), "Some key bits are never set");
+  NS_TEST_ASSERT_MSG_EQ (anyCleared, ~static_cast<uint64_t> (0), "Some key bits are never cleared");
+
+  sock = 0;
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the token and IDSN derived from a key
+ */
+class MpTcpTokenDerivationTest : public TestCase
+{
+public:
+  MpTcpTokenDerivationTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpTokenDerivationTest::MpTcpTokenDerivationTest ()
+  : TestCase ("Token and IDSN derived from the hash of the key")
+{
+}
+
+void
+MpTcpTokenDerivationTest::DoRun (void)
+{
+  uint32_t token;
+  uint64_t idsn;
+
+  GenerateTokenForKey (HMAC_SHA1, 0x0123456789abcdefULL, token, idsn);
+  NS_TEST_EXPECT_MSG_EQ (token, 0x0ca2eadb, "Most significant 32 bits of SHA-1");
+  NS_TEST_EXPECT_MSG_EQ (idsn, 0xe3df8ee121f10547ULL, "Least significant 64 bits of SHA-1");
+
+  GenerateTokenForKey (HMAC_SHA256, 0x0123456789abcdefULL, token, idsn);
+  NS_TEST_EXPECT_MSG_EQ (token, 0x55c53f5d, "Most significant 32 bits of SHA-256");
+  NS_TEST_EXPECT_MSG_EQ (idsn, 0x570762cd38be9818ULL, "Least significant 64 bits of SHA-256");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the HMAC exchanged during the MP_JOIN handshake
+ */
+class MpTcpJoinHmacTest : public TestCase
+{
+public:
+  MpTcpJoinHmacTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpJoinHmacTest::MpTcpJoinHmacTest ()
+  : TestCase ("MP_JOIN HMAC")
+{
+}
+
+void
+MpTcpJoinHmacTest::DoRun (void)
+{
+  const uint64_t keyA = 0x0123456789abcdefULL;
+  const uint64_t keyB = 0xfedcba9876543210ULL;
+  const uint32_t nonceA = 0x11223344;
+  const uint32_t nonceB = 0x55667788;
+  const uint8_t reference[MPTCP_HMAC_SIZE] = {
+    0x71, 0x20, 0x57, 0x4d, 0xe7, 0x10, 0x20, 0xf0, 0xd1, 0x99,
+    0xf1, 0x70, 0x40, 0x7b, 0xf8, 0x0f, 0xb4, 0x08, 0xfd, 0xc4
+  };
+  uint8_t hmac[MPTCP_HMAC_SIZE];
+
+  // third ACK, sent by A
+  GenerateJoinHmac (HMAC_SHA1, keyA, keyB, nonceA, nonceB, hmac);
+  NS_TEST_EXPECT_MSG_EQ (memcmp (hmac, reference, MPTCP_HMAC_SIZE), 0, "HMAC-A");
+
+  // SYN/ACK, sent by B
+  NS_TEST_EXPECT_MSG_EQ (GenerateTruncatedJoinHmac (HMAC_SHA1, keyB, keyA, nonceB, nonceA),
+                         0x49412f7213682cb1ULL, "Truncated HMAC-B");
+
+  // each side computes the HMAC of the other with the roles swapped
+  NS_TEST_EXPECT_MSG_NE (GenerateTruncatedJoinHmac (HMAC_SHA1, keyA, keyB, nonceA, nonceB),
+                         GenerateTruncatedJoinHmac (HMAC_SHA1, keyB, keyA, nonceB, nonceA),
+                         "HMAC-A and HMAC-B must differ");
+  NS_TEST_EXPECT_MSG_NE (GenerateTruncatedJoinHmac (HMAC_SHA1, keyB, keyA, nonceB + 1, nonceA),
+                         0x49412f7213682cb1ULL, "The HMAC must depend on the nonces");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MPTCP token TestSuite
+ */
+class MpTcpTokenTestSuite : public TestSuite
+{
+public:
+  MpTcpTokenTestSuite () : TestSuite ("mptcp-token", UNIT)
+  {
+    AddTestCase (new MpTcpTokenTableTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpKeyWidthTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpTokenDerivationTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpJoinHmacTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpTokenTestSuite g_mptcpTokenTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,387 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015 University of Sussex
+ * Copyright (c) 2015 Université Pierre et Marie Curie (UPMC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-option-mptcp.h"
+#include "ns3/mptcp-crypto.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpV1OptionsTestSuite");
+
+/**
+ * \brief Sends an option through a TCP header and reads it back
+ * \param option the option to send
+ * \return the option read from the received header
+ */
+template<class T>
+static Ptr<const T>
+RoundTrip (Ptr<T> option)
+{
+  TcpHeader header;
+  header.SetFlags (TcpHeader::ACK);
+  header.AppendOption (option);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (header);
+
+  TcpHeader received;
+  p->RemoveHeader (received);
+  Ptr<const T> ret;
+  GetTcpOption (received, ret);
+  return ret;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MP_CAPABLE encodings of RFC 6824 and RFC 8684
+ */
+class MpTcpV1CapableTest : public TestCase
+{
+public:
+  MpTcpV1CapableTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpV1CapableTest::MpTcpV1CapableTest ()
+  : TestCase ("MP_CAPABLE encodings")
+{
+}
+
+void
+MpTcpV1CapableTest::DoRun (void)
+{
+  const uint64_t keyA = 0x0123456789abcdefULL;
+  const uint64_t keyB = 0xfedcba9876543210ULL;
+
+  // version 1 SYN: no key
+  Ptr<TcpOptionMpTcpCapable> syn = CreateObject<TcpOptionMpTcpCapable> ();
+  syn->SetVersion (1);
+  NS_TEST_ASSERT_MSG_EQ (syn->GetSerializedSize (), 4, "Version 1 SYN");
+  Ptr<const TcpOptionMpTcpCapable> read = RoundTrip (syn);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "MP_CAPABLE not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 1, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->HasSenderKey (), false, "No key in a version 1 SYN");
+
+  // version 0 SYN and SYN/ACK
+  Ptr<TcpOptionMpTcpCapable> synAck = CreateObject<TcpOptionMpTcpCapable> ();
+  synAck->SetSenderKey (keyB);
+  NS_TEST_ASSERT_MSG_EQ (synAck->GetSerializedSize (), 12, "Sender key only");
+  read = RoundTrip (synAck);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "MP_CAPABLE not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 0, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->GetSenderKey (), keyB, "Sender key");
+  NS_TEST_EXPECT_MSG_EQ (read->HasReceiverKey (), false, "No receiver key");
+
+  // third ACK
+  Ptr<TcpOptionMpTcpCapable> ack = CreateObject<TcpOptionMpTcpCapable> ();
+  ack->SetVersion (1);
+  ack->SetSenderKey (keyA);
+  ack->SetPeerKey (keyB);
+  NS_TEST_ASSERT_MSG_EQ (ack->GetSerializedSize (), 20, "Both keys");
+  read = RoundTrip (ack);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "MP_CAPABLE not found");
+  NS_TEST_EXPECT_MSG_EQ (read->GetSenderKey (), keyA, "Sender key");
+  NS_TEST_EXPECT_MSG_EQ (read->GetPeerKey (), keyB, "Receiver key");
+  NS_TEST_EXPECT_MSG_EQ (read->HasDataLength (), false, "No data");
+
+  // third ACK carrying data
+  ack->SetDataLength (1400);
+  NS_TEST_ASSERT_MSG_EQ (ack->GetSerializedSize (), 22, "Both keys and the data length");
+  read = RoundTrip (ack);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "MP_CAPABLE not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 1, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->GetSenderKey (), keyA, "Sender key");
+  NS_TEST_EXPECT_MSG_EQ (read->GetPeerKey (), keyB, "Receiver key");
+  NS_TEST_EXPECT_MSG_EQ (read->HasDataLength (), true, "Data length");
+  NS_TEST_EXPECT_MSG_EQ (read->GetDataLength (), 1400, "Data length");
+  NS_TEST_EXPECT_MSG_EQ ((*read == *ack), true, "Options should be equal");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief ADD_ADDR of RFC 8684, with its HMAC and echo, and of RFC 6824
+ */
+class MpTcpV1AddAddressTest : public TestCase
+{
+public:
+  MpTcpV1AddAddressTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpV1AddAddressTest::MpTcpV1AddAddressTest ()
+  : TestCase ("ADD_ADDR encodings and HMAC")
+{
+}
+
+void
+MpTcpV1AddAddressTest::DoRun (void)
+{
+  const uint64_t keyA = 0x0123456789abcdefULL;
+  const uint64_t keyB = 0xfedcba9876543210ULL;
+
+  Ptr<TcpOptionMpTcpAddAddress> v0 = CreateObject<TcpOptionMpTcpAddAddress> ();
+  v0->SetAddress (InetSocketAddress (Ipv4Address ("10.0.0.2"), 80), 1);
+  NS_TEST_ASSERT_MSG_EQ (v0->GetSerializedSize (), 10, "RFC 6824 IPv4");
+  Ptr<const TcpOptionMpTcpAddAddress> read = RoundTrip (v0);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "ADD_ADDR not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 0, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress ().GetIpv4 (), Ipv4Address ("10.0.0.2"), "Address");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress ().GetPort (), 80, "Port");
+
+  // HMAC-SHA256 with Key=(keyA+keyB) over (id, address, port), rightmost 64 bits
+  Ptr<TcpOptionMpTcpAddAddress> v1 = CreateObject<TcpOptionMpTcpAddAddress> ();
+  v1->SetAddress (InetSocketAddress (Ipv4Address ("10.0.0.2"), 80), 1);
+  uint64_t hmac = v1->ComputeTruncatedHmac (HMAC_SHA256, keyA, keyB);
+  NS_TEST_EXPECT_MSG_EQ (hmac, 0x13fce0ee36136862ULL, "Truncated HMAC");
+  NS_TEST_EXPECT_MSG_NE (hmac, v1->ComputeTruncatedHmac (HMAC_SHA256, keyB, keyA), "Keys are ordered");
+  v1->SetTruncatedHmac (hmac);
+  NS_TEST_ASSERT_MSG_EQ (v1->GetSerializedSize (), 18, "RFC 8684 IPv4 with HMAC");
+  read = RoundTrip (v1);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "ADD_ADDR not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 1, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->IsEcho (), false, "Not an echo");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddressVersion (), 4, "IPv4");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddressId (), 1, "Address id");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress ().GetIpv4 (), Ipv4Address ("10.0.0.2"), "Address");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress ().GetPort (), 80, "Port");
+  NS_TEST_EXPECT_MSG_EQ (read->GetTruncatedHmac (), hmac, "Truncated HMAC");
+  // the receiver checks it with the keys in the same order
+  NS_TEST_EXPECT_MSG_EQ (read->ComputeTruncatedHmac (HMAC_SHA256, keyA, keyB), hmac, "HMAC check");
+
+  Ptr<TcpOptionMpTcpAddAddress> v6 = CreateObject<TcpOptionMpTcpAddAddress> ();
+  v6->SetAddress (Inet6SocketAddress (Ipv6Address ("2001:db8::2"), 80), 2);
+  v6->SetTruncatedHmac (v6->ComputeTruncatedHmac (HMAC_SHA256, keyA, keyB));
+  NS_TEST_ASSERT_MSG_EQ (v6->GetSerializedSize (), 30, "RFC 8684 IPv6 with HMAC");
+  read = RoundTrip (v6);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "ADD_ADDR not found");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddressVersion (), 6, "IPv6");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress6 ().GetIpv6 (), Ipv6Address ("2001:db8::2"), "Address");
+  NS_TEST_EXPECT_MSG_EQ (read->GetTruncatedHmac (), v6->GetTruncatedHmac (), "Truncated HMAC");
+
+  // the echo carries no HMAC
+  Ptr<TcpOptionMpTcpAddAddress> echo = CreateObject<TcpOptionMpTcpAddAddress> ();
+  echo->SetAddress (InetSocketAddress (Ipv4Address ("10.0.0.2"), 80), 1);
+  echo->SetEcho (true);
+  NS_TEST_ASSERT_MSG_EQ (echo->GetSerializedSize (), 10, "RFC 8684 IPv4 echo");
+  read = RoundTrip (echo);
+  NS_TEST_ASSERT_MSG_NE (read, 0, "ADD_ADDR not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)read->GetVersion (), 1, "Version");
+  NS_TEST_EXPECT_MSG_EQ (read->IsEcho (), true, "Echo");
+  NS_TEST_EXPECT_MSG_EQ (read->GetAddress ().GetIpv4 (), Ipv4Address ("10.0.0.2"), "Address");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief MP_FASTCLOSE, MP_FAIL and MP_TCPRST
+ */
+class MpTcpV1ResetOptionsTest : public TestCase
+{
+public:
+  MpTcpV1ResetOptionsTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpV1ResetOptionsTest::MpTcpV1ResetOptionsTest ()
+  : TestCase ("MP_FASTCLOSE, MP_FAIL and MP_TCPRST encodings")
+{
+}
+
+void
+MpTcpV1ResetOptionsTest::DoRun (void)
+{
+  Ptr<TcpOptionMpTcpFastClose> fastClose = CreateObject<TcpOptionMpTcpFastClose> ();
+  fastClose->SetPeerKey (0xfedcba9876543210ULL);
+  NS_TEST_ASSERT_MSG_EQ (fastClose->GetSerializedSize (), 12, "MP_FASTCLOSE");
+  Ptr<const TcpOptionMpTcpFastClose> readFastClose = RoundTrip (fastClose);
+  NS_TEST_ASSERT_MSG_NE (readFastClose, 0, "MP_FASTCLOSE not found");
+  NS_TEST_EXPECT_MSG_EQ (readFastClose->GetPeerKey (), 0xfedcba9876543210ULL, "Key");
+
+  Ptr<TcpOptionMpTcpFail> fail = CreateObject<TcpOptionMpTcpFail> ();
+  fail->SetDSN (0x0102030405060708ULL);
+  NS_TEST_ASSERT_MSG_EQ (fail->GetSerializedSize (), 12, "MP_FAIL");
+  Ptr<const TcpOptionMpTcpFail> readFail = RoundTrip (fail);
+  NS_TEST_ASSERT_MSG_NE (readFail, 0, "MP_FAIL not found");
+  NS_TEST_EXPECT_MSG_EQ (readFail->GetDSN (), 0x0102030405060708ULL, "DSN");
+
+  Ptr<TcpOptionMpTcpReset> reset = CreateObject<TcpOptionMpTcpReset> ();
+  reset->SetFlags (TcpOptionMpTcpReset::Transient);
+  reset->SetReason (TcpOptionMpTcpReset::MpTcpSpecific);
+  NS_TEST_ASSERT_MSG_EQ (reset->GetSerializedSize (), 4, "MP_TCPRST");
+  Ptr<const TcpOptionMpTcpReset> readReset = RoundTrip (reset);
+  NS_TEST_ASSERT_MSG_NE (readReset, 0, "MP_TCPRST not found");
+  NS_TEST_EXPECT_MSG_EQ ((int)readReset->GetFlags (), TcpOptionMpTcpReset::Transient, "Flags");
+  NS_TEST_EXPECT_MSG_EQ ((int)readReset->GetReason (), TcpOptionMpTcpReset::MpTcpSpecific, "Reason");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket giving access to the MPTCP version negotiation
+ */
+class MpTcpVersionTestSocket : public TcpSocketBase
+{
+public:
+  /**
+   * \brief Process the MP_CAPABLE received from the peer
+   * \param option MP_CAPABLE
+   */
+  void Receive (Ptr<const TcpOption> option)
+  {
+    ProcessOptionMpTcp (option);
+  }
+
+  /**
+   * \return the MP_CAPABLE of our SYN
+   */
+  Ptr<const TcpOptionMpTcpCapable> Syn (void)
+  {
+    TcpHeader header;
+    header.SetFlags (TcpHeader::SYN);
+    AddMpTcpOptions (header);
+    Ptr<const TcpOptionMpTcpCapable> mpc;
+    GetTcpOption (header, mpc);
+    return mpc;
+  }
+
+  /// \return the negotiated version
+  uint8_t GetVersion (void) const
+  {
+    return m_mptcpVersion;
+  }
+
+  /// \return the hash algorithm
+  mptcp_crypto_alg_t GetAlg (void) const
+  {
+    return GetMpTcpCryptoAlg ();
+  }
+
+  /// \return our key
+  uint64_t GetKey (void) const
+  {
+    return m_mptcpLocalKey;
+  }
+
+  /// \return our token
+  uint32_t GetToken (void) const
+  {
+    return m_mptcpLocalToken;
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Both ends settle on the lowest version
+ */
+class MpTcpVersionNegotiationTest : public TestCase
+{
+public:
+  MpTcpVersionNegotiationTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpTcpVersionNegotiationTest::MpTcpVersionNegotiationTest ()
+  : TestCase ("MPTCP version negotiation")
+{
+}
+
+void
+MpTcpVersionNegotiationTest::DoRun (void)
+{
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+
+  // version 1 client talking to a version 0 server
+  Ptr<MpTcpVersionTestSocket> client = CreateObject<MpTcpVersionTestSocket> ();
+  client->SetTcp (tcp);
+  Ptr<const TcpOptionMpTcpCapable> syn = client->Syn ();
+  NS_TEST_ASSERT_MSG_NE (syn, 0, "MP_CAPABLE expected in the SYN");
+  NS_TEST_EXPECT_MSG_EQ ((int)syn->GetVersion (), 1, "Version 1 by default");
+  NS_TEST_EXPECT_MSG_EQ (syn->HasSenderKey (), false, "The key is not disclosed in a version 1 SYN");
+  NS_TEST_EXPECT_MSG_EQ (client->GetAlg (), HMAC_SHA256, "Version 1 uses SHA-256");
+
+  Ptr<TcpOptionMpTcpCapable> synAck = CreateObject<TcpOptionMpTcpCapable> ();
+  synAck->SetSenderKey (0xfedcba9876543210ULL);
+  client->Receive (synAck);
+  NS_TEST_EXPECT_MSG_EQ ((int)client->GetVersion (), 0, "Fall back to version 0");
+  NS_TEST_EXPECT_MSG_EQ (client->GetAlg (), HMAC_SHA1, "Version 0 uses SHA-1");
+  uint32_t token;
+  uint64_t idsn;
+  GenerateTokenForKey (HMAC_SHA1, client->GetKey (), token, idsn);
+  NS_TEST_EXPECT_MSG_EQ (client->GetToken (), token, "Token derived with SHA-1");
+  NS_TEST_EXPECT_MSG_EQ (tcp->LookupMpTcpToken (token), client, "Token registered");
+
+  // a version 1 peer does not upgrade a version 0 socket
+  Ptr<MpTcpVersionTestSocket> legacy = CreateObject<MpTcpVersionTestSocket> ();
+  legacy->SetTcp (tcp);
+  legacy->SetAttribute ("MpTcpVersion", UintegerValue (0));
+  syn = legacy->Syn ();
+  NS_TEST_ASSERT_MSG_NE (syn, 0, "MP_CAPABLE expected in the SYN");
+  NS_TEST_EXPECT_MSG_EQ ((int)syn->GetVersion (), 0, "Version 0");
+  NS_TEST_EXPECT_MSG_EQ (syn->GetSenderKey (), legacy->GetKey (), "Version 0 SYN carries the key");
+  Ptr<TcpOptionMpTcpCapable> v1 = CreateObject<TcpOptionMpTcpCapable> ();
+  v1->SetVersion (1);
+  legacy->Receive (v1);
+  NS_TEST_EXPECT_MSG_EQ ((int)legacy->GetVersion (), 0, "Stays in version 0");
+
+  client = 0;
+  legacy = 0;
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief RFC 8684 options TestSuite
+ */
+class MpTcpV1OptionsTestSuite : public TestSuite
+{
+public:
+  MpTcpV1OptionsTestSuite () : TestSuite ("mptcp-v1-options", UNIT)
+  {
+    AddTestCase (new MpTcpV1CapableTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpV1AddAddressTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpV1ResetOptionsTest (), TestCase::QUICK);
+    AddTestCase (new MpTcpVersionNegotiationTest (), TestCase::QUICK);
+  }
+};
+
+static MpTcpV1OptionsTestSuite g_mptcpV1OptionsTestSuite; //!< Static variable for test initialization
@@ -22,6 +22,8 @@
 #include "ns3/tcp-westwood.h"
 #include "ns3/simple-channel.h"
 #include "ns3/rtt-estimator.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/simulator.h"
 #include "tcp-general-test.h"
 #include "tcp-error-model.h"
 
@@ -504,6 +506,135 @@ TcpTimeRtoTest::FinalChecks ()
 }
 
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Scheduler counting the events in the event list
+ */
+class TcpRtoCountingScheduler : public MapScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual void Insert (const Scheduler::Event &ev)
+  {
+    MapScheduler::Insert (ev);
+    m_pending++;
+  }
+  virtual Scheduler::Event RemoveNext (void)
+  {
+    m_pending--;
+    return MapScheduler::RemoveNext ();
+  }
+  virtual void Remove (const Scheduler::Event &ev)
+  {
+    MapScheduler::Remove (ev);
+    m_pending--;
+  }
+  virtual void RemoveCancelled (std::vector<Scheduler::Event> &cancelled)
+  {
+    uint32_t size = cancelled.size ();
+    MapScheduler::RemoveCancelled (cancelled);
+    m_pending -= cancelled.size () - size;
+  }
+
+  static uint32_t m_pending; //!< Number of events in the event list
+};
+
+uint32_t TcpRtoCountingScheduler::m_pending = 0;
+
+NS_OBJECT_ENSURE_REGISTERED (TcpRtoCountingScheduler);
+
+TypeId
+TcpRtoCountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpRtoCountingScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpRtoCountingScheduler> ()
+  ;
+  return tid;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Socket giving access to the restart of its retransmission timer
+ */
+class TcpRtoRestartSocket : public TcpSocketBase
+{
+public:
+  /**
+   * \brief Queue data to be acknowledged
+   * \param size Number of bytes.
+   */
+  void Queue (uint32_t size)
+  {
+    m_txBuffer->Add (Create<Packet> (size));
+  }
+  /**
+   * \brief Receive a new ACK, which restarts the retransmission timer
+   * \param ack Acknowledged sequence number.
+   */
+  void Ack (SequenceNumber32 ack)
+  {
+    NewAck (ack, true);
+  }
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that restarting the RTO does not pile up events
+ *
+ * Each new ACK pushes the retransmission timer back: the timer must be
+ * moved in the event list, and not leave a cancelled event behind.
+ */
+class TcpRtoRestartTest : public TestCase
+{
+public:
+  TcpRtoRestartTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpRtoRestartTest::TcpRtoRestartTest ()
+  : TestCase ("RTO restarts keep the number of pending events")
+{
+}
+
+void
+TcpRtoRestartTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (TcpRtoCountingScheduler::GetTypeId ());
+  Simulator::SetScheduler (factory);
+  TcpRtoCountingScheduler::m_pending = 0;
+
+  Ptr<TcpRtoRestartSocket> socket = CreateObject<TcpRtoRestartSocket> ();
+  socket->SetRtt (CreateObject<RttMeanDeviation> ());
+  socket->Queue (1000);
+
+  socket->Ack (SequenceNumber32 (1));
+  uint32_t pending = TcpRtoCountingScheduler::m_pending;
+  NS_TEST_ASSERT_MSG_GT (pending, 0, "Retransmission timer not scheduled");
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      socket->Ack (SequenceNumber32 (1));
+    }
+  NS_TEST_ASSERT_MSG_EQ (TcpRtoCountingScheduler::m_pending, pending, "Restarts left events behind");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -531,6 +662,8 @@ public:
         AddTestCase (new TcpSsThreshRtoTest ((*it), seqToDrop, minRto, (*it).GetName () + " RTO ssthresh testing, set to half of BytesInFlight"), TestCase::QUICK);
         AddTestCase (new TcpTimeRtoTest ((*it), (*it).GetName () + " RTO timing testing"), TestCase::QUICK);
       }
+    // last: its packet is made before the other tests enable the metadata
+    AddTestCase (new TcpRtoRestartTest (), TestCase::QUICK);
   }
 };
 
@@ -0,0 +1,953 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Timestamp of an empty partition, and lookahead without split channel. */
+const uint64_t NO_TS = std::numeric_limits<uint64_t>::max ();
+
+/** Busy waits of a thread before it yields its processor. */
+const uint32_t SPINS_BEFORE_YIELD = 1000;
+
+/**
+ * Wait a little, yielding the processor once the wait gets long.
+ *
+ * \param [in,out] spins The number of waits so far.
+ */
+inline void
+Pause (uint32_t &spins)
+{
+  if (++spins > SPINS_BEFORE_YIELD)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+/**
+ * Find the representative of a node in a union-find forest.
+ *
+ * \param [in,out] parent The forest, compressed on the way.
+ * \param [in] node The node.
+ * \returns The representative of the node.
+ */
+uint32_t
+FindGroup (std::vector<uint32_t> &parent, uint32_t node)
+{
+  while (parent[node] != node)
+    {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+    }
+  return node;
+}
+
+} // unnamed namespace
+
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::g_currentPartition = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MaxThreads",
+                   "Maximum number of threads running the nodes, "
+                   "0 for the number of hardware threads.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_maxThreads (0),
+    m_nThreads (0),
+    m_lookAhead (NO_TS),
+    m_windowEnd (0),
+    m_phase (PROCESS),
+    m_generation (0),
+    m_pending (0),
+    m_nextWorker (0),
+    m_stop (false),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_global.id = 0;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_global.uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_global.currentUid = 0;
+  m_global.currentTs = 0;
+  m_global.currentContext = Simulator::NO_CONTEXT;
+  m_global.eventCount = 0;
+  m_global.unscheduledEvents = 0;
+  // the global partition draws from the global counters
+  m_global.packetUid = 0;
+  m_global.streamIndex = 0;
+  m_global.impl = this;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  ProcessEventsFromThreads ();
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      for (std::vector<EventQueue *>::iterator j = partition->outgoing.begin ();
+           j != partition->outgoing.end (); ++j)
+        {
+          EventWithContext ev;
+          while (*j != 0 && (*j)->Pop (ev))
+            {
+              ev.event->Unref ();
+            }
+          delete *j;
+        }
+      while (!partition->events->IsEmpty ())
+        {
+          partition->events->RemoveNext ().impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  m_nodePartition.clear ();
+  while (!m_global.events->IsEmpty ())
+    {
+      m_global.events->RemoveNext ().impl->Unref ();
+    }
+  m_global.events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "MultithreadedSimulatorImpl::SetScheduler(): Simulation running");
+  m_schedulerFactory = schedulerFactory;
+
+  std::vector<Partition *> partitions = m_partitions;
+  partitions.push_back (&m_global);
+  for (std::vector<Partition *>::iterator i = partitions.begin (); i != partitions.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if ((*i)->events != 0)
+        {
+          while (!(*i)->events->IsEmpty ())
+            {
+              scheduler->Insert ((*i)->events->RemoveNext ());
+            }
+        }
+      (*i)->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::BuildPartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  NodeContainer nodes = NodeContainer::GetGlobal ();
+  uint32_t nNodes = nodes.GetN ();
+
+  // the nodes joined by a channel which cannot be split form a group
+  struct SplitChannel
+  {
+    uint32_t a;      // node at one end
+    uint32_t b;      // node at the other end
+    uint64_t delay;  // propagation delay
+  };
+  std::vector<SplitChannel> splitChannels;
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      parent[i] = i;
+    }
+  TypeId pointToPoint;
+  bool hasPointToPoint = TypeId::LookupByNameFailSafe ("ns3::PointToPointChannel", &pointToPoint);
+  bool hasSystemIds = false;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      hasSystemIds |= node->GetSystemId () != 0;
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          Ptr<Channel> channel = node->GetDevice (j)->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          TypeId tid = channel->GetInstanceTypeId ();
+          TimeValue delay;
+          if (hasPointToPoint && channel->GetNDevices () == 2
+              && (tid == pointToPoint || tid.IsChildOf (pointToPoint))
+              && channel->GetAttributeFailSafe ("Delay", delay)
+              && delay.Get ().IsStrictlyPositive ())
+            {
+              SplitChannel split;
+              split.a = i;
+              split.b = channel->GetDevice (0)->GetNode ()->GetId ();
+              if (split.b == i)
+                {
+                  split.b = channel->GetDevice (1)->GetNode ()->GetId ();
+                }
+              split.delay = delay.Get ().GetTimeStep ();
+              splitChannels.push_back (split);
+              continue;
+            }
+          for (std::size_t k = 0; k < channel->GetNDevices (); k++)
+            {
+              Ptr<Node> peer = channel->GetDevice (k)->GetNode ();
+              if (peer != 0)
+                {
+                  parent[FindGroup (parent, peer->GetId ())] = FindGroup (parent, i);
+                }
+            }
+        }
+    }
+
+  // the groups, by representative, in order of their first node
+  std::map<uint32_t, std::vector<uint32_t> > groups;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      groups[FindGroup (parent, i)].push_back (i);
+    }
+  m_nodePartition.assign (nNodes, 0);
+  uint32_t nPartitions = 1;
+  if (hasSystemIds)
+    {
+      std::map<uint32_t, uint32_t> partitionOfSystemId;
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          partitionOfSystemId[nodes.Get (i)->GetSystemId ()] = 0;
+        }
+      nPartitions = 0;
+      for (std::map<uint32_t, uint32_t>::iterator i = partitionOfSystemId.begin ();
+           i != partitionOfSystemId.end (); ++i)
+        {
+          i->second = nPartitions++;
+        }
+      for (std::map<uint32_t, std::vector<uint32_t> >::const_iterator i = groups.begin ();
+           i != groups.end (); ++i)
+        {
+          uint32_t systemId = nodes.Get (i->second.front ())->GetSystemId ();
+          for (std::vector<uint32_t>::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+            {
+              if (nodes.Get (*j)->GetSystemId () != systemId)
+                {
+                  NS_FATAL_ERROR ("Nodes " << i->second.front () << " and " << *j <<
+                                  " have different system ids but share a channel which cannot be split");
+                }
+              m_nodePartition[*j] = partitionOfSystemId[systemId];
+            }
+        }
+    }
+  else if (!groups.empty ())
+    {
+      uint32_t maxThreads = m_maxThreads;
+      if (maxThreads == 0)
+        {
+          maxThreads = std::max (std::thread::hardware_concurrency (), 1u);
+        }
+      nPartitions = std::min<uint32_t> (maxThreads, groups.size ());
+      // largest group first, in the least loaded partition
+      std::vector<std::pair<uint32_t, uint32_t> > bySize;
+      for (std::map<uint32_t, std::vector<uint32_t> >::const_iterator i = groups.begin ();
+           i != groups.end (); ++i)
+        {
+          bySize.push_back (std::make_pair (-static_cast<uint32_t> (i->second.size ()), i->second.front ()));
+        }
+      std::sort (bySize.begin (), bySize.end ());
+      std::vector<uint32_t> load (nPartitions, 0);
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = bySize.begin ();
+           i != bySize.end (); ++i)
+        {
+          uint32_t partition = std::min_element (load.begin (), load.end ()) - load.begin ();
+          const std::vector<uint32_t> &group = groups[FindGroup (parent, i->second)];
+          for (std::vector<uint32_t>::const_iterator j = group.begin (); j != group.end (); ++j)
+            {
+              m_nodePartition[*j] = partition;
+            }
+          load[partition] += group.size ();
+        }
+    }
+
+  m_lookAhead = NO_TS;
+  for (std::vector<SplitChannel>::const_iterator i = splitChannels.begin (); i != splitChannels.end (); ++i)
+    {
+      if (m_nodePartition[i->a] != m_nodePartition[i->b])
+        {
+          m_lookAhead = std::min (m_lookAhead, i->delay);
+        }
+    }
+
+  for (uint32_t i = 0; i < nPartitions; i++)
+    {
+      Partition *partition = new Partition ();
+      partition->id = i;
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      // the uids of the events moved from the global partition stay unique
+      partition->uid = m_global.uid;
+      partition->currentUid = m_global.currentUid;
+      partition->currentTs = m_global.currentTs;
+      partition->currentContext = Simulator::NO_CONTEXT;
+      partition->eventCount = 0;
+      partition->unscheduledEvents = 0;
+      // counters of their own, so that the uids and the streams do not
+      // depend on the interleaving of the threads
+      partition->packetUid = static_cast<uint64_t> (i + 1) << 48
+        | static_cast<uint64_t> (Simulator::GetSystemId ()) << 32;
+      partition->streamIndex = static_cast<uint64_t> (i + 1) << 48;
+      partition->impl = this;
+      m_partitions.push_back (partition);
+    }
+  m_global.id = nPartitions;
+  for (uint32_t i = 0; i < nPartitions; i++)
+    {
+      for (uint32_t j = 0; j <= nPartitions; j++)
+        {
+          m_partitions[i]->outgoing.push_back (i == j ? 0 : new EventQueue ());
+        }
+    }
+  m_nThreads = nPartitions;
+  if (m_maxThreads != 0)
+    {
+      m_nThreads = std::min (m_nThreads, m_maxThreads);
+    }
+
+  // move the events of the nodes to their partitions
+  std::vector<Scheduler::Event> global;
+  while (!m_global.events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_global.events->RemoveNext ();
+      Partition *partition = GetPartition (ev.key.m_context);
+      if (partition == &m_global)
+        {
+          global.push_back (ev);
+          continue;
+        }
+      m_global.unscheduledEvents--;
+      partition->unscheduledEvents++;
+      partition->events->Insert (ev);
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = global.begin (); i != global.end (); ++i)
+    {
+      m_global.events->Insert (*i);
+    }
+
+  NS_LOG_INFO (nNodes << " nodes in " << nPartitions << " partitions run by " <<
+               m_nThreads << " threads, lookahead " << TimeStep (m_lookAhead));
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context < m_nodePartition.size ())
+    {
+      return m_partitions[m_nodePartition[context]];
+    }
+  // the events without a node and those of the nodes created since
+  // the partitions were built
+  return const_cast<Partition *> (&m_global);
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  if (g_currentPartition != 0)
+    {
+      return g_currentPartition;
+    }
+  return const_cast<Partition *> (&m_global);
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemoteContext (uint32_t context) const
+{
+  // the events of the global partition run between the windows, alone
+  Partition *current = g_currentPartition;
+  return current != 0 && GetPartition (context) != current;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return m_partitions.size ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  if (m_lookAhead == NO_TS)
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookAhead);
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint32_t context, uint64_t ts, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition->uid;
+  partition->uid++;
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNextTs (const Partition *partition) const
+{
+  if (partition->events->IsEmpty ())
+    {
+      return NO_TS;
+    }
+  return partition->events->PeekNext ().key.m_ts;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->currentTs);
+  partition->unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition->currentTs = next.key.m_ts;
+  partition->currentContext = next.key.m_context;
+  partition->currentUid = next.key.m_uid;
+  partition->eventCount++;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition *partition)
+{
+  g_currentPartition = partition;
+  Packet::SetThreadUidCounter (&partition->packetUid);
+  RngSeedManager::SetThreadStreamCounter (&partition->streamIndex);
+  while (GetNextTs (partition) < m_windowEnd)
+    {
+      ProcessOneEvent (partition);
+    }
+  Packet::SetThreadUidCounter (0);
+  RngSeedManager::SetThreadStreamCounter (0);
+  g_currentPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvents (uint64_t ts)
+{
+  NS_LOG_FUNCTION (this << ts);
+  g_currentPartition = &m_global;
+  while (!m_stop && GetNextTs (&m_global) == ts)
+    {
+      ProcessOneEvent (&m_global);
+    }
+  g_currentPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveEvents (Partition *partition)
+{
+  // a fixed order of the senders, whatever the order of the sends
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      EventQueue *queue = (*i)->outgoing[partition->id];
+      EventWithContext ev;
+      while (queue != 0 && queue->Pop (ev))
+        {
+          Insert (partition, ev.context, ev.timestamp, ev.event);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEventsFromThreads (void)
+{
+  std::vector<EventWithContext> events;
+  {
+    CriticalSection cs (m_eventsFromThreadsMutex);
+    events.swap (m_eventsFromThreads);
+  }
+  // every partition has reached the end of the window
+  uint64_t now = std::max (m_windowEnd, m_global.currentTs);
+  for (std::vector<EventWithContext>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      Insert (GetPartition (i->context), i->context, now + i->timestamp, i->event);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPhase (Phase phase)
+{
+  m_phase = phase;
+  m_pending.store (m_threads.size (), std::memory_order_relaxed);
+  m_generation.fetch_add (1, std::memory_order_release);
+  if (phase == EXIT)
+    {
+      return;
+    }
+  DoPhase (0);
+  uint32_t spins = 0;
+  while (m_pending.load (std::memory_order_acquire) != 0)
+    {
+      Pause (spins);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoPhase (uint32_t thread)
+{
+  for (uint32_t i = thread; i < m_partitions.size (); i += m_nThreads)
+    {
+      if (m_phase == PROCESS)
+        {
+          ProcessWindow (m_partitions[i]);
+        }
+      else
+        {
+          ReceiveEvents (m_partitions[i]);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWorker (void)
+{
+  uint32_t thread = m_nextWorker.fetch_add (1);
+  NS_LOG_FUNCTION (this << thread);
+  uint32_t generation = 0;
+  while (true)
+    {
+      uint32_t spins = 0;
+      while (m_generation.load (std::memory_order_acquire) == generation)
+        {
+          Pause (spins);
+        }
+      generation++;
+      if (m_phase == EXIT)
+        {
+          return;
+        }
+      DoPhase (thread);
+      m_pending.fetch_sub (1, std::memory_order_release);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_partitions.empty ())
+    {
+      BuildPartitions ();
+    }
+  m_stop = false;
+  m_running = true;
+
+  m_generation = 0;
+  m_nextWorker = 1;
+  for (uint32_t i = 1; i < m_nThreads; i++)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::RunWorker, this));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+
+  while (!m_stop)
+    {
+      ProcessEventsFromThreads ();
+      uint64_t next = NO_TS;
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          next = std::min (next, GetNextTs (*i));
+        }
+      uint64_t globalNext = GetNextTs (&m_global);
+      if (next == NO_TS && globalNext == NO_TS)
+        {
+          break;
+        }
+      if (globalNext <= next)
+        {
+          ProcessGlobalEvents (globalNext);
+          continue;
+        }
+      // no event of another partition can arrive before the end of the window
+      m_windowEnd = globalNext;
+      if (m_lookAhead < NO_TS - next)
+        {
+          m_windowEnd = std::min (m_windowEnd, next + m_lookAhead);
+        }
+      RunPhase (PROCESS);
+      RunPhase (RECEIVE);
+      ReceiveEvents (&m_global);
+    }
+
+  RunPhase (EXIT);
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+  m_running = false;
+
+  // the main program resumes at the time the partitions reached
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      m_global.currentTs = std::max (m_global.currentTs, (*i)->currentTs);
+    }
+  m_windowEnd = m_global.currentTs;
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  if (!m_stop)
+    {
+      NS_ASSERT (m_global.unscheduledEvents == 0);
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          NS_ASSERT ((*i)->unscheduledEvents == 0);
+        }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return m_global.events->IsEmpty ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the other partitions complete the current window
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (g_currentPartition != 0 || !m_running, "Simulator::Schedule Thread-unsafe invocation!");
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+  Partition *partition = GetCurrentPartition ();
+  uint64_t ts = partition->currentTs + delay.GetTimeStep ();
+  uint32_t context = partition->currentContext;
+  uint32_t uid = Insert (partition, context, ts, event);
+  return EventId (event, ts, context, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Partition *current = g_currentPartition;
+  if (current == 0 && m_running)
+    {
+      EventWithContext ev;
+      ev.context = context;
+      // the current time is added by ProcessEventsFromThreads()
+      ev.timestamp = delay.GetTimeStep ();
+      ev.event = event;
+      CriticalSection cs (m_eventsFromThreadsMutex);
+      m_eventsFromThreads.push_back (ev);
+      return;
+    }
+
+  current = GetCurrentPartition ();
+  uint64_t ts = current->currentTs + delay.GetTimeStep ();
+  Partition *partition = GetPartition (context);
+  if (partition == current || current == &m_global)
+    {
+      // the global events run while the partitions wait
+      Insert (partition, context, ts, event);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event for context " << context << " scheduled by context " <<
+                      current->currentContext << " " << delay << " ahead, below the lookahead of " <<
+                      GetLookAhead () << "; only the channels with a delay are split between partitions");
+    }
+  EventWithContext ev;
+  ev.context = context;
+  ev.timestamp = ts;
+  ev.event = event;
+  current->outgoing[partition->id]->Push (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentPartition ()->currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetPartition (id.GetContext ())->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetPartition (id.GetContext ());
+  NS_ASSERT_MSG (!m_running || g_currentPartition == partition || g_currentPartition == &m_global,
+                 "Simulator::Remove of an event of another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id.GetUid () << delay.GetTimeStep ());
+  NS_ASSERT_MSG (id.GetUid () != 2 && !IsExpired (id),
+                 "MultithreadedSimulatorImpl::Reschedule(): Event not pending");
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Reschedule(): Negative delay");
+  Partition *partition = GetPartition (id.GetContext ());
+  NS_ASSERT_MSG (!m_running || g_currentPartition == partition || g_currentPartition == &m_global,
+                 "Simulator::Reschedule of an event of another partition");
+
+  Scheduler::Event ev;
+  ev.impl = id.PeekEventImpl ();
+  ev.key.m_ts = id.GetTs ();
+  ev.key.m_context = id.GetContext ();
+  ev.key.m_uid = id.GetUid ();
+  // a new uid keeps the order of an event cancelled and scheduled again
+  Scheduler::EventKey key;
+  key.m_ts = GetCurrentPartition ()->currentTs + delay.GetTimeStep ();
+  key.m_context = ev.key.m_context;
+  key.m_uid = partition->uid;
+  partition->uid++;
+  partition->events->Reschedule (ev, key);
+  return EventId (ev.impl, key.m_ts, key.m_context, key.m_uid);
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  const Partition *partition = GetPartition (id.GetContext ());
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < partition->currentTs ||
+      (id.GetTs () == partition->currentTs &&
+       id.GetUid () <= partition->currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t eventCount = m_global.eventCount;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      eventCount += (*i)->eventCount;
+    }
+  return eventCount;
+}
+
+} // namespace ns3
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_SPSC_QUEUE_H
+#define NS3_SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * \file
+ * \ingroup mpi
+ * ns3::SpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ * \brief An unbounded lock-free queue with a single producer and a single
+ * consumer thread.
+ *
+ * The items are stored in a linked list of chunks of CHUNK_SIZE items, so
+ * that Push() never moves the items already queued. The producer publishes
+ * an item by storing the number of items pushed with release semantics,
+ * and the consumer loads it with acquire semantics before reading the item
+ * and, when it crosses a chunk boundary, the link to the next chunk.
+ *
+ * A chunk emptied by the consumer is handed back to the producer through a
+ * single spare slot, so that a queue whose size stays below a few chunks
+ * does not allocate once warmed up.
+ *
+ * \tparam T \explicit The type of the items, copied in and out of the queue.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+  /** Constructor. */
+  SpscQueue ();
+  /** Destructor. */
+  ~SpscQueue ();
+
+  /**
+   * Append an item. To be called by the producer thread only.
+   *
+   * \param [in] item The item.
+   */
+  void Push (const T &item);
+  /**
+   * Remove the oldest item. To be called by the consumer thread only.
+   *
+   * \param [out] item The item, unchanged if the queue is empty.
+   * \returns \c true if an item was removed.
+   */
+  bool Pop (T &item);
+  /**
+   * To be called by the consumer thread only.
+   *
+   * \returns \c true if no item is visible to the consumer.
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /** Number of items of a chunk. */
+  static const uint32_t CHUNK_SIZE = 256;
+  /** Size of the padding between the fields of the two threads. */
+  static const uint32_t CACHE_LINE = 64;
+
+  /** A block of items. */
+  struct Chunk
+  {
+    T items[CHUNK_SIZE];  /**< The items. */
+    Chunk *next;          /**< The next chunk, written by the producer. */
+  };
+
+  /**
+   * Copy constructor, not implemented.
+   * \param [in] o The queue to copy.
+   */
+  SpscQueue (const SpscQueue &o);
+  /**
+   * Assignment operator, not implemented.
+   * \param [in] o The queue to copy.
+   * \returns This queue.
+   */
+  SpscQueue &operator = (const SpscQueue &o);
+
+  Chunk *m_tail;                   /**< Chunk receiving the pushed items. */
+  uint32_t m_tailIndex;            /**< Next free slot of m_tail. */
+  uint64_t m_pushed;               /**< Number of items pushed. */
+  char m_producerPad[CACHE_LINE];  /**< Keep the producer fields apart. */
+  std::atomic<uint64_t> m_published;  /**< Number of items visible to the consumer. */
+  std::atomic<Chunk *> m_spare;    /**< A chunk freed by the consumer, or 0. */
+  char m_sharedPad[CACHE_LINE];    /**< Keep the shared fields apart. */
+  Chunk *m_head;                   /**< Chunk of the oldest item. */
+  uint32_t m_headIndex;            /**< Slot of the oldest item in m_head. */
+  uint64_t m_popped;               /**< Number of items popped. */
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+SpscQueue<T>::SpscQueue ()
+  : m_tailIndex (0),
+    m_pushed (0),
+    m_published (0),
+    m_spare (0),
+    m_headIndex (0),
+    m_popped (0)
+{
+  m_tail = new Chunk;
+  m_tail->next = 0;
+  m_head = m_tail;
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue ()
+{
+  while (m_head != 0)
+    {
+      Chunk *next = m_head->next;
+      delete m_head;
+      m_head = next;
+    }
+  delete m_spare.load (std::memory_order_relaxed);
+}
+
+template <typename T>
+void
+SpscQueue<T>::Push (const T &item)
+{
+  if (m_tailIndex == CHUNK_SIZE)
+    {
+      Chunk *chunk = m_spare.exchange (0, std::memory_order_acquire);
+      if (chunk == 0)
+        {
+          chunk = new Chunk;
+        }
+      chunk->next = 0;
+      // published along with the first item of the chunk
+      m_tail->next = chunk;
+      m_tail = chunk;
+      m_tailIndex = 0;
+    }
+  m_tail->items[m_tailIndex] = item;
+  m_tailIndex++;
+  m_pushed++;
+  m_published.store (m_pushed, std::memory_order_release);
+}
+
+template <typename T>
+bool
+SpscQueue<T>::Pop (T &item)
+{
+  if (m_popped == m_published.load (std::memory_order_acquire))
+    {
+      return false;
+    }
+  if (m_headIndex == CHUNK_SIZE)
+    {
+      Chunk *chunk = m_head;
+      m_head = chunk->next;
+      m_headIndex = 0;
+      // the producer has moved on, it may reuse the chunk
+      delete m_spare.exchange (chunk, std::memory_order_release);
+    }
+  item = m_head->items[m_headIndex];
+  m_headIndex++;
+  m_popped++;
+  return true;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::IsEmpty (void) const
+{
+  return m_popped == m_published.load (std::memory_order_acquire);
+}
+
+} // namespace ns3
+
+#endif /* NS3_SPSC_QUEUE_H */
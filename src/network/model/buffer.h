@@ -765,9 +765,9 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value. Kept per thread, like the free list.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -791,16 +791,14 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
+  /// Container for buffer data, which deallocates its content when destroyed
+  struct FreeList : public std::vector<struct Buffer::Data*>
   {
-    ~LocalStaticDestructor ();
+    ~FreeList ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList g_freeList; //!< Buffer data container of the thread
+  static thread_local bool g_freeListDestroyed; //!< The free list of the thread is gone
 #endif
 };
 
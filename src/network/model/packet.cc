@@ -21,14 +21,17 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/event-profiler.h"
 #include <string>
 #include <cstdarg>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid (0);
+thread_local uint64_t *Packet::m_threadUid = 0;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -126,20 +129,77 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  // the bytes, the metadata and the nix-vector
+  uint32_t size = GetSerializedSize ();
+  std::vector<uint32_t> data ((size + 3) / 4);
+  uint8_t *buffer = reinterpret_cast<uint8_t *> (&data[0]);
+  Serialize (buffer, size);
+  Ptr<Packet> copy = Ptr<Packet> (new Packet (buffer, size, true), false);
+
+  // the tags, which Serialize leaves out
+  ByteTagList::Iterator i = m_byteTagList.Begin (0, GetSize ());
+  while (i.HasNext ())
+    {
+      ByteTagList::Iterator::Item item = i.Next ();
+      TagBuffer tagBuffer = copy->m_byteTagList.Add (item.tid, item.size, item.start, item.end);
+      tagBuffer.CopyFrom (item.buf);
+    }
+  std::vector<const PacketTagList::TagData *> tags;
+  for (const PacketTagList::TagData *cur = m_packetTagList.Head (); cur != 0; cur = cur->next)
+    {
+      tags.push_back (cur);
+    }
+  // Add() prepends, so the copy keeps the order of the tags
+  for (std::vector<const PacketTagList::TagData *>::reverse_iterator j = tags.rbegin ();
+       j != tags.rend (); ++j)
+    {
+      Callback<ObjectBase *> constructor = (*j)->tid.GetConstructor ();
+      NS_ASSERT_MSG (!constructor.IsNull (), "No constructor for tag " << (*j)->tid.GetName ());
+      Tag *tag = dynamic_cast<Tag *> (constructor ());
+      NS_ASSERT (tag != 0);
+      uint8_t *start = const_cast<uint8_t *> ((*j)->data);
+      tag->Deserialize (TagBuffer (start, start + (*j)->size));
+      copy->m_packetTagList.Add (*tag);
+      delete tag;
+    }
+  return copy;
+}
+
+void
+Packet::SetThreadUidCounter (uint64_t *counter)
+{
+  NS_LOG_FUNCTION (counter);
+  m_threadUid = counter;
+}
+
+uint64_t
+Packet::AllocateUid (void)
+{
+  if (m_threadUid != 0)
+    {
+      return (*m_threadUid)++;
+    }
+  /* The upper 32 bits of the packet id in 
+   * metadata is for the system id. For non-
+   * distributed simulations, this is simply 
+   * zero.  The lower 32 bits are for the 
+   * global UID
+   */
+  return static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
+  EventProfiler::CountAllocation ();
 }
 
 Packet::Packet (const Packet &o)
@@ -148,6 +208,7 @@ Packet::Packet (const Packet &o)
     m_packetTagList (o.m_packetTagList),
     m_metadata (o.m_metadata)
 {
+  EventProfiler::CountAllocation ();
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
 }
@@ -172,16 +233,10 @@ Packet::Packet (uint32_t size)
   : m_buffer (size),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
+  EventProfiler::CountAllocation ();
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -190,6 +245,7 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
     m_metadata (0,0),
     m_nixVector (0)
 {
+  EventProfiler::CountAllocation ();
   NS_ASSERT (magic);
   Deserialize (buffer, size);
 }
@@ -198,16 +254,10 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
   : m_buffer (),
     m_byteTagList (),
     m_packetTagList (),
-    /* The upper 32 bits of the packet id in 
-     * metadata is for the system id. For non-
-     * distributed simulations, this is simply 
-     * zero.  The lower 32 bits are for the 
-     * global UID
-     */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
+  EventProfiler::CountAllocation ();
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -221,6 +271,7 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_metadata (metadata),
     m_nixVector (0)
 {
+  EventProfiler::CountAllocation ();
 }
 
 Ptr<Packet>
@@ -21,6 +21,7 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <atomic>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -453,6 +454,18 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \brief performs a copy of the packet which shares nothing with it.
+   *
+   * \returns a copy of the packet owning its buffer, tags and metadata.
+   *
+   * The datasets shared by COW copies are reference counted without
+   * synchronization, so a packet handed over to another thread must be
+   * copied with this method. It is much slower than Copy(). Tags are
+   * rebuilt from their TypeId, which must have a constructor.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * \brief Returns the packet's Uid.
    *
@@ -530,6 +543,19 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Allocate the uids of the packets created by the calling thread
+   * from a counter of its own.
+   *
+   * The global counter is shared by all the threads, so the uids it
+   * allocates depend on how the threads interleave. A simulator running
+   * groups of nodes in several threads gives each group a counter, whose
+   * high bits identify the group, to allocate the same uids in every run.
+   *
+   * \param [in] counter The next uid, incremented for each new packet, or
+   *             0 to use the global counter again.
+   */
+  static void SetThreadUidCounter (uint64_t *counter);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -758,6 +784,12 @@ private:
    */
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \brief Allocate the uid of a new packet.
+   * \returns the uid.
+   */
+  static uint64_t AllocateUid (void);
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
@@ -766,7 +798,8 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid, shared by all threads
+  static thread_local uint64_t *m_threadUid; //!< Counter of packets Uid of the thread, if any
 };
 
 /**
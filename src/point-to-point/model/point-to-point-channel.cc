@@ -80,6 +80,13 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
       m_link[1].m_dst = m_link[0].m_src;
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
+      for (std::size_t i = 0; i < N_DEVICES; i++)
+        {
+          if (m_link[i].m_dst->GetNode () != 0)
+            {
+              m_link[i].m_dstNode = m_link[i].m_dst->GetNode ()->GetId ();
+            }
+        }
     }
 }
 
@@ -96,13 +103,33 @@ PointToPointChannel::TransmitStart (
   NS_ASSERT (m_link[1].m_state != INITIALIZING);
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+  Link &link = m_link[wire];
+  if (link.m_dstNode == NO_NODE)
+    {
+      // the device was attached before being added to its node
+      link.m_dstNode = link.m_dst->GetNode ()->GetId ();
+    }
 
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
-                                  txTime + m_delay, &PointToPointNetDevice::Receive,
-                                  m_link[wire].m_dst, p->Copy ());
+  if (Simulator::IsRemoteContext (link.m_dstNode))
+    {
+      // the receiver is run by another thread, which can share neither
+      // the datasets of the packet nor the reference count of the device
+      Simulator::ScheduleWithContext (link.m_dstNode,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (link.m_dst), p->DeepCopy ());
+    }
+  else
+    {
+      Simulator::ScheduleWithContext (link.m_dstNode,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      link.m_dst, p->Copy ());
+    }
 
   // Call the tx anim callback on the net device
-  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+  if (!m_txrxPointToPoint.IsEmpty ())
+    {
+      m_txrxPointToPoint (p, src, link.m_dst, txTime, txTime + m_delay);
+    }
   return true;
 }
 
@@ -128,6 +155,19 @@ PointToPointChannel::GetDevice (std::size_t i) const
   return GetPointToPointDevice (i);
 }
 
+Address
+PointToPointChannel::GetRemoteAddress (const PointToPointNetDevice *device) const
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT (m_nDevices == N_DEVICES);
+  if (PeekPointer (m_link[0].m_src) == device)
+    {
+      return m_link[1].m_src->GetAddress ();
+    }
+  NS_ASSERT (PeekPointer (m_link[1].m_src) == device);
+  return m_link[0].m_src->GetAddress ();
+}
+
 Time
 PointToPointChannel::GetDelay (void) const
 {
@@ -22,6 +22,7 @@
 #include <list>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
+#include "ns3/address.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/traced-callback.h"
@@ -100,6 +101,17 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Get the address of the device at the other end of the channel
+   *
+   * Unlike GetDevice, it does not touch the reference count of the other
+   * device, which may be run by another thread.
+   *
+   * \param device One of the two devices of the channel
+   * \returns The address of the other device
+   */
+  Address GetRemoteAddress (const PointToPointNetDevice *device) const;
+
 protected:
   /**
    * \brief Get the delay associated with this channel
@@ -185,6 +197,9 @@ private:
     PROPAGATING
   };
 
+  /** Value of Link::m_dstNode before the node is known. */
+  static const uint32_t NO_NODE = 0xffffffff;
+
   /**
    * \brief Wire model for the PointToPointChannel
    */
@@ -194,11 +209,16 @@ public:
     /** \brief Create the link, it will be in INITIALIZING state
      *
      */
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstNode (NO_NODE) {}
 
     WireState                  m_state; //!< State of the link
     Ptr<PointToPointNetDevice> m_src;   //!< First NetDevice
     Ptr<PointToPointNetDevice> m_dst;   //!< Second NetDevice
+    /**
+     * Id of the node of m_dst, so that a transmission does not touch the
+     * receiving node, which may be run by another thread.
+     */
+    uint32_t                   m_dstNode;
   };
 
   Link    m_link[N_DEVICES]; //!< Link model
@@ -0,0 +1,279 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \brief Test the MultithreadedSimulatorImpl on a ring of point to point links
+ *
+ * Each node of the ring forwards the packets it receives on its other
+ * device, one byte larger, until they reach a maximum size. The packets
+ * received by each node must be the same as with the DefaultSimulatorImpl.
+ * Two multithreaded runs must also give the packets the same uids, and
+ * the random variables created by the nodes the same streams.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /** A packet received by a node: time, size and receiving device. */
+  struct Reception
+  {
+    int64_t time;     //!< Reception time, in time steps.
+    uint32_t size;    //!< Packet size.
+    uint32_t device;  //!< Index of the receiving device.
+    uint64_t uid;     //!< Packet uid.
+    uint32_t draw;    //!< Draw of a random variable created at the reception.
+
+    /**
+     * \param [in] o The other reception.
+     * \returns \c true if this reception comes first.
+     */
+    bool operator < (const Reception &o) const
+    {
+      if (time != o.time)
+        {
+          return time < o.time;
+        }
+      if (size != o.size)
+        {
+          return size < o.size;
+        }
+      if (device != o.device)
+        {
+          return device < o.device;
+        }
+      if (uid != o.uid)
+        {
+          return uid < o.uid;
+        }
+      return draw < o.draw;
+    }
+    /**
+     * \param [in] o The other reception.
+     * \returns \c true if the receptions are the same.
+     */
+    bool operator == (const Reception &o) const
+    {
+      return time == o.time && size == o.size && device == o.device
+             && uid == o.uid && draw == o.draw;
+    }
+  };
+
+  /**
+   * \param [in] a Receptions.
+   * \param [in] b Other receptions.
+   * \returns \c true if the receptions have the same times, sizes and
+   *          devices, whatever the uids and the draws.
+   */
+  static bool SameTraffic (const std::vector<Reception> &a, const std::vector<Reception> &b);
+
+  /**
+   * \brief Run the ring with the current simulator implementation
+   *
+   * \returns The receptions of each node, sorted.
+   */
+  std::vector<std::vector<Reception> > RunRing (void);
+
+  /**
+   * \brief Send a packet on a device
+   *
+   * \param device NetDevice to send on
+   * \param size size of the packet
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+
+  /**
+   * \brief Record a packet and forward it on the other device of the node
+   *
+   * \param device the receiving NetDevice
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns \c true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  /** Number of nodes of the ring. */
+  static const uint32_t N_NODES = 8;
+  /** Size above which the packets are not forwarded. */
+  static const uint32_t MAX_SIZE = 200;
+
+  /** The receptions of each node. */
+  std::vector<std::vector<Reception> > m_receptions;
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("Multithreaded simulation of a point to point ring")
+{
+}
+
+void
+PointToPointMultithreadedTest::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultithreadedTest::SameTraffic (const std::vector<Reception> &a, const std::vector<Reception> &b)
+{
+  if (a.size () != b.size ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a.size (); i++)
+    {
+      if (a[i].time != b[i].time || a[i].size != b[i].size || a[i].device != b[i].device)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                        uint16_t protocol, const Address &from)
+{
+  // each node is run by a single thread, which alone touches its receptions
+  Ptr<Node> node = device->GetNode ();
+  uint32_t index = device->GetIfIndex ();
+  Reception reception;
+  reception.time = Simulator::Now ().GetTimeStep ();
+  reception.size = packet->GetSize ();
+  reception.device = index;
+  reception.uid = packet->GetUid ();
+  reception.draw = CreateObject<UniformRandomVariable> ()->GetInteger (0, 0xffffffff);
+  m_receptions[node->GetId ()].push_back (reception);
+  if (reception.size < MAX_SIZE)
+    {
+      Send (node->GetDevice (1 - index), reception.size + 1);
+    }
+  return true;
+}
+
+std::vector<std::vector<PointToPointMultithreadedTest::Reception> >
+PointToPointMultithreadedTest::RunRing (void)
+{
+  m_receptions.assign (N_NODES, std::vector<Reception> ());
+  NodeContainer nodes;
+  nodes.Create (N_NODES);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % N_NODES));
+    }
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          node->GetDevice (j)->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+        }
+      for (uint32_t k = 0; k < 10; k++)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (100 * k + i), &PointToPointMultithreadedTest::Send,
+                                          this, node->GetDevice (k % 2), 100 + k);
+        }
+    }
+
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetNPartitions (), 4, "Nodes not spread over the threads");
+      NS_TEST_EXPECT_MSG_EQ (impl->GetLookAhead (), MilliSeconds (1), "Lookahead is not the link delay");
+    }
+  Simulator::Destroy ();
+
+  std::vector<std::vector<Reception> > receptions;
+  receptions.swap (m_receptions);
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      std::sort (receptions[i].begin (), receptions[i].end ());
+    }
+  return receptions;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  std::vector<std::vector<Reception> > expected = RunRing ();
+
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (4));
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  std::vector<std::vector<Reception> > receptions = RunRing ();
+  std::vector<std::vector<Reception> > again = RunRing ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (0));
+
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (expected[i].size (), 0, "Node " << i << " received nothing");
+      NS_TEST_ASSERT_MSG_EQ (receptions[i].size (), expected[i].size (), "Node " << i << " packet count differs");
+      NS_TEST_ASSERT_MSG_EQ (SameTraffic (receptions[i], expected[i]), true, "Node " << i << " receptions differ");
+      NS_TEST_ASSERT_MSG_EQ ((again[i] == receptions[i]), true,
+                             "Node " << i << " uids or draws differ between multithreaded runs");
+    }
+}
+
+/**
+ * \brief TestSuite for the multithreaded simulation of point to point links
+ */
+class PointToPointMultithreadedTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  PointToPointMultithreadedTestSuite ();
+};
+
+PointToPointMultithreadedTestSuite::PointToPointMultithreadedTestSuite ()
+  : TestSuite ("devices-point-to-point-multithreaded", UNIT)
+{
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
+}
+
+static PointToPointMultithreadedTestSuite g_pointToPointMultithreadedTestSuite; //!< The testsuite
@@ -198,6 +198,12 @@ VisualSimulatorImpl::Cancel (const EventId &id)
   m_simulator->Cancel (id);
 }
 
+EventId
+VisualSimulatorImpl::Reschedule (const EventId &id, const Time &delay)
+{
+  return m_simulator->Reschedule (id, delay);
+}
+
 bool
 VisualSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -216,6 +222,12 @@ VisualSimulatorImpl::GetContext (void) const
   return m_simulator->GetContext ();
 }
 
+uint64_t
+VisualSimulatorImpl::GetEventCount (void) const
+{
+  return m_simulator->GetEventCount ();
+}
+
 void
 VisualSimulatorImpl::RunRealSimulator (void)
 {
@@ -51,7 +51,8 @@ public:
   Bench (const uint32_t population, const uint32_t total)
     : m_population (population),
       m_total (total),
-      m_count (0)
+      m_count (0),
+      m_reschedule (false)
   {
   }
 
@@ -82,18 +83,39 @@ public:
     m_total = total;
   }
 
+  /**
+   * Set the timers restarted by the events
+   * \param timers the number of timers, 0 for none
+   * \param reschedule move the timers with Simulator::Reschedule,
+   *        instead of cancelling and scheduling them again
+   */
+  void SetTimers (const uint32_t timers, bool reschedule)
+  {
+    m_timers.resize (timers);
+    m_reschedule = reschedule;
+  }
+
   /// Run function
   void RunBench (void);
 private:
   /// callback function
   void Cb (void);
+  /// timer function, never run
+  void Timeout (void);
+  /// restart the next timer, as a new ACK restarts a retransmission timer
+  void Restart (void);
 
   Ptr<RandomVariableStream> m_rand; ///< random variable
   uint32_t m_population; ///< population
   uint32_t m_total; ///< total
   uint32_t m_count; ///< count 
+  std::vector<EventId> m_timers; ///< timers restarted by the events
+  bool m_reschedule; ///< restart the timers with Simulator::Reschedule
 };
 
+/// Delay of the timers, much longer than the intervals of the events
+static const Time TIMER_DELAY = Seconds (1);
+
 void
 Bench::RunBench (void)
 {
@@ -110,6 +132,10 @@ Bench::RunBench (void)
       Time at = NanoSeconds (m_rand->GetValue ());
       Simulator::Schedule (at, &Bench::Cb, this);
     }
+  for (uint32_t i = 0; i < m_timers.size (); ++i)
+    {
+      m_timers[i] = Simulator::Schedule (TIMER_DELAY, &Bench::Timeout, this);
+    }
   init = time.End ();
   init /= 1000;
   DEB ("initialization took " << init << "s");
@@ -135,15 +161,44 @@ Bench::Cb (void)
 {
   if (m_count >= m_total)
     {
+      for (uint32_t i = 0; i < m_timers.size (); ++i)
+        {
+          m_timers[i].Cancel ();
+        }
       return;
     }
   DEB ("event at " << Simulator::Now ().GetSeconds () << "s");
 
   Time after = NanoSeconds (m_rand->GetValue ());
   Simulator::Schedule (after, &Bench::Cb, this);
+  if (!m_timers.empty ())
+    {
+      Restart ();
+    }
   ++m_count;
 }
 
+void
+Bench::Timeout (void)
+{
+  NS_FATAL_ERROR ("Timer not restarted in time");
+}
+
+void
+Bench::Restart (void)
+{
+  EventId &timer = m_timers[m_count % m_timers.size ()];
+  if (m_reschedule)
+    {
+      timer = Simulator::Reschedule (timer, TIMER_DELAY);
+    }
+  else
+    {
+      timer.Cancel ();
+      timer = Simulator::Schedule (TIMER_DELAY, &Bench::Timeout, this);
+    }
+}
+
 
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
@@ -205,12 +260,15 @@ int main (int argc, char *argv[])
 
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedLadder = false;
   bool schedList = false;
   bool schedMap  = true;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
   uint32_t runs  =       1;
+  uint32_t timers =      0;
+  bool reschedule = false;
   std::string filename = "";
 
   CommandLine cmd;
@@ -221,15 +279,21 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "\n"
+             "With --timers, each event also restarts one of a set of\n"
+             "long timers, as new ACKs restart retransmission timers.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",           schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
+  cmd.AddValue ("timers", "number of timers restarted by the events (default 0)", timers);
+  cmd.AddValue ("reschedule", "restart the timers with Simulator::Reschedule", reschedule);
   cmd.AddValue ("file",  "file of relative event times",  filename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
@@ -245,6 +309,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::HeapScheduler");
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
   if (schedList)
     {
       factory.SetTypeId ("ns3::ListScheduler");
@@ -258,9 +326,11 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  LOGME ("timers: " << timers << (reschedule ? ", rescheduled" : ", cancelled and scheduled again"));
 
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetTimers (timers, reschedule);
 
   // table header
   LOG ("");